@@ -0,0 +1,87 @@
+// Backoff -- progressive waiting for lock-free queue consumers
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_BACKOFF_H
+#define UDP_CLIENT_SERVER_BACKOFF_H
+
+#include <stdint.h>
+#include <time.h>
+#include <thread>
+
+namespace udp_client_server
+{
+
+/** \brief Wait a little longer each time a queue is found empty or full.
+ *
+ * The first waits are CPU pause instructions, then the thread yields,
+ * then it sleeps 50 microseconds at a time. Call reset() once work was
+ * found again.
+ */
+class Backoff
+{
+public:
+                        Backoff();
+
+    void                reset();
+    void                wait();
+
+private:
+    static const uint32_t SPIN_LIMIT = 64;
+    static const uint32_t YIELD_LIMIT = 128;
+
+    uint32_t            f_count_;
+};
+
+
+inline Backoff::Backoff()
+    : f_count_(0)
+{
+}
+
+inline void Backoff::reset()
+{
+    f_count_ = 0;
+}
+
+inline void Backoff::wait()
+{
+    if(f_count_ < SPIN_LIMIT)
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+    else if(f_count_ < YIELD_LIMIT)
+    {
+        std::this_thread::yield();
+    }
+    else
+    {
+        struct timespec delay;
+        delay.tv_sec = 0;
+        delay.tv_nsec = 50000;
+        nanosleep(&delay, NULL);
+        return;
+    }
+    ++f_count_;
+}
+
+} // namespace udp_client_server
+
+#endif
+// UDP_CLIENT_SERVER_BACKOFF_H
+// vim: ts=4 sw=4 et
@@ -0,0 +1,521 @@
+// Basic UDP Socket -- UDP socket configured by compile-time policies
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_BASIC_UDP_SOCKET_H
+#define UDP_CLIENT_SERVER_BASIC_UDP_SOCKET_H
+
+#include "udp_client_server.h"
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <type_traits>
+
+namespace udp_client_server
+{
+
+int                     openUdpSocket(const std::string& addr, int port, int family, int flags,
+                                      bool bind_address, struct addrinfo *& addrinfo);
+socklen_t               resolveUdpAddress(const std::string& addr, int port, int family,
+                                          struct sockaddr_storage& result);
+
+
+// ========================= POLICIES =========================
+
+struct FamilyPolicyTag {};
+struct BlockingPolicyTag {};
+struct BatchingPolicyTag {};
+struct TimestampingPolicyTag {};
+struct MetricsPolicyTag {};
+struct RolePolicyTag {};
+
+struct AnyFamily        { typedef FamilyPolicyTag category; static const int FAMILY = AF_UNSPEC; };
+struct IPv4Only         { typedef FamilyPolicyTag category; static const int FAMILY = AF_INET; };
+struct IPv6Only         { typedef FamilyPolicyTag category; static const int FAMILY = AF_INET6; };
+
+struct NonBlocking      { typedef BlockingPolicyTag category; static const int SOCKET_FLAGS = SOCK_NONBLOCK; };
+struct Blocking         { typedef BlockingPolicyTag category; static const int SOCKET_FLAGS = 0; };
+
+struct NoBatching       { typedef BatchingPolicyTag category; static const unsigned int BATCH_SIZE = 0; };
+template<unsigned int N>
+struct Batching         { typedef BatchingPolicyTag category; static const unsigned int BATCH_SIZE = N; };
+
+struct NoTimestamps     { typedef TimestampingPolicyTag category; static const bool ENABLED = false; };
+struct KernelTimestamps { typedef TimestampingPolicyTag category; static const bool ENABLED = true; };
+
+struct ClientRole       { typedef RolePolicyTag category; static const bool BIND = false; };
+struct ServerRole       { typedef RolePolicyTag category; static const bool BIND = true; };
+
+/** \brief Metrics policy counting nothing; all the calls compile away.
+ */
+struct NoMetrics
+{
+    typedef MetricsPolicyTag category;
+
+    void                countSent(size_t) {}
+    void                countReceived(size_t) {}
+    void                countError() {}
+};
+
+/** \brief Metrics policy keeping plain per-socket counters.
+ */
+struct SocketMetrics
+{
+    typedef MetricsPolicyTag category;
+
+                        SocketMetrics()
+                            : sent_packets(0)
+                            , sent_bytes(0)
+                            , received_packets(0)
+                            , received_bytes(0)
+                            , errors(0)
+                        {
+                        }
+
+    void                countSent(size_t size) { ++sent_packets; sent_bytes += size; }
+    void                countReceived(size_t size) { ++received_packets; received_bytes += size; }
+    void                countError() { ++errors; }
+
+    uint64_t            sent_packets;
+    uint64_t            sent_bytes;
+    uint64_t            received_packets;
+    uint64_t            received_bytes;
+    uint64_t            errors;
+};
+
+
+namespace detail
+{
+
+template<typename Category, typename Default, typename... Policies>
+struct SelectPolicy
+{
+    typedef Default type;
+};
+
+template<typename Category, typename Default, typename Head, typename... Tail>
+struct SelectPolicy<Category, Default, Head, Tail...>
+{
+    typedef typename std::conditional<std::is_same<typename Head::category, Category>::value
+                                    , Head
+                                    , typename SelectPolicy<Category, Default, Tail...>::type>::type type;
+};
+
+template<typename Category, typename... Policies>
+struct PolicyCount
+{
+    static constexpr int value = 0;
+};
+
+template<typename Category, typename Head, typename... Tail>
+struct PolicyCount<Category, Head, Tail...>
+{
+    static constexpr int value = (std::is_same<typename Head::category, Category>::value ? 1 : 0)
+                               + PolicyCount<Category, Tail...>::value;
+};
+
+template<typename... Policies>
+struct PoliciesValid
+{
+    static constexpr int known = PolicyCount<FamilyPolicyTag, Policies...>::value
+                               + PolicyCount<BlockingPolicyTag, Policies...>::value
+                               + PolicyCount<BatchingPolicyTag, Policies...>::value
+                               + PolicyCount<TimestampingPolicyTag, Policies...>::value
+                               + PolicyCount<MetricsPolicyTag, Policies...>::value
+                               + PolicyCount<RolePolicyTag, Policies...>::value;
+    static constexpr bool unique = PolicyCount<FamilyPolicyTag, Policies...>::value <= 1
+                                && PolicyCount<BlockingPolicyTag, Policies...>::value <= 1
+                                && PolicyCount<BatchingPolicyTag, Policies...>::value <= 1
+                                && PolicyCount<TimestampingPolicyTag, Policies...>::value <= 1
+                                && PolicyCount<MetricsPolicyTag, Policies...>::value <= 1
+                                && PolicyCount<RolePolicyTag, Policies...>::value <= 1;
+    static constexpr bool value = unique && known == static_cast<int>(sizeof...(Policies));
+};
+
+} // namespace detail
+
+
+/** \brief UDP socket whose features are selected at compile time.
+ *
+ * Each policy picks one behavior of the socket. Policies may be given in
+ * any order; a category left out takes its default (first listed):
+ *
+ * \li family: AnyFamily, IPv4Only, IPv6Only
+ * \li blocking: NonBlocking, Blocking
+ * \li batching: NoBatching, Batching<N> (sendBatch()/recvBatch())
+ * \li timestamping: NoTimestamps, KernelTimestamps (SO_TIMESTAMPNS)
+ * \li metrics: NoMetrics, SocketMetrics
+ * \li role: ClientRole (sends to the address), ServerRole (binds the address)
+ *
+ * \code
+ *   typedef BasicUdpSocket<ServerRole, IPv4Only, Batching<32>, SocketMetrics> IngestSocket;
+ *
+ *   IngestSocket s("0.0.0.0", 7000);
+ *   int const count(s.recvBatch(buffers, 32, sizes));
+ *   std::cerr << s.getMetrics().received_packets << "\n";
+ * \endcode
+ *
+ * Functions of a feature that was not selected fail to compile instead of
+ * testing a flag at run time, and the disabled policies (NoMetrics,
+ * NoTimestamps) are empty, so the send and receive paths are exactly the
+ * system call plus whatever was asked for.
+ *
+ * UdpClient and UdpServer remain regular classes: they carry run-time
+ * state (send queue, path MTU) and are forward declared by users. They
+ * share the socket creation code of this template through openUdpSocket().
+ */
+template<typename... Policies>
+class BasicUdpSocket
+    : public detail::SelectPolicy<MetricsPolicyTag, NoMetrics, Policies...>::type
+{
+public:
+    static_assert(detail::PoliciesValid<Policies...>::value,
+                  "BasicUdpSocket: unknown policy or two policies of the same category");
+
+    typedef typename detail::SelectPolicy<FamilyPolicyTag, AnyFamily, Policies...>::type          Family;
+    typedef typename detail::SelectPolicy<BlockingPolicyTag, NonBlocking, Policies...>::type      BlockingMode;
+    typedef typename detail::SelectPolicy<BatchingPolicyTag, NoBatching, Policies...>::type       BatchingMode;
+    typedef typename detail::SelectPolicy<TimestampingPolicyTag, NoTimestamps, Policies...>::type Timestamping;
+    typedef typename detail::SelectPolicy<MetricsPolicyTag, NoMetrics, Policies...>::type         Metrics;
+    typedef typename detail::SelectPolicy<RolePolicyTag, ClientRole, Policies...>::type           Role;
+
+                        BasicUdpSocket(const std::string& addr, int port);
+                        ~BasicUdpSocket();
+
+    int                 getSocket() const;
+    int                 getPort() const;
+    std::string         getAddr() const;
+    const Metrics&      getMetrics() const;
+
+    int                 send(const char *msg, size_t size);
+    int                 sendv(const struct iovec *iov, size_t iovcnt);
+    int                 sendBatch(const UdpSendVector *vectors, unsigned int count);
+
+    int                 recv(char *msg, size_t max_size);
+    int                 recv(char *msg, size_t max_size, struct timespec& stamp);
+    int                 recvBatch(const struct iovec *buffers, unsigned int count, size_t *sizes);
+
+private:
+                        BasicUdpSocket(const BasicUdpSocket&);
+    BasicUdpSocket&     operator=(const BasicUdpSocket&);
+
+    int                 sent(int r);
+    int                 received(int r);
+    void                failed();
+
+    int                 f_socket_;
+    int                 f_port_;
+    std::string         f_addr_;
+    struct addrinfo *   f_addrinfo_;
+};
+
+
+/** \brief Create the socket for \p addr and \p port.
+ *
+ * With the ServerRole policy the socket is bound to the address, with
+ * the ClientRole policy messages are sent to it.
+ *
+ * \exception UdpClientServerRuntimeError
+ * The address cannot be resolved in the selected family, or the socket
+ * cannot be created, bound or configured.
+ *
+ * \param[in] addr  The address to send to or receive on.
+ * \param[in] port  The port number.
+ */
+template<typename... Policies>
+BasicUdpSocket<Policies...>::BasicUdpSocket(const std::string& addr, int port)
+    : f_socket_(-1)
+    , f_port_(port)
+    , f_addr_(addr)
+    , f_addrinfo_(NULL)
+{
+    f_socket_ = openUdpSocket(addr, port, Family::FAMILY, BlockingMode::SOCKET_FLAGS, Role::BIND, f_addrinfo_);
+    if(Timestamping::ENABLED)
+    {
+        int const on(1);
+        if(setsockopt(f_socket_, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) != 0)
+        {
+            freeaddrinfo(f_addrinfo_);
+            close(f_socket_);
+            throw UdpClientServerRuntimeError(("could not enable timestamps on UDP socket for: \"" + addr + "\"").c_str());
+        }
+    }
+}
+
+/** \brief Close the socket.
+ */
+template<typename... Policies>
+BasicUdpSocket<Policies...>::~BasicUdpSocket()
+{
+    freeaddrinfo(f_addrinfo_);
+    close(f_socket_);
+}
+
+/** \brief Return the socket, i.e. to poll() it.
+ */
+template<typename... Policies>
+int BasicUdpSocket<Policies...>::getSocket() const
+{
+    return f_socket_;
+}
+
+/** \brief Return the port given to the constructor.
+ */
+template<typename... Policies>
+int BasicUdpSocket<Policies...>::getPort() const
+{
+    return f_port_;
+}
+
+/** \brief Return a verbatim copy of the address given to the constructor.
+ */
+template<typename... Policies>
+std::string BasicUdpSocket<Policies...>::getAddr() const
+{
+    return f_addr_;
+}
+
+/** \brief Return the counters of the metrics policy.
+ */
+template<typename... Policies>
+const typename BasicUdpSocket<Policies...>::Metrics& BasicUdpSocket<Policies...>::getMetrics() const
+{
+    return *this;
+}
+
+/** \brief Send a message to the address of the socket (ClientRole only.)
+ *
+ * \return -1 if an error occurs, otherwise the number of bytes sent.
+ */
+template<typename... Policies>
+int BasicUdpSocket<Policies...>::send(const char *msg, size_t size)
+{
+    static_assert(!Role::BIND, "BasicUdpSocket::send() requires the ClientRole policy");
+    return sent(sendto(f_socket_, msg, size, 0, f_addrinfo_->ai_addr, f_addrinfo_->ai_addrlen));
+}
+
+/** \brief Send a message made of several buffers (ClientRole only.)
+ *
+ * \return -1 if an error occurs, otherwise the number of bytes sent.
+ */
+template<typename... Policies>
+int BasicUdpSocket<Policies...>::sendv(const struct iovec *iov, size_t iovcnt)
+{
+    static_assert(!Role::BIND, "BasicUdpSocket::sendv() requires the ClientRole policy");
+    struct msghdr hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.msg_name = f_addrinfo_->ai_addr;
+    hdr.msg_namelen = f_addrinfo_->ai_addrlen;
+    hdr.msg_iov = const_cast<struct iovec *>(iov);
+    hdr.msg_iovlen = iovcnt;
+    return sent(sendmsg(f_socket_, &hdr, 0));
+}
+
+/** \brief Send several messages with sendmmsg() (ClientRole and Batching only.)
+ *
+ * Messages are submitted in chunks of the batch size of the policy. The
+ * function stops at the first chunk the kernel does not fully accept.
+ *
+ * \return -1 if the very first message could not be sent, otherwise the
+ * number of messages sent.
+ */
+template<typename... Policies>
+int BasicUdpSocket<Policies...>::sendBatch(const UdpSendVector *vectors, unsigned int count)
+{
+    static_assert(!Role::BIND, "BasicUdpSocket::sendBatch() requires the ClientRole policy");
+    static_assert(BatchingMode::BATCH_SIZE > 0, "BasicUdpSocket::sendBatch() requires the Batching<N> policy");
+
+    struct mmsghdr msgs[BatchingMode::BATCH_SIZE];
+    unsigned int done(0);
+    while(done < count)
+    {
+        unsigned int const chunk(count - done < BatchingMode::BATCH_SIZE ? count - done : BatchingMode::BATCH_SIZE);
+        memset(msgs, 0, sizeof(msgs[0]) * chunk);
+        for(unsigned int i(0); i < chunk; ++i)
+        {
+            msgs[i].msg_hdr.msg_name = f_addrinfo_->ai_addr;
+            msgs[i].msg_hdr.msg_namelen = f_addrinfo_->ai_addrlen;
+            msgs[i].msg_hdr.msg_iov = const_cast<struct iovec *>(vectors[done + i].iov);
+            msgs[i].msg_hdr.msg_iovlen = vectors[done + i].iovcnt;
+        }
+        int const r(sendmmsg(f_socket_, msgs, chunk, 0));
+        if(r < 0)
+        {
+            failed();
+            return done == 0 ? -1 : static_cast<int>(done);
+        }
+        for(int i(0); i < r; ++i)
+        {
+            this->countSent(msgs[i].msg_len);
+        }
+        done += static_cast<unsigned int>(r);
+        if(static_cast<unsigned int>(r) < chunk)
+        {
+            break;
+        }
+    }
+    return static_cast<int>(done);
+}
+
+/** \brief Receive a message (ServerRole only.)
+ *
+ * Blocks or not depending on the blocking policy. A message larger than
+ * \p max_size is truncated.
+ *
+ * \return The number of bytes read or -1 if an error occurs.
+ */
+template<typename... Policies>
+int BasicUdpSocket<Policies...>::recv(char *msg, size_t max_size)
+{
+    static_assert(Role::BIND, "BasicUdpSocket::recv() requires the ServerRole policy");
+    return received(::recv(f_socket_, msg, max_size, 0));
+}
+
+/** \brief Receive a message and its kernel receive time (ServerRole and KernelTimestamps only.)
+ *
+ * \param[in] msg  The buffer where the message is saved.
+ * \param[in] max_size  The size of \p msg.
+ * \param[out] stamp  The CLOCK_REALTIME time at which the kernel received
+ * the packet, zero if the kernel did not attach one.
+ *
+ * \return The number of bytes read or -1 if an error occurs.
+ */
+template<typename... Policies>
+int BasicUdpSocket<Policies...>::recv(char *msg, size_t max_size, struct timespec& stamp)
+{
+    static_assert(Role::BIND, "BasicUdpSocket::recv() requires the ServerRole policy");
+    static_assert(Timestamping::ENABLED, "BasicUdpSocket::recv() with a time stamp requires the KernelTimestamps policy");
+
+    struct iovec iov;
+    iov.iov_base = msg;
+    iov.iov_len = max_size;
+    union
+    {
+        char            buf[CMSG_SPACE(sizeof(struct timespec))];
+        struct cmsghdr  align;
+    } control;
+    struct msghdr hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.msg_iov = &iov;
+    hdr.msg_iovlen = 1;
+    hdr.msg_control = control.buf;
+    hdr.msg_controllen = sizeof(control.buf);
+    stamp.tv_sec = 0;
+    stamp.tv_nsec = 0;
+    int const r(recvmsg(f_socket_, &hdr, 0));
+    if(r >= 0)
+    {
+        for(struct cmsghdr *cmsg(CMSG_FIRSTHDR(&hdr)); cmsg != NULL; cmsg = CMSG_NXTHDR(&hdr, cmsg))
+        {
+            if(cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS)
+            {
+                memcpy(&stamp, CMSG_DATA(cmsg), sizeof(stamp));
+            }
+        }
+    }
+    return received(r);
+}
+
+/** \brief Receive up to \p count messages with recvmmsg() (ServerRole and Batching only.)
+ *
+ * Each entry of \p buffers receives one datagram and the matching entry
+ * of \p sizes its size. Only the messages already queued are returned:
+ * the function never waits for a batch to fill up.
+ *
+ * \return The number of messages received, or -1 if an error occurs
+ * (EAGAIN when no messages are pending.)
+ */
+template<typename... Policies>
+int BasicUdpSocket<Policies...>::recvBatch(const struct iovec *buffers, unsigned int count, size_t *sizes)
+{
+    static_assert(Role::BIND, "BasicUdpSocket::recvBatch() requires the ServerRole policy");
+    static_assert(BatchingMode::BATCH_SIZE > 0, "BasicUdpSocket::recvBatch() requires the Batching<N> policy");
+
+    struct mmsghdr msgs[BatchingMode::BATCH_SIZE];
+    unsigned int const chunk(count < BatchingMode::BATCH_SIZE ? count : BatchingMode::BATCH_SIZE);
+    memset(msgs, 0, sizeof(msgs[0]) * chunk);
+    for(unsigned int i(0); i < chunk; ++i)
+    {
+        msgs[i].msg_hdr.msg_iov = const_cast<struct iovec *>(buffers + i);
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    int const r(recvmmsg(f_socket_, msgs, chunk, MSG_DONTWAIT, NULL));
+    if(r < 0)
+    {
+        failed();
+        return -1;
+    }
+    for(int i(0); i < r; ++i)
+    {
+        sizes[i] = msgs[i].msg_len;
+        this->countReceived(msgs[i].msg_len);
+    }
+    return r;
+}
+
+/** \brief Account for the result of a send.
+ */
+template<typename... Policies>
+int BasicUdpSocket<Policies...>::sent(int r)
+{
+    if(r < 0)
+    {
+        failed();
+    }
+    else
+    {
+        this->countSent(static_cast<size_t>(r));
+    }
+    return r;
+}
+
+/** \brief Account for the result of a receive.
+ */
+template<typename... Policies>
+int BasicUdpSocket<Policies...>::received(int r)
+{
+    if(r < 0)
+    {
+        failed();
+    }
+    else
+    {
+        this->countReceived(static_cast<size_t>(r));
+    }
+    return r;
+}
+
+/** \brief Account for a failed system call.
+ *
+ * EAGAIN is the normal outcome of a non-blocking socket and is not
+ * counted as an error.
+ */
+template<typename... Policies>
+void BasicUdpSocket<Policies...>::failed()
+{
+    if(errno != EAGAIN && errno != EWOULDBLOCK)
+    {
+        this->countError();
+    }
+}
+
+} // namespace udp_client_server
+
+#endif
+// UDP_CLIENT_SERVER_BASIC_UDP_SOCKET_H
+// vim: ts=4 sw=4 et
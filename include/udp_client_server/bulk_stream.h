@@ -0,0 +1,276 @@
+// Bulk Stream -- delay-based congestion control for bulk transfers
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_BULK_STREAM_H
+#define UDP_CLIENT_SERVER_BULK_STREAM_H
+
+#include "udp_client_server.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+namespace udp_client_server
+{
+
+/** \brief Header in front of each datagram of a bulk stream, in network byte order.
+ *
+ * The send time is the sender's monotonic clock in microseconds,
+ * truncated to 32 bits. The receiver only uses it to compute one-way
+ * delays, whose constant clock offset cancels out against the base delay.
+ */
+struct BulkDataHeader
+{
+    static const uint8_t DATA = 0x81;
+    static const size_t SIZE = 12;
+
+    uint8_t             kind;
+    uint8_t             flags;
+    uint32_t            sequence;
+    uint32_t            send_time_us;
+
+    void                write(char *buffer) const;
+    bool                read(const char *buffer, size_t size);
+};
+
+
+/** \brief Feedback sent back by a BulkReceiver, in network byte order.
+ *
+ * The counters are cumulative so a lost feedback does not lose
+ * information. The delay is the smallest one-way delay measured since
+ * the previous feedback; the echo is the send time of the highest
+ * sequence and the hold time how long the receiver kept it before
+ * answering, which gives the sender its round trip time.
+ */
+struct BulkFeedback
+{
+    static const uint8_t FEEDBACK = 0x82;
+    static const size_t SIZE = 28;
+
+    uint8_t             kind;
+    uint8_t             flags;
+    uint32_t            highest_sequence;
+    uint32_t            received_packets;
+    uint32_t            received_bytes;
+    uint32_t            delay_us;
+    uint32_t            echo_us;
+    uint32_t            hold_us;
+
+    void                write(char *buffer) const;
+    bool                read(const char *buffer, size_t size);
+};
+
+
+struct LedbatParameters
+{
+                        LedbatParameters()
+                            : target_delay_ns(25000000ULL)
+                            , gain(1.0)
+                            , mss(0)
+                            , initial_cwnd(0)
+                            , min_cwnd(0)
+                            , max_cwnd(64 * 1024 * 1024)
+                            , min_rate(16 * 1024)
+                            , max_rate(0)
+                        {
+                        }
+
+    uint64_t            target_delay_ns;    // queuing delay the stream tries not to exceed
+    double              gain;               // window increase per round trip, in mss, at zero queuing delay
+    size_t              mss;                // bytes per datagram, 0 for UdpClient::maxPayload()
+    size_t              initial_cwnd;       // bytes, 0 for 4 mss
+    size_t              min_cwnd;           // bytes, 0 for 2 mss
+    size_t              max_cwnd;           // bytes
+    uint64_t            min_rate;           // bytes per second
+    uint64_t            max_rate;           // bytes per second, 0 for unlimited
+};
+
+
+/** \brief LEDBAT congestion window and pacing rate of a bulk stream.
+ *
+ * The window follows RFC 6817: it grows while the queuing delay (the
+ * one-way delay above the smallest one seen in the last ten minutes)
+ * stays below the target, in proportion to the distance to the target.
+ * Above the target it shrinks multiplicatively as in LEDBAT++, so the
+ * stream backs off within a few round trips when other traffic needs
+ * the link, and it is halved on loss. The stream starts in slow start,
+ * left at the first loss or once the delay reaches 3/4 of the target.
+ * The pacing rate is the window over the smoothed round trip time.
+ * When no feedback comes back at all the sender calls onTimeout(),
+ * which collapses the window to its minimum.
+ */
+class LedbatController
+{
+public:
+                        LedbatController(const LedbatParameters& parameters = LedbatParameters());
+
+    void                onFeedback(uint64_t now_ns, size_t acked_bytes, uint32_t lost_packets,
+                                   uint32_t delay_us, uint64_t rtt_ns, bool rate_limited);
+    void                onTimeout(uint64_t now_ns);
+
+    const LedbatParameters& getParameters() const;
+    size_t              getCwnd() const;
+    uint64_t            getRate() const;
+    uint64_t            getSrtt() const;
+    uint64_t            getQueuingDelay() const;
+    bool                inSlowStart() const;
+
+private:
+    static const size_t BASE_HISTORY = 10;
+    static const uint64_t BASE_INTERVAL_NS = 60000000000ULL;
+    static const size_t CURRENT_FILTER = 4;
+    static const uint64_t INITIAL_RTT_NS = 100000000ULL;
+
+    void                updateBaseDelay(uint64_t now_ns, uint32_t delay_us);
+    void                updateCurrentDelay(uint32_t delay_us);
+    void                updateRate();
+
+    LedbatParameters    f_parameters_;
+    double              f_cwnd_;
+    uint64_t            f_rate_;
+    uint64_t            f_srtt_ns_;
+    uint64_t            f_queuing_delay_ns_;
+    bool                f_slow_start_;
+    uint64_t            f_last_loss_ns_;
+    uint32_t            f_base_history_[BASE_HISTORY];
+    size_t              f_base_count_;
+    uint64_t            f_base_started_ns_;
+    uint32_t            f_current_filter_[CURRENT_FILTER];
+    size_t              f_current_count_;
+};
+
+
+/** \brief Sends a bulk stream paced by a LedbatController.
+ *
+ * Each datagram gets a BulkDataHeader; the feedback of the BulkReceiver
+ * comes back on the same socket and is read by poll(), which updates
+ * the controller and so the pacing rate. send() refuses datagrams sent
+ * ahead of the pacing schedule, or while a full window is in flight,
+ * with EAGAIN; nextSendTime() tells when the pacing allows the next one.
+ *
+ * When no feedback arrives for NO_FEEDBACK_RTTS smoothed round trips
+ * while data is in flight, the feedback path is assumed lost: the
+ * window collapses to its minimum and the data in flight is forgotten,
+ * so a probe datagram can go out. The timeout doubles at each
+ * consecutive expiry, up to 64 times, until a feedback arrives.
+ *
+ * Not thread safe; meant to be used by the thread owning the client.
+ */
+class BulkSender
+{
+public:
+                        BulkSender(UdpClient& client, const LedbatParameters& parameters = LedbatParameters());
+
+    int                 send(const char *msg, size_t size, uint64_t now_ns);
+    uint64_t            nextSendTime() const;
+    size_t              getFlightSize() const;
+    int                 poll(uint64_t now_ns, size_t max_feedbacks = 64);
+
+    const LedbatController& getController() const;
+    uint64_t            getSentCount() const;
+    uint64_t            getLostCount() const;
+    uint64_t            getFeedbackCount() const;
+    uint64_t            getTimeoutCount() const;
+
+private:
+    static const uint64_t BURST_NS = 1000000ULL;
+    static const uint64_t NO_FEEDBACK_RTTS = 4;
+    static const size_t MAX_BACKOFF = 6;
+
+    void                onFeedback(const BulkFeedback& feedback, uint64_t now_ns);
+    void                checkTimeout(uint64_t now_ns);
+
+    UdpClient&          f_client_;
+    LedbatController    f_controller_;
+    uint32_t            f_next_sequence_;
+    uint32_t            f_highest_acked_;
+    uint64_t            f_sent_bytes_;
+    uint64_t            f_next_send_ns_;
+    uint64_t            f_last_progress_ns_;
+    size_t              f_backoff_;
+    bool                f_rate_limited_;
+    bool                f_has_feedback_;
+    uint32_t            f_received_packets_;
+    uint32_t            f_received_bytes_;
+    uint32_t            f_lost_packets_;
+    uint64_t            f_sent_;
+    uint64_t            f_lost_;
+    uint64_t            f_feedbacks_;
+    uint64_t            f_timeouts_;
+    char                f_header_[BulkDataHeader::SIZE];
+    char                f_buffer_[BulkFeedback::SIZE];
+};
+
+
+/** \brief Receives a bulk stream and sends the feedback driving its sender.
+ *
+ * The receiver follows one stream at a time: a datagram from another
+ * source restarts the counters. Feedback is sent at most once per
+ * feedback interval, and only when new data arrived.
+ *
+ * The constructor turns on SO_TIMESTAMPNS on the server socket so the
+ * one-way delays use the kernel arrival time of each datagram rather
+ * than the time poll() got to it.
+ *
+ * Not thread safe; meant to be used by the thread owning the server.
+ */
+class BulkReceiver
+{
+public:
+    typedef void        (*Callback)(void *user, const char *data, size_t size);
+
+                        BulkReceiver(UdpServer& server, uint64_t feedback_interval_ns = 10000000ULL,
+                                     size_t max_size = 65507);
+
+    void                setCallback(Callback callback, void *user);
+    int                 poll(uint64_t now_ns, size_t max_datagrams = 256);
+
+    uint64_t            getReceivedCount() const;
+    uint64_t            getLostCount() const;
+    uint64_t            getInvalidCount() const;
+    uint64_t            getFeedbackCount() const;
+
+private:
+    void                restart(const struct sockaddr_storage& source, socklen_t source_len, uint32_t sequence);
+    void                sendFeedback(uint64_t now_ns);
+
+    UdpServer&          f_server_;
+    uint64_t            f_feedback_interval_ns_;
+    Callback            f_callback_;
+    void *              f_user_;
+    std::vector<char>   f_buffer_;
+    struct sockaddr_storage f_source_;
+    socklen_t           f_source_len_;
+    bool                f_started_;
+    bool                f_pending_;
+    uint32_t            f_first_sequence_;
+    uint32_t            f_highest_sequence_;
+    uint32_t            f_highest_send_time_us_;
+    uint64_t            f_highest_arrival_ns_;
+    uint32_t            f_received_packets_;
+    uint32_t            f_received_bytes_;
+    uint32_t            f_min_delay_us_;
+    uint64_t            f_last_feedback_ns_;
+    uint64_t            f_received_;
+    uint64_t            f_invalid_;
+    uint64_t            f_feedbacks_;
+};
+
+} // namespace udp_client_server
+
+#endif
+// UDP_CLIENT_SERVER_BULK_STREAM_H
+// vim: ts=4 sw=4 et
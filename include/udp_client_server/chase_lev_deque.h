@@ -0,0 +1,186 @@
+// Chase-Lev Deque -- work-stealing deque of a single owner and many thieves
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_CHASE_LEV_DEQUE_H
+#define UDP_CLIENT_SERVER_CHASE_LEV_DEQUE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <vector>
+
+namespace udp_client_server
+{
+
+/** \brief Work-stealing deque of Chase and Lev.
+ *
+ * The memory orderings are the ones Lê, Pop, Cohen and Zappa Nardelli
+ * proved correct for the C11 memory model. The owner thread pushes and
+ * pops at the bottom, last in first out, so it keeps working on what is
+ * hot in its cache. Other threads steal from the top, first in first
+ * out, taking the oldest work. Only the last item needs a
+ * compare-and-swap between the owner and the thieves.
+ *
+ * The capacity is fixed (rounded up to a power of two) and push() fails
+ * when the deque is full. \p T must be small and trivially copyable
+ * (typically a pointer) since items are read and written atomically.
+ */
+template<typename T>
+class ChaseLevDeque
+{
+public:
+                        ChaseLevDeque(size_t capacity);
+
+    bool                push(T item);
+    bool                pop(T& item);
+    bool                steal(T& item);
+
+    size_t              capacity() const;
+    size_t              sizeApprox() const;
+
+private:
+    static const size_t CACHE_LINE_SIZE = 64;
+
+                        ChaseLevDeque(const ChaseLevDeque&);
+    ChaseLevDeque&      operator = (const ChaseLevDeque&);
+
+    static size_t       roundCapacity(size_t capacity);
+
+    std::vector<std::atomic<T> > f_items_;
+    int64_t             f_mask_;
+    char                f_pad0_[CACHE_LINE_SIZE];
+    std::atomic<int64_t> f_top_;
+    char                f_pad1_[CACHE_LINE_SIZE - sizeof(std::atomic<int64_t>)];
+    std::atomic<int64_t> f_bottom_;
+    char                f_pad2_[CACHE_LINE_SIZE - sizeof(std::atomic<int64_t>)];
+};
+
+template<typename T>
+const size_t ChaseLevDeque<T>::CACHE_LINE_SIZE;
+
+
+/** \brief Allocate a deque of at least \p capacity items.
+ */
+template<typename T>
+ChaseLevDeque<T>::ChaseLevDeque(size_t capacity)
+    : f_items_(roundCapacity(capacity))
+    , f_mask_(static_cast<int64_t>(f_items_.size()) - 1)
+    , f_top_(0)
+    , f_bottom_(0)
+{
+}
+
+/** \brief Round \p capacity up to a power of two, at least 2.
+ */
+template<typename T>
+size_t ChaseLevDeque<T>::roundCapacity(size_t capacity)
+{
+    size_t size(2);
+    while(size < capacity)
+    {
+        size <<= 1;
+    }
+    return size;
+}
+
+/** \brief Add \p item at the bottom; owner thread only.
+ *
+ * \return false if the deque is full.
+ */
+template<typename T>
+bool ChaseLevDeque<T>::push(T item)
+{
+    int64_t const b(f_bottom_.load(std::memory_order_relaxed));
+    int64_t const t(f_top_.load(std::memory_order_acquire));
+    if(b - t > f_mask_)
+    {
+        return false;
+    }
+    f_items_[b & f_mask_].store(item, std::memory_order_relaxed);
+    f_bottom_.store(b + 1, std::memory_order_release);
+    return true;
+}
+
+/** \brief Take the item at the bottom; owner thread only.
+ *
+ * \return false if the deque is empty or a thief took the last item.
+ */
+template<typename T>
+bool ChaseLevDeque<T>::pop(T& item)
+{
+    int64_t const b(f_bottom_.load(std::memory_order_relaxed) - 1);
+    f_bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t(f_top_.load(std::memory_order_relaxed));
+    if(t > b)
+    {
+        f_bottom_.store(b + 1, std::memory_order_relaxed);
+        return false;
+    }
+    item = f_items_[b & f_mask_].load(std::memory_order_relaxed);
+    if(t == b)
+    {
+        // last item: race the thieves for it
+        bool const won(f_top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed));
+        f_bottom_.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+/** \brief Take the item at the top; any thread.
+ *
+ * \return false if the deque is empty or another thread took the item
+ * first.
+ */
+template<typename T>
+bool ChaseLevDeque<T>::steal(T& item)
+{
+    int64_t t(f_top_.load(std::memory_order_acquire));
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t const b(f_bottom_.load(std::memory_order_acquire));
+    if(t >= b)
+    {
+        return false;
+    }
+    item = f_items_[t & f_mask_].load(std::memory_order_relaxed);
+    return f_top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+}
+
+/** \brief Maximum number of items in the deque.
+ */
+template<typename T>
+size_t ChaseLevDeque<T>::capacity() const
+{
+    return static_cast<size_t>(f_mask_ + 1);
+}
+
+/** \brief Number of items in the deque, possibly already outdated.
+ */
+template<typename T>
+size_t ChaseLevDeque<T>::sizeApprox() const
+{
+    int64_t const b(f_bottom_.load(std::memory_order_relaxed));
+    int64_t const t(f_top_.load(std::memory_order_relaxed));
+    return b > t ? static_cast<size_t>(b - t) : 0;
+}
+
+} // namespace udp_client_server
+
+#endif
+// UDP_CLIENT_SERVER_CHASE_LEV_DEQUE_H
+// vim: ts=4 sw=4 et
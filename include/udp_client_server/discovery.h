@@ -0,0 +1,126 @@
+// Discovery -- find named UDP endpoints with broadcast or multicast beacons
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_DISCOVERY_H
+#define UDP_CLIENT_SERVER_DISCOVERY_H
+
+#include "udp_client_server.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace udp_client_server
+{
+
+/** \brief An endpoint advertised by a peer.
+ *
+ * The address is the source address of the beacon with the advertised
+ * port, ready to be given to UdpClient::setDestination().
+ */
+struct DiscoveredEndpoint
+{
+    std::string         name;
+    struct sockaddr_storage addr;
+    socklen_t           addrlen;
+    uint32_t            node_id;
+    uint64_t            last_seen_ns;
+};
+
+enum DiscoveryEvent
+{
+    DISCOVERY_FOUND,            // a new endpoint appeared
+    DISCOVERY_MOVED,            // an endpoint changed address or restarted
+    DISCOVERY_LOST              // an endpoint stopped sending beacons
+};
+
+
+/** \brief Advertise local endpoints and discover the ones of the peers.
+ *
+ * Each node periodically sends a small beacon listing its endpoints
+ * (name and port) to a broadcast address or a multicast group, and
+ * listens for the beacons of the others on the same port. Endpoints not
+ * heard of for a few beacon intervals are forgotten.
+ *
+ * \code
+ *   UdpServer beacons("0.0.0.0", 7400);
+ *   Discovery discovery(beacons, "239.255.74.0", 7400);
+ *   discovery.advertise("robot3/cmd", 7000);
+ *   ...
+ *   discovery.poll(monotonicNowNs());
+ *   DiscoveredEndpoint robot;
+ *   if(discovery.find("robot3/cmd", robot))
+ *   {
+ *       client.setDestination(reinterpret_cast<struct sockaddr *>(&robot.addr), robot.addrlen);
+ *   }
+ * \endcode
+ *
+ * Endpoints are kept in a plain vector: discovery is meant for tens of
+ * endpoints, not thousands. Not thread safe.
+ */
+class Discovery
+{
+public:
+    typedef void        (*Listener)(void *user, DiscoveryEvent event, const DiscoveredEndpoint& endpoint);
+
+    static const size_t MAX_BEACON_SIZE = 1400;
+
+                        Discovery(UdpServer& server, const std::string& beacon_addr, int beacon_port);
+
+    void                setInterval(uint64_t interval_ns);
+    void                setListener(Listener listener, void *user);
+
+    int                 advertise(const std::string& name, int port);
+    bool                withdraw(const std::string& name);
+
+    int                 poll(uint64_t now_ns, size_t max_beacons = 64);
+
+    bool                find(const std::string& name, DiscoveredEndpoint& endpoint) const;
+    std::vector<DiscoveredEndpoint> findAll(const std::string& name) const;
+    const std::vector<DiscoveredEndpoint>& getEndpoints() const;
+    uint32_t            getNodeId() const;
+
+private:
+    struct Advertised
+    {
+        std::string     name;
+        uint16_t        port;
+    };
+
+    int                 sendBeacon();
+    void                receiveBeacon(const char *beacon, size_t size,
+                                      const struct sockaddr_storage& from, socklen_t from_len, uint64_t now_ns);
+    void                notify(DiscoveryEvent event, const DiscoveredEndpoint& endpoint);
+
+    UdpServer&          f_server_;
+    struct sockaddr_storage f_beacon_addr_;
+    socklen_t           f_beacon_addr_len_;
+    uint32_t            f_node_id_;
+    uint64_t            f_interval_ns_;
+    uint64_t            f_last_beacon_ns_;
+    bool                f_beacon_sent_;
+    Listener            f_listener_;
+    void *              f_listener_user_;
+    std::vector<Advertised> f_advertised_;
+    std::vector<DiscoveredEndpoint> f_endpoints_;
+    std::vector<char>   f_buffer_;
+};
+
+} // namespace udp_client_server
+
+#endif
+// UDP_CLIENT_SERVER_DISCOVERY_H
+// vim: ts=4 sw=4 et
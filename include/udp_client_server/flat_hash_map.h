@@ -0,0 +1,438 @@
+// Flat Hash Map -- fixed capacity open-addressing hash map
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_FLAT_HASH_MAP_H
+#define UDP_CLIENT_SERVER_FLAT_HASH_MAP_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <utility>
+#include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace udp_client_server
+{
+
+/** \brief Open-addressing hash map with a capacity fixed at construction.
+ *
+ * The layout follows the "Swiss table" design: each slot has a one byte
+ * control word holding either a state (empty, deleted) or 7 bits of the
+ * hash of its key. Slots are probed 16 at a time, comparing the control
+ * bytes of a whole group with a single SSE2 instruction when available,
+ * so a lookup usually touches one cache line of control bytes and one
+ * slot.
+ *
+ * All the memory is allocated by the constructor. The map never grows:
+ * insert() fails once the map holds its capacity, so lookups and inserts
+ * never allocate.
+ *
+ * Erasing may leave tombstones, which lookups have to probe past. Once
+ * they fill one eighth of the slots, erase() and eraseIf() rehash the
+ * table in place, so a map with constant churn (peers coming and going)
+ * keeps short probe sequences.
+ *
+ * \p Hash must return a well mixed 64 bit value; the top 57 bits select
+ * the group and the low 7 bits are stored in the control byte.
+ */
+template<typename Key, typename Value, typename Hash>
+class FlatHashMap
+{
+public:
+    static const size_t GROUP_SIZE = 16;
+
+                        FlatHashMap(size_t capacity);
+
+    Value *             find(const Key& key);
+    const Value *       find(const Key& key) const;
+    Value *             insert(const Key& key, bool *inserted = NULL);
+    bool                erase(const Key& key);
+    void                clear();
+
+    size_t              size() const;
+    size_t              capacity() const;
+    size_t              tombstones() const;
+
+    template<typename F>
+    void                forEach(F f);
+
+    template<typename P>
+    size_t              eraseIf(P predicate);
+
+private:
+    static const uint8_t EMPTY = 0x80;
+    static const uint8_t DELETED = 0xFE;
+
+    struct Slot
+    {
+        Key             key;
+        Value           value;
+    };
+
+    uint32_t            matchByte(size_t group, uint8_t byte) const;
+    size_t              findIndex(const Key& key, uint64_t hash) const;
+    size_t              findFree(uint64_t hash) const;
+    void                eraseIndex(size_t index);
+    void                reclaimTombstones();
+    void                rehashInPlace();
+
+    size_t              f_group_mask_;
+    size_t              f_max_size_;
+    size_t              f_size_;
+    size_t              f_deleted_;
+    std::vector<uint8_t> f_ctrl_;
+    std::vector<Slot>   f_slots_;
+    Hash                f_hash_;
+};
+
+template<typename Key, typename Value, typename Hash>
+const size_t FlatHashMap<Key, Value, Hash>::GROUP_SIZE;
+
+template<typename Key, typename Value, typename Hash>
+const uint8_t FlatHashMap<Key, Value, Hash>::EMPTY;
+
+template<typename Key, typename Value, typename Hash>
+const uint8_t FlatHashMap<Key, Value, Hash>::DELETED;
+
+
+/** \brief Allocate a map able to hold \p capacity entries.
+ *
+ * The number of slots is the next power of two leaving at least one
+ * eighth of the slots empty, which keeps probe sequences short.
+ *
+ * \param[in] capacity  The maximum number of entries.
+ */
+template<typename Key, typename Value, typename Hash>
+FlatHashMap<Key, Value, Hash>::FlatHashMap(size_t capacity)
+    : f_group_mask_(0)
+    , f_max_size_(capacity)
+    , f_size_(0)
+    , f_deleted_(0)
+{
+    size_t slots(GROUP_SIZE);
+    while(slots - slots / 8 < capacity)
+    {
+        slots <<= 1;
+    }
+    f_group_mask_ = slots / GROUP_SIZE - 1;
+    f_ctrl_.assign(slots, EMPTY);
+    f_slots_.resize(slots);
+}
+
+/** \brief Look for \p key.
+ *
+ * \return A pointer to the value of \p key or NULL if not present.
+ */
+template<typename Key, typename Value, typename Hash>
+Value *FlatHashMap<Key, Value, Hash>::find(const Key& key)
+{
+    size_t const index(findIndex(key, f_hash_(key)));
+    return index == static_cast<size_t>(-1) ? NULL : &f_slots_[index].value;
+}
+
+template<typename Key, typename Value, typename Hash>
+const Value *FlatHashMap<Key, Value, Hash>::find(const Key& key) const
+{
+    size_t const index(findIndex(key, f_hash_(key)));
+    return index == static_cast<size_t>(-1) ? NULL : &f_slots_[index].value;
+}
+
+/** \brief Find \p key, adding it with a default value if not present.
+ *
+ * \param[in] key  The key to look for.
+ * \param[out] inserted  If not NULL, set to true when the key was added.
+ *
+ * \return A pointer to the value of \p key, or NULL if the key was not
+ * present and the map is full.
+ */
+template<typename Key, typename Value, typename Hash>
+Value *FlatHashMap<Key, Value, Hash>::insert(const Key& key, bool *inserted)
+{
+    if(inserted != NULL)
+    {
+        *inserted = false;
+    }
+    uint64_t const hash(f_hash_(key));
+    size_t const found(findIndex(key, hash));
+    if(found != static_cast<size_t>(-1))
+    {
+        return &f_slots_[found].value;
+    }
+    if(f_size_ >= f_max_size_)
+    {
+        return NULL;
+    }
+
+    // the key is not present, use the first empty or deleted slot of
+    // its probe sequence
+    size_t const index(findFree(hash));
+    if(f_ctrl_[index] == DELETED)
+    {
+        --f_deleted_;
+    }
+    f_ctrl_[index] = static_cast<uint8_t>(hash & 0x7F);
+    f_slots_[index].key = key;
+    f_slots_[index].value = Value();
+    ++f_size_;
+    if(inserted != NULL)
+    {
+        *inserted = true;
+    }
+    return &f_slots_[index].value;
+}
+
+/** \brief Remove \p key from the map.
+ *
+ * \return false if \p key was not present.
+ */
+template<typename Key, typename Value, typename Hash>
+bool FlatHashMap<Key, Value, Hash>::erase(const Key& key)
+{
+    size_t const index(findIndex(key, f_hash_(key)));
+    if(index == static_cast<size_t>(-1))
+    {
+        return false;
+    }
+    eraseIndex(index);
+    reclaimTombstones();
+    return true;
+}
+
+/** \brief Remove all the entries.
+ */
+template<typename Key, typename Value, typename Hash>
+void FlatHashMap<Key, Value, Hash>::clear()
+{
+    f_ctrl_.assign(f_ctrl_.size(), EMPTY);
+    f_size_ = 0;
+    f_deleted_ = 0;
+}
+
+/** \brief Number of entries in the map.
+ */
+template<typename Key, typename Value, typename Hash>
+size_t FlatHashMap<Key, Value, Hash>::size() const
+{
+    return f_size_;
+}
+
+/** \brief Maximum number of entries of the map.
+ */
+template<typename Key, typename Value, typename Hash>
+size_t FlatHashMap<Key, Value, Hash>::capacity() const
+{
+    return f_max_size_;
+}
+
+/** \brief Number of slots holding a tombstone.
+ */
+template<typename Key, typename Value, typename Hash>
+size_t FlatHashMap<Key, Value, Hash>::tombstones() const
+{
+    return f_deleted_;
+}
+
+/** \brief Call \p f with the key and value of each entry.
+ *
+ * \p f must not insert nor erase entries.
+ */
+template<typename Key, typename Value, typename Hash>
+template<typename F>
+void FlatHashMap<Key, Value, Hash>::forEach(F f)
+{
+    for(size_t i(0); i < f_ctrl_.size(); ++i)
+    {
+        if((f_ctrl_[i] & 0x80) == 0)
+        {
+            f(static_cast<const Key&>(f_slots_[i].key), f_slots_[i].value);
+        }
+    }
+}
+
+/** \brief Erase all the entries for which \p predicate returns true.
+ *
+ * \return The number of entries erased.
+ */
+template<typename Key, typename Value, typename Hash>
+template<typename P>
+size_t FlatHashMap<Key, Value, Hash>::eraseIf(P predicate)
+{
+    size_t erased(0);
+    for(size_t i(0); i < f_ctrl_.size(); ++i)
+    {
+        if((f_ctrl_[i] & 0x80) == 0
+        && predicate(static_cast<const Key&>(f_slots_[i].key), f_slots_[i].value))
+        {
+            eraseIndex(i);
+            ++erased;
+        }
+    }
+    reclaimTombstones();
+    return erased;
+}
+
+/** \brief Return a bit mask of the control bytes of \p group equal to \p byte.
+ */
+template<typename Key, typename Value, typename Hash>
+inline uint32_t FlatHashMap<Key, Value, Hash>::matchByte(size_t group, uint8_t byte) const
+{
+    const uint8_t *ctrl(&f_ctrl_[group * GROUP_SIZE]);
+#ifdef __SSE2__
+    __m128i const bytes(_mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl)));
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(static_cast<char>(byte)))));
+#else
+    uint32_t mask(0);
+    for(size_t i(0); i < GROUP_SIZE; ++i)
+    {
+        mask |= static_cast<uint32_t>(ctrl[i] == byte) << i;
+    }
+    return mask;
+#endif
+}
+
+template<typename Key, typename Value, typename Hash>
+inline size_t FlatHashMap<Key, Value, Hash>::findIndex(const Key& key, uint64_t hash) const
+{
+    uint8_t const h2(static_cast<uint8_t>(hash & 0x7F));
+    size_t group((hash >> 7) & f_group_mask_);
+    for(size_t step(1); step <= f_group_mask_ + 1; ++step)
+    {
+        uint32_t candidates(matchByte(group, h2));
+        while(candidates != 0)
+        {
+            size_t const index(group * GROUP_SIZE + __builtin_ctz(candidates));
+            if(f_slots_[index].key == key)
+            {
+                return index;
+            }
+            candidates &= candidates - 1;
+        }
+        if(matchByte(group, EMPTY) != 0)
+        {
+            break;
+        }
+        group = (group + step) & f_group_mask_;
+    }
+    return static_cast<size_t>(-1);
+}
+
+/** \brief Index of the first empty or deleted slot in the probe sequence of \p hash.
+ *
+ * The map always keeps free slots, so this terminates.
+ */
+template<typename Key, typename Value, typename Hash>
+inline size_t FlatHashMap<Key, Value, Hash>::findFree(uint64_t hash) const
+{
+    size_t group((hash >> 7) & f_group_mask_);
+    for(size_t step(1);; ++step)
+    {
+        uint32_t const free_slots(matchByte(group, EMPTY) | matchByte(group, DELETED));
+        if(free_slots != 0)
+        {
+            return group * GROUP_SIZE + __builtin_ctz(free_slots);
+        }
+        group = (group + step) & f_group_mask_;
+    }
+}
+
+/** \brief Free slot \p index.
+ *
+ * Lookups stop at the first group with an empty slot. If the group of
+ * \p index already has one, no probe sequence goes through this group
+ * and the slot can be made empty; otherwise it becomes a tombstone.
+ */
+template<typename Key, typename Value, typename Hash>
+void FlatHashMap<Key, Value, Hash>::eraseIndex(size_t index)
+{
+    size_t const group(index / GROUP_SIZE);
+    if(matchByte(group, EMPTY) != 0)
+    {
+        f_ctrl_[index] = EMPTY;
+    }
+    else
+    {
+        f_ctrl_[index] = DELETED;
+        ++f_deleted_;
+    }
+    --f_size_;
+}
+
+/** \brief Rehash the table once tombstones fill one eighth of the slots.
+ *
+ * Each rehash costs one pass over the slots and clears all the
+ * tombstones, so the cost per erase stays constant.
+ */
+template<typename Key, typename Value, typename Hash>
+void FlatHashMap<Key, Value, Hash>::reclaimTombstones()
+{
+    if(f_deleted_ >= f_ctrl_.size() / 8)
+    {
+        rehashInPlace();
+    }
+}
+
+/** \brief Drop all the tombstones without allocating.
+ *
+ * Tombstones become empty slots and live entries are marked DELETED,
+ * meaning "not placed yet". Each unplaced entry then goes to the first
+ * free slot of its probe sequence: it stays where it is if that slot is
+ * in its own group, moves if that slot is empty, and is swapped with
+ * the other unplaced entry there otherwise, which is then placed in turn.
+ */
+template<typename Key, typename Value, typename Hash>
+void FlatHashMap<Key, Value, Hash>::rehashInPlace()
+{
+    for(size_t i(0); i < f_ctrl_.size(); ++i)
+    {
+        f_ctrl_[i] = (f_ctrl_[i] & 0x80) == 0 ? DELETED : EMPTY;
+    }
+    for(size_t i(0); i < f_ctrl_.size(); ++i)
+    {
+        if(f_ctrl_[i] != DELETED)
+        {
+            continue;
+        }
+        uint64_t const hash(f_hash_(f_slots_[i].key));
+        uint8_t const h2(static_cast<uint8_t>(hash & 0x7F));
+        size_t const target(findFree(hash));
+        if(target / GROUP_SIZE == i / GROUP_SIZE)
+        {
+            f_ctrl_[i] = h2;
+        }
+        else if(f_ctrl_[target] == EMPTY)
+        {
+            f_slots_[target] = f_slots_[i];
+            f_ctrl_[target] = h2;
+            f_ctrl_[i] = EMPTY;
+        }
+        else
+        {
+            std::swap(f_slots_[target], f_slots_[i]);
+            f_ctrl_[target] = h2;
+            --i;
+        }
+    }
+    f_deleted_ = 0;
+}
+
+} // namespace udp_client_server
+
+#endif
+// UDP_CLIENT_SERVER_FLAT_HASH_MAP_H
+// vim: ts=4 sw=4 et
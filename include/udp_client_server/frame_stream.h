@@ -0,0 +1,193 @@
+// Frame Stream -- large frames sent in chunks and reassembled in place
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_FRAME_STREAM_H
+#define UDP_CLIENT_SERVER_FRAME_STREAM_H
+
+#include "udp_client_server.h"
+#include <stdint.h>
+#include <vector>
+
+namespace udp_client_server
+{
+
+/** \brief Header in front of each chunk of a frame, in network byte order.
+ *
+ * All the chunks of a frame have \p chunk_size bytes of payload except
+ * the last one, so the offset gives the chunk index.
+ */
+struct FrameChunkHeader
+{
+    static const uint8_t CHUNK = 0x71;
+    static const size_t SIZE = 16;
+
+    uint8_t             kind;
+    uint8_t             flags;
+    uint16_t            chunk_size;
+    uint32_t            frame_id;
+    uint32_t            frame_size;
+    uint32_t            offset;
+
+    void                write(char *buffer) const;
+    bool                read(const char *buffer, size_t size);
+};
+
+
+/** \brief A reassembled frame, complete or not.
+ *
+ * The data lives in a slot of the receiver and is only valid during the
+ * delivery callback. In a partial frame, the bytes of the missing chunks
+ * are undefined; use hasChunk() to know which ones arrived.
+ */
+struct FrameView
+{
+    uint32_t            frame_id;
+    const char *        data;
+    size_t              size;
+    bool                complete;
+    size_t              received_bytes;
+    size_t              chunk_size;
+    size_t              chunk_count;
+    size_t              received_chunks;
+    const uint64_t *    bitmap;
+    uint64_t            first_arrival_ns;
+
+    bool                hasChunk(size_t index) const;
+};
+
+
+/** \brief Sends frames as sequences of chunks.
+ *
+ * The chunks are gathered from the frame buffer with sendBatchv(), each
+ * datagram being a small header followed by a slice of the frame, so the
+ * frame is never copied.
+ */
+class FrameSender
+{
+public:
+                        FrameSender(UdpClient& client, size_t chunk_size = 0);
+
+    int64_t             sendFrame(const char *frame, size_t size);
+
+    size_t              getChunkSize() const;
+    uint32_t            getNextFrameId() const;
+
+private:
+    static const size_t BATCH_SIZE = 64;
+
+    UdpClient&          f_client_;
+    size_t              f_chunk_size_;
+    uint32_t            f_next_frame_id_;
+    std::vector<char>   f_headers_;
+    std::vector<struct iovec> f_iov_;
+    std::vector<UdpSendVector> f_vectors_;
+};
+
+
+/** \brief Reassembles the frames of a FrameSender into preallocated slots.
+ *
+ * Each datagram is received with recvv() straight into its place in a
+ * frame slot: the header goes to a small buffer and the payload to the
+ * position the receiver predicts for it, the slot and offset following
+ * the previous chunk (or offset 0 of the slot reserved for the next new
+ * frame). When the prediction is wrong, i.e. after a loss or reordering,
+ * the payload is moved to its real place; with in-order traffic chunks
+ * are never copied. A predicted place holding a chunk already received
+ * is never used; the payload then goes to the overflow buffer.
+ *
+ * A bitmap per slot records the chunks received. A frame is delivered
+ * as soon as it is complete, or when its deadline (counted from its
+ * first chunk) expires, as a partial frame if partial delivery is on.
+ * Frames are dropped (and counted) when all the slots are busy and a new
+ * frame starts; the oldest frame is given up to make room.
+ *
+ * Not thread safe; meant to be used by the thread owning the socket.
+ */
+class FrameReceiver
+{
+public:
+    typedef void        (*Callback)(void *user, const FrameView& frame);
+
+                        FrameReceiver(UdpServer& server, size_t max_frame_size,
+                                      size_t slot_count = 4, size_t max_chunk_size = 65507);
+
+    void                setCallback(Callback callback, void *user);
+    void                setDeadline(uint64_t deadline_ns);
+    void                setPartialDelivery(bool partial);
+
+    int                 poll(uint64_t now_ns, size_t max_datagrams = 256);
+
+    uint64_t            getCompleteCount() const;
+    uint64_t            getPartialCount() const;
+    uint64_t            getDroppedCount() const;
+    uint64_t            getLateChunkCount() const;
+    uint64_t            getInvalidCount() const;
+    uint64_t            getCopiedChunkCount() const;
+
+private:
+    static const size_t RECENT_FRAMES = 16;
+
+    struct Slot
+    {
+        bool            busy;
+        uint32_t        frame_id;
+        size_t          frame_size;
+        size_t          chunk_size;
+        size_t          chunk_count;
+        size_t          received_chunks;
+        size_t          received_bytes;
+        uint64_t        first_arrival_ns;
+        std::vector<char> data;
+        std::vector<uint64_t> bitmap;
+    };
+
+    Slot *              findSlot(uint32_t frame_id);
+    Slot *              reserveSlot();
+    bool                isRecent(uint32_t frame_id) const;
+    bool                hasChunk(const Slot& slot, size_t offset) const;
+    void                deliver(Slot& slot);
+    void                release(Slot& slot);
+    void                predict(Slot *slot, size_t offset);
+    void                store(const FrameChunkHeader& header, const char *payload, size_t size, uint64_t now_ns);
+
+    UdpServer&          f_server_;
+    size_t              f_max_frame_size_;
+    Callback            f_callback_;
+    void *              f_user_;
+    uint64_t            f_deadline_ns_;
+    bool                f_partial_;
+    std::vector<Slot>   f_slots_;
+    Slot *              f_predicted_slot_;
+    size_t              f_predicted_offset_;
+    char                f_header_[FrameChunkHeader::SIZE];
+    std::vector<char>   f_overflow_;
+    uint32_t            f_recent_[RECENT_FRAMES];
+    size_t              f_recent_count_;
+    size_t              f_recent_next_;
+    uint64_t            f_complete_;
+    uint64_t            f_partial_count_;
+    uint64_t            f_dropped_;
+    uint64_t            f_late_;
+    uint64_t            f_invalid_;
+    uint64_t            f_copied_;
+};
+
+} // namespace udp_client_server
+
+#endif
+// UDP_CLIENT_SERVER_FRAME_STREAM_H
+// vim: ts=4 sw=4 et
@@ -0,0 +1,109 @@
+// Impaired Socket -- inject loss, delay, duplication and reordering on real sockets
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_IMPAIRED_SOCKET_H
+#define UDP_CLIENT_SERVER_IMPAIRED_SOCKET_H
+
+#include "udp_client_server.h"
+#include "network_impairment.h"
+#include "timer_wheel.h"
+#include <deque>
+#include <mutex>
+#include <string>
+
+namespace udp_client_server
+{
+
+class PacketImpairer
+{
+public:
+    struct Stats
+    {
+                        Stats() : submitted(0), lost(0), duplicated(0), released(0) {}
+
+        uint64_t        submitted;
+        uint64_t        lost;
+        uint64_t        duplicated;
+        uint64_t        released;
+    };
+
+                        PacketImpairer(uint64_t seed = 1);
+
+    void                setImpairment(const NetworkImpairment& impairment);
+    NetworkImpairment   getImpairment() const;
+    Stats               getStats() const;
+
+    void                submit(uint64_t now_ns, const char *msg, size_t size);
+    bool                release(uint64_t now_ns, std::string& msg);
+    size_t              pending() const;
+
+    static uint64_t     now();
+
+private:
+    mutable std::mutex  f_mutex_;
+    NetworkImpairment   f_impairment_;
+    ImpairmentModel     f_model_;
+    uint64_t            f_busy_until_;
+    Stats               f_stats_;
+    TimerWheel<std::string> f_wheel_;
+    std::deque<std::string> f_ready_;
+};
+
+
+class ImpairedUdpClient
+{
+public:
+                        ImpairedUdpClient(UdpClient& client, uint64_t seed = 1);
+
+    UdpClient&          getClient() const;
+    PacketImpairer&     getImpairer();
+    void                setImpairment(const NetworkImpairment& impairment);
+
+    int                 send(const char *msg, size_t size);
+    int                 sendv(const struct iovec *iov, size_t iovcnt);
+    int                 poll();
+
+private:
+    UdpClient&          f_client_;
+    PacketImpairer      f_impairer_;
+    std::string         f_message_;
+};
+
+
+class ImpairedUdpServer
+{
+public:
+                        ImpairedUdpServer(UdpServer& server, uint64_t seed = 1);
+
+    UdpServer&          getServer() const;
+    PacketImpairer&     getImpairer();
+    void                setImpairment(const NetworkImpairment& impairment);
+
+    int                 recv(char *msg, size_t max_size, size_t max_packets = 64);
+
+private:
+    UdpServer&          f_server_;
+    PacketImpairer      f_impairer_;
+    std::string         f_buffer_;
+    std::string         f_message_;
+};
+
+} // namespace udp_client_server
+
+#endif
+// UDP_CLIENT_SERVER_IMPAIRED_SOCKET_H
+// vim: ts=4 sw=4 et
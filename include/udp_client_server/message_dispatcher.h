@@ -0,0 +1,274 @@
+// Message Dispatcher -- route UDP payloads to handlers by message ID
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_MESSAGE_DISPATCHER_H
+#define UDP_CLIENT_SERVER_MESSAGE_DISPATCHER_H
+
+#include "udp_client_server.h"
+#include <stdint.h>
+#include <string.h>
+
+namespace udp_client_server
+{
+
+namespace detail
+{
+
+template<uint8_t Id, typename... Handlers>
+struct MessageIdUnused;
+
+template<uint8_t Id>
+struct MessageIdUnused<Id>
+{
+    static constexpr bool value = true;
+};
+
+template<uint8_t Id, typename Head, typename... Tail>
+struct MessageIdUnused<Id, Head, Tail...>
+{
+    static constexpr bool value = static_cast<uint8_t>(Head::ID) != Id && MessageIdUnused<Id, Tail...>::value;
+};
+
+template<typename... Handlers>
+struct UniqueMessageIds;
+
+template<>
+struct UniqueMessageIds<>
+{
+    static constexpr bool value = true;
+};
+
+template<typename Head, typename... Tail>
+struct UniqueMessageIds<Head, Tail...>
+{
+    static constexpr bool value = MessageIdUnused<static_cast<uint8_t>(Head::ID), Tail...>::value
+                               && UniqueMessageIds<Tail...>::value;
+};
+
+template<typename... Handlers>
+struct MessageIdsFit;
+
+template<>
+struct MessageIdsFit<>
+{
+    static constexpr bool value = true;
+};
+
+template<typename Head, typename... Tail>
+struct MessageIdsFit<Head, Tail...>
+{
+    static constexpr bool value = static_cast<long long>(Head::ID) >= 0
+                               && static_cast<long long>(Head::ID) <= 0xFF
+                               && MessageIdsFit<Tail...>::value;
+};
+
+template<typename Handler, typename... Handlers>
+struct HandlerRegistration;
+
+template<typename Handler>
+struct HandlerRegistration<Handler>
+{
+    static void fill(Handler *, bool *)
+    {
+    }
+};
+
+template<typename Handler, typename Head, typename... Tail>
+struct HandlerRegistration<Handler, Head, Tail...>
+{
+    static void fill(Handler *table, bool *registered)
+    {
+        table[static_cast<uint8_t>(Head::ID)] = &Head::handle;
+        registered[static_cast<uint8_t>(Head::ID)] = true;
+        HandlerRegistration<Handler, Tail...>::fill(table, registered);
+    }
+};
+
+} // namespace detail
+
+
+/** \brief Dispatch UDP payloads to handlers selected by their first byte.
+ *
+ * The set of handlers is fixed at compile time. Each handler is a type
+ * exposing a message ID and a static handling function:
+ *
+ * \code
+ *   struct PoseHandler
+ *   {
+ *       static const uint8_t ID = 3;
+ *       static void handle(Controller& c, const char *msg, size_t size);
+ *   };
+ *
+ *   MessageDispatcher<Controller, PoseHandler, StatusHandler> dispatcher;
+ *   dispatcher.poll(server, controller, buffer, sizeof(buffer));
+ * \endcode
+ *
+ * The constructor expands the handler list into a dense 256 entry jump
+ * table. Unregistered IDs point to an internal fallback, so dispatch()
+ * is one indexed load and one indirect call no matter how many message
+ * types are registered. Duplicate IDs are rejected at compile time.
+ *
+ * The handler receives the whole payload, including the ID byte.
+ *
+ * Counters are plain integers: a dispatcher is meant to be used by the
+ * single thread that owns the receiving socket.
+ */
+template<typename Context, typename... Handlers>
+class MessageDispatcher
+{
+public:
+    typedef void        (*Handler)(Context& context, const char *msg, size_t size);
+
+    static const size_t TABLE_SIZE = 256;
+
+    static_assert(detail::MessageIdsFit<Handlers...>::value,
+                  "MessageDispatcher: a message ID does not fit in the first byte (0 to 255)");
+    static_assert(detail::UniqueMessageIds<Handlers...>::value,
+                  "MessageDispatcher: two handlers share the same message ID");
+
+                        MessageDispatcher();
+
+    void                dispatch(Context& context, const char *msg, size_t size);
+    int                 poll(UdpServer& server, Context& context, char *msg, size_t max_size);
+
+    uint64_t            getCount(uint8_t id) const;
+    uint64_t            getUnhandledCount() const;
+    uint64_t            getEmptyCount() const;
+    void                resetCounts();
+
+private:
+    static void         unhandled(Context& context, const char *msg, size_t size);
+
+    Handler             f_table_[TABLE_SIZE];
+    bool                f_registered_[TABLE_SIZE];
+    uint64_t            f_counts_[TABLE_SIZE];
+    uint64_t            f_empty_;
+};
+
+
+/** \brief Build the jump table from the handler list.
+ *
+ * Every slot starts out pointing to the fallback handler, then each
+ * registered handler overwrites the slot matching its ID.
+ */
+template<typename Context, typename... Handlers>
+MessageDispatcher<Context, Handlers...>::MessageDispatcher()
+    : f_empty_(0)
+{
+    for(size_t i(0); i < TABLE_SIZE; ++i)
+    {
+        f_table_[i] = &MessageDispatcher::unhandled;
+        f_registered_[i] = false;
+    }
+    detail::HandlerRegistration<Handler, Handlers...>::fill(f_table_, f_registered_);
+    resetCounts();
+}
+
+/** \brief Call the handler registered for the message ID of \p msg.
+ *
+ * The ID is the first byte of the payload. Empty payloads carry no ID
+ * and are only counted.
+ *
+ * \param[in,out] context  The object passed through to the handler.
+ * \param[in] msg  The payload, starting with the message ID byte.
+ * \param[in] size  The number of bytes in \p msg.
+ */
+template<typename Context, typename... Handlers>
+inline void MessageDispatcher<Context, Handlers...>::dispatch(Context& context, const char *msg, size_t size)
+{
+    if(size == 0)
+    {
+        ++f_empty_;
+        return;
+    }
+    uint8_t const id(static_cast<uint8_t>(msg[0]));
+    ++f_counts_[id];
+    f_table_[id](context, msg, size);
+}
+
+/** \brief Receive one message from \p server and dispatch it.
+ *
+ * \param[in] server  The server to read from.
+ * \param[in,out] context  The object passed through to the handler.
+ * \param[in] msg  The buffer where the message is saved.
+ * \param[in] max_size  The size of the \p msg buffer.
+ *
+ * \return The value returned by UdpServer::recv(), so -1 with errno set
+ * to EAGAIN when no message was pending.
+ */
+template<typename Context, typename... Handlers>
+inline int MessageDispatcher<Context, Handlers...>::poll(UdpServer& server, Context& context, char *msg, size_t max_size)
+{
+    int const r(server.recv(msg, max_size));
+    if(r >= 0)
+    {
+        dispatch(context, msg, static_cast<size_t>(r));
+    }
+    return r;
+}
+
+/** \brief Number of messages dispatched for \p id, handled or not.
+ */
+template<typename Context, typename... Handlers>
+uint64_t MessageDispatcher<Context, Handlers...>::getCount(uint8_t id) const
+{
+    return f_counts_[id];
+}
+
+/** \brief Number of messages whose ID had no registered handler.
+ */
+template<typename Context, typename... Handlers>
+uint64_t MessageDispatcher<Context, Handlers...>::getUnhandledCount() const
+{
+    uint64_t total(0);
+    for(size_t i(0); i < TABLE_SIZE; ++i)
+    {
+        if(!f_registered_[i])
+        {
+            total += f_counts_[i];
+        }
+    }
+    return total;
+}
+
+/** \brief Number of empty payloads seen by dispatch().
+ */
+template<typename Context, typename... Handlers>
+uint64_t MessageDispatcher<Context, Handlers...>::getEmptyCount() const
+{
+    return f_empty_;
+}
+
+/** \brief Reset all the counters to zero.
+ */
+template<typename Context, typename... Handlers>
+void MessageDispatcher<Context, Handlers...>::resetCounts()
+{
+    memset(f_counts_, 0, sizeof(f_counts_));
+    f_empty_ = 0;
+}
+
+template<typename Context, typename... Handlers>
+void MessageDispatcher<Context, Handlers...>::unhandled(Context&, const char *, size_t)
+{
+}
+
+} // namespace udp_client_server
+
+#endif
+// UDP_CLIENT_SERVER_MESSAGE_DISPATCHER_H
+// vim: ts=4 sw=4 et
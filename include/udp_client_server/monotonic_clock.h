@@ -0,0 +1,43 @@
+// Monotonic Clock -- nanosecond timestamps for timeouts and rate control
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_MONOTONIC_CLOCK_H
+#define UDP_CLIENT_SERVER_MONOTONIC_CLOCK_H
+
+#include <stdint.h>
+#include <time.h>
+
+namespace udp_client_server
+{
+
+/** \brief Current CLOCK_MONOTONIC time in nanoseconds.
+ *
+ * All the timestamps, deadlines and idle times handled by this library
+ * are expressed on this clock unless stated otherwise.
+ */
+inline uint64_t monotonicNowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+} // namespace udp_client_server
+
+#endif
+// UDP_CLIENT_SERVER_MONOTONIC_CLOCK_H
+// vim: ts=4 sw=4 et
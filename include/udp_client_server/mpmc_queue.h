@@ -0,0 +1,199 @@
+// MPMC Queue -- bounded lock-free multi-producer multi-consumer queue
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_MPMC_QUEUE_H
+#define UDP_CLIENT_SERVER_MPMC_QUEUE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <vector>
+
+namespace udp_client_server
+{
+
+/** \brief Bounded lock-free queue for any number of producers and consumers.
+ *
+ * This is Dmitry Vyukov's array queue: each cell carries a sequence
+ * number telling whether it is ready to be written or read for a given
+ * lap of the ring, so producers and consumers only contend on their own
+ * position counter with one compare-and-swap per operation, and never
+ * wait on each other unless the queue is full or empty.
+ *
+ * The capacity is rounded up to a power of two and all the memory is
+ * allocated by the constructor. push() and pop() never block; they fail
+ * when the queue is full or empty and the caller decides how to wait.
+ *
+ * Items pushed by one thread are popped in the order they were pushed.
+ */
+template<typename T>
+class MpmcQueue
+{
+public:
+                        MpmcQueue(size_t capacity);
+
+    bool                push(const T& item);
+    bool                pop(T& item);
+
+    size_t              capacity() const;
+    size_t              sizeApprox() const;
+
+private:
+    static const size_t CACHE_LINE_SIZE = 64;
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T               item;
+    };
+
+                        MpmcQueue(const MpmcQueue&);
+    MpmcQueue&          operator = (const MpmcQueue&);
+
+    static size_t       roundCapacity(size_t capacity);
+
+    std::vector<Cell>   f_cells_;
+    size_t              f_mask_;
+    char                f_pad0_[CACHE_LINE_SIZE];
+    std::atomic<size_t> f_enqueue_;
+    char                f_pad1_[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> f_dequeue_;
+    char                f_pad2_[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+};
+
+template<typename T>
+const size_t MpmcQueue<T>::CACHE_LINE_SIZE;
+
+
+/** \brief Allocate a queue of at least \p capacity items.
+ */
+template<typename T>
+MpmcQueue<T>::MpmcQueue(size_t capacity)
+    : f_cells_(roundCapacity(capacity))
+    , f_mask_(f_cells_.size() - 1)
+    , f_enqueue_(0)
+    , f_dequeue_(0)
+{
+    for(size_t i(0); i < f_cells_.size(); ++i)
+    {
+        f_cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+/** \brief Round \p capacity up to a power of two, at least 2.
+ */
+template<typename T>
+size_t MpmcQueue<T>::roundCapacity(size_t capacity)
+{
+    size_t size(2);
+    while(size < capacity)
+    {
+        size <<= 1;
+    }
+    return size;
+}
+
+/** \brief Add \p item at the end of the queue.
+ *
+ * \return false if the queue is full.
+ */
+template<typename T>
+bool MpmcQueue<T>::push(const T& item)
+{
+    size_t pos(f_enqueue_.load(std::memory_order_relaxed));
+    for(;;)
+    {
+        Cell& cell(f_cells_[pos & f_mask_]);
+        size_t const sequence(cell.sequence.load(std::memory_order_acquire));
+        intptr_t const diff(static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos));
+        if(diff == 0)
+        {
+            if(f_enqueue_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                cell.item = item;
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if(diff < 0)
+        {
+            // the cell still holds the item of the previous lap
+            return false;
+        }
+        else
+        {
+            pos = f_enqueue_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+/** \brief Remove the item at the front of the queue.
+ *
+ * \return false if the queue is empty.
+ */
+template<typename T>
+bool MpmcQueue<T>::pop(T& item)
+{
+    size_t pos(f_dequeue_.load(std::memory_order_relaxed));
+    for(;;)
+    {
+        Cell& cell(f_cells_[pos & f_mask_]);
+        size_t const sequence(cell.sequence.load(std::memory_order_acquire));
+        intptr_t const diff(static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1));
+        if(diff == 0)
+        {
+            if(f_dequeue_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                item = cell.item;
+                cell.sequence.store(pos + f_mask_ + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if(diff < 0)
+        {
+            return false;
+        }
+        else
+        {
+            pos = f_dequeue_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+/** \brief Maximum number of items in the queue.
+ */
+template<typename T>
+size_t MpmcQueue<T>::capacity() const
+{
+    return f_mask_ + 1;
+}
+
+/** \brief Number of items in the queue, possibly already outdated.
+ */
+template<typename T>
+size_t MpmcQueue<T>::sizeApprox() const
+{
+    size_t const enqueue(f_enqueue_.load(std::memory_order_relaxed));
+    size_t const dequeue(f_dequeue_.load(std::memory_order_relaxed));
+    return enqueue > dequeue ? enqueue - dequeue : 0;
+}
+
+} // namespace udp_client_server
+
+#endif
+// UDP_CLIENT_SERVER_MPMC_QUEUE_H
+// vim: ts=4 sw=4 et
@@ -0,0 +1,81 @@
+// Network Impairment -- loss, delay, duplication and reordering models
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_NETWORK_IMPAIRMENT_H
+#define UDP_CLIENT_SERVER_NETWORK_IMPAIRMENT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <random>
+
+namespace udp_client_server
+{
+
+/** \brief Description of how a link misbehaves.
+ *
+ * Probabilities are in [0, 1], times in nanoseconds. A default constructed
+ * impairment is a perfect link: no delay, no loss, unlimited bandwidth.
+ */
+struct NetworkImpairment
+{
+                        NetworkImpairment()
+                            : latency_ns(0)
+                            , jitter_ns(0)
+                            , loss(0.0)
+                            , duplicate(0.0)
+                            , reorder(0.0)
+                            , reorder_delay_ns(0)
+                            , bandwidth_bps(0)
+                        {
+                        }
+
+    uint64_t            latency_ns;         // fixed one-way delay
+    uint64_t            jitter_ns;          // uniform extra delay in [0, jitter_ns]
+    double              loss;               // probability a packet is dropped
+    double              duplicate;          // probability a packet is delivered twice
+    double              reorder;            // probability a packet is held back
+    uint64_t            reorder_delay_ns;   // how long a reordered packet is held back
+    uint64_t            bandwidth_bps;      // link rate in bits per second, 0 for unlimited
+};
+
+
+/** \brief Draw the fate of each packet according to a NetworkImpairment.
+ *
+ * The model is driven by a seeded pseudo-random generator so a run can be
+ * replayed exactly.
+ */
+class ImpairmentModel
+{
+public:
+                        ImpairmentModel(uint64_t seed = 1);
+
+    bool                drop(const NetworkImpairment& impairment);
+    bool                duplicate(const NetworkImpairment& impairment);
+    uint64_t            delay(const NetworkImpairment& impairment);
+    static uint64_t     transmitTime(const NetworkImpairment& impairment, size_t size);
+
+private:
+    bool                chance(double probability);
+
+    std::mt19937_64     f_random_;
+};
+
+} // namespace udp_client_server
+
+#endif
+// UDP_CLIENT_SERVER_NETWORK_IMPAIRMENT_H
+// vim: ts=4 sw=4 et
@@ -0,0 +1,63 @@
+// NUMA Placement -- keep packet memory and workers on the same node
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_NUMA_PLACEMENT_H
+#define UDP_CLIENT_SERVER_NUMA_PLACEMENT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+namespace udp_client_server
+{
+
+/** \brief Memory allocation counters of a NUMA node (from numastat.)
+ *
+ * These count page allocations, not memory accesses: a page allocated
+ * locally and then read from another node still counts as local. Use
+ * them as a proxy for the allocation locality of a workload; actual
+ * remote access traffic is only visible through hardware counters.
+ */
+struct NumaAllocStats
+{
+                        NumaAllocStats() : local(0), remote(0) {}
+
+    uint64_t            local;      // pages allocated on the node by tasks running on it
+    uint64_t            remote;     // pages allocated on the node by tasks running elsewhere
+
+    double              remoteRatio() const;
+};
+
+int                     numaNodeCount();
+int                     numaCurrentNode();
+int                     numaNodeOfCpu(int cpu);
+int                     numaNodeOfInterface(const std::string& ifname);
+int                     numaNodeOfAddress(const void *addr);
+std::vector<int>        numaCpusOfNode(int node);
+int                     numaPinThreadToNode(int node);
+
+void *                  numaAlloc(size_t size, int node);
+void                    numaFree(void *ptr, size_t size);
+
+int                     numaReadAllocStats(int node, NumaAllocStats& stats);
+
+} // namespace udp_client_server
+
+#endif
+// UDP_CLIENT_SERVER_NUMA_PLACEMENT_H
+// vim: ts=4 sw=4 et
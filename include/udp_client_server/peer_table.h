@@ -0,0 +1,251 @@
+// Peer Table -- per-source state for UDP servers
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_PEER_TABLE_H
+#define UDP_CLIENT_SERVER_PEER_TABLE_H
+
+#include "flat_hash_map.h"
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <string.h>
+#include <string>
+
+namespace udp_client_server
+{
+
+/** \brief Compact, hashable identifier of a UDP endpoint.
+ *
+ * IPv4 addresses are stored as IPv4-mapped IPv6 addresses so both
+ * families share one 20 byte layout that compares with memcmp().
+ */
+struct PeerKey
+{
+                        PeerKey();
+    explicit            PeerKey(const struct sockaddr *addr);
+
+    bool                operator == (const PeerKey& rhs) const;
+    bool                operator != (const PeerKey& rhs) const;
+
+    socklen_t           toSockaddr(struct sockaddr_storage& addr) const;
+    std::string         toString() const;
+
+    uint8_t             address[16];
+    uint16_t            port;
+    uint16_t            family;
+};
+
+
+struct PeerKeyHash
+{
+    uint64_t            operator () (const PeerKey& key) const;
+};
+
+
+inline bool PeerKey::operator == (const PeerKey& rhs) const
+{
+    return memcmp(this, &rhs, sizeof(PeerKey)) == 0;
+}
+
+inline bool PeerKey::operator != (const PeerKey& rhs) const
+{
+    return !(*this == rhs);
+}
+
+/** \brief Hash a peer key.
+ *
+ * The 20 bytes of the key are folded in 64 bits and run through the
+ * MurmurHash3 finalizer, which spreads every input bit over the output
+ * as FlatHashMap expects. It is inline since it runs for every packet.
+ */
+inline uint64_t PeerKeyHash::operator () (const PeerKey& key) const
+{
+    uint64_t a, b;
+    memcpy(&a, key.address, 8);
+    memcpy(&b, key.address + 8, 8);
+    uint64_t const c(key.port | (static_cast<uint64_t>(key.family) << 16));
+    uint64_t h(a ^ (b * 0x9E3779B97F4A7C15ULL) ^ (c << 17));
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+
+/** \brief Per-peer bookkeeping kept by PeerTable next to the user state.
+ */
+template<typename State>
+struct PeerEntry
+{
+                        PeerEntry() : first_seen_ns(0), last_seen_ns(0), packets(0), bytes(0), state() {}
+
+    uint64_t            first_seen_ns;
+    uint64_t            last_seen_ns;
+    uint64_t            packets;
+    uint64_t            bytes;
+    State               state;
+};
+
+
+/** \brief Table of per-peer state keyed by source endpoint.
+ *
+ * The table is a FlatHashMap preallocated to the configured capacity so
+ * that the lookup done for each received packet never allocates. Peers
+ * that stay silent are removed by evictIdle(), which the owner calls
+ * periodically (i.e. once per second.)
+ *
+ * \code
+ *   PeerTable<RobotState> peers(256);
+ *   struct sockaddr_storage from;
+ *   socklen_t len(sizeof(from));
+ *   int r(server.recvFrom(buf, sizeof(buf), &from, &len));
+ *   PeerEntry<RobotState> *peer(peers.touch(from, now_ns, r));
+ * \endcode
+ *
+ * Like the rest of the receive path, a table is owned by one thread.
+ */
+template<typename State>
+class PeerTable
+{
+public:
+    typedef PeerEntry<State> Entry;
+
+                        PeerTable(size_t capacity);
+
+    Entry *             touch(const struct sockaddr_storage& addr, uint64_t now_ns, size_t bytes);
+    Entry *             touch(const PeerKey& key, uint64_t now_ns, size_t bytes);
+    Entry *             find(const PeerKey& key);
+    bool                erase(const PeerKey& key);
+    size_t              evictIdle(uint64_t now_ns, uint64_t idle_ns);
+
+    size_t              size() const;
+    size_t              capacity() const;
+
+    template<typename F>
+    void                forEach(F f);
+
+private:
+    FlatHashMap<PeerKey, Entry, PeerKeyHash> f_peers_;
+};
+
+
+/** \brief Create a table holding at most \p capacity peers.
+ */
+template<typename State>
+PeerTable<State>::PeerTable(size_t capacity)
+    : f_peers_(capacity)
+{
+}
+
+/** \brief Account for a packet of \p bytes bytes received from \p addr.
+ *
+ * The peer is added if it was not known yet.
+ *
+ * \return The entry of the peer, or NULL if the peer is new and the
+ * table is full.
+ */
+template<typename State>
+inline typename PeerTable<State>::Entry *PeerTable<State>::touch(const struct sockaddr_storage& addr, uint64_t now_ns, size_t bytes)
+{
+    return touch(PeerKey(reinterpret_cast<const struct sockaddr *>(&addr)), now_ns, bytes);
+}
+
+template<typename State>
+inline typename PeerTable<State>::Entry *PeerTable<State>::touch(const PeerKey& key, uint64_t now_ns, size_t bytes)
+{
+    bool inserted;
+    Entry *entry(f_peers_.insert(key, &inserted));
+    if(entry != NULL)
+    {
+        if(inserted)
+        {
+            entry->first_seen_ns = now_ns;
+        }
+        entry->last_seen_ns = now_ns;
+        ++entry->packets;
+        entry->bytes += bytes;
+    }
+    return entry;
+}
+
+/** \brief Look for a peer without accounting for a packet.
+ *
+ * \return The entry of the peer or NULL if unknown.
+ */
+template<typename State>
+typename PeerTable<State>::Entry *PeerTable<State>::find(const PeerKey& key)
+{
+    return f_peers_.find(key);
+}
+
+/** \brief Forget a peer.
+ *
+ * \return false if the peer was not known.
+ */
+template<typename State>
+bool PeerTable<State>::erase(const PeerKey& key)
+{
+    return f_peers_.erase(key);
+}
+
+/** \brief Forget the peers not heard from in the last \p idle_ns nanoseconds.
+ *
+ * This visits every slot of the table, so it is meant to be called at a
+ * low rate, not once per packet.
+ *
+ * \return The number of peers evicted.
+ */
+template<typename State>
+size_t PeerTable<State>::evictIdle(uint64_t now_ns, uint64_t idle_ns)
+{
+    return f_peers_.eraseIf([now_ns, idle_ns](const PeerKey&, const Entry& entry)
+        {
+            return entry.last_seen_ns + idle_ns < now_ns;
+        });
+}
+
+/** \brief Number of peers in the table.
+ */
+template<typename State>
+size_t PeerTable<State>::size() const
+{
+    return f_peers_.size();
+}
+
+/** \brief Maximum number of peers in the table.
+ */
+template<typename State>
+size_t PeerTable<State>::capacity() const
+{
+    return f_peers_.capacity();
+}
+
+/** \brief Call \p f with the key and the entry of each peer.
+ */
+template<typename State>
+template<typename F>
+void PeerTable<State>::forEach(F f)
+{
+    f_peers_.forEach(f);
+}
+
+} // namespace udp_client_server
+
+#endif
+// UDP_CLIENT_SERVER_PEER_TABLE_H
+// vim: ts=4 sw=4 et
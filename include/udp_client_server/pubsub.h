@@ -0,0 +1,228 @@
+// Publish/Subscribe -- topic routing over UDP with hashed topic IDs
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_PUBSUB_H
+#define UDP_CLIENT_SERVER_PUBSUB_H
+
+#include "udp_client_server.h"
+#include "flat_hash_map.h"
+#include <stdint.h>
+#include <vector>
+
+namespace udp_client_server
+{
+
+/** \brief FNV-1a step of topicId().
+ */
+constexpr uint32_t topicIdStep(const char *name, uint32_t hash)
+{
+    return *name == '\0'
+            ? hash
+            : topicIdStep(name + 1, (hash ^ static_cast<uint8_t>(*name)) * 16777619u);
+}
+
+/** \brief Hash a topic name to the 32 bit ID carried by the datagrams.
+ *
+ * This is a constexpr function so topic IDs of names known at compile
+ * time cost nothing at run time:
+ *
+ * \code
+ *   static constexpr uint32_t ODOMETRY = topicId("/robot/odometry");
+ * \endcode
+ */
+constexpr uint32_t topicId(const char *name)
+{
+    return topicIdStep(name, 2166136261u);
+}
+
+
+/** \brief Header in front of each pub/sub datagram, in network byte order.
+ */
+struct PubSubHeader
+{
+    static const uint8_t DATA = 0x61;
+    static const uint8_t SUBSCRIBE = 0x62;
+    static const uint8_t UNSUBSCRIBE = 0x63;
+    static const uint8_t CHALLENGE = 0x64;
+    static const uint8_t FLAG_MULTICAST = 0x01;    // SUBSCRIBE: the subscriber listens on the group
+    static const size_t SIZE = 8;
+    static const size_t COOKIE_SIZE = 8;            // after the header of the control messages
+
+    uint8_t             kind;
+    uint8_t             flags;
+    uint16_t            sequence;
+    uint32_t            topic;
+
+    void                write(char *buffer) const;
+    bool                read(const char *buffer, size_t size);
+};
+
+
+struct TopicIdHash
+{
+    uint64_t            operator () (uint32_t topic) const;
+};
+
+
+/** \brief Spread the bits of a topic ID over 64 bits for FlatHashMap.
+ *
+ * Topic IDs are already hashes but FlatHashMap takes the group from the
+ * high bits, so they are multiplied up. It is inline since it runs for
+ * every message.
+ */
+inline uint64_t TopicIdHash::operator () (uint32_t topic) const
+{
+    uint64_t const h(topic * 0x9E3779B97F4A7C15ULL);
+    return h ^ (h >> 29);
+}
+
+
+/** \brief Sends messages to the subscribers of each topic.
+ *
+ * Subscribers register by sending SUBSCRIBE datagrams to the publisher
+ * socket, and refresh their subscription periodically; subscriptions
+ * not refreshed within the subscription timeout are dropped.
+ *
+ * A subscription only counts once the subscriber proved it receives at
+ * its source address: the publisher answers a SUBSCRIBE without a valid
+ * cookie with a CHALLENGE holding the cookie of that address, and only
+ * SUBSCRIBE and UNSUBSCRIBE messages echoing it are applied. The cookie
+ * is a keyed hash of the address, so the publisher keeps no state for
+ * unconfirmed subscribers and a spoofed SUBSCRIBE cannot direct the
+ * traffic of a topic to a third party. Each topic accepts at most
+ * \p max_members subscribers.
+ *
+ * For each message, publish() picks unicast fan-out (one sendmmsg() for
+ * all the subscribers) or, once a multicast group is set, one datagram
+ * to the group when the topic has enough subscribers and all of them
+ * listen on the group.
+ *
+ * Not thread safe; meant to be used by the thread owning the socket.
+ */
+class Publisher
+{
+public:
+                        Publisher(UdpServer& server, size_t max_topics = 256, size_t max_members = 256);
+
+    void                setMulticastGroup(const std::string& group, int port, size_t threshold = 4);
+    void                setSubscriptionTimeout(uint64_t timeout_ns);
+
+    int                 poll(uint64_t now_ns, size_t max_messages = 64);
+    int                 publish(uint32_t topic, const char *msg, size_t size);
+
+    size_t              getSubscriberCount(uint32_t topic) const;
+    uint64_t            getMulticastCount() const;
+
+private:
+    struct Member
+    {
+        struct sockaddr_storage addr;
+        socklen_t       addrlen;
+        uint64_t        last_seen_ns;
+        bool            multicast;
+    };
+
+    struct Topic
+    {
+                        Topic() : sequence(0), multicast_members(0) {}
+
+        uint16_t        sequence;
+        size_t          multicast_members;
+        std::vector<Member> members;
+    };
+
+    typedef FlatHashMap<uint32_t, Topic, TopicIdHash> TopicMap;
+
+    void                subscribe(uint32_t topic, const struct sockaddr_storage& from, socklen_t from_len,
+                                  bool multicast, uint64_t now_ns);
+    void                unsubscribe(uint32_t topic, const struct sockaddr_storage& from, socklen_t from_len);
+    void                cookie(const struct sockaddr_storage& from, char *buffer) const;
+    void                expire(uint64_t now_ns);
+
+    UdpServer&          f_server_;
+    TopicMap            f_topics_;
+    size_t              f_max_members_;
+    uint64_t            f_secret_[2];
+    struct sockaddr_storage f_group_;
+    socklen_t           f_group_len_;
+    size_t              f_multicast_threshold_;
+    uint64_t            f_timeout_ns_;
+    uint64_t            f_last_expiry_ns_;
+    uint64_t            f_multicast_sent_;
+    std::vector<char>   f_buffer_;
+};
+
+
+/** \brief Receives the messages of the topics it subscribed to.
+ *
+ * Messages arrive on the socket of \p server, which is also used to send
+ * the subscriptions so the publisher learns where to send to. poll()
+ * answers the CHALLENGE of the publisher and echoes its cookie in the
+ * following subscriptions.
+ *
+ * Not thread safe; meant to be used by the thread owning the socket.
+ */
+class Subscriber
+{
+public:
+    typedef void        (*Callback)(void *user, uint32_t topic, const char *msg, size_t size);
+
+                        Subscriber(UdpServer& server, const std::string& publisher_addr, int publisher_port,
+                                   size_t max_topics = 256);
+
+    void                setRefreshInterval(uint64_t interval_ns);
+
+    int                 subscribe(uint32_t topic, Callback callback, void *user, bool multicast = false);
+    int                 unsubscribe(uint32_t topic);
+    int                 poll(uint64_t now_ns, size_t max_messages = 64);
+
+    uint64_t            getLostCount() const;
+    uint64_t            getUnknownTopicCount() const;
+
+private:
+    struct Subscription
+    {
+                        Subscription() : callback(NULL), user(NULL), multicast(false), started(false), next_sequence(0) {}
+
+        Callback        callback;
+        void *          user;
+        bool            multicast;
+        bool            started;
+        uint16_t        next_sequence;
+    };
+
+    typedef FlatHashMap<uint32_t, Subscription, TopicIdHash> SubscriptionMap;
+
+    int                 sendControl(uint8_t kind, uint32_t topic, bool multicast);
+
+    UdpServer&          f_server_;
+    struct sockaddr_storage f_publisher_;
+    socklen_t           f_publisher_len_;
+    char                f_cookie_[PubSubHeader::COOKIE_SIZE];
+    SubscriptionMap     f_subscriptions_;
+    uint64_t            f_refresh_ns_;
+    uint64_t            f_last_refresh_ns_;
+    uint64_t            f_lost_;
+    uint64_t            f_unknown_;
+    std::vector<char>   f_buffer_;
+};
+
+} // namespace udp_client_server
+
+#endif
+// UDP_CLIENT_SERVER_PUBSUB_H
+// vim: ts=4 sw=4 et
@@ -0,0 +1,125 @@
+// Rate Limiter -- per-peer token buckets for UDP servers
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_RATE_LIMITER_H
+#define UDP_CLIENT_SERVER_RATE_LIMITER_H
+
+#include "udp_client_server.h"
+#include "peer_table.h"
+#include <deque>
+#include <string>
+
+namespace udp_client_server
+{
+
+/** \brief Budget allowed to each peer.
+ *
+ * A rate of 0 means unlimited. The burst is the size of the bucket, i.e.
+ * how much a peer may send at once after being quiet; a burst of 0 is
+ * one second worth of the rate.
+ */
+struct RateLimit
+{
+                        RateLimit()
+                            : packets_per_sec(0.0)
+                            , packet_burst(0.0)
+                            , bytes_per_sec(0.0)
+                            , byte_burst(0.0)
+                        {
+                        }
+
+    double              packets_per_sec;
+    double              packet_burst;
+    double              bytes_per_sec;
+    double              byte_burst;
+};
+
+
+struct PeerRateState
+{
+                        PeerRateState()
+                            : refill_ns(0)
+                            , packet_tokens(0.0)
+                            , byte_tokens(0.0)
+                            , accepted(0)
+                            , dropped(0)
+                            , dropped_bytes(0)
+                            , deferred(0)
+                        {
+                        }
+
+    uint64_t            refill_ns;
+    double              packet_tokens;
+    double              byte_tokens;
+    uint64_t            accepted;
+    uint64_t            dropped;
+    uint64_t            dropped_bytes;
+    uint64_t            deferred;
+};
+
+
+class PeerRateLimiter
+{
+public:
+    enum OverBudgetPolicy
+    {
+        OVER_BUDGET_DROP,       // discard packets over budget
+        OVER_BUDGET_DEFER       // deliver them only once the socket is drained
+    };
+
+    typedef PeerTable<PeerRateState> Table;
+
+    static const size_t MAX_REJECTED_PER_CALL = 64;
+
+                        PeerRateLimiter(const RateLimit& limit, size_t max_peers,
+                                        OverBudgetPolicy policy = OVER_BUDGET_DROP, size_t max_deferred = 64);
+
+    void                setLimit(const RateLimit& limit);
+    const RateLimit&    getLimit() const;
+
+    bool                admit(const struct sockaddr_storage& from, size_t size, uint64_t now_ns);
+    int                 recv(UdpServer& server, char *msg, size_t max_size,
+                             struct sockaddr_storage *from = NULL, socklen_t *from_len = NULL);
+
+    size_t              evictIdle(uint64_t now_ns, uint64_t idle_ns);
+    Table&              getPeers();
+    uint64_t            getDroppedCount() const;
+    uint64_t            getUntrackedDropCount() const;
+
+private:
+    struct Deferred
+    {
+        std::string             msg;
+        struct sockaddr_storage from;
+        socklen_t               from_len;
+    };
+
+    RateLimit           f_limit_;
+    OverBudgetPolicy    f_policy_;
+    size_t              f_max_deferred_;
+    Table               f_peers_;
+    std::deque<Deferred> f_deferred_;
+    std::string         f_buffer_;
+    uint64_t            f_dropped_;
+    uint64_t            f_untracked_dropped_;
+};
+
+} // namespace udp_client_server
+
+#endif
+// UDP_CLIENT_SERVER_RATE_LIMITER_H
+// vim: ts=4 sw=4 et
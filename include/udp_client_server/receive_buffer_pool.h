@@ -0,0 +1,95 @@
+// Receive Buffer Pool -- size-classed buffers for incoming UDP messages
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_RECEIVE_BUFFER_POOL_H
+#define UDP_CLIENT_SERVER_RECEIVE_BUFFER_POOL_H
+
+#include "udp_client_server.h"
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+namespace udp_client_server
+{
+
+struct ReceiveBuffer
+{
+                        ReceiveBuffer() : data(NULL), capacity(0), size(0), truncated(false) {}
+
+    char *              data;
+    size_t              capacity;
+    size_t              size;
+    bool                truncated;
+};
+
+
+class ReceiveBufferPool
+{
+public:
+    enum RecvMode
+    {
+        RECV_PEEK_SIZE,         // peek the size first, never truncate (two system calls)
+        RECV_DETECT_TRUNC       // single system call, truncation detected and learned from
+    };
+
+    static const size_t CLASS_COUNT = 9;
+    static const size_t MIN_CLASS_SIZE = 256;
+    static const size_t MAX_CLASS_SIZE = MIN_CLASS_SIZE << (CLASS_COUNT - 1);
+
+    static const size_t NUMA_SLAB_SIZE = 64 * 1024;
+
+                        ReceiveBufferPool(RecvMode mode = RECV_PEEK_SIZE, size_t max_free_per_class = 64, int numa_node = -1);
+                        ~ReceiveBufferPool();
+
+    int                 recv(UdpServer& server, ReceiveBuffer& buffer);
+
+    bool                acquire(size_t size, ReceiveBuffer& buffer);
+    void                release(ReceiveBuffer& buffer);
+
+    RecvMode            getMode() const;
+    int                 getNumaNode() const;
+    size_t              getPreferredSize() const;
+    uint64_t            getTruncatedCount() const;
+
+    static size_t       classOf(size_t size);
+    static size_t       classSize(size_t size_class);
+
+private:
+                        ReceiveBufferPool(const ReceiveBufferPool&);
+    ReceiveBufferPool&  operator=(const ReceiveBufferPool&);
+
+    void                observe(size_t size);
+    bool                allocateSlab(size_t size_class);
+
+    static const uint32_t DECAY_INTERVAL = 1024;
+
+    RecvMode            f_mode_;
+    size_t              f_max_free_per_class_;
+    int                 f_numa_node_;
+    std::vector<std::pair<void *, size_t> > f_slabs_;
+    std::vector<char *> f_free_[CLASS_COUNT];
+    uint32_t            f_observed_[CLASS_COUNT];
+    uint32_t            f_since_decay_;
+    size_t              f_preferred_class_;
+    uint64_t            f_truncated_;
+};
+
+} // namespace udp_client_server
+
+#endif
+// UDP_CLIENT_SERVER_RECEIVE_BUFFER_POOL_H
+// vim: ts=4 sw=4 et
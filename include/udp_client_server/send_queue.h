@@ -0,0 +1,74 @@
+// Send Queue -- bounded user-space queue of datagrams waiting for the socket
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_SEND_QUEUE_H
+#define UDP_CLIENT_SERVER_SEND_QUEUE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/uio.h>
+#include <vector>
+
+namespace udp_client_server
+{
+
+enum SendQueueOverflow
+{
+    SEND_QUEUE_DROP_NEWEST,     // discard the message being sent
+    SEND_QUEUE_DROP_OLDEST,     // discard the oldest queued message
+    SEND_QUEUE_REJECT           // fail the send with EAGAIN
+};
+
+
+/** \brief Fixed-size ring of datagrams.
+ *
+ * All the memory is allocated by the constructor: \p capacity slots of
+ * \p slot_size bytes each. Used by UdpClient to hold messages the socket
+ * refused with EAGAIN.
+ */
+class SendQueue
+{
+public:
+                        SendQueue(size_t capacity, size_t slot_size, SendQueueOverflow policy);
+
+    bool                push(const struct iovec *iov, size_t iovcnt);
+    size_t              peek(struct iovec *iov, size_t max_count) const;
+    void                pop(size_t count);
+
+    bool                empty() const;
+    size_t              size() const;
+    size_t              capacity() const;
+    size_t              slotSize() const;
+    SendQueueOverflow   getPolicy() const;
+    uint64_t            getDroppedCount() const;
+
+private:
+    size_t              f_capacity_;
+    size_t              f_slot_size_;
+    SendQueueOverflow   f_policy_;
+    size_t              f_head_;
+    size_t              f_count_;
+    uint64_t            f_dropped_;
+    std::vector<char>   f_data_;
+    std::vector<size_t> f_sizes_;
+};
+
+} // namespace udp_client_server
+
+#endif
+// UDP_CLIENT_SERVER_SEND_QUEUE_H
+// vim: ts=4 sw=4 et
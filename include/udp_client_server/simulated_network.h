@@ -0,0 +1,198 @@
+// Simulated Network -- in-process UDP transport with a virtual clock
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_SIMULATED_NETWORK_H
+#define UDP_CLIENT_SERVER_SIMULATED_NETWORK_H
+
+#include "udp_client_server.h"
+#include "network_impairment.h"
+#include "peer_table.h"
+#include <deque>
+#include <memory>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace udp_client_server
+{
+
+class SimulatedNetwork
+{
+public:
+    struct Stats
+    {
+                        Stats() : sent(0), delivered(0), lost(0), duplicated(0), overflowed(0), unroutable(0) {}
+
+        uint64_t        sent;
+        uint64_t        delivered;
+        uint64_t        lost;
+        uint64_t        duplicated;
+        uint64_t        overflowed;
+        uint64_t        unroutable;
+    };
+
+    static const size_t DEFAULT_RECEIVE_BUFFER_SIZE = 212992;
+    static const size_t DEFAULT_MTU = 1500;
+
+                        SimulatedNetwork(uint64_t seed = 1);
+
+    void                setImpairment(const NetworkImpairment& impairment);
+    void                setImpairment(const std::string& addr, int port, const NetworkImpairment& impairment);
+    void                setReceiveBufferSize(size_t size);
+    void                setMtu(size_t mtu);
+    size_t              getMtu() const;
+
+    uint64_t            now() const;
+    void                advance(uint64_t ns);
+    void                advanceTo(uint64_t time_ns);
+    bool                nextEventTime(uint64_t& time_ns) const;
+    void                runUntilIdle();
+
+    const Stats&        getStats() const;
+
+private:
+    friend class SimulatedUdpClient;
+    friend class SimulatedUdpServer;
+
+    typedef std::shared_ptr<const std::string> Payload;
+
+    struct Datagram
+    {
+        PeerKey         source;
+        Payload         payload;
+    };
+
+    struct Endpoint
+    {
+                        Endpoint() : has_impairment(false), bound(false), busy_until(0), queued_bytes(0) {}
+
+        NetworkImpairment impairment;
+        bool            has_impairment;
+        bool            bound;
+        uint64_t        busy_until;
+        size_t          queued_bytes;
+        std::deque<Datagram> queue;
+    };
+
+    struct InFlight
+    {
+        uint64_t        deliver_at;
+        uint64_t        sequence;
+        PeerKey         destination;
+        Datagram        datagram;
+
+        bool            operator > (const InFlight& rhs) const
+                        {
+                            return deliver_at != rhs.deliver_at
+                                ? deliver_at > rhs.deliver_at
+                                : sequence > rhs.sequence;
+                        }
+    };
+
+    static PeerKey      endpointKey(const std::string& addr, int port);
+
+    PeerKey             allocateSource(const PeerKey& destination);
+    void                bind(const PeerKey& key);
+    void                unbind(const PeerKey& key);
+    int                 send(const PeerKey& source, const PeerKey& destination, const Payload& payload);
+    Endpoint *          route(const PeerKey& key);
+    Endpoint&           endpoint(const PeerKey& key);
+
+    ImpairmentModel     f_model_;
+    NetworkImpairment   f_default_impairment_;
+    size_t              f_receive_buffer_size_;
+    size_t              f_mtu_;
+    uint16_t            f_next_port_;
+    uint64_t            f_now_;
+    uint64_t            f_sequence_;
+    Stats               f_stats_;
+    std::unordered_map<PeerKey, Endpoint, PeerKeyHash> f_endpoints_;
+    std::priority_queue<InFlight, std::vector<InFlight>, std::greater<InFlight> > f_in_flight_;
+};
+
+
+/** \brief A UdpClient sending on a SimulatedNetwork.
+ *
+ * The send functions have the same signatures and error reporting as
+ * the UdpClient ones, so code templated on the client type runs on the
+ * real and the simulated network unchanged.
+ */
+class SimulatedUdpClient
+{
+public:
+                        SimulatedUdpClient(SimulatedNetwork& network, const std::string& addr, int port);
+
+    int                 getSocket() const;
+    int                 getPort() const;
+    std::string         getAddr() const;
+    int                 setDestination(const std::string& addr, int port);
+
+    int                 send(const char *msg, size_t size);
+    int                 sendv(const struct iovec *iov, size_t iovcnt);
+    int                 sendBatchv(const UdpSendVector *vectors, unsigned int count);
+
+    size_t              maxPayload() const;
+
+private:
+    SimulatedNetwork&   f_network_;
+    int                 f_port_;
+    std::string         f_addr_;
+    PeerKey             f_key_;
+    PeerKey             f_source_;
+};
+
+
+/** \brief A UdpServer receiving from a SimulatedNetwork.
+ *
+ * Like SimulatedUdpClient, the receive functions match the UdpServer
+ * ones so templated code can be given either.
+ */
+class SimulatedUdpServer
+{
+public:
+                        SimulatedUdpServer(SimulatedNetwork& network, const std::string& addr, int port);
+                        ~SimulatedUdpServer();
+
+    int                 getSocket() const;
+    int                 getPort() const;
+    std::string         getAddr() const;
+
+    int                 recv(char *msg, size_t max_size);
+    int                 recvFrom(char *msg, size_t max_size, struct sockaddr_storage *from, socklen_t *from_len);
+    int                 recvv(const struct iovec *iov, size_t iovcnt, int *msg_flags = NULL);
+    int                 recvTrunc(char *msg, size_t max_size);
+    int                 peekSize();
+    int                 timedRecv(char *msg, size_t max_size, int max_wait_ms);
+
+private:
+                        SimulatedUdpServer(const SimulatedUdpServer&);
+    SimulatedUdpServer& operator=(const SimulatedUdpServer&);
+
+    SimulatedNetwork::Datagram pop();
+
+    SimulatedNetwork&   f_network_;
+    int                 f_port_;
+    std::string         f_addr_;
+    PeerKey             f_key_;
+};
+
+} // namespace udp_client_server
+
+#endif
+// UDP_CLIENT_SERVER_SIMULATED_NETWORK_H
+// vim: ts=4 sw=4 et
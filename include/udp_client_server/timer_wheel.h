@@ -0,0 +1,199 @@
+// Timer Wheel -- hashed timing wheel for delayed items
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_TIMER_WHEEL_H
+#define UDP_CLIENT_SERVER_TIMER_WHEEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <algorithm>
+#include <vector>
+
+namespace udp_client_server
+{
+
+/** \brief Hashed timing wheel holding items until their deadline.
+ *
+ * Time is cut in ticks of \p tick_ns nanoseconds and each tick maps to
+ * one of \p slot_count slots (a power of two.) Scheduling an item is a
+ * push in its slot; advancing the wheel only visits the slots of the
+ * ticks that elapsed. Deadlines further than one revolution away stay
+ * in their slot until the wheel comes back to them with the deadline
+ * reached.
+ *
+ * Items of the same tick are released in insertion order.
+ *
+ * The release functor must not schedule new items in the wheel.
+ */
+template<typename T>
+class TimerWheel
+{
+public:
+                        TimerWheel(uint64_t tick_ns = 100000, size_t slot_count = 4096);
+
+    void                schedule(uint64_t deadline_ns, const T& item);
+
+    template<typename F>
+    size_t              advance(uint64_t now_ns, F release);
+
+    size_t              size() const;
+    bool                empty() const;
+
+private:
+    struct Entry
+    {
+        uint64_t        deadline;
+        T               item;
+    };
+
+    template<typename F>
+    size_t              releaseSlot(std::vector<Entry>& slot, uint64_t now_ns, F& release);
+
+    uint64_t            f_tick_ns_;
+    size_t              f_mask_;
+    uint64_t            f_current_tick_;
+    size_t              f_size_;
+    std::vector<std::vector<Entry> > f_slots_;
+};
+
+
+/** \brief Initialize an empty wheel.
+ *
+ * \param[in] tick_ns  The resolution of the wheel in nanoseconds.
+ * \param[in] slot_count  The number of slots, rounded up to a power of two.
+ */
+template<typename T>
+TimerWheel<T>::TimerWheel(uint64_t tick_ns, size_t slot_count)
+    : f_tick_ns_(tick_ns == 0 ? 1 : tick_ns)
+    , f_mask_(0)
+    , f_current_tick_(0)
+    , f_size_(0)
+{
+    size_t count(1);
+    while(count < slot_count)
+    {
+        count <<= 1;
+    }
+    f_mask_ = count - 1;
+    f_slots_.resize(count);
+}
+
+/** \brief Hold \p item until \p deadline_ns.
+ *
+ * An item scheduled in the past is released by the next advance().
+ */
+template<typename T>
+void TimerWheel<T>::schedule(uint64_t deadline_ns, const T& item)
+{
+    uint64_t tick(deadline_ns / f_tick_ns_);
+    if(tick < f_current_tick_)
+    {
+        tick = f_current_tick_;
+    }
+    Entry entry;
+    entry.deadline = deadline_ns;
+    entry.item = item;
+    f_slots_[tick & f_mask_].push_back(entry);
+    ++f_size_;
+}
+
+/** \brief Release all the items whose deadline is \p now_ns or earlier.
+ *
+ * \param[in] now_ns  The current time in nanoseconds.
+ * \param[in] release  A functor called with each released item.
+ *
+ * \return The number of items released.
+ */
+template<typename T>
+template<typename F>
+size_t TimerWheel<T>::advance(uint64_t now_ns, F release)
+{
+    uint64_t const now_tick(now_ns / f_tick_ns_);
+    if(f_size_ == 0 || now_tick < f_current_tick_)
+    {
+        f_current_tick_ = std::max(f_current_tick_, now_tick);
+        return 0;
+    }
+
+    size_t released(0);
+    if(now_tick - f_current_tick_ > f_mask_)
+    {
+        // a full revolution elapsed, every slot is due
+        for(size_t i(0); i <= f_mask_; ++i)
+        {
+            released += releaseSlot(f_slots_[(f_current_tick_ + i) & f_mask_], now_ns, release);
+        }
+    }
+    else
+    {
+        for(uint64_t tick(f_current_tick_); tick <= now_tick; ++tick)
+        {
+            released += releaseSlot(f_slots_[tick & f_mask_], now_ns, release);
+        }
+    }
+    f_current_tick_ = now_tick;
+    return released;
+}
+
+/** \brief Number of items waiting in the wheel.
+ */
+template<typename T>
+size_t TimerWheel<T>::size() const
+{
+    return f_size_;
+}
+
+/** \brief Check whether the wheel holds no items.
+ */
+template<typename T>
+bool TimerWheel<T>::empty() const
+{
+    return f_size_ == 0;
+}
+
+template<typename T>
+template<typename F>
+size_t TimerWheel<T>::releaseSlot(std::vector<Entry>& slot, uint64_t now_ns, F& release)
+{
+    size_t released(0);
+    size_t kept(0);
+    for(size_t i(0); i < slot.size(); ++i)
+    {
+        if(slot[i].deadline <= now_ns)
+        {
+            release(slot[i].item);
+            ++released;
+        }
+        else
+        {
+            if(kept != i)
+            {
+                slot[kept] = slot[i];
+            }
+            ++kept;
+        }
+    }
+    slot.erase(slot.begin() + kept, slot.end());
+    f_size_ -= released;
+    return released;
+}
+
+} // namespace udp_client_server
+
+#endif
+// UDP_CLIENT_SERVER_TIMER_WHEEL_H
+// vim: ts=4 sw=4 et
@@ -0,0 +1,93 @@
+// Traffic Statistics -- per-flow arrival jitter and sequence loss
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_TRAFFIC_STATS_H
+#define UDP_CLIENT_SERVER_TRAFFIC_STATS_H
+
+#include "udp_client_server.h"
+#include "peer_table.h"
+#include <stdint.h>
+
+namespace udp_client_server
+{
+
+/** \brief Arrival statistics of one flow, kept in a PeerTable entry.
+ *
+ * The jitter is the mean absolute deviation of the interarrival time
+ * from its running average, both smoothed with a 1/16 gain. This is not
+ * the RFC 3550 interarrival jitter, which compares the spacing of the
+ * arrivals to the spacing of the sender timestamps: the datagrams carry
+ * none, so a sender which does not send at a steady rate shows up as
+ * jitter too. Loss and reordering are only known when the datagrams
+ * carry a sequence number (see TrafficStats::setSequenceField().)
+ */
+struct FlowStats
+{
+                        FlowStats()
+                            : last_arrival_ns(0)
+                            , mean_interarrival_ns(0.0)
+                            , jitter_ns(0.0)
+                            , next_sequence(0)
+                            , sequenced(false)
+                            , lost(0)
+                            , reordered(0)
+                            , truncated(0)
+                        {
+                        }
+
+    uint64_t            last_arrival_ns;
+    double              mean_interarrival_ns;
+    double              jitter_ns;
+    uint32_t            next_sequence;
+    bool                sequenced;
+    uint64_t            lost;
+    uint64_t            reordered;
+    uint64_t            truncated;
+};
+
+
+/** \brief Jitter and loss statistics of the flows seen by a receiver.
+ *
+ * Feed it the views of UdpServer::recvView() or of a PacketMonitor;
+ * flows are keyed by their source address and port.
+ */
+class TrafficStats
+{
+public:
+    typedef PeerTable<FlowStats> Table;
+
+                        TrafficStats(size_t max_flows = 1024);
+
+    void                setSequenceField(size_t offset, size_t width);
+    void                observe(const UdpPacketView& view);
+
+    size_t              evictIdle(uint64_t now_ns, uint64_t idle_ns);
+    Table&              getFlows();
+    uint64_t            getUntrackedCount() const;
+
+private:
+    Table               f_flows_;
+    size_t              f_sequence_offset_;
+    size_t              f_sequence_width_;
+    uint64_t            f_untracked_;
+};
+
+} // namespace udp_client_server
+
+#endif
+// UDP_CLIENT_SERVER_TRAFFIC_STATS_H
+// vim: ts=4 sw=4 et
@@ -19,12 +19,18 @@
 #define SNAP_UDP_CLIENT_SERVER_H
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netdb.h>
 #include <stdexcept>
 #include <stdio.h>
 #include <stdlib.h>
 #include <iostream>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "send_queue.h"
 
 namespace udp_client_server
 {
@@ -36,23 +42,154 @@ public:
 };
 
 
+/** \brief One datagram described as a list of buffers.
+ *
+ * Used by UdpClient::sendBatchv() to gather a header, payload segments
+ * and a trailer into a single datagram without copying them together.
+ */
+struct UdpSendVector
+{
+    const struct iovec *    iov;
+    size_t                  iovcnt;
+};
+
+
+/** \brief Kernel memory accounting of a socket (SO_MEMINFO.)
+ *
+ * Values are in bytes and include the kernel overhead of each packet,
+ * so they are larger than the sum of the payloads.
+ */
+struct SocketMemInfo
+{
+    uint32_t            rmem_alloc;     // memory used by the receive queue
+    uint32_t            rcvbuf;         // receive buffer limit (SO_RCVBUF)
+    uint32_t            wmem_alloc;     // memory used by packets being sent
+    uint32_t            sndbuf;         // send buffer limit (SO_SNDBUF)
+    uint32_t            fwd_alloc;
+    uint32_t            wmem_queued;
+    uint32_t            optmem;
+    uint32_t            backlog;
+    uint32_t            drops;          // packets dropped because the receive queue was full
+
+    double              receiveFill() const;
+    double              sendFill() const;
+};
+
+
+/** \brief A received UDP datagram and where it came from.
+ *
+ * The data is not owned by the view: it points to the buffer given to
+ * UdpServer::recvView(), or in the ring of a PacketMonitor, and is only
+ * valid until that buffer is reused.
+ */
+struct UdpPacketView
+{
+    const char *        data;
+    size_t              size;           // size of data, may be less than the datagram (see truncated)
+    size_t              wire_size;      // size of the UDP payload on the wire
+    struct sockaddr_storage source;
+    socklen_t           source_len;
+    struct sockaddr_storage destination;
+    socklen_t           destination_len;
+    uint64_t            timestamp_ns;   // CLOCK_REALTIME time of arrival
+
+    bool                truncated() const { return size < wire_size; }
+};
+
+
+enum UdpErrorKind
+{
+    UDP_ERROR_PORT_UNREACHABLE,         // nothing listens on the destination port (ECONNREFUSED)
+    UDP_ERROR_HOST_UNREACHABLE,         // the destination host or network cannot be reached
+    UDP_ERROR_FRAGMENTATION_NEEDED,     // the datagram exceeds the path MTU (EMSGSIZE)
+    UDP_ERROR_OTHER                     // any other error, see UdpErrorEvent::error
+};
+
+
+/** \brief An error reported by the kernel for a datagram sent earlier.
+ *
+ * These come from the socket error queue (IP_RECVERR), mostly from ICMP
+ * messages sent back by the destination or a router on the way. The
+ * destination is where the failed datagram was sent, the offender the
+ * node that reported the error, when known.
+ */
+struct UdpErrorEvent
+{
+    UdpErrorKind        kind;
+    int                 error;          // errno value of the error
+    uint8_t             origin;         // SO_EE_ORIGIN_ICMP, SO_EE_ORIGIN_ICMP6 or SO_EE_ORIGIN_LOCAL
+    uint8_t             type;           // ICMP type
+    uint8_t             code;           // ICMP code
+    uint32_t            mtu;            // the path MTU for UDP_ERROR_FRAGMENTATION_NEEDED, 0 otherwise
+    struct sockaddr_storage destination;
+    socklen_t           destination_len;
+    struct sockaddr_storage offender;
+    socklen_t           offender_len;   // 0 when the offender is not known
+};
+
+
 class UdpClient
 {
 public:
+    typedef void        (*ErrorCallback)(void *user, const UdpErrorEvent& event);
+
                         UdpClient(const std::string& addr, int port);
                         ~UdpClient();
 
     int                 getSocket() const;
     int                 getPort() const;
     std::string         getAddr() const;
+    int                 setDestination(const std::string& addr, int port);
+    int                 setDestination(const struct sockaddr *addr, socklen_t addrlen);
 
     int                 send(const char *msg, size_t size);
+    int                 sendv(const struct iovec *iov, size_t iovcnt);
+    int                 sendBatchv(const UdpSendVector *vectors, unsigned int count);
+
+    int                 enablePmtuDiscovery();
+    int                 getMtu() const;
+    size_t              maxPayload() const;
+
+    int                 enableErrorReporting(ErrorCallback callback, void *user);
+    int                 pollErrors();
+
+    int                 nextDatagramSize() const;
+    int                 pendingSendBytes() const;
+    int                 pendingRecvBytes() const;
+    int                 getMemInfo(SocketMemInfo& info) const;
+
+    int                 enableSendQueue(size_t capacity,
+                                        SendQueueOverflow policy = SEND_QUEUE_DROP_NEWEST,
+                                        size_t max_message_size = 0);
+    int                 flushSendQueue();
+    bool                hasQueuedSends() const;
+    const SendQueue *   getSendQueue() const;
 
 private:
+    struct Destination;
+    class DestinationRef;
+
+                        UdpClient(const UdpClient&);
+    UdpClient&          operator=(const UdpClient&);
+
+    int                 swapDestination(Destination *destination);
+    void                refreshMtu();
+    int                 sendResult(int r);
+    int                 sendvNow(const struct iovec *iov, size_t iovcnt);
+    int                 sendBatchvNow(const UdpSendVector *vectors, unsigned int count);
+    int                 queuedSendv(const struct iovec *iov, size_t iovcnt);
+
     int                 f_socket_;
-    int                 f_port_;
-    std::string         f_addr_;
-    struct addrinfo *   f_addrinfo_;
+    int                 f_family_;
+    std::atomic<const Destination *> f_destination_;
+    std::mutex          f_destination_mutex_;
+    std::atomic<unsigned int> f_destination_epoch_;
+    mutable std::atomic<int> f_destination_readers_[2];
+    bool                f_connected_;
+    std::atomic<int>    f_mtu_;
+    SendQueue *         f_send_queue_;
+    ErrorCallback       f_error_callback_;
+    void *              f_error_user_;
 };
 
 
@@ -67,8 +204,22 @@ public:
     std::string         getAddr() const;
 
     int                 recv(char *msg, size_t max_size);
+    int                 recvFrom(char *msg, size_t max_size, struct sockaddr_storage *from, socklen_t *from_len);
+    int                 recvv(const struct iovec *iov, size_t iovcnt, int *msg_flags = NULL);
+    int                 recvTrunc(char *msg, size_t max_size);
+    int                 recvView(char *msg, size_t max_size, UdpPacketView& view);
+    int                 peekSize();
     int                 timedRecv(char *msg, size_t max_size, int max_wait_ms);
 
+    int                 joinMulticastGroup(const std::string& group, const std::string& ifname = std::string());
+
+    int                 nextDatagramSize() const;
+    int                 pendingSendBytes() const;
+    int                 pendingRecvBytes() const;
+    int                 getMemInfo(SocketMemInfo& info) const;
+    int                 incomingCpu() const;
+    int                 incomingNumaNode() const;
+
 private:
     int                 f_socket_;
     int                 f_port_;
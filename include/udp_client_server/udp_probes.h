@@ -0,0 +1,50 @@
+// UDP Probes -- USDT tracepoints on the send and receive paths
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_UDP_PROBES_H
+#define UDP_CLIENT_SERVER_UDP_PROBES_H
+
+// Static tracepoints for bpftrace, perf and SystemTap.
+//
+// When the library is built with sys/sdt.h available (the CMake script
+// defines HAVE_SYS_SDT_H), UDP_PROBE() places a USDT probe: a single NOP
+// in the code plus a note in the ELF file telling tracers where the
+// arguments are. Without a tracer attached nothing else runs. Without
+// sys/sdt.h the probes compile to nothing.
+//
+// Probes come in pairs, NAME_entry with the socket and the size, and
+// NAME_return with the socket, the size and the result. Tracers stamp
+// each probe hit, so the latency of a call is the difference of the two:
+//
+//   bpftrace -e '
+//     usdt:./my_node:udp_client_server:server_recv_entry { @start[tid] = nsecs; }
+//     usdt:./my_node:udp_client_server:server_recv_return /@start[tid]/ {
+//         @latency_ns = hist(nsecs - @start[tid]); delete(@start[tid]); }'
+//
+// The size is the buffer size on receive (0 for peekSize()) and the
+// number of messages for the batch calls.
+
+#ifdef HAVE_SYS_SDT_H
+#include <sys/sdt.h>
+#define UDP_PROBE(name, ...)    STAP_PROBEV(udp_client_server, name, __VA_ARGS__)
+#else
+#define UDP_PROBE(name, ...)    do {} while(0)
+#endif
+
+#endif
+// UDP_CLIENT_SERVER_UDP_PROBES_H
+// vim: ts=4 sw=4 et
@@ -0,0 +1,155 @@
+// UDP RPC -- request/response calls with correlation IDs and deadlines
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_UDP_RPC_H
+#define UDP_CLIENT_SERVER_UDP_RPC_H
+
+#include "udp_client_server.h"
+#include "timer_wheel.h"
+#include <stdint.h>
+#include <vector>
+
+namespace udp_client_server
+{
+
+enum RpcStatus
+{
+    RPC_OK,                     // the response payload is valid
+    RPC_REMOTE_ERROR,           // the server handler failed
+    RPC_TIMEOUT                 // no response before the deadline
+};
+
+/** \brief Header in front of each RPC datagram, in network byte order.
+ */
+struct RpcHeader
+{
+    static const uint8_t REQUEST = 0x51;
+    static const uint8_t RESPONSE = 0x52;
+    static const size_t SIZE = 8;
+
+    uint8_t             kind;
+    uint8_t             status;
+    uint16_t            method;
+    uint32_t            id;
+
+    void                write(char *buffer) const;
+    bool                read(const char *buffer, size_t size);
+};
+
+/** \brief Retransmission schedule of the requests.
+ *
+ * A request is sent again after \p initial_ns, then the delay is
+ * multiplied by \p multiplier each time, up to \p max_ns, until the
+ * response arrives or the deadline of the call expires.
+ */
+struct RpcRetryPolicy
+{
+                        RpcRetryPolicy() : initial_ns(10000000), max_ns(1000000000), multiplier(2.0) {}
+
+    uint64_t            initial_ns;
+    uint64_t            max_ns;
+    double              multiplier;
+};
+
+
+/** \brief Asynchronous RPC caller; many calls may be in flight on one socket.
+ *
+ * The client is not thread safe: call(), cancel() and poll() are meant
+ * to be used by the thread owning the socket.
+ */
+class RpcClient
+{
+public:
+    typedef void        (*Callback)(void *user, RpcStatus status, const char *response, size_t size);
+
+    static const size_t MAX_IN_FLIGHT = 65536;
+
+                        RpcClient(UdpClient& client, size_t max_in_flight = 1024);
+
+    void                setRetryPolicy(const RpcRetryPolicy& policy);
+    const RpcRetryPolicy& getRetryPolicy() const;
+
+    int64_t             call(uint16_t method, const char *request, size_t size, uint64_t deadline_ns,
+                             Callback callback, void *user);
+    bool                cancel(uint32_t id);
+    int                 poll(uint64_t now_ns, size_t max_responses = 64);
+
+    size_t              getInFlight() const;
+    uint64_t            getRetransmitCount() const;
+    uint64_t            getTimeoutCount() const;
+    uint64_t            getStaleResponseCount() const;
+
+private:
+    struct Call
+    {
+        uint32_t        id;
+        bool            active;
+        uint64_t        deadline_ns;
+        uint64_t        retry_ns;
+        std::vector<char> request;
+        Callback        callback;
+        void *          user;
+    };
+
+    Call *              lookup(uint32_t id);
+    void                finish(Call& c, RpcStatus status, const char *response, size_t size);
+    void                expire(uint32_t id, uint64_t now_ns);
+
+    UdpClient&          f_client_;
+    RpcRetryPolicy      f_policy_;
+    uint32_t            f_index_mask_;
+    std::vector<Call>   f_calls_;
+    std::vector<uint32_t> f_free_;
+    TimerWheel<uint32_t> f_timers_;
+    std::vector<uint32_t> f_expired_;
+    std::vector<char>   f_buffer_;
+    uint64_t            f_retransmits_;
+    uint64_t            f_timeouts_;
+    uint64_t            f_stale_;
+};
+
+
+/** \brief Answers RPC requests with a single handler function.
+ */
+class RpcServer
+{
+public:
+    typedef int         (*Handler)(void *user, uint16_t method, const char *request, size_t size,
+                                   char *response, size_t max_size);
+
+                        RpcServer(UdpServer& server, Handler handler, void *user);
+
+    int                 poll(size_t max_requests = 64);
+
+    uint64_t            getRequestCount() const;
+    uint64_t            getInvalidCount() const;
+
+private:
+    UdpServer&          f_server_;
+    Handler             f_handler_;
+    void *              f_user_;
+    std::vector<char>   f_request_;
+    std::vector<char>   f_response_;
+    uint64_t            f_requests_;
+    uint64_t            f_invalid_;
+};
+
+} // namespace udp_client_server
+
+#endif
+// UDP_CLIENT_SERVER_UDP_RPC_H
+// vim: ts=4 sw=4 et
@@ -0,0 +1,134 @@
+// Work-Stealing Executor -- run packet handlers on a pool of stealing workers
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_WORK_STEALING_EXECUTOR_H
+#define UDP_CLIENT_SERVER_WORK_STEALING_EXECUTOR_H
+
+#include "udp_client_server.h"
+#include "chase_lev_deque.h"
+#include "mpmc_queue.h"
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace udp_client_server
+{
+
+/** \brief A unit of work run by a WorkStealingExecutor.
+ *
+ * The task is intrusive: embed it in (or derive from it) the structure
+ * holding the state of the work, and get back to that structure in
+ * run(). The executor never allocates nor frees tasks; the task must
+ * stay alive until run() was called.
+ */
+struct ExecutorTask
+{
+    void                (*run)(ExecutorTask *task);
+};
+
+
+/** \brief Run tasks on a pool of workers balancing their load by stealing.
+ *
+ * Each worker owns a Chase-Lev deque. Tasks submitted by a worker (i.e.
+ * a handler splitting its work) go to its own deque; tasks submitted by
+ * other threads go to a shared injection queue, which idle workers move
+ * to their deque in small batches. A worker with nothing to do steals the
+ * oldest task of a randomly chosen worker, so a burst of expensive
+ * messages spreads over all the workers instead of backing up behind the
+ * one a static assignment would have picked.
+ *
+ * Order-sensitive work is submitted pinned: it goes to a queue of the
+ * worker chosen by hashing its flow and is never stolen, so the tasks of
+ * one flow run one at a time, in submission order.
+ *
+ * dispatch() reads datagrams from a UdpServer and runs a handler for
+ * each of them as a task, using packet slots allocated up front.
+ */
+class WorkStealingExecutor
+{
+public:
+    typedef void        (*PacketHandler)(void *user, const UdpPacketView& packet);
+
+    static const size_t INJECTION_BATCH = 16;
+
+                        WorkStealingExecutor(size_t worker_count, size_t queue_capacity = 4096,
+                                             size_t slot_count = 4096, size_t slot_size = 2048);
+                        ~WorkStealingExecutor();
+
+    int                 start();
+    void                stop();
+
+    bool                submit(ExecutorTask *task);
+    bool                submitPinned(uint64_t flow, ExecutorTask *task);
+    int                 dispatch(UdpServer& server, PacketHandler handler, void *user,
+                                 bool pin_flows = false, size_t max_packets = 64);
+
+    size_t              getWorkerCount() const;
+    static int          currentWorker();
+
+    uint64_t            getExecutedCount() const;
+    uint64_t            getStolenCount() const;
+    uint64_t            getRejectedCount() const;
+
+private:
+    struct Worker
+    {
+                        Worker(size_t capacity, uint64_t seed)
+                            : deque(capacity), pinned(capacity), rng(seed), executed(0), stolen(0) {}
+
+        ChaseLevDeque<ExecutorTask *> deque;
+        MpmcQueue<ExecutorTask *> pinned;
+        std::thread     thread;
+        uint64_t        rng;
+        std::atomic<uint64_t> executed;
+        std::atomic<uint64_t> stolen;
+    };
+
+    struct PacketTask
+        : public ExecutorTask
+    {
+        WorkStealingExecutor * executor;
+        PacketHandler   handler;
+        void *          user;
+        UdpPacketView   view;
+    };
+
+                        WorkStealingExecutor(const WorkStealingExecutor&);
+    WorkStealingExecutor& operator = (const WorkStealingExecutor&);
+
+    static void         runPacket(ExecutorTask *task);
+
+    void                workerLoop(size_t index);
+    ExecutorTask *      findTask(size_t index);
+
+    std::vector<std::unique_ptr<Worker>> f_workers_;
+    MpmcQueue<ExecutorTask *> f_injection_;
+    std::vector<char>   f_arena_;
+    std::vector<PacketTask> f_packets_;
+    MpmcQueue<PacketTask *> f_free_packets_;
+    size_t              f_slot_size_;
+    std::atomic<bool>   f_running_;
+    std::atomic<uint64_t> f_rejected_;
+};
+
+} // namespace udp_client_server
+
+#endif
+// UDP_CLIENT_SERVER_WORK_STEALING_EXECUTOR_H
+// vim: ts=4 sw=4 et
@@ -0,0 +1,135 @@
+// XDP Socket -- UDP over AF_XDP, bypassing the kernel UDP stack
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_XDP_SOCKET_H
+#define UDP_CLIENT_SERVER_XDP_SOCKET_H
+
+#include "udp_client_server.h"
+#include <stdint.h>
+#include <linux/if_xdp.h>
+#include <vector>
+
+namespace udp_client_server
+{
+
+/** \brief UDP endpoint on an AF_XDP socket.
+ *
+ * An XDP program attached to the interface redirects the IPv4 UDP
+ * datagrams sent to the configured port to this socket; everything else
+ * continues to the kernel stack. Datagrams are received from and sent
+ * through a region of memory (the UMEM) shared with the kernel, cut in
+ * frames that travel between four rings:
+ *
+ * \li fill: frames given to the kernel to receive in,
+ * \li rx: frames holding received packets,
+ * \li tx: frames holding packets to send,
+ * \li completion: frames the kernel is done sending.
+ *
+ * The send/receive functions are the ones of UdpClient and UdpServer.
+ * Headers are built and parsed here, so the destination hardware address
+ * must be known (see setDestination().) IP options and fragments are not
+ * handled; such packets are left to the kernel.
+ *
+ * By default the program is attached in generic (SKB) mode which works
+ * with any driver, i.e. veth pairs, at the cost of a copy. This requires
+ * CAP_NET_ADMIN and CAP_BPF (or CAP_SYS_ADMIN) and Linux 5.9 or newer.
+ *
+ * One socket serves one queue of the interface; to receive everything
+ * the NIC must steer the port to that queue (i.e. with ethtool -N) or
+ * have a single queue. Not thread safe.
+ */
+class XdpSocket
+{
+public:
+    static const size_t DEFAULT_FRAME_COUNT = 4096;
+    static const size_t DEFAULT_FRAME_SIZE = 2048;
+
+                        XdpSocket(const std::string& ifname, const std::string& addr, int port,
+                                  int queue_id = 0, bool generic_mode = true,
+                                  size_t frame_count = DEFAULT_FRAME_COUNT,
+                                  size_t frame_size = DEFAULT_FRAME_SIZE);
+                        ~XdpSocket();
+
+    int                 getSocket() const;
+    int                 getPort() const;
+    std::string         getAddr() const;
+
+    int                 setDestination(const std::string& addr, int port, const uint8_t *mac = NULL);
+
+    int                 send(const char *msg, size_t size);
+    int                 sendv(const struct iovec *iov, size_t iovcnt);
+
+    int                 recv(char *msg, size_t max_size);
+    int                 recvView(char *msg, size_t max_size, UdpPacketView& view);
+    int                 timedRecv(char *msg, size_t max_size, int max_wait_ms);
+    int                 timedRecvView(char *msg, size_t max_size, UdpPacketView& view, int max_wait_ms);
+
+    int64_t             getRxDropCount() const;
+
+private:
+    struct Ring
+    {
+        uint32_t *      producer;
+        uint32_t *      consumer;
+        uint32_t *      flags;
+        void *          descs;
+        uint32_t        mask;
+        void *          map;
+        size_t          map_size;
+    };
+
+                        XdpSocket(const XdpSocket&);
+    XdpSocket&          operator = (const XdpSocket&);
+
+    void                mapRing(Ring& ring, uint32_t size, const struct xdp_ring_offset& offset,
+                                size_t desc_size, off_t pgoff);
+    void                loadProgram(int queue_id, bool generic_mode);
+    void                release();
+
+    void                refill(uint64_t addr);
+    void                reclaim();
+    int                 receive(char *msg, size_t max_size, UdpPacketView *view, int max_wait_ms);
+
+    int                 f_socket_;
+    int                 f_map_fd_;
+    int                 f_prog_fd_;
+    int                 f_link_fd_;
+    unsigned int        f_ifindex_;
+    int                 f_port_;
+    std::string         f_addr_;
+    uint32_t            f_local_ip_;
+    uint8_t             f_local_mac_[6];
+    uint32_t            f_dest_ip_;
+    uint16_t            f_dest_port_;
+    uint8_t             f_dest_mac_[6];
+    bool                f_has_destination_;
+    uint16_t            f_ip_id_;
+    unsigned char *     f_umem_;
+    size_t              f_umem_size_;
+    size_t              f_frame_size_;
+    Ring                f_fill_;
+    Ring                f_completion_;
+    Ring                f_rx_;
+    Ring                f_tx_;
+    std::vector<uint64_t> f_tx_frames_;
+};
+
+} // namespace udp_client_server
+
+#endif
+// UDP_CLIENT_SERVER_XDP_SOCKET_H
+// vim: ts=4 sw=4 et
@@ -0,0 +1,124 @@
+// Basic UDP Socket -- UDP socket configured by compile-time policies
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_BASIC_UDP_SOCKET_CPP
+#define UDP_CLIENT_SERVER_BASIC_UDP_SOCKET_CPP
+
+#include <basic_udp_socket.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace udp_client_server
+{
+
+/** \brief Resolve \p addr and create a UDP socket for it.
+ *
+ * This is the socket creation shared by UdpClient, UdpServer and
+ * BasicUdpSocket. Only the first address found by getaddrinfo() is used.
+ * The socket is close-on-exec.
+ *
+ * \exception UdpClientServerRuntimeError
+ * The address and port cannot be resolved, or the socket cannot be
+ * created or bound.
+ *
+ * \param[in] addr  The address to convert to a numeric IP.
+ * \param[in] port  The port number.
+ * \param[in] family  AF_UNSPEC, AF_INET or AF_INET6.
+ * \param[in] flags  Extra socket type flags, i.e. SOCK_NONBLOCK.
+ * \param[in] bind_address  Whether the socket gets bound to the address.
+ * \param[out] addrinfo  The resolved address, to free with freeaddrinfo().
+ *
+ * \return The socket.
+ */
+int openUdpSocket(const std::string& addr, int port, int family, int flags,
+                  bool bind_address, struct addrinfo *& addrinfo)
+{
+    char decimal_port[16];
+    snprintf(decimal_port, sizeof(decimal_port), "%d", port);
+    decimal_port[sizeof(decimal_port) / sizeof(decimal_port[0]) - 1] = '\0';
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = family;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_protocol = IPPROTO_UDP;
+    addrinfo = NULL;
+    int r(getaddrinfo(addr.c_str(), decimal_port, &hints, &addrinfo));
+    if(r != 0 || addrinfo == NULL)
+    {
+        throw UdpClientServerRuntimeError(("invalid address or port for UDP socket: \"" + addr + ":" + decimal_port + "\"").c_str());
+    }
+    int const s(socket(addrinfo->ai_family, SOCK_DGRAM | SOCK_CLOEXEC | flags, IPPROTO_UDP));
+    if(s == -1)
+    {
+        freeaddrinfo(addrinfo);
+        throw UdpClientServerRuntimeError(("could not create UDP socket for: \"" + addr + ":" + decimal_port + "\"").c_str());
+    }
+    if(bind_address)
+    {
+        r = bind(s, addrinfo->ai_addr, addrinfo->ai_addrlen);
+        if(r != 0)
+        {
+            int const e(errno);
+            freeaddrinfo(addrinfo);
+            close(s);
+            throw UdpClientServerRuntimeError(("could not bind UDP socket with: \"" + addr + ":" + decimal_port + ". errno: " + std::to_string(e) + "\"").c_str());
+        }
+    }
+    return s;
+}
+
+/** \brief Resolve \p addr and \p port to a socket address.
+ *
+ * Used by the classes which send to addresses other than the one of
+ * their socket. Only the first address found by getaddrinfo() is used.
+ *
+ * \exception UdpClientServerRuntimeError
+ * The address and port cannot be resolved.
+ *
+ * \param[in] addr  The address to convert to a numeric IP.
+ * \param[in] port  The port number.
+ * \param[in] family  AF_UNSPEC, AF_INET or AF_INET6.
+ * \param[out] result  The resolved address.
+ *
+ * \return The size of the address saved in \p result.
+ */
+socklen_t resolveUdpAddress(const std::string& addr, int port, int family, struct sockaddr_storage& result)
+{
+    char decimal_port[16];
+    snprintf(decimal_port, sizeof(decimal_port), "%d", port);
+    decimal_port[sizeof(decimal_port) / sizeof(decimal_port[0]) - 1] = '\0';
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = family;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_protocol = IPPROTO_UDP;
+    struct addrinfo *info(NULL);
+    if(getaddrinfo(addr.c_str(), decimal_port, &hints, &info) != 0 || info == NULL)
+    {
+        throw UdpClientServerRuntimeError(("invalid address or port for UDP socket: \"" + addr + ":" + decimal_port + "\"").c_str());
+    }
+    memset(&result, 0, sizeof(result));
+    memcpy(&result, info->ai_addr, info->ai_addrlen);
+    socklen_t const len(info->ai_addrlen);
+    freeaddrinfo(info);
+    return len;
+}
+
+} // namespace udp_client_server
+#endif
+// vim: ts=4 sw=4 et
@@ -0,0 +1,878 @@
+// Bulk Stream -- delay-based congestion control for bulk transfers
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_BULK_STREAM_CPP
+#define UDP_CLIENT_SERVER_BULK_STREAM_CPP
+
+#include <bulk_stream.h>
+#include <errno.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <algorithm>
+
+namespace udp_client_server
+{
+
+namespace
+{
+
+/** \brief Compare two 32 bit counters or timestamps that may wrap.
+ *
+ * \return true if \p a comes before \p b.
+ */
+bool serialBefore(uint32_t a, uint32_t b)
+{
+    return static_cast<int32_t>(a - b) < 0;
+}
+
+/** \brief Fill the sizes a sender left to 0 from its client.
+ */
+LedbatParameters senderParameters(const UdpClient& client, LedbatParameters parameters)
+{
+    if(parameters.mss == 0)
+    {
+        parameters.mss = client.maxPayload();
+    }
+    return parameters;
+}
+
+void write32(char *buffer, uint32_t value)
+{
+    uint32_t const v(htonl(value));
+    memcpy(buffer, &v, sizeof(v));
+}
+
+uint32_t read32(const char *buffer)
+{
+    uint32_t v;
+    memcpy(&v, buffer, sizeof(v));
+    return ntohl(v);
+}
+
+} // no name namespace
+
+
+const uint8_t BulkDataHeader::DATA;
+const size_t BulkDataHeader::SIZE;
+const uint8_t BulkFeedback::FEEDBACK;
+const size_t BulkFeedback::SIZE;
+const size_t LedbatController::BASE_HISTORY;
+const uint64_t LedbatController::BASE_INTERVAL_NS;
+const size_t LedbatController::CURRENT_FILTER;
+const uint64_t LedbatController::INITIAL_RTT_NS;
+const uint64_t BulkSender::BURST_NS;
+const uint64_t BulkSender::NO_FEEDBACK_RTTS;
+const size_t BulkSender::MAX_BACKOFF;
+
+
+/** \brief Serialize the header in the first SIZE bytes of \p buffer.
+ */
+void BulkDataHeader::write(char *buffer) const
+{
+    buffer[0] = static_cast<char>(kind);
+    buffer[1] = static_cast<char>(flags);
+    buffer[2] = 0;
+    buffer[3] = 0;
+    write32(buffer + 4, sequence);
+    write32(buffer + 8, send_time_us);
+}
+
+/** \brief Parse a header from \p buffer.
+ *
+ * \return true if the buffer holds a data header.
+ */
+bool BulkDataHeader::read(const char *buffer, size_t size)
+{
+    if(size < SIZE)
+    {
+        return false;
+    }
+    kind = static_cast<uint8_t>(buffer[0]);
+    flags = static_cast<uint8_t>(buffer[1]);
+    sequence = read32(buffer + 4);
+    send_time_us = read32(buffer + 8);
+    return kind == DATA;
+}
+
+
+/** \brief Serialize the feedback in the first SIZE bytes of \p buffer.
+ */
+void BulkFeedback::write(char *buffer) const
+{
+    buffer[0] = static_cast<char>(kind);
+    buffer[1] = static_cast<char>(flags);
+    buffer[2] = 0;
+    buffer[3] = 0;
+    write32(buffer + 4, highest_sequence);
+    write32(buffer + 8, received_packets);
+    write32(buffer + 12, received_bytes);
+    write32(buffer + 16, delay_us);
+    write32(buffer + 20, echo_us);
+    write32(buffer + 24, hold_us);
+}
+
+/** \brief Parse a feedback from \p buffer.
+ *
+ * \return true if the buffer holds a feedback.
+ */
+bool BulkFeedback::read(const char *buffer, size_t size)
+{
+    if(size < SIZE)
+    {
+        return false;
+    }
+    kind = static_cast<uint8_t>(buffer[0]);
+    flags = static_cast<uint8_t>(buffer[1]);
+    highest_sequence = read32(buffer + 4);
+    received_packets = read32(buffer + 8);
+    received_bytes = read32(buffer + 12);
+    delay_us = read32(buffer + 16);
+    echo_us = read32(buffer + 20);
+    hold_us = read32(buffer + 24);
+    return kind == FEEDBACK;
+}
+
+
+/** \brief Initialize a controller in slow start.
+ *
+ * \param[in] parameters  The target delay, gain and limits; the sizes
+ * left to 0 get their documented defaults.
+ *
+ * \exception UdpClientServerRuntimeError
+ * The target delay, the gain or the window limits are invalid.
+ */
+LedbatController::LedbatController(const LedbatParameters& parameters)
+    : f_parameters_(parameters)
+    , f_cwnd_(0.0)
+    , f_rate_(0)
+    , f_srtt_ns_(0)
+    , f_queuing_delay_ns_(0)
+    , f_slow_start_(true)
+    , f_last_loss_ns_(0)
+    , f_base_count_(0)
+    , f_base_started_ns_(0)
+    , f_current_count_(0)
+{
+    if(f_parameters_.mss == 0)
+    {
+        f_parameters_.mss = 1400;
+    }
+    if(f_parameters_.initial_cwnd == 0)
+    {
+        f_parameters_.initial_cwnd = 4 * f_parameters_.mss;
+    }
+    if(f_parameters_.min_cwnd == 0)
+    {
+        f_parameters_.min_cwnd = 2 * f_parameters_.mss;
+    }
+    if(f_parameters_.target_delay_ns == 0
+    || f_parameters_.gain <= 0.0
+    || f_parameters_.min_cwnd > f_parameters_.max_cwnd
+    || (f_parameters_.max_rate != 0 && f_parameters_.min_rate > f_parameters_.max_rate))
+    {
+        throw UdpClientServerRuntimeError("invalid LEDBAT parameters");
+    }
+    f_cwnd_ = static_cast<double>(std::min(std::max(f_parameters_.initial_cwnd, f_parameters_.min_cwnd)
+                                         , f_parameters_.max_cwnd));
+    updateRate();
+}
+
+/** \brief Update the window with the feedback of the receiver.
+ *
+ * \param[in] now_ns  The current monotonic time.
+ * \param[in] acked_bytes  The bytes received since the previous feedback.
+ * \param[in] lost_packets  The packets lost since the previous feedback.
+ * \param[in] delay_us  The one-way delay measured by the receiver, on
+ * clocks that may have any constant offset.
+ * \param[in] rtt_ns  The round trip time measured with this feedback,
+ * 0 if unknown.
+ * \param[in] rate_limited  Whether the sender was held back by the
+ * pacing rate since the previous feedback; the window does not grow
+ * when the application did not use it.
+ */
+void LedbatController::onFeedback(uint64_t now_ns, size_t acked_bytes, uint32_t lost_packets,
+                                  uint32_t delay_us, uint64_t rtt_ns, bool rate_limited)
+{
+    if(rtt_ns != 0)
+    {
+        f_srtt_ns_ = f_srtt_ns_ == 0 ? rtt_ns : (f_srtt_ns_ * 7 + rtt_ns) / 8;
+    }
+    updateBaseDelay(now_ns, delay_us);
+    updateCurrentDelay(delay_us);
+
+    double const mss(static_cast<double>(f_parameters_.mss));
+    if(lost_packets > 0)
+    {
+        // at most one decrease per round trip, the losses of a single
+        // congestion event are usually reported over several feedbacks
+        uint64_t const srtt(f_srtt_ns_ != 0 ? f_srtt_ns_ : INITIAL_RTT_NS);
+        if(f_last_loss_ns_ == 0
+        || now_ns - f_last_loss_ns_ >= srtt)
+        {
+            f_cwnd_ /= 2.0;
+            f_last_loss_ns_ = now_ns;
+        }
+        f_slow_start_ = false;
+    }
+    else
+    {
+        double const target(static_cast<double>(f_parameters_.target_delay_ns));
+        double const queuing(static_cast<double>(f_queuing_delay_ns_));
+        if(f_slow_start_)
+        {
+            if(queuing > target * 0.75)
+            {
+                f_slow_start_ = false;
+            }
+            else if(rate_limited)
+            {
+                f_cwnd_ += static_cast<double>(acked_bytes);
+            }
+        }
+        if(!f_slow_start_)
+        {
+            // the change below is per round trip, which acknowledges
+            // about one window of data
+            double const window(f_cwnd_ / mss);
+            double const fraction(std::min(1.0, static_cast<double>(acked_bytes) / f_cwnd_));
+            double delta(0.0);
+            if(queuing <= target)
+            {
+                if(rate_limited)
+                {
+                    delta = f_parameters_.gain * (target - queuing) / target;
+                }
+            }
+            else
+            {
+                delta = std::max(f_parameters_.gain - window * (queuing / target - 1.0), -window / 2.0);
+            }
+            f_cwnd_ += delta * mss * fraction;
+        }
+    }
+    f_cwnd_ = std::min(std::max(f_cwnd_, static_cast<double>(f_parameters_.min_cwnd))
+                     , static_cast<double>(f_parameters_.max_cwnd));
+    updateRate();
+}
+
+/** \brief Collapse the window after the feedback stopped coming.
+ *
+ * Without feedback the sender cannot tell congestion from a dead
+ * return path, so it assumes the worst: the window drops to its minimum
+ * and grows again from there once feedback resumes.
+ *
+ * \param[in] now_ns  The current monotonic time.
+ */
+void LedbatController::onTimeout(uint64_t now_ns)
+{
+    f_cwnd_ = static_cast<double>(f_parameters_.min_cwnd);
+    f_slow_start_ = false;
+    // the losses of the timed out window show up in the next feedbacks,
+    // they must not halve the window again
+    f_last_loss_ns_ = now_ns;
+    updateRate();
+}
+
+/** \brief Record a delay sample in the base delay history.
+ *
+ * The history keeps the smallest delay of each of the last BASE_HISTORY
+ * minutes, so the base delay follows a route change within that time.
+ */
+void LedbatController::updateBaseDelay(uint64_t now_ns, uint32_t delay_us)
+{
+    if(f_base_count_ == 0
+    || now_ns - f_base_started_ns_ >= BASE_INTERVAL_NS)
+    {
+        if(f_base_count_ == BASE_HISTORY)
+        {
+            std::copy(f_base_history_ + 1, f_base_history_ + BASE_HISTORY, f_base_history_);
+            --f_base_count_;
+        }
+        f_base_history_[f_base_count_] = delay_us;
+        ++f_base_count_;
+        f_base_started_ns_ = now_ns;
+    }
+    else if(serialBefore(delay_us, f_base_history_[f_base_count_ - 1]))
+    {
+        f_base_history_[f_base_count_ - 1] = delay_us;
+    }
+}
+
+/** \brief Record a delay sample and compute the queuing delay.
+ *
+ * The current delay is the smallest of the last CURRENT_FILTER samples,
+ * which filters out the delay spikes of a single packet.
+ */
+void LedbatController::updateCurrentDelay(uint32_t delay_us)
+{
+    f_current_filter_[f_current_count_ % CURRENT_FILTER] = delay_us;
+    ++f_current_count_;
+
+    uint32_t current(f_current_filter_[0]);
+    for(size_t i(1); i < std::min(f_current_count_, CURRENT_FILTER); ++i)
+    {
+        if(serialBefore(f_current_filter_[i], current))
+        {
+            current = f_current_filter_[i];
+        }
+    }
+    uint32_t base(f_base_history_[0]);
+    for(size_t i(1); i < f_base_count_; ++i)
+    {
+        if(serialBefore(f_base_history_[i], base))
+        {
+            base = f_base_history_[i];
+        }
+    }
+    f_queuing_delay_ns_ = serialBefore(current, base) ? 0 : static_cast<uint64_t>(current - base) * 1000;
+}
+
+/** \brief Derive the pacing rate from the window and round trip time.
+ */
+void LedbatController::updateRate()
+{
+    uint64_t const srtt(f_srtt_ns_ != 0 ? f_srtt_ns_ : INITIAL_RTT_NS);
+    double const rate(f_cwnd_ * 1e9 / static_cast<double>(srtt));
+    f_rate_ = rate > 1.8e19 ? UINT64_MAX : static_cast<uint64_t>(rate);
+    f_rate_ = std::max(f_rate_, f_parameters_.min_rate);
+    if(f_parameters_.max_rate != 0)
+    {
+        f_rate_ = std::min(f_rate_, f_parameters_.max_rate);
+    }
+}
+
+/** \brief The parameters in use, with the defaults filled in.
+ */
+const LedbatParameters& LedbatController::getParameters() const
+{
+    return f_parameters_;
+}
+
+/** \brief The congestion window in bytes.
+ */
+size_t LedbatController::getCwnd() const
+{
+    return static_cast<size_t>(f_cwnd_);
+}
+
+/** \brief The pacing rate in bytes per second.
+ */
+uint64_t LedbatController::getRate() const
+{
+    return f_rate_;
+}
+
+/** \brief The smoothed round trip time in nanoseconds, 0 until measured.
+ */
+uint64_t LedbatController::getSrtt() const
+{
+    return f_srtt_ns_;
+}
+
+/** \brief The last queuing delay estimate in nanoseconds.
+ */
+uint64_t LedbatController::getQueuingDelay() const
+{
+    return f_queuing_delay_ns_;
+}
+
+/** \brief Whether the controller is still in slow start.
+ */
+bool LedbatController::inSlowStart() const
+{
+    return f_slow_start_;
+}
+
+
+/** \brief Initialize a bulk sender on \p client.
+ *
+ * The client socket receives the feedback of the BulkReceiver, so the
+ * receiver must answer to the address the client sends from.
+ *
+ * \param[in] client  The client sending the stream.
+ * \param[in] parameters  The congestion control parameters; a 0 mss
+ * uses the largest payload that avoids IP fragmentation.
+ *
+ * \exception UdpClientServerRuntimeError
+ * The parameters are invalid.
+ */
+BulkSender::BulkSender(UdpClient& client, const LedbatParameters& parameters)
+    : f_client_(client)
+    , f_controller_(senderParameters(client, parameters))
+    , f_next_sequence_(1)
+    , f_highest_acked_(0)
+    , f_sent_bytes_(0)
+    , f_next_send_ns_(0)
+    , f_last_progress_ns_(0)
+    , f_backoff_(0)
+    , f_rate_limited_(false)
+    , f_has_feedback_(false)
+    , f_received_packets_(0)
+    , f_received_bytes_(0)
+    , f_lost_packets_(0)
+    , f_sent_(0)
+    , f_lost_(0)
+    , f_feedbacks_(0)
+    , f_timeouts_(0)
+{
+}
+
+/** \brief Send one datagram of the stream if the pacing rate allows it.
+ *
+ * Up to BURST_NS worth of datagrams can be sent back to back to catch
+ * up after the caller was late.
+ *
+ * \param[in] msg  The payload.
+ * \param[in] size  The size of the payload.
+ * \param[in] now_ns  The current monotonic time.
+ *
+ * \return The size of the payload, or -1 if an error occurs. errno is
+ * set accordingly (EAGAIN when it is too early to send, see
+ * nextSendTime(), or when the window is full until the next feedback.)
+ */
+int BulkSender::send(const char *msg, size_t size, uint64_t now_ns)
+{
+    checkTimeout(now_ns);
+    if(now_ns < f_next_send_ns_
+    || getFlightSize() >= f_controller_.getCwnd())
+    {
+        f_rate_limited_ = true;
+        errno = EAGAIN;
+        return -1;
+    }
+
+    BulkDataHeader header;
+    header.kind = BulkDataHeader::DATA;
+    header.flags = 0;
+    header.sequence = f_next_sequence_;
+    header.send_time_us = static_cast<uint32_t>(now_ns / 1000);
+    header.write(f_header_);
+
+    struct iovec iov[2];
+    iov[0].iov_base = f_header_;
+    iov[0].iov_len = BulkDataHeader::SIZE;
+    iov[1].iov_base = const_cast<char *>(msg);
+    iov[1].iov_len = size;
+    if(f_client_.sendv(iov, 2) < 0)
+    {
+        return -1;
+    }
+    if(getFlightSize() == 0)
+    {
+        // the no feedback timeout counts from the oldest data in flight
+        f_last_progress_ns_ = now_ns;
+    }
+    ++f_next_sequence_;
+    ++f_sent_;
+    f_sent_bytes_ += size + BulkDataHeader::SIZE;
+
+    uint64_t const start(now_ns > BURST_NS ? std::max(f_next_send_ns_, now_ns - BURST_NS) : f_next_send_ns_);
+    f_next_send_ns_ = start + (size + BulkDataHeader::SIZE) * 1000000000ULL / f_controller_.getRate();
+    if(f_next_send_ns_ > now_ns)
+    {
+        f_rate_limited_ = true;
+    }
+    return static_cast<int>(size);
+}
+
+/** \brief Monotonic time at which send() accepts the next datagram.
+ */
+uint64_t BulkSender::nextSendTime() const
+{
+    return f_next_send_ns_;
+}
+
+/** \brief Estimate of the bytes sent and not yet reported received.
+ *
+ * Counts the datagrams sent after the highest sequence the receiver
+ * reported, at the average size of the datagrams sent so far.
+ */
+size_t BulkSender::getFlightSize() const
+{
+    if(f_sent_ == 0)
+    {
+        return 0;
+    }
+    uint32_t const packets(f_next_sequence_ - 1 - f_highest_acked_);
+    return static_cast<size_t>(packets * (f_sent_bytes_ / f_sent_));
+}
+
+/** \brief Read the feedback received and update the pacing rate.
+ *
+ * Call this function when the client socket is readable, or at least
+ * once per feedback interval of the receiver while sending; it also
+ * checks the no feedback timeout.
+ *
+ * \param[in] now_ns  The current monotonic time.
+ * \param[in] max_feedbacks  The maximum number of datagrams read.
+ *
+ * \return The number of feedbacks processed, or -1 if the socket
+ * reported an error. errno is set accordingly.
+ */
+int BulkSender::poll(uint64_t now_ns, size_t max_feedbacks)
+{
+    int processed(0);
+    for(size_t count(0); count < max_feedbacks; ++count)
+    {
+        int const r(::recv(f_client_.getSocket(), f_buffer_, sizeof(f_buffer_), 0));
+        if(r < 0)
+        {
+            if(errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+            if(errno == ECONNREFUSED || errno == EINTR)
+            {
+                // the receiver is not there yet
+                continue;
+            }
+            return -1;
+        }
+        BulkFeedback feedback;
+        if(!feedback.read(f_buffer_, static_cast<size_t>(r)))
+        {
+            continue;
+        }
+        onFeedback(feedback, now_ns);
+        ++processed;
+    }
+    checkTimeout(now_ns);
+    return processed;
+}
+
+/** \brief Give up on the data in flight when the feedback stopped.
+ *
+ * After NO_FEEDBACK_RTTS smoothed round trips without feedback, backed
+ * off at each consecutive expiry, the window collapses and the data in
+ * flight is considered gone so send() accepts a probe datagram.
+ */
+void BulkSender::checkTimeout(uint64_t now_ns)
+{
+    if(getFlightSize() == 0)
+    {
+        return;
+    }
+    // before the first measure, the controller paces with a 100 ms rtt
+    uint64_t const srtt(f_controller_.getSrtt() != 0 ? f_controller_.getSrtt() : 100000000ULL);
+    uint64_t const timeout((srtt * NO_FEEDBACK_RTTS) << f_backoff_);
+    if(now_ns - f_last_progress_ns_ < timeout)
+    {
+        return;
+    }
+    f_controller_.onTimeout(now_ns);
+    f_highest_acked_ = f_next_sequence_ - 1;
+    f_next_send_ns_ = now_ns;
+    f_last_progress_ns_ = now_ns;
+    f_backoff_ = std::min(f_backoff_ + 1, MAX_BACKOFF);
+    ++f_timeouts_;
+}
+
+/** \brief Feed one feedback to the controller.
+ *
+ * Feedbacks arriving out of order are ignored since the counters are
+ * cumulative.
+ */
+void BulkSender::onFeedback(const BulkFeedback& feedback, uint64_t now_ns)
+{
+    if(f_has_feedback_
+    && !serialBefore(f_received_packets_, feedback.received_packets))
+    {
+        return;
+    }
+
+    // sequences start at 1, anything not received up to the highest one
+    // is lost (or reordered, in which case it shows up later)
+    uint32_t lost_packets(feedback.highest_sequence - feedback.received_packets);
+    if(static_cast<int32_t>(lost_packets) < 0)
+    {
+        lost_packets = 0;
+    }
+    uint32_t const acked(feedback.received_bytes - f_received_bytes_);
+    uint32_t lost(0);
+    if(serialBefore(f_lost_packets_, lost_packets))
+    {
+        lost = lost_packets - f_lost_packets_;
+        f_lost_packets_ = lost_packets;
+    }
+
+    uint32_t const rtt_us(static_cast<uint32_t>(now_ns / 1000) - feedback.echo_us - feedback.hold_us);
+    uint64_t const rtt_ns(static_cast<int32_t>(rtt_us) > 0 ? static_cast<uint64_t>(rtt_us) * 1000 : 0);
+
+    f_controller_.onFeedback(now_ns, acked, lost, feedback.delay_us, rtt_ns, f_rate_limited_);
+    f_rate_limited_ = false;
+    f_has_feedback_ = true;
+    f_last_progress_ns_ = now_ns;
+    f_backoff_ = 0;
+    if(serialBefore(f_highest_acked_, feedback.highest_sequence))
+    {
+        f_highest_acked_ = feedback.highest_sequence;
+    }
+    f_received_packets_ = feedback.received_packets;
+    f_received_bytes_ = feedback.received_bytes;
+    f_lost_ += lost;
+    ++f_feedbacks_;
+}
+
+/** \brief The controller setting the pacing rate.
+ */
+const LedbatController& BulkSender::getController() const
+{
+    return f_controller_;
+}
+
+/** \brief Number of datagrams sent.
+ */
+uint64_t BulkSender::getSentCount() const
+{
+    return f_sent_;
+}
+
+/** \brief Number of datagrams the receiver reported lost.
+ */
+uint64_t BulkSender::getLostCount() const
+{
+    return f_lost_;
+}
+
+/** \brief Number of feedbacks processed.
+ */
+uint64_t BulkSender::getFeedbackCount() const
+{
+    return f_feedbacks_;
+}
+
+/** \brief Number of times the feedback timed out.
+ */
+uint64_t BulkSender::getTimeoutCount() const
+{
+    return f_timeouts_;
+}
+
+
+/** \brief Initialize a receiver of bulk streams on \p server.
+ *
+ * \param[in] server  The server receiving the stream.
+ * \param[in] feedback_interval_ns  The minimum time between two
+ * feedbacks; it should stay well below the round trip time.
+ * \param[in] max_size  The largest datagram accepted, header included.
+ *
+ * \exception UdpClientServerRuntimeError
+ * The maximum size cannot hold a header, or the kernel timestamps
+ * cannot be turned on.
+ */
+BulkReceiver::BulkReceiver(UdpServer& server, uint64_t feedback_interval_ns, size_t max_size)
+    : f_server_(server)
+    , f_feedback_interval_ns_(feedback_interval_ns)
+    , f_callback_(NULL)
+    , f_user_(NULL)
+    , f_buffer_(max_size)
+    , f_source_len_(0)
+    , f_started_(false)
+    , f_pending_(false)
+    , f_first_sequence_(0)
+    , f_highest_sequence_(0)
+    , f_highest_send_time_us_(0)
+    , f_highest_arrival_ns_(0)
+    , f_received_packets_(0)
+    , f_received_bytes_(0)
+    , f_min_delay_us_(0)
+    , f_last_feedback_ns_(0)
+    , f_received_(0)
+    , f_invalid_(0)
+    , f_feedbacks_(0)
+{
+    if(max_size < BulkDataHeader::SIZE)
+    {
+        throw UdpClientServerRuntimeError("bulk receiver buffer too small for a header");
+    }
+    int const on(1);
+    if(setsockopt(f_server_.getSocket(), SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) != 0)
+    {
+        throw UdpClientServerRuntimeError("could not enable SO_TIMESTAMPNS for the bulk receiver");
+    }
+    memset(&f_source_, 0, sizeof(f_source_));
+}
+
+/** \brief Set the function receiving the payloads.
+ *
+ * The payloads are delivered in arrival order; the data is only valid
+ * during the call.
+ */
+void BulkReceiver::setCallback(Callback callback, void *user)
+{
+    f_callback_ = callback;
+    f_user_ = user;
+}
+
+/** \brief Receive the pending datagrams and send feedback when due.
+ *
+ * The arrival time of each datagram is its kernel timestamp, moved to
+ * the clock of \p now_ns: a datagram that waited in the socket buffer
+ * gets the time it arrived, not the time it was read.
+ *
+ * Datagrams longer than the receive buffer are truncated by the kernel;
+ * they are counted as invalid rather than delivered.
+ *
+ * \param[in] now_ns  The current monotonic time.
+ * \param[in] max_datagrams  The maximum number of datagrams read,
+ * invalid ones included.
+ *
+ * \return The number of payloads delivered, or -1 if the socket
+ * reported an error before any was. errno is set accordingly.
+ */
+int BulkReceiver::poll(uint64_t now_ns, size_t max_datagrams)
+{
+    int delivered(0);
+    // the kernel stamps the datagrams with CLOCK_REALTIME
+    struct timespec realtime;
+    clock_gettime(CLOCK_REALTIME, &realtime);
+    uint64_t const realtime_ns(static_cast<uint64_t>(realtime.tv_sec) * 1000000000ULL + static_cast<uint64_t>(realtime.tv_nsec));
+    for(size_t count(0); count < max_datagrams; ++count)
+    {
+        UdpPacketView view;
+        int const r(f_server_.recvView(&f_buffer_[0], f_buffer_.size(), view));
+        if(r < 0)
+        {
+            if(errno == EAGAIN || errno == EWOULDBLOCK || delivered > 0)
+            {
+                break;
+            }
+            return -1;
+        }
+        BulkDataHeader header;
+        if(view.wire_size > view.size
+        || !header.read(view.data, view.size))
+        {
+            ++f_invalid_;
+            continue;
+        }
+        if(!f_started_
+        || view.source_len != f_source_len_
+        || memcmp(&view.source, &f_source_, view.source_len) != 0)
+        {
+            restart(view.source, view.source_len, header.sequence);
+        }
+        if(!serialBefore(header.sequence, f_first_sequence_))
+        {
+            uint64_t const age_ns(realtime_ns > view.timestamp_ns ? realtime_ns - view.timestamp_ns : 0);
+            uint64_t const arrival_ns(now_ns > age_ns ? now_ns - age_ns : 0);
+            uint32_t const delay_us(static_cast<uint32_t>(arrival_ns / 1000) - header.send_time_us);
+            if(!f_pending_
+            || serialBefore(delay_us, f_min_delay_us_))
+            {
+                f_min_delay_us_ = delay_us;
+            }
+            if(serialBefore(f_highest_sequence_, header.sequence))
+            {
+                f_highest_sequence_ = header.sequence;
+                f_highest_send_time_us_ = header.send_time_us;
+                f_highest_arrival_ns_ = arrival_ns;
+            }
+            ++f_received_packets_;
+            f_received_bytes_ += static_cast<uint32_t>(view.size);
+            f_pending_ = true;
+        }
+        ++f_received_;
+        ++delivered;
+        if(f_callback_ != NULL)
+        {
+            f_callback_(f_user_, view.data + BulkDataHeader::SIZE, view.size - BulkDataHeader::SIZE);
+        }
+    }
+
+    if(f_pending_
+    && now_ns - f_last_feedback_ns_ >= f_feedback_interval_ns_)
+    {
+        sendFeedback(now_ns);
+    }
+    return delivered;
+}
+
+/** \brief Start following the stream of a new source.
+ */
+void BulkReceiver::restart(const struct sockaddr_storage& source, socklen_t source_len, uint32_t sequence)
+{
+    memcpy(&f_source_, &source, source_len);
+    f_source_len_ = source_len;
+    f_started_ = true;
+    f_pending_ = false;
+    f_first_sequence_ = sequence;
+    f_highest_sequence_ = sequence - 1;
+    f_received_packets_ = 0;
+    f_received_bytes_ = 0;
+    f_last_feedback_ns_ = 0;
+}
+
+/** \brief Send the feedback of the data received since the last one.
+ */
+void BulkReceiver::sendFeedback(uint64_t now_ns)
+{
+    BulkFeedback feedback;
+    feedback.kind = BulkFeedback::FEEDBACK;
+    feedback.flags = 0;
+    feedback.highest_sequence = f_highest_sequence_;
+    feedback.received_packets = f_received_packets_;
+    feedback.received_bytes = f_received_bytes_;
+    feedback.delay_us = f_min_delay_us_;
+    feedback.echo_us = f_highest_send_time_us_;
+    feedback.hold_us = static_cast<uint32_t>((now_ns - f_highest_arrival_ns_) / 1000);
+
+    char buffer[BulkFeedback::SIZE];
+    feedback.write(buffer);
+    sendto(f_server_.getSocket(), buffer, sizeof(buffer), 0
+         , reinterpret_cast<const struct sockaddr *>(&f_source_), f_source_len_);
+    f_pending_ = false;
+    f_last_feedback_ns_ = now_ns;
+    ++f_feedbacks_;
+}
+
+/** \brief Number of datagrams delivered.
+ */
+uint64_t BulkReceiver::getReceivedCount() const
+{
+    return f_received_;
+}
+
+/** \brief Number of datagrams of the current stream never received.
+ *
+ * Datagrams still on their way count until they arrive.
+ */
+uint64_t BulkReceiver::getLostCount() const
+{
+    uint32_t const expected(f_highest_sequence_ - f_first_sequence_ + 1);
+    return f_started_ && serialBefore(f_received_packets_, expected) ? expected - f_received_packets_ : 0;
+}
+
+/** \brief Number of datagrams ignored because they were not stream data.
+ */
+uint64_t BulkReceiver::getInvalidCount() const
+{
+    return f_invalid_;
+}
+
+/** \brief Number of feedbacks sent.
+ */
+uint64_t BulkReceiver::getFeedbackCount() const
+{
+    return f_feedbacks_;
+}
+
+} // namespace udp_client_server
+#endif
+// vim: ts=4 sw=4 et
@@ -0,0 +1,460 @@
+// Discovery -- find named UDP endpoints with broadcast or multicast beacons
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_DISCOVERY_CPP
+#define UDP_CLIENT_SERVER_DISCOVERY_CPP
+
+#include <discovery.h>
+#include <basic_udp_socket.h>
+#include <monotonic_clock.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace udp_client_server
+{
+
+namespace
+{
+
+/** \brief First bytes of a beacon.
+ */
+const char BEACON_MAGIC[4] = { 'U', 'D', 'S', 'C' };
+
+const uint8_t BEACON_VERSION = 1;
+
+/** \brief Magic, version, endpoint count, two reserved bytes and the node ID.
+ */
+const size_t BEACON_HEADER_SIZE = 12;
+
+/** \brief Number of missed beacons after which an endpoint is lost.
+ */
+const uint64_t BEACON_MISSED_LIMIT = 3;
+
+/** \brief Change the port of \p addr.
+ */
+void setPort(struct sockaddr_storage& addr, uint16_t port)
+{
+    if(addr.ss_family == AF_INET6)
+    {
+        reinterpret_cast<struct sockaddr_in6 *>(&addr)->sin6_port = htons(port);
+    }
+    else
+    {
+        reinterpret_cast<struct sockaddr_in *>(&addr)->sin_port = htons(port);
+    }
+}
+
+/** \brief Check whether \p addr is a multicast group.
+ */
+bool isMulticast(const struct sockaddr_storage& addr)
+{
+    if(addr.ss_family == AF_INET6)
+    {
+        return IN6_IS_ADDR_MULTICAST(&reinterpret_cast<const struct sockaddr_in6 *>(&addr)->sin6_addr);
+    }
+    return IN_MULTICAST(ntohl(reinterpret_cast<const struct sockaddr_in *>(&addr)->sin_addr.s_addr));
+}
+
+} // no name namespace
+
+const size_t Discovery::MAX_BEACON_SIZE;
+
+/** \brief Initialize the discovery service.
+ *
+ * \p server must be bound to the wildcard address and to \p beacon_port
+ * so it receives the beacons of the other nodes. When \p beacon_addr is
+ * a multicast group, the server joins it; otherwise it is expected to be
+ * a broadcast address (i.e. 255.255.255.255 or the one of the subnet.)
+ *
+ * Each instance gets a random node ID so a process restarting with the
+ * same endpoints is detected, and so its own beacons are ignored.
+ *
+ * \exception UdpClientServerRuntimeError
+ * The beacon address cannot be resolved or the multicast group cannot be
+ * joined.
+ *
+ * \param[in] server  The server sending and receiving the beacons.
+ * \param[in] beacon_addr  The broadcast or multicast address beacons are sent to.
+ * \param[in] beacon_port  The port beacons are sent to.
+ */
+Discovery::Discovery(UdpServer& server, const std::string& beacon_addr, int beacon_port)
+    : f_server_(server)
+    , f_beacon_addr_len_(0)
+    , f_node_id_(0)
+    , f_interval_ns_(1000000000ULL)
+    , f_last_beacon_ns_(0)
+    , f_beacon_sent_(false)
+    , f_listener_(NULL)
+    , f_listener_user_(NULL)
+    , f_buffer_(65536)
+{
+    f_beacon_addr_len_ = resolveUdpAddress(beacon_addr, beacon_port, AF_UNSPEC, f_beacon_addr_);
+    if(isMulticast(f_beacon_addr_))
+    {
+        if(f_server_.joinMulticastGroup(beacon_addr) != 0)
+        {
+            throw UdpClientServerRuntimeError(("could not join multicast group: \"" + beacon_addr + "\". errno: " + std::to_string(errno)).c_str());
+        }
+    }
+    else if(f_beacon_addr_.ss_family == AF_INET)
+    {
+        int const on(1);
+        setsockopt(f_server_.getSocket(), SOL_SOCKET, SO_BROADCAST, &on, sizeof(on));
+    }
+
+    // splitmix64 of the process ID, the time and this object address
+    uint64_t z(monotonicNowNs() ^ (static_cast<uint64_t>(getpid()) << 32) ^ reinterpret_cast<uintptr_t>(this));
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    f_node_id_ = static_cast<uint32_t>(z ^ (z >> 31));
+}
+
+/** \brief Change the time between two beacons.
+ *
+ * Endpoints of the other nodes are lost after BEACON_MISSED_LIMIT of
+ * this node intervals, so all the nodes should use the same interval.
+ */
+void Discovery::setInterval(uint64_t interval_ns)
+{
+    f_interval_ns_ = interval_ns;
+}
+
+/** \brief Get told when endpoints appear, move or disappear.
+ *
+ * \p listener is called from poll().
+ */
+void Discovery::setListener(Listener listener, void *user)
+{
+    f_listener_ = listener;
+    f_listener_user_ = user;
+}
+
+/** \brief Advertise a local endpoint.
+ *
+ * The peers see it at the address this node sends its beacons from, on
+ * \p port. The next beacon is sent right away by the next poll().
+ *
+ * \param[in] name  The name of the endpoint, i.e. "robot3/cmd".
+ * \param[in] port  The port of the endpoint.
+ *
+ * \return 0 on success, -1 if an error occurs. errno is set to EINVAL for
+ * an empty name, a name longer than 255 bytes or an invalid port, and to
+ * EMSGSIZE when the beacon would exceed MAX_BEACON_SIZE.
+ */
+int Discovery::advertise(const std::string& name, int port)
+{
+    if(name.empty() || name.size() > 255 || port <= 0 || port > 65535)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    size_t size(BEACON_HEADER_SIZE);
+    for(size_t i(0); i < f_advertised_.size(); ++i)
+    {
+        if(f_advertised_[i].name == name)
+        {
+            f_advertised_[i].port = static_cast<uint16_t>(port);
+            f_beacon_sent_ = false;
+            return 0;
+        }
+        size += 3 + f_advertised_[i].name.size();
+    }
+    if(size + 3 + name.size() > MAX_BEACON_SIZE || f_advertised_.size() >= 255)
+    {
+        errno = EMSGSIZE;
+        return -1;
+    }
+    Advertised advertised;
+    advertised.name = name;
+    advertised.port = static_cast<uint16_t>(port);
+    f_advertised_.push_back(advertised);
+    f_beacon_sent_ = false;
+    return 0;
+}
+
+/** \brief Stop advertising endpoint \p name.
+ *
+ * The peers notice when they receive the next beacon.
+ *
+ * \return false if \p name was not advertised.
+ */
+bool Discovery::withdraw(const std::string& name)
+{
+    for(size_t i(0); i < f_advertised_.size(); ++i)
+    {
+        if(f_advertised_[i].name == name)
+        {
+            f_advertised_.erase(f_advertised_.begin() + i);
+            f_beacon_sent_ = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+/** \brief Send the beacon when due, read the beacons of the peers.
+ *
+ * Call this function when the server is readable and at least once per
+ * interval.
+ *
+ * \param[in] now_ns  The current monotonic time.
+ * \param[in] max_beacons  The maximum number of datagrams read by this
+ * call, so a flood on the beacon port cannot starve the caller.
+ *
+ * \return The number of beacons received, or -1 if the socket reported
+ * an error. errno is set accordingly.
+ */
+int Discovery::poll(uint64_t now_ns, size_t max_beacons)
+{
+    if(!f_beacon_sent_ || now_ns - f_last_beacon_ns_ >= f_interval_ns_)
+    {
+        f_last_beacon_ns_ = now_ns;
+        f_beacon_sent_ = true;
+        sendBeacon();
+    }
+
+    int received(0);
+    for(size_t datagrams(0); datagrams < max_beacons; ++datagrams)
+    {
+        struct sockaddr_storage from;
+        socklen_t from_len(sizeof(from));
+        int const r(f_server_.recvFrom(&f_buffer_[0], f_buffer_.size(), &from, &from_len));
+        if(r < 0)
+        {
+            if(errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+        receiveBeacon(&f_buffer_[0], static_cast<size_t>(r), from, from_len, now_ns);
+        ++received;
+    }
+
+    uint64_t const timeout(f_interval_ns_ * BEACON_MISSED_LIMIT + f_interval_ns_ / 2);
+    for(size_t i(f_endpoints_.size()); i > 0; --i)
+    {
+        if(f_endpoints_[i - 1].last_seen_ns + timeout < now_ns)
+        {
+            DiscoveredEndpoint const lost(f_endpoints_[i - 1]);
+            f_endpoints_.erase(f_endpoints_.begin() + (i - 1));
+            notify(DISCOVERY_LOST, lost);
+        }
+    }
+    return received;
+}
+
+/** \brief Look for an endpoint named \p name.
+ *
+ * When several nodes advertise the same name, the most recently heard
+ * of is returned.
+ *
+ * \return false if no peer advertises \p name.
+ */
+bool Discovery::find(const std::string& name, DiscoveredEndpoint& endpoint) const
+{
+    const DiscoveredEndpoint *best(NULL);
+    for(size_t i(0); i < f_endpoints_.size(); ++i)
+    {
+        if(f_endpoints_[i].name == name
+        && (best == NULL || f_endpoints_[i].last_seen_ns > best->last_seen_ns))
+        {
+            best = &f_endpoints_[i];
+        }
+    }
+    if(best == NULL)
+    {
+        return false;
+    }
+    endpoint = *best;
+    return true;
+}
+
+/** \brief Return all the endpoints named \p name, one per node.
+ */
+std::vector<DiscoveredEndpoint> Discovery::findAll(const std::string& name) const
+{
+    std::vector<DiscoveredEndpoint> result;
+    for(size_t i(0); i < f_endpoints_.size(); ++i)
+    {
+        if(f_endpoints_[i].name == name)
+        {
+            result.push_back(f_endpoints_[i]);
+        }
+    }
+    return result;
+}
+
+/** \brief Return all the endpoints currently known.
+ */
+const std::vector<DiscoveredEndpoint>& Discovery::getEndpoints() const
+{
+    return f_endpoints_;
+}
+
+/** \brief Return the random ID of this node, as found in its beacons.
+ */
+uint32_t Discovery::getNodeId() const
+{
+    return f_node_id_;
+}
+
+/** \brief Send the list of the advertised endpoints.
+ */
+int Discovery::sendBeacon()
+{
+    char beacon[MAX_BEACON_SIZE];
+    memcpy(beacon, BEACON_MAGIC, sizeof(BEACON_MAGIC));
+    beacon[4] = static_cast<char>(BEACON_VERSION);
+    beacon[5] = static_cast<char>(f_advertised_.size());
+    beacon[6] = 0;
+    beacon[7] = 0;
+    uint32_t const node(htonl(f_node_id_));
+    memcpy(beacon + 8, &node, sizeof(node));
+    size_t size(BEACON_HEADER_SIZE);
+    for(size_t i(0); i < f_advertised_.size(); ++i)
+    {
+        uint16_t const port(htons(f_advertised_[i].port));
+        memcpy(beacon + size, &port, sizeof(port));
+        beacon[size + 2] = static_cast<char>(f_advertised_[i].name.size());
+        memcpy(beacon + size + 3, f_advertised_[i].name.data(), f_advertised_[i].name.size());
+        size += 3 + f_advertised_[i].name.size();
+    }
+    return sendto(f_server_.getSocket(), beacon, size, 0
+                , reinterpret_cast<struct sockaddr *>(&f_beacon_addr_), f_beacon_addr_len_) < 0 ? -1 : 0;
+}
+
+/** \brief Update the endpoints of the node which sent \p beacon.
+ *
+ * Endpoints of that node missing from the beacon were withdrawn. A
+ * beacon which does not parse completely is ignored, so a corrupted
+ * datagram cannot withdraw endpoints.
+ */
+void Discovery::receiveBeacon(const char *beacon, size_t size,
+                              const struct sockaddr_storage& from, socklen_t from_len, uint64_t now_ns)
+{
+    if(size < BEACON_HEADER_SIZE
+    || memcmp(beacon, BEACON_MAGIC, sizeof(BEACON_MAGIC)) != 0
+    || static_cast<uint8_t>(beacon[4]) != BEACON_VERSION)
+    {
+        return;
+    }
+    uint32_t node;
+    memcpy(&node, beacon + 8, sizeof(node));
+    node = ntohl(node);
+    if(node == f_node_id_)
+    {
+        return;
+    }
+
+    // a truncated or corrupted beacon is ignored as a whole; applying the
+    // records which parsed would withdraw the endpoints of the others
+    size_t const count(static_cast<uint8_t>(beacon[5]));
+    size_t offset(BEACON_HEADER_SIZE);
+    for(size_t n(0); n < count; ++n)
+    {
+        if(offset + 3 > size
+        || offset + 3 + static_cast<uint8_t>(beacon[offset + 2]) > size)
+        {
+            return;
+        }
+        offset += 3 + static_cast<uint8_t>(beacon[offset + 2]);
+    }
+    if(offset != size)
+    {
+        return;
+    }
+
+    offset = BEACON_HEADER_SIZE;
+    for(size_t n(0); n < count; ++n)
+    {
+        uint16_t port;
+        memcpy(&port, beacon + offset, sizeof(port));
+        size_t const name_len(static_cast<uint8_t>(beacon[offset + 2]));
+        DiscoveredEndpoint endpoint;
+        endpoint.name.assign(beacon + offset + 3, name_len);
+        offset += 3 + name_len;
+        memset(&endpoint.addr, 0, sizeof(endpoint.addr));
+        memcpy(&endpoint.addr, &from, from_len);
+        endpoint.addrlen = from_len;
+        setPort(endpoint.addr, ntohs(port));
+        endpoint.node_id = node;
+        endpoint.last_seen_ns = now_ns;
+
+        // same node, or a restart of the node at the same address
+        DiscoveredEndpoint *known(NULL);
+        for(size_t i(0); i < f_endpoints_.size(); ++i)
+        {
+            DiscoveredEndpoint& e(f_endpoints_[i]);
+            if(e.name == endpoint.name
+            && (e.node_id == node
+                || (e.addrlen == endpoint.addrlen && memcmp(&e.addr, &endpoint.addr, e.addrlen) == 0)))
+            {
+                known = &e;
+                break;
+            }
+        }
+        if(known == NULL)
+        {
+            f_endpoints_.push_back(endpoint);
+            notify(DISCOVERY_FOUND, endpoint);
+        }
+        else
+        {
+            bool const moved(known->node_id != node
+                          || known->addrlen != endpoint.addrlen
+                          || memcmp(&known->addr, &endpoint.addr, endpoint.addrlen) != 0);
+            *known = endpoint;
+            if(moved)
+            {
+                notify(DISCOVERY_MOVED, endpoint);
+            }
+        }
+    }
+
+    for(size_t i(f_endpoints_.size()); i > 0; --i)
+    {
+        if(f_endpoints_[i - 1].node_id == node
+        && f_endpoints_[i - 1].last_seen_ns != now_ns)
+        {
+            DiscoveredEndpoint const lost(f_endpoints_[i - 1]);
+            f_endpoints_.erase(f_endpoints_.begin() + (i - 1));
+            notify(DISCOVERY_LOST, lost);
+        }
+    }
+}
+
+/** \brief Call the listener, if any.
+ */
+void Discovery::notify(DiscoveryEvent event, const DiscoveredEndpoint& endpoint)
+{
+    if(f_listener_ != NULL)
+    {
+        f_listener_(f_listener_user_, event, endpoint);
+    }
+}
+
+} // namespace udp_client_server
+#endif
+// vim: ts=4 sw=4 et
@@ -0,0 +1,643 @@
+// Frame Stream -- large frames sent in chunks and reassembled in place
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_FRAME_STREAM_CPP
+#define UDP_CLIENT_SERVER_FRAME_STREAM_CPP
+
+#include <frame_stream.h>
+#include <errno.h>
+#include <string.h>
+#include <poll.h>
+#include <arpa/inet.h>
+#include <algorithm>
+
+namespace udp_client_server
+{
+
+const uint8_t FrameChunkHeader::CHUNK;
+const size_t FrameChunkHeader::SIZE;
+const size_t FrameSender::BATCH_SIZE;
+const size_t FrameReceiver::RECENT_FRAMES;
+
+
+/** \brief Serialize the header in the first SIZE bytes of \p buffer.
+ */
+void FrameChunkHeader::write(char *buffer) const
+{
+    uint16_t const c(htons(chunk_size));
+    uint32_t const i(htonl(frame_id));
+    uint32_t const s(htonl(frame_size));
+    uint32_t const o(htonl(offset));
+    buffer[0] = static_cast<char>(kind);
+    buffer[1] = static_cast<char>(flags);
+    memcpy(buffer + 2, &c, sizeof(c));
+    memcpy(buffer + 4, &i, sizeof(i));
+    memcpy(buffer + 8, &s, sizeof(s));
+    memcpy(buffer + 12, &o, sizeof(o));
+}
+
+/** \brief Parse a header from \p buffer.
+ *
+ * \return true if the buffer holds a chunk header.
+ */
+bool FrameChunkHeader::read(const char *buffer, size_t size)
+{
+    if(size < SIZE)
+    {
+        return false;
+    }
+    uint16_t c;
+    uint32_t i;
+    uint32_t s;
+    uint32_t o;
+    kind = static_cast<uint8_t>(buffer[0]);
+    flags = static_cast<uint8_t>(buffer[1]);
+    memcpy(&c, buffer + 2, sizeof(c));
+    memcpy(&i, buffer + 4, sizeof(i));
+    memcpy(&s, buffer + 8, sizeof(s));
+    memcpy(&o, buffer + 12, sizeof(o));
+    chunk_size = ntohs(c);
+    frame_id = ntohl(i);
+    frame_size = ntohl(s);
+    offset = ntohl(o);
+    return kind == CHUNK;
+}
+
+
+/** \brief Check whether chunk \p index of the frame was received.
+ */
+bool FrameView::hasChunk(size_t index) const
+{
+    return index < chunk_count && (bitmap[index / 64] & (1ULL << (index % 64))) != 0;
+}
+
+
+/** \brief Initialize a sender of frames on \p client.
+ *
+ * \param[in] client  The client sending the chunks.
+ * \param[in] chunk_size  The payload size of a chunk; 0 picks the
+ * largest that avoids IP fragmentation (see UdpClient::maxPayload().)
+ *
+ * \exception UdpClientServerRuntimeError
+ * The chunk size does not fit in a datagram.
+ */
+FrameSender::FrameSender(UdpClient& client, size_t chunk_size)
+    : f_client_(client)
+    , f_chunk_size_(chunk_size != 0 ? chunk_size : client.maxPayload() - FrameChunkHeader::SIZE)
+    , f_next_frame_id_(1)
+    , f_headers_(BATCH_SIZE * FrameChunkHeader::SIZE)
+    , f_iov_(BATCH_SIZE * 2)
+    , f_vectors_(BATCH_SIZE)
+{
+    if(f_chunk_size_ == 0
+    || f_chunk_size_ > 0xFFFF
+    || f_chunk_size_ + FrameChunkHeader::SIZE > 65507)
+    {
+        throw UdpClientServerRuntimeError("invalid chunk size for frame sender");
+    }
+    for(size_t i(0); i < BATCH_SIZE; ++i)
+    {
+        f_iov_[i * 2].iov_base = &f_headers_[i * FrameChunkHeader::SIZE];
+        f_iov_[i * 2].iov_len = FrameChunkHeader::SIZE;
+        f_vectors_[i].iov = &f_iov_[i * 2];
+        f_vectors_[i].iovcnt = 2;
+    }
+}
+
+/** \brief Send one frame.
+ *
+ * The chunks are sent in batches of up to BATCH_SIZE datagrams. When the
+ * socket buffer is full the function waits for it to drain, for up to
+ * 100 ms at a time.
+ *
+ * \param[in] frame  The frame data.
+ * \param[in] size  The size of the frame, 1 byte to 4 GiB.
+ *
+ * \return The ID of the frame, or -1 if an error occurs. errno is set
+ * accordingly on error (EINVAL for an empty frame, EMSGSIZE for a frame
+ * too large, EAGAIN when the socket stayed full.)
+ */
+int64_t FrameSender::sendFrame(const char *frame, size_t size)
+{
+    if(size == 0)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    if(size > 0xFFFFFFFFULL)
+    {
+        errno = EMSGSIZE;
+        return -1;
+    }
+
+    FrameChunkHeader header;
+    header.kind = FrameChunkHeader::CHUNK;
+    header.flags = 0;
+    header.chunk_size = static_cast<uint16_t>(f_chunk_size_);
+    header.frame_id = f_next_frame_id_++;
+    header.frame_size = static_cast<uint32_t>(size);
+
+    for(size_t offset(0); offset < size; )
+    {
+        size_t count(0);
+        for(; count < BATCH_SIZE && offset < size; ++count, offset += f_chunk_size_)
+        {
+            header.offset = static_cast<uint32_t>(offset);
+            header.write(&f_headers_[count * FrameChunkHeader::SIZE]);
+            f_iov_[count * 2 + 1].iov_base = const_cast<char *>(frame + offset);
+            f_iov_[count * 2 + 1].iov_len = std::min(f_chunk_size_, size - offset);
+        }
+        for(size_t sent(0); sent < count; )
+        {
+            int const r(f_client_.sendBatchv(&f_vectors_[sent], static_cast<unsigned int>(count - sent)));
+            if(r > 0)
+            {
+                sent += r;
+                continue;
+            }
+            if(r < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                return -1;
+            }
+            struct pollfd fd;
+            fd.fd = f_client_.getSocket();
+            fd.events = POLLOUT;
+            fd.revents = 0;
+            if(::poll(&fd, 1, 100) <= 0)
+            {
+                errno = EAGAIN;
+                return -1;
+            }
+        }
+    }
+    return header.frame_id;
+}
+
+/** \brief Payload size of the chunks.
+ */
+size_t FrameSender::getChunkSize() const
+{
+    return f_chunk_size_;
+}
+
+/** \brief ID the next frame sent will have.
+ */
+uint32_t FrameSender::getNextFrameId() const
+{
+    return f_next_frame_id_;
+}
+
+
+/** \brief Initialize a receiver reassembling frames from \p server.
+ *
+ * All the memory is allocated here: \p slot_count slots of
+ * \p max_frame_size bytes.
+ *
+ * \param[in] server  The server receiving the chunks.
+ * \param[in] max_frame_size  The largest frame accepted.
+ * \param[in] slot_count  The number of frames reassembled at the same time.
+ * \param[in] max_chunk_size  The largest chunk payload expected.
+ *
+ * \exception UdpClientServerRuntimeError
+ * One of the sizes or the slot count is 0.
+ */
+FrameReceiver::FrameReceiver(UdpServer& server, size_t max_frame_size, size_t slot_count, size_t max_chunk_size)
+    : f_server_(server)
+    , f_max_frame_size_(max_frame_size)
+    , f_callback_(NULL)
+    , f_user_(NULL)
+    , f_deadline_ns_(100000000)
+    , f_partial_(false)
+    , f_slots_(slot_count)
+    , f_predicted_slot_(NULL)
+    , f_predicted_offset_(0)
+    , f_overflow_(max_chunk_size)
+    , f_recent_count_(0)
+    , f_recent_next_(0)
+    , f_complete_(0)
+    , f_partial_count_(0)
+    , f_dropped_(0)
+    , f_late_(0)
+    , f_invalid_(0)
+    , f_copied_(0)
+{
+    if(max_frame_size == 0 || slot_count == 0 || max_chunk_size == 0)
+    {
+        throw UdpClientServerRuntimeError("invalid parameters for frame receiver");
+    }
+    for(size_t i(0); i < slot_count; ++i)
+    {
+        Slot& slot(f_slots_[i]);
+        slot.busy = false;
+        slot.data.resize(max_frame_size);
+        // enough for chunks of 512 bytes or more without reallocating
+        slot.bitmap.reserve((max_frame_size / 512 + 64) / 64);
+        release(slot);
+    }
+    predict(NULL, 0);
+}
+
+/** \brief Set the function receiving the frames.
+ */
+void FrameReceiver::setCallback(Callback callback, void *user)
+{
+    f_callback_ = callback;
+    f_user_ = user;
+}
+
+/** \brief Set how long after its first chunk a frame must be complete.
+ *
+ * Past this delay the frame is delivered partial or dropped (see
+ * setPartialDelivery().) The default is 100 ms.
+ */
+void FrameReceiver::setDeadline(uint64_t deadline_ns)
+{
+    f_deadline_ns_ = deadline_ns;
+}
+
+/** \brief Choose whether incomplete frames are delivered or dropped.
+ *
+ * Partial frames are delivered on their deadline, or when their slot is
+ * needed for a newer frame. The default is to drop them.
+ */
+void FrameReceiver::setPartialDelivery(bool partial)
+{
+    f_partial_ = partial;
+}
+
+/** \brief Receive the pending chunks and deliver the frames that are due.
+ *
+ * Up to \p max_datagrams datagrams are read without waiting. Then the
+ * frames whose deadline expired at \p now_ns are delivered or dropped.
+ *
+ * \return The number of datagrams read, or -1 if an error occurs. errno
+ * is set accordingly on error.
+ */
+int FrameReceiver::poll(uint64_t now_ns, size_t max_datagrams)
+{
+    int count(0);
+    for(; static_cast<size_t>(count) < max_datagrams; ++count)
+    {
+        // header first, then the payload where it most likely belongs,
+        // anything beyond in the overflow buffer
+        struct iovec iov[3];
+        size_t iovcnt(0);
+        iov[iovcnt].iov_base = f_header_;
+        iov[iovcnt].iov_len = FrameChunkHeader::SIZE;
+        ++iovcnt;
+        char *landing(NULL);
+        size_t landing_size(0);
+        Slot *predicted(f_predicted_slot_);
+        if(predicted != NULL
+        && f_predicted_offset_ < f_max_frame_size_
+        && (!predicted->busy || !hasChunk(*predicted, f_predicted_offset_)))
+        {
+            landing = &predicted->data[f_predicted_offset_];
+            landing_size = f_max_frame_size_ - f_predicted_offset_;
+            if(predicted->busy)
+            {
+                // never spill over the next chunk, it may have arrived already
+                landing_size = std::min(predicted->chunk_size, predicted->frame_size - f_predicted_offset_);
+            }
+            iov[iovcnt].iov_base = landing;
+            iov[iovcnt].iov_len = landing_size;
+            ++iovcnt;
+        }
+        iov[iovcnt].iov_base = &f_overflow_[0];
+        iov[iovcnt].iov_len = f_overflow_.size();
+        ++iovcnt;
+
+        int msg_flags(0);
+        int const r(f_server_.recvv(iov, iovcnt, &msg_flags));
+        if(r < 0)
+        {
+            if(errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+            return count == 0 ? -1 : count;
+        }
+
+        FrameChunkHeader header;
+        if((msg_flags & MSG_TRUNC) != 0 || !header.read(f_header_, static_cast<size_t>(r)))
+        {
+            ++f_invalid_;
+            continue;
+        }
+        size_t const size(static_cast<size_t>(r) - FrameChunkHeader::SIZE);
+        if(landing != NULL && size > landing_size)
+        {
+            // the payload was split between the landing and the overflow
+            // buffer: make it contiguous in the overflow buffer
+            if(size > f_overflow_.size())
+            {
+                ++f_invalid_;
+                continue;
+            }
+            memmove(&f_overflow_[landing_size], &f_overflow_[0], size - landing_size);
+            memcpy(&f_overflow_[0], landing, landing_size);
+            landing = NULL;
+        }
+        store(header, landing != NULL ? landing : &f_overflow_[0], size, now_ns);
+    }
+
+    for(size_t i(0); i < f_slots_.size(); ++i)
+    {
+        Slot& slot(f_slots_[i]);
+        if(slot.busy && slot.first_arrival_ns + f_deadline_ns_ <= now_ns)
+        {
+            deliver(slot);
+            if(f_predicted_slot_ == &slot || f_predicted_slot_ == NULL)
+            {
+                predict(NULL, 0);
+            }
+        }
+    }
+    return count;
+}
+
+/** \brief Number of frames delivered complete.
+ */
+uint64_t FrameReceiver::getCompleteCount() const
+{
+    return f_complete_;
+}
+
+/** \brief Number of frames delivered with missing chunks.
+ */
+uint64_t FrameReceiver::getPartialCount() const
+{
+    return f_partial_count_;
+}
+
+/** \brief Number of incomplete frames dropped.
+ */
+uint64_t FrameReceiver::getDroppedCount() const
+{
+    return f_dropped_;
+}
+
+/** \brief Number of chunks received twice or after their frame was gone.
+ */
+uint64_t FrameReceiver::getLateChunkCount() const
+{
+    return f_late_;
+}
+
+/** \brief Number of datagrams that were not valid chunks.
+ */
+uint64_t FrameReceiver::getInvalidCount() const
+{
+    return f_invalid_;
+}
+
+/** \brief Number of chunks that had to be moved to their place.
+ *
+ * This counts the mispredicted placements; with in-order traffic it
+ * stays at zero.
+ */
+uint64_t FrameReceiver::getCopiedChunkCount() const
+{
+    return f_copied_;
+}
+
+/** \brief Put a received chunk in its frame slot.
+ */
+void FrameReceiver::store(const FrameChunkHeader& header, const char *payload, size_t size, uint64_t now_ns)
+{
+    size_t const frame_size(header.frame_size);
+    size_t const chunk_size(header.chunk_size);
+    size_t const offset(header.offset);
+    if(chunk_size == 0
+    || frame_size == 0
+    || frame_size > f_max_frame_size_
+    || offset >= frame_size
+    || offset % chunk_size != 0
+    || size != std::min(chunk_size, frame_size - offset))
+    {
+        ++f_invalid_;
+        return;
+    }
+    if(isRecent(header.frame_id))
+    {
+        ++f_late_;
+        return;
+    }
+
+    Slot *slot(findSlot(header.frame_id));
+    if(slot == NULL)
+    {
+        slot = reserveSlot();
+        slot->busy = true;
+        slot->frame_id = header.frame_id;
+        slot->frame_size = frame_size;
+        slot->chunk_size = chunk_size;
+        slot->chunk_count = (frame_size + chunk_size - 1) / chunk_size;
+        slot->first_arrival_ns = now_ns;
+        slot->bitmap.assign((slot->chunk_count + 63) / 64, 0);
+    }
+    else if(slot->frame_size != frame_size || slot->chunk_size != chunk_size)
+    {
+        ++f_invalid_;
+        return;
+    }
+
+    size_t const index(offset / chunk_size);
+    uint64_t const bit(1ULL << (index % 64));
+    if((slot->bitmap[index / 64] & bit) != 0)
+    {
+        ++f_late_;
+        return;
+    }
+    char *destination(&slot->data[offset]);
+    if(payload != destination)
+    {
+        memmove(destination, payload, size);
+        ++f_copied_;
+    }
+    slot->bitmap[index / 64] |= bit;
+    ++slot->received_chunks;
+    slot->received_bytes += size;
+
+    if(slot->received_chunks == slot->chunk_count)
+    {
+        deliver(*slot);
+        predict(NULL, 0);
+    }
+    else if(offset + chunk_size < frame_size)
+    {
+        predict(slot, offset + chunk_size);
+    }
+    else
+    {
+        predict(NULL, 0);
+    }
+}
+
+/** \brief Check whether the chunk at \p offset of \p slot was received.
+ *
+ * A chunk already in place must never be used as a landing area: after
+ * a reordering the prediction can point back at a received chunk, and
+ * receiving the next payload there would overwrite it.
+ */
+bool FrameReceiver::hasChunk(const Slot& slot, size_t offset) const
+{
+    if(offset >= slot.frame_size)
+    {
+        // not a chunk of this frame, nothing to overwrite
+        return false;
+    }
+    size_t const index(offset / slot.chunk_size);
+    return (slot.bitmap[index / 64] & (1ULL << (index % 64))) != 0;
+}
+
+/** \brief Find the slot reassembling \p frame_id.
+ */
+FrameReceiver::Slot *FrameReceiver::findSlot(uint32_t frame_id)
+{
+    for(size_t i(0); i < f_slots_.size(); ++i)
+    {
+        if(f_slots_[i].busy && f_slots_[i].frame_id == frame_id)
+        {
+            return &f_slots_[i];
+        }
+    }
+    return NULL;
+}
+
+/** \brief Get a free slot for a new frame.
+ *
+ * When all the slots are busy, the frame which started first is given
+ * up: delivered partial or dropped.
+ */
+FrameReceiver::Slot *FrameReceiver::reserveSlot()
+{
+    Slot *oldest(NULL);
+    for(size_t i(0); i < f_slots_.size(); ++i)
+    {
+        Slot& slot(f_slots_[i]);
+        if(!slot.busy)
+        {
+            return &slot;
+        }
+        if(oldest == NULL || slot.first_arrival_ns < oldest->first_arrival_ns)
+        {
+            oldest = &slot;
+        }
+    }
+    deliver(*oldest);
+    return oldest;
+}
+
+/** \brief Check whether \p frame_id was delivered or dropped recently.
+ */
+bool FrameReceiver::isRecent(uint32_t frame_id) const
+{
+    for(size_t i(0); i < f_recent_count_; ++i)
+    {
+        if(f_recent_[i] == frame_id)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** \brief Hand the frame of \p slot to the callback, or drop it, and free the slot.
+ */
+void FrameReceiver::deliver(Slot& slot)
+{
+    bool const complete(slot.received_chunks == slot.chunk_count);
+    if(complete || f_partial_)
+    {
+        FrameView view;
+        view.frame_id = slot.frame_id;
+        view.data = &slot.data[0];
+        view.size = slot.frame_size;
+        view.complete = complete;
+        view.received_bytes = slot.received_bytes;
+        view.chunk_size = slot.chunk_size;
+        view.chunk_count = slot.chunk_count;
+        view.received_chunks = slot.received_chunks;
+        view.bitmap = &slot.bitmap[0];
+        view.first_arrival_ns = slot.first_arrival_ns;
+        if(complete)
+        {
+            ++f_complete_;
+        }
+        else
+        {
+            ++f_partial_count_;
+        }
+        if(f_callback_ != NULL)
+        {
+            f_callback_(f_user_, view);
+        }
+    }
+    else
+    {
+        ++f_dropped_;
+    }
+
+    // remember the frame so its late chunks do not start it again
+    f_recent_[f_recent_next_] = slot.frame_id;
+    f_recent_next_ = (f_recent_next_ + 1) % RECENT_FRAMES;
+    f_recent_count_ = std::min(f_recent_count_ + 1, RECENT_FRAMES);
+    release(slot);
+}
+
+/** \brief Mark \p slot free.
+ */
+void FrameReceiver::release(Slot& slot)
+{
+    slot.busy = false;
+    slot.frame_id = 0;
+    slot.frame_size = 0;
+    slot.chunk_size = 0;
+    slot.chunk_count = 0;
+    slot.received_chunks = 0;
+    slot.received_bytes = 0;
+    slot.first_arrival_ns = 0;
+}
+
+/** \brief Set where the payload of the next chunk is expected.
+ *
+ * With \p slot NULL the next chunk is expected to start a new frame, so
+ * its payload goes at offset 0 of the slot reserveSlot() would pick if
+ * it is free.
+ */
+void FrameReceiver::predict(Slot *slot, size_t offset)
+{
+    if(slot == NULL)
+    {
+        offset = 0;
+        for(size_t i(0); i < f_slots_.size(); ++i)
+        {
+            if(!f_slots_[i].busy)
+            {
+                slot = &f_slots_[i];
+                break;
+            }
+        }
+    }
+    f_predicted_slot_ = slot;
+    f_predicted_offset_ = offset;
+}
+
+} // namespace udp_client_server
+#endif
+// vim: ts=4 sw=4 et
@@ -0,0 +1,339 @@
+// Impaired Socket -- inject loss, delay, duplication and reordering on real sockets
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_IMPAIRED_SOCKET_CPP
+#define UDP_CLIENT_SERVER_IMPAIRED_SOCKET_CPP
+
+#include <impaired_socket.h>
+#include <monotonic_clock.h>
+#include <errno.h>
+#include <string.h>
+#include <algorithm>
+
+namespace udp_client_server
+{
+
+namespace
+{
+
+/** \brief Largest datagram read from the real socket by ImpairedUdpServer.
+ */
+const size_t MAX_DATAGRAM_SIZE = 65536;
+
+} // no name namespace
+
+
+// ========================= IMPAIRER =========================
+
+/** \brief Initialize a packet impairer.
+ *
+ * A packet impairer sits between the application and a real socket.
+ * Packets submitted to it are dropped, duplicated and held back in a
+ * timer wheel according to the current NetworkImpairment, then given
+ * back by release() once their delay elapsed.
+ *
+ * The impairment can be changed at any time, from any thread.
+ *
+ * \param[in] seed  The seed used to draw loss, jitter, duplication and
+ * reordering.
+ */
+PacketImpairer::PacketImpairer(uint64_t seed)
+    : f_model_(seed)
+    , f_busy_until_(0)
+{
+}
+
+/** \brief Change the impairment applied to the next packets.
+ *
+ * Packets already held back keep the delay they were given.
+ */
+void PacketImpairer::setImpairment(const NetworkImpairment& impairment)
+{
+    std::lock_guard<std::mutex> lock(f_mutex_);
+    f_impairment_ = impairment;
+}
+
+/** \brief Return a copy of the current impairment.
+ */
+NetworkImpairment PacketImpairer::getImpairment() const
+{
+    std::lock_guard<std::mutex> lock(f_mutex_);
+    return f_impairment_;
+}
+
+/** \brief Return a copy of the impairer counters.
+ */
+PacketImpairer::Stats PacketImpairer::getStats() const
+{
+    std::lock_guard<std::mutex> lock(f_mutex_);
+    return f_stats_;
+}
+
+/** \brief Submit a packet to the impairer.
+ *
+ * \param[in] now_ns  The current monotonic time, see now().
+ * \param[in] msg  The packet.
+ * \param[in] size  The number of bytes in \p msg.
+ */
+void PacketImpairer::submit(uint64_t now_ns, const char *msg, size_t size)
+{
+    std::lock_guard<std::mutex> lock(f_mutex_);
+    ++f_stats_.submitted;
+    if(f_model_.drop(f_impairment_))
+    {
+        ++f_stats_.lost;
+        return;
+    }
+
+    uint64_t const departure(std::max(now_ns, f_busy_until_)
+                           + ImpairmentModel::transmitTime(f_impairment_, size));
+    f_busy_until_ = departure;
+
+    int copies(1);
+    if(f_model_.duplicate(f_impairment_))
+    {
+        ++f_stats_.duplicated;
+        copies = 2;
+    }
+    for(int i(0); i < copies; ++i)
+    {
+        uint64_t const deadline(departure + f_model_.delay(f_impairment_));
+        if(deadline <= now_ns)
+        {
+            f_ready_.push_back(std::string(msg, size));
+        }
+        else
+        {
+            f_wheel_.schedule(deadline, std::string(msg, size));
+        }
+    }
+}
+
+/** \brief Retrieve the next packet whose delay elapsed.
+ *
+ * \param[in] now_ns  The current monotonic time, see now().
+ * \param[out] msg  The released packet.
+ *
+ * \return false if no packets are due yet.
+ */
+bool PacketImpairer::release(uint64_t now_ns, std::string& msg)
+{
+    std::lock_guard<std::mutex> lock(f_mutex_);
+    std::deque<std::string>& ready(f_ready_);
+    f_wheel_.advance(now_ns, [&ready](const std::string& m) { ready.push_back(m); });
+    if(f_ready_.empty())
+    {
+        return false;
+    }
+    msg.swap(f_ready_.front());
+    f_ready_.pop_front();
+    ++f_stats_.released;
+    return true;
+}
+
+/** \brief Number of packets held back or ready to be released.
+ */
+size_t PacketImpairer::pending() const
+{
+    std::lock_guard<std::mutex> lock(f_mutex_);
+    return f_wheel_.size() + f_ready_.size();
+}
+
+/** \brief Current CLOCK_MONOTONIC time in nanoseconds.
+ */
+uint64_t PacketImpairer::now()
+{
+    return monotonicNowNs();
+}
+
+
+
+// ========================= CLIENT =========================
+
+/** \brief Wrap a UDP client to impair the packets it sends.
+ *
+ * Packets go through a PacketImpairer before reaching \p client. Delayed
+ * packets are only sent by a later call to send() or poll(), so poll()
+ * must be called regularly (i.e. once per control loop iteration) for
+ * the delays to be accurate.
+ *
+ * \param[in] client  The client sending the packets, it must outlive
+ * the wrapper.
+ * \param[in] seed  The seed of the impairment model.
+ */
+ImpairedUdpClient::ImpairedUdpClient(UdpClient& client, uint64_t seed)
+    : f_client_(client)
+    , f_impairer_(seed)
+{
+}
+
+/** \brief Return the wrapped client.
+ */
+UdpClient& ImpairedUdpClient::getClient() const
+{
+    return f_client_;
+}
+
+/** \brief Return the impairer, i.e. to read its counters.
+ */
+PacketImpairer& ImpairedUdpClient::getImpairer()
+{
+    return f_impairer_;
+}
+
+/** \brief Change the impairment applied to the packets sent from now on.
+ */
+void ImpairedUdpClient::setImpairment(const NetworkImpairment& impairment)
+{
+    f_impairer_.setImpairment(impairment);
+}
+
+/** \brief Send a message through the impairer.
+ *
+ * Like a real network, the message is reported as sent even when it gets
+ * lost or held back.
+ *
+ * \param[in] msg  The message to send.
+ * \param[in] size  The number of bytes representing this message.
+ *
+ * \return \p size.
+ */
+int ImpairedUdpClient::send(const char *msg, size_t size)
+{
+    f_impairer_.submit(PacketImpairer::now(), msg, size);
+    poll();
+    return static_cast<int>(size);
+}
+
+/** \brief Send a message made of several buffers through the impairer.
+ *
+ * \return The number of bytes in the message.
+ */
+int ImpairedUdpClient::sendv(const struct iovec *iov, size_t iovcnt)
+{
+    f_message_.clear();
+    for(size_t i(0); i < iovcnt; ++i)
+    {
+        f_message_.append(static_cast<const char *>(iov[i].iov_base), iov[i].iov_len);
+    }
+    return send(f_message_.data(), f_message_.size());
+}
+
+/** \brief Send the packets whose delay elapsed.
+ *
+ * A packet the socket refuses (i.e. EAGAIN) is dropped, just like the
+ * kernel drops packets when an interface queue overflows.
+ *
+ * \return The number of packets sent.
+ */
+int ImpairedUdpClient::poll()
+{
+    int sent(0);
+    uint64_t const now(PacketImpairer::now());
+    std::string msg;
+    while(f_impairer_.release(now, msg))
+    {
+        if(f_client_.send(msg.data(), msg.size()) >= 0)
+        {
+            ++sent;
+        }
+    }
+    return sent;
+}
+
+
+
+// ========================= SERVER =========================
+
+/** \brief Wrap a UDP server to impair the packets it receives.
+ *
+ * \param[in] server  The server receiving the packets, it must outlive
+ * the wrapper.
+ * \param[in] seed  The seed of the impairment model.
+ */
+ImpairedUdpServer::ImpairedUdpServer(UdpServer& server, uint64_t seed)
+    : f_server_(server)
+    , f_impairer_(seed)
+    , f_buffer_(MAX_DATAGRAM_SIZE, '\0')
+{
+}
+
+/** \brief Return the wrapped server.
+ */
+UdpServer& ImpairedUdpServer::getServer() const
+{
+    return f_server_;
+}
+
+/** \brief Return the impairer, i.e. to read its counters.
+ */
+PacketImpairer& ImpairedUdpServer::getImpairer()
+{
+    return f_impairer_;
+}
+
+/** \brief Change the impairment applied to the packets received from now on.
+ */
+void ImpairedUdpServer::setImpairment(const NetworkImpairment& impairment)
+{
+    f_impairer_.setImpairment(impairment);
+}
+
+/** \brief Attempt to receive an impaired message in a non-blocking manner.
+ *
+ * Up to \p max_packets messages pending on the real socket are read and
+ * submitted to the impairer, then the first message whose delay elapsed
+ * is returned. The bound keeps a flood from holding the caller here;
+ * messages left on the socket are read by the next calls.
+ *
+ * \param[in] msg  The buffer where the message is saved.
+ * \param[in] max_size  The maximum size the message (i.e. size of the \p msg buffer.)
+ * \param[in] max_packets  The maximum number of messages read from the socket.
+ *
+ * \return The number of bytes read or -1 if an error occurs. errno is
+ * set to EAGAIN when no messages are due yet.
+ */
+int ImpairedUdpServer::recv(char *msg, size_t max_size, size_t max_packets)
+{
+    uint64_t const now(PacketImpairer::now());
+    for(size_t count(0); count < max_packets; ++count)
+    {
+        int const r(f_server_.recvTrunc(&f_buffer_[0], f_buffer_.size()));
+        if(r < 0)
+        {
+            if(errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                return -1;
+            }
+            break;
+        }
+        f_impairer_.submit(now, f_buffer_.data(), std::min(static_cast<size_t>(r), f_buffer_.size()));
+    }
+
+    if(!f_impairer_.release(now, f_message_))
+    {
+        errno = EAGAIN;
+        return -1;
+    }
+    size_t const size(std::min(max_size, f_message_.size()));
+    memcpy(msg, f_message_.data(), size);
+    return static_cast<int>(size);
+}
+
+} // namespace udp_client_server
+#endif
+// vim: ts=4 sw=4 et
@@ -0,0 +1,99 @@
+// Network Impairment -- loss, delay, duplication and reordering models
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_NETWORK_IMPAIRMENT_CPP
+#define UDP_CLIENT_SERVER_NETWORK_IMPAIRMENT_CPP
+
+#include <network_impairment.h>
+
+namespace udp_client_server
+{
+
+/** \brief Initialize the model with a pseudo-random \p seed.
+ *
+ * Two models created with the same seed and asked the same questions
+ * give the same answers.
+ *
+ * \param[in] seed  The seed of the pseudo-random generator.
+ */
+ImpairmentModel::ImpairmentModel(uint64_t seed)
+    : f_random_(seed)
+{
+}
+
+/** \brief Decide whether the next packet is lost.
+ */
+bool ImpairmentModel::drop(const NetworkImpairment& impairment)
+{
+    return chance(impairment.loss);
+}
+
+/** \brief Decide whether the next packet is delivered twice.
+ */
+bool ImpairmentModel::duplicate(const NetworkImpairment& impairment)
+{
+    return chance(impairment.duplicate);
+}
+
+/** \brief Draw the one-way delay of the next packet.
+ *
+ * The delay is the fixed latency plus a uniform jitter. Reordered packets
+ * are additionally held back by reorder_delay_ns so that packets sent
+ * after them overtake them.
+ *
+ * \return The delay in nanoseconds, not including the transmit time.
+ */
+uint64_t ImpairmentModel::delay(const NetworkImpairment& impairment)
+{
+    uint64_t d(impairment.latency_ns);
+    if(impairment.jitter_ns != 0)
+    {
+        d += std::uniform_int_distribution<uint64_t>(0, impairment.jitter_ns)(f_random_);
+    }
+    if(chance(impairment.reorder))
+    {
+        d += impairment.reorder_delay_ns;
+    }
+    return d;
+}
+
+/** \brief Time needed to put \p size bytes on the link.
+ *
+ * \return The serialization time in nanoseconds, 0 when the bandwidth is
+ * unlimited.
+ */
+uint64_t ImpairmentModel::transmitTime(const NetworkImpairment& impairment, size_t size)
+{
+    if(impairment.bandwidth_bps == 0)
+    {
+        return 0;
+    }
+    return static_cast<uint64_t>(size) * 8ULL * 1000000000ULL / impairment.bandwidth_bps;
+}
+
+bool ImpairmentModel::chance(double probability)
+{
+    if(probability <= 0.0)
+    {
+        return false;
+    }
+    return std::uniform_real_distribution<double>(0.0, 1.0)(f_random_) < probability;
+}
+
+} // namespace udp_client_server
+#endif
+// vim: ts=4 sw=4 et
@@ -0,0 +1,331 @@
+// NUMA Placement -- keep packet memory and workers on the same node
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+// The NUMA policy system calls are used directly so the library does not
+// depend on libnuma. On kernels built without NUMA support they fail with
+// ENOSYS and everything degrades to plain allocations on a single node.
+
+#ifndef UDP_CLIENT_SERVER_NUMA_PLACEMENT_CPP
+#define UDP_CLIENT_SERVER_NUMA_PLACEMENT_CPP
+
+#include <numa_placement.h>
+#include <errno.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <fstream>
+
+namespace udp_client_server
+{
+
+namespace
+{
+
+/** \brief Memory policy binding pages to a set of nodes (MPOL_BIND.)
+ */
+const int NUMA_MPOL_BIND = 2;
+
+/** \brief Read the first line of a sysfs file.
+ */
+bool readSysfsLine(const std::string& path, std::string& line)
+{
+    std::ifstream in(path.c_str());
+    return static_cast<bool>(std::getline(in, line));
+}
+
+/** \brief Parse a sysfs CPU or node list such as "0-3,8-11".
+ */
+std::vector<int> parseList(const std::string& list)
+{
+    std::vector<int> result;
+    const char *p(list.c_str());
+    while(*p != '\0')
+    {
+        char *end;
+        long const first(strtol(p, &end, 10));
+        if(end == p)
+        {
+            break;
+        }
+        long last(first);
+        p = end;
+        if(*p == '-')
+        {
+            last = strtol(p + 1, &end, 10);
+            p = end;
+        }
+        for(long i(first); i <= last; ++i)
+        {
+            result.push_back(static_cast<int>(i));
+        }
+        if(*p == ',')
+        {
+            ++p;
+        }
+        else
+        {
+            break;
+        }
+    }
+    return result;
+}
+
+} // no name namespace
+
+
+/** \brief Fraction of the allocations of a node done from another node.
+ *
+ * \return A value from 0.0 (all local) to 1.0 (all remote.)
+ */
+double NumaAllocStats::remoteRatio() const
+{
+    uint64_t const total(local + remote);
+    return total == 0 ? 0.0 : static_cast<double>(remote) / static_cast<double>(total);
+}
+
+/** \brief Number of NUMA nodes of this machine.
+ *
+ * \return The number of possible nodes, 1 when the kernel does not
+ * expose NUMA information.
+ */
+int numaNodeCount()
+{
+    std::string line;
+    if(!readSysfsLine("/sys/devices/system/node/possible", line))
+    {
+        return 1;
+    }
+    std::vector<int> const nodes(parseList(line));
+    return nodes.empty() ? 1 : nodes.back() + 1;
+}
+
+/** \brief Node of the CPU the calling thread runs on.
+ *
+ * \return The node number, or -1 if an error occurs.
+ */
+int numaCurrentNode()
+{
+    unsigned int cpu(0);
+    unsigned int node(0);
+    if(syscall(SYS_getcpu, &cpu, &node, NULL) != 0)
+    {
+        return -1;
+    }
+    return static_cast<int>(node);
+}
+
+/** \brief Node of CPU \p cpu.
+ *
+ * \return The node number, or -1 if \p cpu is not found.
+ */
+int numaNodeOfCpu(int cpu)
+{
+    int const count(numaNodeCount());
+    for(int node(0); node < count; ++node)
+    {
+        std::vector<int> const cpus(numaCpusOfNode(node));
+        for(size_t i(0); i < cpus.size(); ++i)
+        {
+            if(cpus[i] == cpu)
+            {
+                return node;
+            }
+        }
+    }
+    return -1;
+}
+
+/** \brief Node the network interface \p ifname is attached to.
+ *
+ * Received packets are written by the NIC in memory of this node, so the
+ * receive workers of that interface are best placed there.
+ *
+ * \return The node number, or -1 if unknown (i.e. virtual interfaces or
+ * single node machines.)
+ */
+int numaNodeOfInterface(const std::string& ifname)
+{
+    std::string line;
+    if(ifname.find('/') != std::string::npos
+    || !readSysfsLine("/sys/class/net/" + ifname + "/device/numa_node", line))
+    {
+        return -1;
+    }
+    return atoi(line.c_str());
+}
+
+/** \brief Node holding the page of \p addr.
+ *
+ * This checks where a buffer actually ended up. The page must have been
+ * touched already.
+ *
+ * \return The node number, or -1 if an error occurs.
+ */
+int numaNodeOfAddress(const void *addr)
+{
+    long const page_size(sysconf(_SC_PAGESIZE));
+    void *page(reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(addr) & ~static_cast<uintptr_t>(page_size - 1)));
+    int status(-1);
+    if(syscall(SYS_move_pages, 0, 1UL, &page, NULL, &status, 0) != 0 || status < 0)
+    {
+        return -1;
+    }
+    return status;
+}
+
+/** \brief List the CPUs of \p node.
+ *
+ * \return The CPU numbers, empty if the node does not exist.
+ */
+std::vector<int> numaCpusOfNode(int node)
+{
+    std::string line;
+    if(!readSysfsLine("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist", line))
+    {
+        return std::vector<int>();
+    }
+    return parseList(line);
+}
+
+/** \brief Restrict the calling thread to the CPUs of \p node.
+ *
+ * \return 0 on success, -1 if an error occurs. errno is set accordingly
+ * on error (EINVAL if the node has no CPUs.)
+ */
+int numaPinThreadToNode(int node)
+{
+    std::vector<int> const cpus(numaCpusOfNode(node));
+    if(cpus.empty())
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(size_t i(0); i < cpus.size(); ++i)
+    {
+        if(cpus[i] < CPU_SETSIZE)
+        {
+            CPU_SET(cpus[i], &set);
+        }
+    }
+    return sched_setaffinity(0, sizeof(set), &set);
+}
+
+/** \brief Allocate \p size bytes of memory on \p node.
+ *
+ * The memory is mapped, bound to \p node and touched so all its pages are
+ * faulted in on that node before the function returns. It is page
+ * aligned and must be released with numaFree().
+ *
+ * When the kernel has no NUMA support the memory is allocated normally.
+ *
+ * \param[in] size  The number of bytes to allocate.
+ * \param[in] node  The node to allocate on, -1 for no preference.
+ *
+ * \return A pointer to the memory, or NULL if an error occurs.
+ */
+void *numaAlloc(size_t size, int node)
+{
+    void *ptr(mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if(ptr == MAP_FAILED)
+    {
+        return NULL;
+    }
+    if(node >= 0)
+    {
+        unsigned long mask[16];
+        unsigned long const bits(sizeof(unsigned long) * 8);
+        if(static_cast<unsigned long>(node) >= bits * 16)
+        {
+            munmap(ptr, size);
+            errno = EINVAL;
+            return NULL;
+        }
+        memset(mask, 0, sizeof(mask));
+        mask[node / bits] = 1UL << (node % bits);
+        if(syscall(SYS_mbind, ptr, size, NUMA_MPOL_BIND, mask, bits * 16, 0) != 0
+        && errno != ENOSYS)
+        {
+            int const e(errno);
+            munmap(ptr, size);
+            errno = e;
+            return NULL;
+        }
+    }
+    memset(ptr, 0, size);
+    return ptr;
+}
+
+/** \brief Release memory obtained from numaAlloc().
+ *
+ * \param[in] ptr  The pointer returned by numaAlloc().
+ * \param[in] size  The size given to numaAlloc().
+ */
+void numaFree(void *ptr, size_t size)
+{
+    if(ptr != NULL)
+    {
+        munmap(ptr, size);
+    }
+}
+
+/** \brief Read the allocation counters of \p node.
+ *
+ * The counters come from the node numastat file and cover the whole
+ * system since boot; sample them twice and compare the differences to
+ * measure one workload. They count where pages were allocated, not
+ * where they are read from, so they only approximate the locality of
+ * the accesses (see NumaAllocStats.)
+ *
+ * \param[in] node  The node to read.
+ * \param[out] stats  The local and remote allocation counters.
+ *
+ * \return 0 on success, -1 if the counters are not available.
+ */
+int numaReadAllocStats(int node, NumaAllocStats& stats)
+{
+    std::ifstream in(("/sys/devices/system/node/node" + std::to_string(node) + "/numastat").c_str());
+    if(!in)
+    {
+        errno = ENOENT;
+        return -1;
+    }
+    stats = NumaAllocStats();
+    std::string name;
+    uint64_t value;
+    while(in >> name >> value)
+    {
+        if(name == "local_node")
+        {
+            stats.local = value;
+        }
+        else if(name == "other_node")
+        {
+            stats.remote = value;
+        }
+    }
+    return 0;
+}
+
+} // namespace udp_client_server
+#endif
+// vim: ts=4 sw=4 et
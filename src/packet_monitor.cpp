@@ -0,0 +1,466 @@
+// Packet Monitor -- passive UDP capture with a TPACKET_V3 ring
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_PACKET_MONITOR_CPP
+#define UDP_CLIENT_SERVER_PACKET_MONITOR_CPP
+
+#include <packet_monitor.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <linux/filter.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <vector>
+
+namespace udp_client_server
+{
+
+namespace
+{
+
+/** \brief Symbolic jump targets used while building the filter.
+ */
+enum FilterTarget
+{
+    FILTER_NEXT = -1,
+    FILTER_ACCEPT = -2,
+    FILTER_DROP = -3,
+    FILTER_IPV6 = -4
+};
+
+struct FilterInstruction
+{
+    struct sock_filter  code;
+    int                 jt;
+    int                 jf;
+};
+
+void emit(std::vector<FilterInstruction>& program, uint16_t code, uint32_t k,
+          int jt = FILTER_NEXT, int jf = FILTER_NEXT)
+{
+    FilterInstruction i;
+    i.code.code = code;
+    i.code.jt = 0;
+    i.code.jf = 0;
+    i.code.k = k;
+    i.jt = jt;
+    i.jf = jf;
+    program.push_back(i);
+}
+
+/** \brief Load a 16 bit port and accept the packet if it is \p port.
+ *
+ * When \p last is true the packet is dropped otherwise.
+ */
+void emitPortCheck(std::vector<FilterInstruction>& program, uint16_t load, uint32_t offset, int port, bool last)
+{
+    emit(program, load, offset);
+    emit(program, BPF_JMP | BPF_JEQ | BPF_K, static_cast<uint32_t>(port),
+                  FILTER_ACCEPT, last ? FILTER_DROP : FILTER_NEXT);
+}
+
+uint16_t read16(const unsigned char *p)
+{
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+} // no name namespace
+
+
+/** \brief Open a capture ring on interface \p ifname.
+ *
+ * The ring is made of \p block_count blocks of \p block_size bytes. The
+ * kernel fills one block at a time and hands it over when it is full or
+ * after 10 ms, so a block holds many packets when the traffic is heavy
+ * and latency stays bounded when it is light.
+ *
+ * \param[in] ifname  The interface to watch, i.e. "eth0" or "lo".
+ * \param[in] udp_port  Only capture datagrams from or to this port, 0 for all.
+ * \param[in] block_size  The size of one block, a multiple of the page size.
+ * \param[in] block_count  The number of blocks in the ring.
+ * \param[in] frame_size  The maximum size of one captured packet.
+ *
+ * \exception UdpClientServerRuntimeError
+ * The socket cannot be created (i.e. missing CAP_NET_RAW), the interface
+ * does not exist or the ring cannot be set up with these sizes.
+ */
+PacketMonitor::PacketMonitor(const std::string& ifname, int udp_port,
+                             size_t block_size, size_t block_count, size_t frame_size)
+    : f_socket_(-1)
+    , f_ring_(NULL)
+    , f_ring_size_(block_size * block_count)
+    , f_block_size_(block_size)
+    , f_block_count_(block_count)
+    , f_current_block_(0)
+    , f_handler_(NULL)
+    , f_user_(NULL)
+    , f_stats_(NULL)
+    , f_drops_(0)
+{
+    long const page_size(sysconf(_SC_PAGESIZE));
+    if(block_count == 0
+    || block_size == 0
+    || block_size % page_size != 0
+    || frame_size < TPACKET3_HDRLEN
+    || frame_size % TPACKET_ALIGNMENT != 0
+    || frame_size > block_size)
+    {
+        throw UdpClientServerRuntimeError("invalid ring geometry for packet monitor");
+    }
+    unsigned int const ifindex(if_nametoindex(ifname.c_str()));
+    if(ifindex == 0)
+    {
+        throw UdpClientServerRuntimeError(("unknown interface for packet monitor: \"" + ifname + "\"").c_str());
+    }
+
+    // no protocol yet: nothing is queued before the filter is attached
+    f_socket_ = socket(AF_PACKET, SOCK_RAW | SOCK_CLOEXEC, 0);
+    if(f_socket_ == -1)
+    {
+        throw UdpClientServerRuntimeError(("could not create packet socket, errno: " + std::to_string(errno)).c_str());
+    }
+    try
+    {
+        attachFilter(udp_port);
+
+        int version(TPACKET_V3);
+        if(setsockopt(f_socket_, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) != 0)
+        {
+            throw UdpClientServerRuntimeError(("could not select TPACKET_V3, errno: " + std::to_string(errno)).c_str());
+        }
+
+        struct tpacket_req3 req;
+        memset(&req, 0, sizeof(req));
+        req.tp_block_size = static_cast<unsigned int>(block_size);
+        req.tp_block_nr = static_cast<unsigned int>(block_count);
+        req.tp_frame_size = static_cast<unsigned int>(frame_size);
+        req.tp_frame_nr = static_cast<unsigned int>(f_ring_size_ / frame_size);
+        req.tp_retire_blk_tov = 10;
+        if(setsockopt(f_socket_, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) != 0)
+        {
+            throw UdpClientServerRuntimeError(("could not create packet ring, errno: " + std::to_string(errno)).c_str());
+        }
+
+        void *ring(mmap(NULL, f_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED, f_socket_, 0));
+        if(ring == MAP_FAILED)
+        {
+            // MAP_LOCKED fails when over RLIMIT_MEMLOCK, it is only an optimization
+            ring = mmap(NULL, f_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED, f_socket_, 0);
+            if(ring == MAP_FAILED)
+            {
+                throw UdpClientServerRuntimeError(("could not map packet ring, errno: " + std::to_string(errno)).c_str());
+            }
+        }
+        f_ring_ = static_cast<unsigned char *>(ring);
+
+        struct sockaddr_ll ll;
+        memset(&ll, 0, sizeof(ll));
+        ll.sll_family = AF_PACKET;
+        ll.sll_protocol = htons(ETH_P_ALL);
+        ll.sll_ifindex = static_cast<int>(ifindex);
+        if(bind(f_socket_, reinterpret_cast<struct sockaddr *>(&ll), sizeof(ll)) != 0)
+        {
+            throw UdpClientServerRuntimeError(("could not bind packet socket to \"" + ifname + "\", errno: " + std::to_string(errno)).c_str());
+        }
+    }
+    catch(...)
+    {
+        if(f_ring_ != NULL)
+        {
+            munmap(f_ring_, f_ring_size_);
+        }
+        close(f_socket_);
+        throw;
+    }
+}
+
+/** \brief Unmap the ring and close the socket.
+ */
+PacketMonitor::~PacketMonitor()
+{
+    munmap(f_ring_, f_ring_size_);
+    close(f_socket_);
+}
+
+/** \brief Attach the classic BPF program selecting the UDP datagrams.
+ *
+ * The program accepts received (not outgoing) non-fragmented IPv4 and
+ * IPv6 UDP packets on an Ethernet-like link, and if \p udp_port is not
+ * zero only the ones with that source or destination port.
+ *
+ * \exception UdpClientServerRuntimeError
+ * The kernel refuses the program.
+ */
+void PacketMonitor::attachFilter(int udp_port)
+{
+    std::vector<FilterInstruction> program;
+
+    // on loopback each packet is seen leaving and arriving: keep one
+    emit(program, BPF_LD | BPF_B | BPF_ABS, static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_PKTTYPE));
+    emit(program, BPF_JMP | BPF_JEQ | BPF_K, PACKET_OUTGOING, FILTER_DROP, FILTER_NEXT);
+
+    emit(program, BPF_LD | BPF_H | BPF_ABS, 12);
+    emit(program, BPF_JMP | BPF_JEQ | BPF_K, ETH_P_IPV6, FILTER_IPV6, FILTER_NEXT);
+    emit(program, BPF_JMP | BPF_JEQ | BPF_K, ETH_P_IP, FILTER_NEXT, FILTER_DROP);
+    emit(program, BPF_LD | BPF_B | BPF_ABS, 14 + 9);
+    emit(program, BPF_JMP | BPF_JEQ | BPF_K, IPPROTO_UDP, FILTER_NEXT, FILTER_DROP);
+    emit(program, BPF_LD | BPF_H | BPF_ABS, 14 + 6);
+    emit(program, BPF_JMP | BPF_JSET | BPF_K, 0x3FFF, FILTER_DROP, udp_port == 0 ? FILTER_ACCEPT : FILTER_NEXT);
+    if(udp_port != 0)
+    {
+        emit(program, BPF_LDX | BPF_B | BPF_MSH, 14);
+        emitPortCheck(program, BPF_LD | BPF_H | BPF_IND, 14, udp_port, false);
+        emitPortCheck(program, BPF_LD | BPF_H | BPF_IND, 14 + 2, udp_port, true);
+    }
+
+    size_t const ipv6(program.size());
+    emit(program, BPF_LD | BPF_B | BPF_ABS, 14 + 6);
+    emit(program, BPF_JMP | BPF_JEQ | BPF_K, IPPROTO_UDP, udp_port == 0 ? FILTER_ACCEPT : FILTER_NEXT, FILTER_DROP);
+    if(udp_port != 0)
+    {
+        emitPortCheck(program, BPF_LD | BPF_H | BPF_ABS, 14 + 40, udp_port, false);
+        emitPortCheck(program, BPF_LD | BPF_H | BPF_ABS, 14 + 40 + 2, udp_port, true);
+    }
+
+    size_t const accept(program.size());
+    emit(program, BPF_RET | BPF_K, 0x40000);
+    size_t const drop(program.size());
+    emit(program, BPF_RET | BPF_K, 0);
+
+    std::vector<struct sock_filter> code(program.size());
+    for(size_t i(0); i < program.size(); ++i)
+    {
+        code[i] = program[i].code;
+        if(BPF_CLASS(code[i].code) == BPF_JMP)
+        {
+            int const targets[2] = { program[i].jt, program[i].jf };
+            uint8_t *offsets[2] = { &code[i].jt, &code[i].jf };
+            for(int t(0); t < 2; ++t)
+            {
+                size_t const target(targets[t] == FILTER_ACCEPT ? accept
+                                  : targets[t] == FILTER_DROP   ? drop
+                                  : targets[t] == FILTER_IPV6   ? ipv6
+                                  : i + 1);
+                *offsets[t] = static_cast<uint8_t>(target - i - 1);
+            }
+        }
+    }
+
+    struct sock_fprog fprog;
+    fprog.len = static_cast<unsigned short>(code.size());
+    fprog.filter = &code[0];
+    if(setsockopt(f_socket_, SOL_SOCKET, SO_ATTACH_FILTER, &fprog, sizeof(fprog)) != 0)
+    {
+        throw UdpClientServerRuntimeError(("could not attach packet filter, errno: " + std::to_string(errno)).c_str());
+    }
+}
+
+/** \brief Return the AF_PACKET socket, i.e. to add it to an epoll set.
+ */
+int PacketMonitor::getSocket() const
+{
+    return f_socket_;
+}
+
+/** \brief Set the function called with each captured datagram.
+ *
+ * The view points inside the ring and is only valid during the call.
+ */
+void PacketMonitor::setHandler(Handler handler, void *user)
+{
+    f_handler_ = handler;
+    f_user_ = user;
+}
+
+/** \brief Account each captured datagram in \p stats, NULL to stop.
+ *
+ * The statistics are updated before the handler is called.
+ */
+void PacketMonitor::setStats(TrafficStats *stats)
+{
+    f_stats_ = stats;
+}
+
+/** \brief Process the blocks the kernel handed over.
+ *
+ * If no block is ready, wait for up to \p timeout_ms milliseconds for
+ * one (0 does not wait, -1 waits forever.) Then up to \p max_blocks of
+ * the ready blocks are processed and given back to the kernel; call
+ * poll() again with a timeout of 0 while it returns datagrams to catch
+ * up with a busy interface.
+ *
+ * \param[in] timeout_ms  How long to wait for a block.
+ * \param[in] max_blocks  The maximum number of blocks processed.
+ *
+ * \return The number of datagrams processed, or -1 if an error occurs.
+ * errno is set accordingly on error (EINTR if a signal interrupted the
+ * wait.)
+ */
+int PacketMonitor::poll(int timeout_ms, size_t max_blocks)
+{
+    int count(0);
+    for(size_t blocks(0); blocks < max_blocks; )
+    {
+        struct tpacket_block_desc *block(reinterpret_cast<struct tpacket_block_desc *>(
+                                            f_ring_ + f_current_block_ * f_block_size_));
+        if((__atomic_load_n(&block->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) == 0)
+        {
+            if(count > 0 || timeout_ms == 0)
+            {
+                return count;
+            }
+            struct pollfd fd;
+            fd.fd = f_socket_;
+            fd.events = POLLIN | POLLERR;
+            fd.revents = 0;
+            int const r(::poll(&fd, 1, timeout_ms));
+            if(r <= 0)
+            {
+                return r;
+            }
+            // only wait once
+            timeout_ms = 0;
+            continue;
+        }
+
+        const unsigned char *packet(reinterpret_cast<const unsigned char *>(block) + block->hdr.bh1.offset_to_first_pkt);
+        for(uint32_t i(0); i < block->hdr.bh1.num_pkts; ++i)
+        {
+            const struct tpacket3_hdr *hdr(reinterpret_cast<const struct tpacket3_hdr *>(packet));
+            UdpPacketView view;
+            uint64_t const timestamp_ns(static_cast<uint64_t>(hdr->tp_sec) * 1000000000ULL + hdr->tp_nsec);
+            if(decode(packet + hdr->tp_mac, hdr->tp_snaplen, timestamp_ns, view))
+            {
+                if(f_stats_ != NULL)
+                {
+                    f_stats_->observe(view);
+                }
+                if(f_handler_ != NULL)
+                {
+                    f_handler_(f_user_, view);
+                }
+                ++count;
+            }
+            packet += hdr->tp_next_offset;
+        }
+
+        __atomic_store_n(&block->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+        f_current_block_ = (f_current_block_ + 1) % f_block_count_;
+        ++blocks;
+    }
+    return count;
+}
+
+/** \brief Decode the Ethernet, IP and UDP headers of a captured frame.
+ *
+ * \return true if \p view describes a UDP datagram.
+ */
+bool PacketMonitor::decode(const unsigned char *frame, size_t size, uint64_t timestamp_ns,
+                           UdpPacketView& view) const
+{
+    if(size < 14)
+    {
+        return false;
+    }
+    uint16_t const ethertype(read16(frame + 12));
+    const unsigned char *ip(frame + 14);
+    size_t const ip_size(size - 14);
+    size_t header_size;
+    memset(&view.source, 0, sizeof(view.source));
+    memset(&view.destination, 0, sizeof(view.destination));
+    if(ethertype == ETH_P_IP)
+    {
+        header_size = (ip[0] & 0x0F) * 4;
+        if(ip_size < 20 || header_size < 20 || ip_size < header_size + 8 || ip[9] != IPPROTO_UDP)
+        {
+            return false;
+        }
+        struct sockaddr_in *source(reinterpret_cast<struct sockaddr_in *>(&view.source));
+        struct sockaddr_in *destination(reinterpret_cast<struct sockaddr_in *>(&view.destination));
+        source->sin_family = AF_INET;
+        destination->sin_family = AF_INET;
+        memcpy(&source->sin_addr, ip + 12, 4);
+        memcpy(&destination->sin_addr, ip + 16, 4);
+        memcpy(&source->sin_port, ip + header_size, 2);
+        memcpy(&destination->sin_port, ip + header_size + 2, 2);
+        view.source_len = sizeof(struct sockaddr_in);
+        view.destination_len = sizeof(struct sockaddr_in);
+    }
+    else if(ethertype == ETH_P_IPV6)
+    {
+        header_size = 40;
+        if(ip_size < header_size + 8 || ip[6] != IPPROTO_UDP)
+        {
+            return false;
+        }
+        struct sockaddr_in6 *source(reinterpret_cast<struct sockaddr_in6 *>(&view.source));
+        struct sockaddr_in6 *destination(reinterpret_cast<struct sockaddr_in6 *>(&view.destination));
+        source->sin6_family = AF_INET6;
+        destination->sin6_family = AF_INET6;
+        memcpy(&source->sin6_addr, ip + 8, 16);
+        memcpy(&destination->sin6_addr, ip + 24, 16);
+        memcpy(&source->sin6_port, ip + header_size, 2);
+        memcpy(&destination->sin6_port, ip + header_size + 2, 2);
+        view.source_len = sizeof(struct sockaddr_in6);
+        view.destination_len = sizeof(struct sockaddr_in6);
+    }
+    else
+    {
+        return false;
+    }
+
+    uint16_t const udp_length(read16(ip + header_size + 4));
+    if(udp_length < 8)
+    {
+        return false;
+    }
+    size_t const captured(ip_size - header_size - 8);
+    view.data = reinterpret_cast<const char *>(ip + header_size + 8);
+    view.wire_size = udp_length - 8;
+    view.size = captured < view.wire_size ? captured : view.wire_size;
+    view.timestamp_ns = timestamp_ns;
+    return true;
+}
+
+/** \brief Number of packets the kernel dropped because the ring was full.
+ *
+ * \return The total since the monitor was created, or -1 if an error
+ * occurs. errno is set accordingly on error.
+ */
+int64_t PacketMonitor::getDropCount()
+{
+    // the kernel resets its counters each time they are read
+    struct tpacket_stats_v3 stats;
+    socklen_t len(sizeof(stats));
+    if(getsockopt(f_socket_, SOL_PACKET, PACKET_STATISTICS, &stats, &len) != 0)
+    {
+        return -1;
+    }
+    f_drops_ += stats.tp_drops;
+    return f_drops_;
+}
+
+} // namespace udp_client_server
+#endif
+// vim: ts=4 sw=4 et
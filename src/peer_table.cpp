@@ -0,0 +1,113 @@
+// Peer Table -- per-source state for UDP servers
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_PEER_TABLE_CPP
+#define UDP_CLIENT_SERVER_PEER_TABLE_CPP
+
+#include <peer_table.h>
+#include <arpa/inet.h>
+#include <string.h>
+
+namespace udp_client_server
+{
+
+/** \brief Initialize an empty key (family AF_UNSPEC.)
+ */
+PeerKey::PeerKey()
+    : port(0)
+    , family(AF_UNSPEC)
+{
+    memset(address, 0, sizeof(address));
+}
+
+/** \brief Build the key of a socket address.
+ *
+ * \param[in] addr  An AF_INET or AF_INET6 address, as returned by
+ * recvfrom(). Other families give an AF_UNSPEC key.
+ */
+PeerKey::PeerKey(const struct sockaddr *addr)
+    : port(0)
+    , family(AF_UNSPEC)
+{
+    memset(address, 0, sizeof(address));
+    if(addr->sa_family == AF_INET)
+    {
+        const struct sockaddr_in *in(reinterpret_cast<const struct sockaddr_in *>(addr));
+        address[10] = 0xFF;
+        address[11] = 0xFF;
+        memcpy(address + 12, &in->sin_addr, 4);
+        port = ntohs(in->sin_port);
+        family = AF_INET;
+    }
+    else if(addr->sa_family == AF_INET6)
+    {
+        const struct sockaddr_in6 *in6(reinterpret_cast<const struct sockaddr_in6 *>(addr));
+        memcpy(address, &in6->sin6_addr, 16);
+        port = ntohs(in6->sin6_port);
+        family = AF_INET6;
+    }
+}
+
+/** \brief Convert the key back to a socket address.
+ *
+ * \param[out] addr  The socket address, i.e. to reply with sendto().
+ *
+ * \return The length of the address, 0 for an AF_UNSPEC key.
+ */
+socklen_t PeerKey::toSockaddr(struct sockaddr_storage& addr) const
+{
+    memset(&addr, 0, sizeof(addr));
+    if(family == AF_INET)
+    {
+        struct sockaddr_in *in(reinterpret_cast<struct sockaddr_in *>(&addr));
+        in->sin_family = AF_INET;
+        in->sin_port = htons(port);
+        memcpy(&in->sin_addr, address + 12, 4);
+        return sizeof(struct sockaddr_in);
+    }
+    if(family == AF_INET6)
+    {
+        struct sockaddr_in6 *in6(reinterpret_cast<struct sockaddr_in6 *>(&addr));
+        in6->sin6_family = AF_INET6;
+        in6->sin6_port = htons(port);
+        memcpy(&in6->sin6_addr, address, 16);
+        return sizeof(struct sockaddr_in6);
+    }
+    return 0;
+}
+
+/** \brief Return the key as "address:port", i.e. for logs.
+ */
+std::string PeerKey::toString() const
+{
+    char buf[INET6_ADDRSTRLEN];
+    if(family == AF_INET)
+    {
+        inet_ntop(AF_INET, address + 12, buf, sizeof(buf));
+        return std::string(buf) + ":" + std::to_string(port);
+    }
+    if(family == AF_INET6)
+    {
+        inet_ntop(AF_INET6, address, buf, sizeof(buf));
+        return "[" + std::string(buf) + "]:" + std::to_string(port);
+    }
+    return "unspec";
+}
+
+} // namespace udp_client_server
+#endif
+// vim: ts=4 sw=4 et
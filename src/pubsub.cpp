@@ -0,0 +1,676 @@
+// Publish/Subscribe -- topic routing over UDP with hashed topic IDs
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_PUBSUB_CPP
+#define UDP_CLIENT_SERVER_PUBSUB_CPP
+
+#include <pubsub.h>
+#include <basic_udp_socket.h>
+#include <peer_table.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <string.h>
+#include <algorithm>
+#include <random>
+
+namespace udp_client_server
+{
+
+namespace
+{
+
+/** \brief Size of the buffers receiving datagrams, large enough for any of them.
+ */
+const size_t PUBSUB_BUFFER_SIZE = 65536;
+
+/** \brief Number of subscribers sent to per sendmmsg() call.
+ */
+const size_t PUBSUB_SEND_BATCH = 64;
+
+/** \brief One SipRound of SipHash.
+ */
+inline void sipRound(uint64_t& v0, uint64_t& v1, uint64_t& v2, uint64_t& v3)
+{
+    v0 += v1; v1 = (v1 << 13) | (v1 >> 51); v1 ^= v0; v0 = (v0 << 32) | (v0 >> 32);
+    v2 += v3; v3 = (v3 << 16) | (v3 >> 48); v3 ^= v2;
+    v0 += v3; v3 = (v3 << 21) | (v3 >> 43); v3 ^= v0;
+    v2 += v1; v1 = (v1 << 17) | (v1 >> 47); v1 ^= v2; v2 = (v2 << 32) | (v2 >> 32);
+}
+
+/** \brief SipHash-2-4 of \p count 64 bit words with the 128 bit \p key.
+ *
+ * The subscription cookies must not be predictable from the cookies an
+ * attacker receives for its own addresses, which a plain hash such as
+ * PeerKeyHash does not guarantee.
+ */
+uint64_t sipHash24(const uint64_t key[2], const uint64_t *words, size_t count)
+{
+    uint64_t v0(key[0] ^ 0x736F6D6570736575ULL);
+    uint64_t v1(key[1] ^ 0x646F72616E646F6DULL);
+    uint64_t v2(key[0] ^ 0x6C7967656E657261ULL);
+    uint64_t v3(key[1] ^ 0x7465646279746573ULL);
+    for(size_t i(0); i < count; ++i)
+    {
+        v3 ^= words[i];
+        sipRound(v0, v1, v2, v3);
+        sipRound(v0, v1, v2, v3);
+        v0 ^= words[i];
+    }
+    uint64_t const last(static_cast<uint64_t>(count * 8) << 56);
+    v3 ^= last;
+    sipRound(v0, v1, v2, v3);
+    sipRound(v0, v1, v2, v3);
+    v0 ^= last;
+    v2 ^= 0xFF;
+    sipRound(v0, v1, v2, v3);
+    sipRound(v0, v1, v2, v3);
+    sipRound(v0, v1, v2, v3);
+    sipRound(v0, v1, v2, v3);
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+} // no name namespace
+
+const uint8_t PubSubHeader::DATA;
+const uint8_t PubSubHeader::SUBSCRIBE;
+const uint8_t PubSubHeader::UNSUBSCRIBE;
+const uint8_t PubSubHeader::CHALLENGE;
+const uint8_t PubSubHeader::FLAG_MULTICAST;
+const size_t PubSubHeader::SIZE;
+const size_t PubSubHeader::COOKIE_SIZE;
+
+// ========================= HEADER =========================
+
+/** \brief Save the header in the first SIZE bytes of \p buffer.
+ */
+void PubSubHeader::write(char *buffer) const
+{
+    uint16_t const s(htons(sequence));
+    uint32_t const t(htonl(topic));
+    buffer[0] = static_cast<char>(kind);
+    buffer[1] = static_cast<char>(flags);
+    memcpy(buffer + 2, &s, sizeof(s));
+    memcpy(buffer + 4, &t, sizeof(t));
+}
+
+/** \brief Load the header from \p buffer.
+ *
+ * \return false if \p buffer is too small or is not a pub/sub message.
+ */
+bool PubSubHeader::read(const char *buffer, size_t size)
+{
+    if(size < SIZE)
+    {
+        return false;
+    }
+    kind = static_cast<uint8_t>(buffer[0]);
+    flags = static_cast<uint8_t>(buffer[1]);
+    uint16_t s;
+    uint32_t t;
+    memcpy(&s, buffer + 2, sizeof(s));
+    memcpy(&t, buffer + 4, sizeof(t));
+    sequence = ntohs(s);
+    topic = ntohl(t);
+    return kind == DATA || kind == SUBSCRIBE || kind == UNSUBSCRIBE || kind == CHALLENGE;
+}
+
+// ========================= PUBLISHER =========================
+
+/** \brief Initialize a publisher receiving subscriptions on \p server.
+ *
+ * Messages are sent from the socket of \p server, so subscribers only
+ * need to know this one address and port.
+ *
+ * \param[in] server  The server subscribers send their subscriptions to.
+ * \param[in] max_topics  The maximum number of topics with subscribers.
+ * \param[in] max_members  The maximum number of subscribers of one topic;
+ * further subscriptions are ignored until a subscriber leaves.
+ */
+Publisher::Publisher(UdpServer& server, size_t max_topics, size_t max_members)
+    : f_server_(server)
+    , f_topics_(max_topics)
+    , f_max_members_(max_members == 0 ? 1 : max_members)
+    , f_group_len_(0)
+    , f_multicast_threshold_(0)
+    , f_timeout_ns_(5000000000ULL)
+    , f_last_expiry_ns_(0)
+    , f_multicast_sent_(0)
+    , f_buffer_(PUBSUB_BUFFER_SIZE)
+{
+    memset(&f_group_, 0, sizeof(f_group_));
+    std::random_device random;
+    for(size_t i(0); i < 2; ++i)
+    {
+        f_secret_[i] = (static_cast<uint64_t>(random()) << 32) ^ random();
+    }
+}
+
+/** \brief Allow sending to a multicast group.
+ *
+ * A topic is published with a single datagram to the group when it has
+ * at least \p threshold subscribers and all of them said they listen on
+ * the group; otherwise it is sent to each subscriber. Below a few
+ * subscribers unicast is cheaper for the network and the receivers,
+ * which do not get the traffic of the topics they did not subscribe to.
+ *
+ * \exception UdpClientServerRuntimeError
+ * The group address cannot be resolved.
+ *
+ * \param[in] group  The multicast group address.
+ * \param[in] port  The port the subscribers listen on.
+ * \param[in] threshold  The minimum number of subscribers to use multicast.
+ */
+void Publisher::setMulticastGroup(const std::string& group, int port, size_t threshold)
+{
+    f_group_len_ = resolveUdpAddress(group, port, AF_UNSPEC, f_group_);
+    f_multicast_threshold_ = threshold == 0 ? 1 : threshold;
+}
+
+/** \brief Change how long a subscription lasts without being refreshed.
+ *
+ * Subscribers refresh their subscriptions at their refresh interval,
+ * which must be well below this timeout.
+ */
+void Publisher::setSubscriptionTimeout(uint64_t timeout_ns)
+{
+    f_timeout_ns_ = timeout_ns;
+}
+
+/** \brief Process the subscriptions received and expire the old ones.
+ *
+ * Call this function when the publisher socket is readable and from
+ * time to time so subscribers that went away are forgotten. Topics
+ * left without subscribers are removed.
+ *
+ * SUBSCRIBE messages without the cookie of their source address are
+ * answered with a CHALLENGE and otherwise ignored; UNSUBSCRIBE messages
+ * without it are ignored.
+ *
+ * \param[in] now_ns  The current monotonic time.
+ * \param[in] max_messages  The maximum number of datagrams read by this
+ * call, so a flood of subscriptions cannot starve the caller.
+ *
+ * \return The number of subscription messages processed, or -1 if the
+ * socket reported an error. errno is set accordingly.
+ */
+int Publisher::poll(uint64_t now_ns, size_t max_messages)
+{
+    int processed(0);
+    for(size_t received(0); received < max_messages; ++received)
+    {
+        struct sockaddr_storage from;
+        socklen_t from_len(sizeof(from));
+        int const r(f_server_.recvFrom(&f_buffer_[0], f_buffer_.size(), &from, &from_len));
+        if(r < 0)
+        {
+            if(errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+        PubSubHeader header;
+        if(!header.read(&f_buffer_[0], static_cast<size_t>(r))
+        || static_cast<size_t>(r) < PubSubHeader::SIZE + PubSubHeader::COOKIE_SIZE
+        || (header.kind != PubSubHeader::SUBSCRIBE && header.kind != PubSubHeader::UNSUBSCRIBE))
+        {
+            continue;
+        }
+        char expected[PubSubHeader::SIZE + PubSubHeader::COOKIE_SIZE];
+        cookie(from, expected + PubSubHeader::SIZE);
+        if(memcmp(&f_buffer_[PubSubHeader::SIZE], expected + PubSubHeader::SIZE, PubSubHeader::COOKIE_SIZE) != 0)
+        {
+            if(header.kind == PubSubHeader::SUBSCRIBE)
+            {
+                // no larger than the SUBSCRIBE, so it cannot amplify a spoofed one
+                header.kind = PubSubHeader::CHALLENGE;
+                header.flags = 0;
+                header.write(expected);
+                sendto(f_server_.getSocket(), expected, sizeof(expected), 0
+                     , reinterpret_cast<struct sockaddr *>(&from), from_len);
+            }
+            continue;
+        }
+        if(header.kind == PubSubHeader::SUBSCRIBE)
+        {
+            subscribe(header.topic, from, from_len, (header.flags & PubSubHeader::FLAG_MULTICAST) != 0, now_ns);
+        }
+        else
+        {
+            unsubscribe(header.topic, from, from_len);
+        }
+        ++processed;
+    }
+
+    if(now_ns - f_last_expiry_ns_ >= f_timeout_ns_ / 4)
+    {
+        f_last_expiry_ns_ = now_ns;
+        expire(now_ns);
+    }
+    return processed;
+}
+
+/** \brief Send \p msg to the subscribers of \p topic.
+ *
+ * Subscribers whose datagram cannot be sent (i.e. the socket buffer is
+ * full) are skipped; like any UDP datagram, a message may be lost.
+ *
+ * \param[in] topic  The topic ID, see topicId().
+ * \param[in] msg  The message.
+ * \param[in] size  The size of \p msg.
+ *
+ * \return The number of datagrams sent: 0 if the topic has no
+ * subscribers, 1 when sent to the multicast group.
+ */
+int Publisher::publish(uint32_t topic, const char *msg, size_t size)
+{
+    Topic *t(f_topics_.find(topic));
+    if(t == NULL || t->members.empty())
+    {
+        return 0;
+    }
+
+    char buffer[PubSubHeader::SIZE];
+    PubSubHeader header;
+    header.kind = PubSubHeader::DATA;
+    header.flags = 0;
+    header.sequence = t->sequence++;
+    header.topic = topic;
+    header.write(buffer);
+    struct iovec iov[2];
+    iov[0].iov_base = buffer;
+    iov[0].iov_len = sizeof(buffer);
+    iov[1].iov_base = const_cast<char *>(msg);
+    iov[1].iov_len = size;
+
+    if(f_group_len_ != 0
+    && t->members.size() >= f_multicast_threshold_
+    && t->multicast_members == t->members.size())
+    {
+        struct msghdr hdr;
+        memset(&hdr, 0, sizeof(hdr));
+        hdr.msg_name = &f_group_;
+        hdr.msg_namelen = f_group_len_;
+        hdr.msg_iov = iov;
+        hdr.msg_iovlen = 2;
+        if(sendmsg(f_server_.getSocket(), &hdr, 0) < 0)
+        {
+            return 0;
+        }
+        ++f_multicast_sent_;
+        return 1;
+    }
+
+    struct mmsghdr msgs[PUBSUB_SEND_BATCH];
+    size_t const count(t->members.size());
+    int sent(0);
+    size_t i(0);
+    while(i < count)
+    {
+        size_t const chunk(std::min(count - i, PUBSUB_SEND_BATCH));
+        memset(msgs, 0, sizeof(msgs[0]) * chunk);
+        for(size_t j(0); j < chunk; ++j)
+        {
+            msgs[j].msg_hdr.msg_name = &t->members[i + j].addr;
+            msgs[j].msg_hdr.msg_namelen = t->members[i + j].addrlen;
+            msgs[j].msg_hdr.msg_iov = iov;
+            msgs[j].msg_hdr.msg_iovlen = 2;
+        }
+        int const r(sendmmsg(f_server_.getSocket(), msgs, static_cast<unsigned int>(chunk), 0));
+        if(r <= 0)
+        {
+            // skip the subscriber that failed
+            ++i;
+            continue;
+        }
+        sent += r;
+        i += static_cast<size_t>(r);
+    }
+    return sent;
+}
+
+/** \brief Number of current subscribers of \p topic.
+ */
+size_t Publisher::getSubscriberCount(uint32_t topic) const
+{
+    const Topic *t(f_topics_.find(topic));
+    return t == NULL ? 0 : t->members.size();
+}
+
+/** \brief Number of messages sent to the multicast group.
+ */
+uint64_t Publisher::getMulticastCount() const
+{
+    return f_multicast_sent_;
+}
+
+/** \brief Add or refresh the subscription of \p from to \p topic.
+ */
+void Publisher::subscribe(uint32_t topic, const struct sockaddr_storage& from, socklen_t from_len,
+                          bool multicast, uint64_t now_ns)
+{
+    Topic *t(f_topics_.insert(topic));
+    if(t == NULL)
+    {
+        return;
+    }
+    for(size_t i(0); i < t->members.size(); ++i)
+    {
+        Member& m(t->members[i]);
+        if(m.addrlen == from_len && memcmp(&m.addr, &from, from_len) == 0)
+        {
+            m.last_seen_ns = now_ns;
+            if(m.multicast != multicast)
+            {
+                m.multicast = multicast;
+                if(multicast)
+                {
+                    ++t->multicast_members;
+                }
+                else
+                {
+                    --t->multicast_members;
+                }
+            }
+            return;
+        }
+    }
+    if(t->members.size() >= f_max_members_)
+    {
+        return;
+    }
+    Member m;
+    memset(&m.addr, 0, sizeof(m.addr));
+    memcpy(&m.addr, &from, from_len);
+    m.addrlen = from_len;
+    m.last_seen_ns = now_ns;
+    m.multicast = multicast;
+    t->members.push_back(m);
+    if(multicast)
+    {
+        ++t->multicast_members;
+    }
+}
+
+/** \brief Remove the subscription of \p from to \p topic.
+ */
+void Publisher::unsubscribe(uint32_t topic, const struct sockaddr_storage& from, socklen_t from_len)
+{
+    Topic *t(f_topics_.find(topic));
+    if(t == NULL)
+    {
+        return;
+    }
+    for(size_t i(0); i < t->members.size(); ++i)
+    {
+        Member const& m(t->members[i]);
+        if(m.addrlen == from_len && memcmp(&m.addr, &from, from_len) == 0)
+        {
+            if(m.multicast)
+            {
+                --t->multicast_members;
+            }
+            t->members.erase(t->members.begin() + i);
+            break;
+        }
+    }
+    if(t->members.empty())
+    {
+        f_topics_.erase(topic);
+    }
+}
+
+/** \brief Compute the subscription cookie of \p from.
+ *
+ * \param[in] from  The address of the subscriber.
+ * \param[out] buffer  Receives the COOKIE_SIZE bytes of the cookie.
+ */
+void Publisher::cookie(const struct sockaddr_storage& from, char *buffer) const
+{
+    PeerKey const key(reinterpret_cast<const struct sockaddr *>(&from));
+    uint64_t words[3];
+    memcpy(&words[0], key.address, 8);
+    memcpy(&words[1], key.address + 8, 8);
+    words[2] = key.port | (static_cast<uint64_t>(key.family) << 16);
+    uint64_t const h(sipHash24(f_secret_, words, 3));
+    memcpy(buffer, &h, PubSubHeader::COOKIE_SIZE);
+}
+
+/** \brief Drop the subscriptions not refreshed in time and the empty topics.
+ */
+void Publisher::expire(uint64_t now_ns)
+{
+    uint64_t const timeout(f_timeout_ns_);
+    f_topics_.eraseIf([now_ns, timeout](uint32_t, Topic& topic)
+        {
+            for(size_t i(topic.members.size()); i > 0; --i)
+            {
+                Member const& m(topic.members[i - 1]);
+                if(m.last_seen_ns + timeout < now_ns)
+                {
+                    if(m.multicast)
+                    {
+                        --topic.multicast_members;
+                    }
+                    topic.members.erase(topic.members.begin() + (i - 1));
+                }
+            }
+            return topic.members.empty();
+        });
+}
+
+// ========================= SUBSCRIBER =========================
+
+/** \brief Initialize a subscriber receiving messages on \p server.
+ *
+ * \exception UdpClientServerRuntimeError
+ * The publisher address cannot be resolved.
+ *
+ * \param[in] server  The server messages are received on.
+ * \param[in] publisher_addr  The address of the publisher server.
+ * \param[in] publisher_port  The port of the publisher server.
+ * \param[in] max_topics  The maximum number of subscriptions.
+ */
+Subscriber::Subscriber(UdpServer& server, const std::string& publisher_addr, int publisher_port, size_t max_topics)
+    : f_server_(server)
+    , f_publisher_len_(0)
+    , f_subscriptions_(max_topics)
+    , f_refresh_ns_(1000000000ULL)
+    , f_last_refresh_ns_(0)
+    , f_lost_(0)
+    , f_unknown_(0)
+    , f_buffer_(PUBSUB_BUFFER_SIZE)
+{
+    f_publisher_len_ = resolveUdpAddress(publisher_addr, publisher_port, AF_UNSPEC, f_publisher_);
+    memset(f_cookie_, 0, sizeof(f_cookie_));
+}
+
+/** \brief Change how often the subscriptions are sent again to the publisher.
+ *
+ * Keep it well below the subscription timeout of the publisher (5
+ * seconds by default) so a couple of lost refreshes do not matter.
+ */
+void Subscriber::setRefreshInterval(uint64_t interval_ns)
+{
+    f_refresh_ns_ = interval_ns;
+}
+
+/** \brief Start receiving the messages of \p topic.
+ *
+ * When \p multicast is true, the server must have joined the multicast
+ * group of the publisher (see UdpServer::joinMulticastGroup()) and be
+ * bound to its port; the publisher may then send the topic to the group.
+ *
+ * \param[in] topic  The topic ID, see topicId().
+ * \param[in] callback  The function receiving the messages.
+ * \param[in] user  A pointer passed back to \p callback.
+ * \param[in] multicast  Whether this subscriber listens on the group.
+ *
+ * \return 0 on success, -1 if an error occurs. errno is set to ENOSPC when
+ * the subscription table is full. If only sending the subscription
+ * failed, it is kept and sent again at the next refresh.
+ */
+int Subscriber::subscribe(uint32_t topic, Callback callback, void *user, bool multicast)
+{
+    Subscription *s(f_subscriptions_.insert(topic));
+    if(s == NULL)
+    {
+        errno = ENOSPC;
+        return -1;
+    }
+    s->callback = callback;
+    s->user = user;
+    s->multicast = multicast;
+    return sendControl(PubSubHeader::SUBSCRIBE, topic, multicast);
+}
+
+/** \brief Stop receiving the messages of \p topic.
+ *
+ * \return 0 on success, -1 if an error occurs. errno is set to ENOENT if
+ * there was no such subscription.
+ */
+int Subscriber::unsubscribe(uint32_t topic)
+{
+    if(!f_subscriptions_.erase(topic))
+    {
+        errno = ENOENT;
+        return -1;
+    }
+    return sendControl(PubSubHeader::UNSUBSCRIBE, topic, false);
+}
+
+/** \brief Deliver the messages waiting in the socket.
+ *
+ * The subscriptions are refreshed from here, so call it at least once
+ * per refresh interval even when no messages arrive.
+ *
+ * \param[in] now_ns  The current monotonic time.
+ * \param[in] max_messages  The maximum number of datagrams read by this
+ * call. Datagrams which are not delivered (challenges, messages of
+ * unknown topics, invalid datagrams) count too.
+ *
+ * \return The number of messages delivered, or -1 if the socket reported
+ * an error before any message was delivered. errno is set accordingly.
+ */
+int Subscriber::poll(uint64_t now_ns, size_t max_messages)
+{
+    if(now_ns - f_last_refresh_ns_ >= f_refresh_ns_)
+    {
+        f_last_refresh_ns_ = now_ns;
+        Subscriber *self(this);
+        f_subscriptions_.forEach([self](uint32_t topic, Subscription& s)
+            {
+                self->sendControl(PubSubHeader::SUBSCRIBE, topic, s.multicast);
+            });
+    }
+
+    int delivered(0);
+    for(size_t count(0); count < max_messages; ++count)
+    {
+        int const r(f_server_.recv(&f_buffer_[0], f_buffer_.size()));
+        if(r < 0)
+        {
+            if(errno == EAGAIN || errno == EWOULDBLOCK || delivered > 0)
+            {
+                break;
+            }
+            return -1;
+        }
+        PubSubHeader header;
+        if(!header.read(&f_buffer_[0], static_cast<size_t>(r)))
+        {
+            continue;
+        }
+        if(header.kind == PubSubHeader::CHALLENGE)
+        {
+            Subscription const *s(f_subscriptions_.find(header.topic));
+            if(s != NULL
+            && static_cast<size_t>(r) >= PubSubHeader::SIZE + PubSubHeader::COOKIE_SIZE)
+            {
+                memcpy(f_cookie_, &f_buffer_[PubSubHeader::SIZE], sizeof(f_cookie_));
+                sendControl(PubSubHeader::SUBSCRIBE, header.topic, s->multicast);
+            }
+            continue;
+        }
+        if(header.kind != PubSubHeader::DATA)
+        {
+            continue;
+        }
+        Subscription *s(f_subscriptions_.find(header.topic));
+        if(s == NULL)
+        {
+            // late messages after unsubscribe(), or multicast traffic of other topics
+            ++f_unknown_;
+            continue;
+        }
+        if(s->started)
+        {
+            uint16_t const gap(static_cast<uint16_t>(header.sequence - s->next_sequence));
+            if(gap < 0x8000)
+            {
+                f_lost_ += gap;
+            }
+        }
+        s->started = true;
+        s->next_sequence = static_cast<uint16_t>(header.sequence + 1);
+        s->callback(s->user, header.topic, &f_buffer_[PubSubHeader::SIZE], static_cast<size_t>(r) - PubSubHeader::SIZE);
+        ++delivered;
+    }
+    return delivered;
+}
+
+/** \brief Number of messages missing from the sequence of their topic.
+ */
+uint64_t Subscriber::getLostCount() const
+{
+    return f_lost_;
+}
+
+/** \brief Number of messages received for topics not subscribed to.
+ */
+uint64_t Subscriber::getUnknownTopicCount() const
+{
+    return f_unknown_;
+}
+
+/** \brief Send a SUBSCRIBE or UNSUBSCRIBE message to the publisher.
+ *
+ * The message carries the last cookie received from the publisher, all
+ * zeroes until the first CHALLENGE.
+ */
+int Subscriber::sendControl(uint8_t kind, uint32_t topic, bool multicast)
+{
+    char buffer[PubSubHeader::SIZE + PubSubHeader::COOKIE_SIZE];
+    PubSubHeader header;
+    header.kind = kind;
+    header.flags = multicast ? PubSubHeader::FLAG_MULTICAST : 0;
+    header.sequence = 0;
+    header.topic = topic;
+    header.write(buffer);
+    memcpy(buffer + PubSubHeader::SIZE, f_cookie_, sizeof(f_cookie_));
+    int const r(sendto(f_server_.getSocket(), buffer, sizeof(buffer), 0
+                     , reinterpret_cast<struct sockaddr *>(&f_publisher_), f_publisher_len_));
+    return r < 0 ? -1 : 0;
+}
+
+} // namespace udp_client_server
+#endif
+// vim: ts=4 sw=4 et
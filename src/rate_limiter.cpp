@@ -0,0 +1,283 @@
+// Rate Limiter -- per-peer token buckets for UDP servers
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_RATE_LIMITER_CPP
+#define UDP_CLIENT_SERVER_RATE_LIMITER_CPP
+
+#include <rate_limiter.h>
+#include <monotonic_clock.h>
+#include <errno.h>
+#include <string.h>
+#include <algorithm>
+
+namespace udp_client_server
+{
+
+namespace
+{
+
+/** \brief Size of a bucket: the burst, or one second of the rate if 0.
+ */
+double bucketSize(double rate, double burst)
+{
+    return burst > 0.0 ? burst : rate;
+}
+
+/** \brief Refill a token bucket and try to take \p cost tokens from it.
+ *
+ * A rate of 0 means unlimited, the bucket always has tokens.
+ */
+bool takeTokens(double& tokens, double rate, double burst, double elapsed_sec, double cost)
+{
+    if(rate <= 0.0)
+    {
+        return true;
+    }
+    tokens = std::min(std::max(bucketSize(rate, burst), cost), tokens + rate * elapsed_sec);
+    return tokens >= cost;
+}
+
+} // no name namespace
+
+
+const size_t PeerRateLimiter::MAX_REJECTED_PER_CALL;
+
+
+/** \brief Initialize a per-peer rate limiter.
+ *
+ * Each source endpoint gets a packet bucket and a byte bucket, refilled at
+ * the rates given in \p limit. A packet is admitted only if both buckets
+ * have enough tokens. New peers start with full buckets, so their first
+ * packet is always admitted.
+ *
+ * The limiter is meant to be checked right after a packet is received and
+ * before it gets parsed, so a flooding peer costs one system call and one
+ * hash lookup per packet and nothing more. recv() does exactly that.
+ *
+ * \param[in] limit  The budget of each peer.
+ * \param[in] max_peers  The number of peers tracked. Packets from new
+ * peers are dropped while the table is full, see evictIdle().
+ * \param[in] policy  Whether packets over budget are dropped or deferred.
+ * \param[in] max_deferred  How many deferred packets are kept, extra
+ * ones are dropped.
+ */
+PeerRateLimiter::PeerRateLimiter(const RateLimit& limit, size_t max_peers, OverBudgetPolicy policy, size_t max_deferred)
+    : f_limit_(limit)
+    , f_policy_(policy)
+    , f_max_deferred_(max_deferred)
+    , f_peers_(max_peers)
+    , f_dropped_(0)
+    , f_untracked_dropped_(0)
+{
+}
+
+/** \brief Change the budget of the peers.
+ *
+ * The buckets keep their current tokens, clamped to the new bursts on
+ * their next refill.
+ */
+void PeerRateLimiter::setLimit(const RateLimit& limit)
+{
+    f_limit_ = limit;
+}
+
+/** \brief Return the budget of the peers.
+ */
+const RateLimit& PeerRateLimiter::getLimit() const
+{
+    return f_limit_;
+}
+
+/** \brief Check a packet against the budget of its sender.
+ *
+ * The packet is accounted in the sender's entry: accepted, or dropped.
+ *
+ * \param[in] from  The address of the sender.
+ * \param[in] size  The size of the packet in bytes.
+ * \param[in] now_ns  The current monotonic time.
+ *
+ * \return true if the packet is within budget.
+ */
+bool PeerRateLimiter::admit(const struct sockaddr_storage& from, size_t size, uint64_t now_ns)
+{
+    Table::Entry *peer(f_peers_.touch(from, now_ns, size));
+    if(peer == NULL)
+    {
+        ++f_untracked_dropped_;
+        ++f_dropped_;
+        return false;
+    }
+
+    PeerRateState& state(peer->state);
+    double const bytes(static_cast<double>(size));
+    if(peer->packets == 1)
+    {
+        state.packet_tokens = std::max(bucketSize(f_limit_.packets_per_sec, f_limit_.packet_burst), 1.0);
+        state.byte_tokens = std::max(bucketSize(f_limit_.bytes_per_sec, f_limit_.byte_burst), bytes);
+        state.refill_ns = now_ns;
+    }
+    double const elapsed(now_ns > state.refill_ns ? static_cast<double>(now_ns - state.refill_ns) * 1e-9 : 0.0);
+    state.refill_ns = now_ns;
+
+    bool const packet_ok(takeTokens(state.packet_tokens, f_limit_.packets_per_sec, f_limit_.packet_burst, elapsed, 1.0));
+    bool const byte_ok(takeTokens(state.byte_tokens, f_limit_.bytes_per_sec, f_limit_.byte_burst, elapsed, bytes));
+    if(packet_ok && byte_ok)
+    {
+        if(f_limit_.packets_per_sec > 0.0)
+        {
+            state.packet_tokens -= 1.0;
+        }
+        if(f_limit_.bytes_per_sec > 0.0)
+        {
+            state.byte_tokens -= bytes;
+        }
+        ++state.accepted;
+        return true;
+    }
+    ++state.dropped;
+    state.dropped_bytes += size;
+    ++f_dropped_;
+    return false;
+}
+
+/** \brief Receive the next message within budget from \p server.
+ *
+ * Messages from peers over budget are read and dropped (or deferred)
+ * until a message within budget is found or the socket is empty. With
+ * the OVER_BUDGET_DEFER policy, deferred messages are returned once the
+ * socket has nothing else to offer, so abusive peers only get the CPU
+ * time left over by the well behaved ones.
+ *
+ * A call gives up after MAX_REJECTED_PER_CALL messages over budget and
+ * fails with EAGAIN even though more may be pending, so a flood cannot
+ * keep the caller in here; the socket stays readable and the next call
+ * carries on.
+ *
+ * \param[in] server  The server to read from.
+ * \param[in] msg  The buffer where the message is saved.
+ * \param[in] max_size  The maximum size the message (i.e. size of the \p msg buffer.)
+ * \param[out] from  If not NULL, the address of the sender.
+ * \param[in,out] from_len  If not NULL, the size of \p from on input and of
+ * the address on output.
+ *
+ * \return The number of bytes read or -1 if an error occurs. errno is set
+ * to EAGAIN when no messages are pending.
+ */
+int PeerRateLimiter::recv(UdpServer& server, char *msg, size_t max_size, struct sockaddr_storage *from, socklen_t *from_len)
+{
+    for(size_t rejected(0);; ++rejected)
+    {
+        if(rejected >= MAX_REJECTED_PER_CALL)
+        {
+            errno = EAGAIN;
+            return -1;
+        }
+
+        struct sockaddr_storage src;
+        socklen_t src_len(sizeof(src));
+        int const r(server.recvFrom(msg, max_size, &src, &src_len));
+        if(r < 0)
+        {
+            if((errno != EAGAIN && errno != EWOULDBLOCK) || f_deferred_.empty())
+            {
+                return -1;
+            }
+            Deferred& deferred(f_deferred_.front());
+            size_t const size(std::min(max_size, deferred.msg.size()));
+            memcpy(msg, deferred.msg.data(), size);
+            src = deferred.from;
+            src_len = deferred.from_len;
+            f_deferred_.pop_front();
+            if(from != NULL && from_len != NULL)
+            {
+                memcpy(from, &src, std::min(*from_len, src_len));
+                *from_len = src_len;
+            }
+            return static_cast<int>(size);
+        }
+
+        uint64_t const dropped(f_dropped_);
+        if(admit(src, static_cast<size_t>(r), monotonicNowNs()))
+        {
+            if(from != NULL && from_len != NULL)
+            {
+                memcpy(from, &src, std::min(*from_len, src_len));
+                *from_len = src_len;
+            }
+            return r;
+        }
+
+        Table::Entry *peer(f_peers_.find(PeerKey(reinterpret_cast<struct sockaddr *>(&src))));
+        if(f_policy_ == OVER_BUDGET_DEFER
+        && peer != NULL
+        && f_deferred_.size() < f_max_deferred_)
+        {
+            // admit() counted it as dropped, it is deferred instead
+            f_dropped_ = dropped;
+            --peer->state.dropped;
+            peer->state.dropped_bytes -= static_cast<size_t>(r);
+            ++peer->state.deferred;
+
+            Deferred deferred;
+            deferred.msg.assign(msg, static_cast<size_t>(r));
+            deferred.from = src;
+            deferred.from_len = src_len;
+            f_deferred_.push_back(deferred);
+        }
+    }
+}
+
+/** \brief Forget the peers not heard from in the last \p idle_ns nanoseconds.
+ *
+ * \return The number of peers evicted.
+ */
+size_t PeerRateLimiter::evictIdle(uint64_t now_ns, uint64_t idle_ns)
+{
+    return f_peers_.evictIdle(now_ns, idle_ns);
+}
+
+/** \brief Return the table of peers, i.e. to report drops per peer.
+ *
+ * \code
+ *   limiter.getPeers().forEach([](const PeerKey& key, PeerRateLimiter::Table::Entry& peer)
+ *       {
+ *           std::cerr << key.toString() << " dropped " << peer.state.dropped << "\n";
+ *       });
+ * \endcode
+ */
+PeerRateLimiter::Table& PeerRateLimiter::getPeers()
+{
+    return f_peers_;
+}
+
+/** \brief Total number of packets dropped, from all peers.
+ */
+uint64_t PeerRateLimiter::getDroppedCount() const
+{
+    return f_dropped_;
+}
+
+/** \brief Number of packets dropped because the peer table was full.
+ */
+uint64_t PeerRateLimiter::getUntrackedDropCount() const
+{
+    return f_untracked_dropped_;
+}
+
+} // namespace udp_client_server
+#endif
+// vim: ts=4 sw=4 et
@@ -0,0 +1,317 @@
+// Receive Buffer Pool -- size-classed buffers for incoming UDP messages
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_RECEIVE_BUFFER_POOL_CPP
+#define UDP_CLIENT_SERVER_RECEIVE_BUFFER_POOL_CPP
+
+#include <receive_buffer_pool.h>
+#include <numa_placement.h>
+#include <errno.h>
+#include <string.h>
+
+namespace udp_client_server
+{
+
+const size_t ReceiveBufferPool::CLASS_COUNT;
+const size_t ReceiveBufferPool::MIN_CLASS_SIZE;
+const size_t ReceiveBufferPool::MAX_CLASS_SIZE;
+const uint32_t ReceiveBufferPool::DECAY_INTERVAL;
+const size_t ReceiveBufferPool::NUMA_SLAB_SIZE;
+
+/** \brief Initialize a receive buffer pool.
+ *
+ * The pool hands out buffers in power of two size classes, from
+ * MIN_CLASS_SIZE up to MAX_CLASS_SIZE which fits any UDP datagram.
+ * Buffers are allocated lazily and aligned on a cache line.
+ *
+ * In RECV_PEEK_SIZE mode, recv() first asks the kernel for the size of the
+ * next datagram and picks the smallest class that fits it, so messages are
+ * never truncated at the cost of a second system call.
+ *
+ * In RECV_DETECT_TRUNC mode, recv() reads directly in a buffer of the
+ * preferred size, which is the largest class seen in recent traffic. A
+ * larger datagram is truncated, but this is reported in the buffer and
+ * the preferred size grows right away so the next one fits.
+ *
+ * When \p numa_node is set, buffers are carved out of slabs of at least
+ * NUMA_SLAB_SIZE bytes bound to that node, so the worker reading and
+ * parsing the messages does not go through the interconnect. Use the node
+ * of the worker CPU, or numaNodeOfInterface() for the NIC, and pin the
+ * worker with numaPinThreadToNode(). Slab buffers are never freed before
+ * the pool is destroyed.
+ *
+ * \param[in] mode  How recv() learns the size of incoming messages.
+ * \param[in] max_free_per_class  How many released buffers are kept for
+ * reuse in each size class. Extra buffers are freed.
+ * \param[in] numa_node  The node to allocate buffers on, -1 for any node.
+ */
+ReceiveBufferPool::ReceiveBufferPool(RecvMode mode, size_t max_free_per_class, int numa_node)
+    : f_mode_(mode)
+    , f_max_free_per_class_(max_free_per_class)
+    , f_numa_node_(numa_node)
+    , f_since_decay_(0)
+    , f_preferred_class_(0)
+    , f_truncated_(0)
+{
+    memset(f_observed_, 0, sizeof(f_observed_));
+}
+
+/** \brief Free the buffers held by the pool.
+ *
+ * Buffers still held by callers are not tracked by the pool and must be
+ * released before the pool is destroyed.
+ */
+ReceiveBufferPool::~ReceiveBufferPool()
+{
+    if(f_numa_node_ >= 0)
+    {
+        for(size_t i(0); i < f_slabs_.size(); ++i)
+        {
+            numaFree(f_slabs_[i].first, f_slabs_[i].second);
+        }
+        return;
+    }
+    for(size_t c(0); c < CLASS_COUNT; ++c)
+    {
+        for(size_t i(0); i < f_free_[c].size(); ++i)
+        {
+            free(f_free_[c][i]);
+        }
+    }
+}
+
+/** \brief Receive the next message of \p server in a pooled buffer.
+ *
+ * If \p buffer already holds a pooled buffer large enough for the incoming
+ * message, it is reused. Otherwise it is released and replaced with one
+ * of the proper size class.
+ *
+ * \param[in] server  The server to read from.
+ * \param[in,out] buffer  The buffer receiving the message.
+ *
+ * \return The real size of the datagram or -1 if an error occurs. If no
+ * messages are available, errno is set to EAGAIN. In RECV_DETECT_TRUNC
+ * mode the value may be larger than buffer.size, in which case
+ * buffer.truncated is set.
+ */
+int ReceiveBufferPool::recv(UdpServer& server, ReceiveBuffer& buffer)
+{
+    size_t wanted(classSize(f_preferred_class_));
+    if(f_mode_ == RECV_PEEK_SIZE)
+    {
+        int const size(server.peekSize());
+        if(size < 0)
+        {
+            return -1;
+        }
+        wanted = static_cast<size_t>(size);
+    }
+    if(buffer.data == NULL || buffer.capacity < wanted)
+    {
+        release(buffer);
+        if(!acquire(wanted, buffer))
+        {
+            errno = ENOMEM;
+            return -1;
+        }
+    }
+
+    int const r(server.recvTrunc(buffer.data, buffer.capacity));
+    if(r < 0)
+    {
+        buffer.size = 0;
+        buffer.truncated = false;
+        return -1;
+    }
+    buffer.truncated = static_cast<size_t>(r) > buffer.capacity;
+    buffer.size = buffer.truncated ? buffer.capacity : static_cast<size_t>(r);
+    if(buffer.truncated)
+    {
+        ++f_truncated_;
+    }
+    observe(static_cast<size_t>(r));
+    return r;
+}
+
+/** \brief Get a buffer of at least \p size bytes.
+ *
+ * \param[in] size  The minimum capacity of the buffer, at most MAX_CLASS_SIZE.
+ * \param[out] buffer  The buffer, its capacity is the size of its class.
+ *
+ * \return false if \p size is too large or the allocation failed.
+ */
+bool ReceiveBufferPool::acquire(size_t size, ReceiveBuffer& buffer)
+{
+    if(size > MAX_CLASS_SIZE)
+    {
+        return false;
+    }
+    size_t const c(classOf(size));
+    char *data(NULL);
+    if(f_free_[c].empty() && f_numa_node_ >= 0 && !allocateSlab(c))
+    {
+        return false;
+    }
+    if(!f_free_[c].empty())
+    {
+        data = f_free_[c].back();
+        f_free_[c].pop_back();
+    }
+    else
+    {
+        void *ptr(NULL);
+        if(posix_memalign(&ptr, 64, classSize(c)) != 0)
+        {
+            return false;
+        }
+        data = static_cast<char *>(ptr);
+    }
+    buffer.data = data;
+    buffer.capacity = classSize(c);
+    buffer.size = 0;
+    buffer.truncated = false;
+    return true;
+}
+
+/** \brief Give a buffer back to the pool.
+ *
+ * The buffer is reset. Releasing an empty buffer does nothing.
+ *
+ * \param[in,out] buffer  A buffer obtained from acquire() or recv().
+ */
+void ReceiveBufferPool::release(ReceiveBuffer& buffer)
+{
+    if(buffer.data != NULL)
+    {
+        size_t const c(classOf(buffer.capacity));
+        if(f_free_[c].size() < f_max_free_per_class_
+        || f_numa_node_ >= 0)
+        {
+            f_free_[c].push_back(buffer.data);
+        }
+        else
+        {
+            free(buffer.data);
+        }
+    }
+    buffer = ReceiveBuffer();
+}
+
+/** \brief Return the mode used by recv().
+ */
+ReceiveBufferPool::RecvMode ReceiveBufferPool::getMode() const
+{
+    return f_mode_;
+}
+
+/** \brief Return the NUMA node of the buffers, -1 if not bound to a node.
+ */
+int ReceiveBufferPool::getNumaNode() const
+{
+    return f_numa_node_;
+}
+
+/** \brief Return the buffer size currently preferred by the pool.
+ *
+ * This is the size of the largest class observed in recent traffic. Counts
+ * are halved every DECAY_INTERVAL messages, so a class that stops being
+ * used is forgotten after a few thousand messages and the preferred size
+ * shrinks back.
+ *
+ * \return The preferred buffer size in bytes.
+ */
+size_t ReceiveBufferPool::getPreferredSize() const
+{
+    return classSize(f_preferred_class_);
+}
+
+/** \brief Number of messages truncated by recv() in RECV_DETECT_TRUNC mode.
+ */
+uint64_t ReceiveBufferPool::getTruncatedCount() const
+{
+    return f_truncated_;
+}
+
+/** \brief Return the smallest size class holding \p size bytes.
+ */
+size_t ReceiveBufferPool::classOf(size_t size)
+{
+    size_t c(0);
+    while(c + 1 < CLASS_COUNT && classSize(c) < size)
+    {
+        ++c;
+    }
+    return c;
+}
+
+/** \brief Return the capacity of the buffers of class \p size_class.
+ */
+size_t ReceiveBufferPool::classSize(size_t size_class)
+{
+    return MIN_CLASS_SIZE << size_class;
+}
+
+/** \brief Account for a message of \p size bytes in the traffic histogram.
+ */
+void ReceiveBufferPool::observe(size_t size)
+{
+    size_t const c(classOf(size));
+    ++f_observed_[c];
+    if(c > f_preferred_class_)
+    {
+        f_preferred_class_ = c;
+    }
+
+    if(++f_since_decay_ >= DECAY_INTERVAL)
+    {
+        f_since_decay_ = 0;
+        f_preferred_class_ = 0;
+        for(size_t i(0); i < CLASS_COUNT; ++i)
+        {
+            f_observed_[i] /= 2;
+            if(f_observed_[i] != 0)
+            {
+                f_preferred_class_ = i;
+            }
+        }
+    }
+}
+
+/** \brief Allocate a slab on the pool node and split it in buffers of \p size_class.
+ *
+ * \return false if the allocation failed.
+ */
+bool ReceiveBufferPool::allocateSlab(size_t size_class)
+{
+    size_t const size(classSize(size_class));
+    size_t const slab_size(size > NUMA_SLAB_SIZE ? size : NUMA_SLAB_SIZE);
+    char *slab(static_cast<char *>(numaAlloc(slab_size, f_numa_node_)));
+    if(slab == NULL)
+    {
+        return false;
+    }
+    f_slabs_.push_back(std::make_pair(static_cast<void *>(slab), slab_size));
+    for(size_t offset(0); offset + size <= slab_size; offset += size)
+    {
+        f_free_[size_class].push_back(slab + offset);
+    }
+    return true;
+}
+
+} // namespace udp_client_server
+#endif
+// vim: ts=4 sw=4 et
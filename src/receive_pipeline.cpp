@@ -0,0 +1,342 @@
+// Receive Pipeline -- receive stage feeding a pool of decode workers
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_RECEIVE_PIPELINE_CPP
+#define UDP_CLIENT_SERVER_RECEIVE_PIPELINE_CPP
+
+#include <receive_pipeline.h>
+#include <backoff.h>
+#include <errno.h>
+#include <poll.h>
+#include <system_error>
+
+namespace udp_client_server
+{
+
+/** \brief Initialize a pipeline with \p worker_count decode workers.
+ *
+ * Nothing runs until start() is called.
+ *
+ * \param[in] worker_count  The number of decode threads, at least 1.
+ * \param[in] decoder  The function decoding one datagram. It runs on the
+ * worker threads and returns the message to pass to the consumers, or
+ * NULL to drop the datagram.
+ * \param[in] user  The first parameter of \p decoder.
+ * \param[in] slot_count  The number of datagrams in flight between the
+ * receive stage and the workers.
+ * \param[in] slot_size  The size of a slot; longer datagrams are truncated.
+ *
+ * \exception UdpClientServerRuntimeError
+ * The worker count, slot count or slot size is 0, or the slot count does
+ * not fit a handle.
+ */
+ReceivePipeline::ReceivePipeline(size_t worker_count, Decoder decoder, void *user,
+                                 size_t slot_count, size_t slot_size)
+    : f_decoder_(decoder)
+    , f_discard_(NULL)
+    , f_user_(user)
+    , f_slot_size_(slot_size)
+    , f_arena_(slot_count * slot_size)
+    , f_slots_(slot_count)
+    , f_free_(slot_count)
+    , f_results_(slot_count)
+    , f_running_(false)
+    , f_received_(0)
+    , f_dropped_(0)
+    , f_stalls_(0)
+{
+    if(worker_count == 0 || slot_count == 0 || slot_size == 0 || slot_count > 0xFFFFFFFFULL)
+    {
+        throw UdpClientServerRuntimeError("invalid parameters for receive pipeline");
+    }
+    for(uint32_t i(0); i < slot_count; ++i)
+    {
+        f_free_.push(i);
+    }
+    for(size_t i(0); i < worker_count; ++i)
+    {
+        f_workers_.push_back(std::unique_ptr<Worker>(new Worker(slot_count)));
+    }
+}
+
+/** \brief Stop the threads and release the workers.
+ */
+ReceivePipeline::~ReceivePipeline()
+{
+    stop();
+}
+
+/** \brief Set the function releasing messages that cannot be delivered.
+ *
+ * It is called with the user pointer of the decoder for the messages
+ * still decoded while stopping when the result queue is full. Without
+ * it such messages are lost.
+ */
+void ReceivePipeline::setDiscard(Discard discard)
+{
+    f_discard_ = discard;
+}
+
+/** \brief Start the decode workers and, optionally, the receive stage.
+ *
+ * With \p server, a receive thread reads it and feeds the workers. With
+ * NULL, the caller runs the receive stage by calling receive(), i.e. to
+ * read several sockets.
+ *
+ * If a thread cannot be created, the threads already started are
+ * stopped and joined before returning.
+ *
+ * \return 0 on success, -1 if the pipeline is already running (errno
+ * is set to EBUSY) or a thread could not be created (errno is set to
+ * EAGAIN.)
+ */
+int ReceivePipeline::start(UdpServer *server)
+{
+    if(f_running_.exchange(true))
+    {
+        errno = EBUSY;
+        return -1;
+    }
+    try
+    {
+        for(size_t i(0); i < f_workers_.size(); ++i)
+        {
+            f_workers_[i]->thread = std::thread(&ReceivePipeline::decodeLoop, this, f_workers_[i].get());
+        }
+        if(server != NULL)
+        {
+            f_receiver_ = std::thread(&ReceivePipeline::receiveLoop, this, server);
+        }
+    }
+    catch(const std::system_error&)
+    {
+        stop();
+        errno = EAGAIN;
+        return -1;
+    }
+    return 0;
+}
+
+/** \brief Stop the receive thread and the workers.
+ *
+ * The workers decode the datagrams already handed to them before
+ * exiting. Results not popped yet stay in the result queue.
+ */
+void ReceivePipeline::stop()
+{
+    f_running_ = false;
+    if(f_receiver_.joinable())
+    {
+        f_receiver_.join();
+    }
+    for(size_t i(0); i < f_workers_.size(); ++i)
+    {
+        if(f_workers_[i]->thread.joinable())
+        {
+            f_workers_[i]->thread.join();
+        }
+    }
+}
+
+/** \brief Run the receive stage once.
+ *
+ * Read up to \p max_packets datagrams from \p server without waiting
+ * and hand each of them to the worker of its flow. Several threads may
+ * call this function at the same time, each with its own socket.
+ *
+ * \return The number of datagrams handed to the workers, 0 if none was
+ * available or all the slots are in use, -1 if an error occurs. errno is
+ * set accordingly on error.
+ */
+int ReceivePipeline::receive(UdpServer& server, size_t max_packets)
+{
+    int count(0);
+    uint32_t handle;
+    for(size_t i(0); i < max_packets; ++i)
+    {
+        if(!f_free_.pop(handle))
+        {
+            f_stalls_.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+        Slot& slot(f_slots_[handle]);
+        int const r(server.recvView(&f_arena_[handle * f_slot_size_], f_slot_size_, slot.view));
+        if(r < 0)
+        {
+            f_free_.push(handle);
+            if(errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+            return count == 0 ? -1 : count;
+        }
+        f_received_.fetch_add(1, std::memory_order_relaxed);
+        slot.flow = PeerKey(reinterpret_cast<const struct sockaddr *>(&slot.view.source));
+        if(f_workers_[workerOf(slot.flow)]->queue.push(handle))
+        {
+            ++count;
+        }
+        else
+        {
+            f_dropped_.fetch_add(1, std::memory_order_relaxed);
+            f_free_.push(handle);
+        }
+    }
+    return count;
+}
+
+/** \brief Take the next decoded message.
+ *
+ * Any number of consumer threads may pop results.
+ *
+ * \return false if no result is available.
+ */
+bool ReceivePipeline::popResult(PipelineResult& result)
+{
+    return f_results_.pop(result);
+}
+
+/** \brief Number of decode workers.
+ */
+size_t ReceivePipeline::getWorkerCount() const
+{
+    return f_workers_.size();
+}
+
+/** \brief Index of the worker decoding the datagrams of \p flow.
+ *
+ * The high bits of the flow hash are scaled to the worker count, which
+ * avoids a division.
+ */
+size_t ReceivePipeline::workerOf(const PeerKey& flow) const
+{
+    uint64_t const hash(PeerKeyHash()(flow) >> 32);
+    return static_cast<size_t>((hash * f_workers_.size()) >> 32);
+}
+
+/** \brief Number of datagrams read by the receive stage.
+ */
+uint64_t ReceivePipeline::getReceivedCount() const
+{
+    return f_received_.load(std::memory_order_relaxed);
+}
+
+/** \brief Number of datagrams the workers decoded.
+ */
+uint64_t ReceivePipeline::getDecodedCount() const
+{
+    uint64_t decoded(0);
+    for(size_t i(0); i < f_workers_.size(); ++i)
+    {
+        decoded += f_workers_[i]->decoded.load(std::memory_order_relaxed);
+    }
+    return decoded;
+}
+
+/** \brief Number of datagrams dropped because their worker queue was full.
+ */
+uint64_t ReceivePipeline::getDroppedCount() const
+{
+    return f_dropped_.load(std::memory_order_relaxed);
+}
+
+/** \brief Number of times the receive stage found no free slot.
+ */
+uint64_t ReceivePipeline::getStallCount() const
+{
+    return f_stalls_.load(std::memory_order_relaxed);
+}
+
+/** \brief Body of the receive thread started by start().
+ */
+void ReceivePipeline::receiveLoop(UdpServer *server)
+{
+    Backoff backoff;
+    struct pollfd fd;
+    fd.fd = server->getSocket();
+    fd.events = POLLIN;
+    while(f_running_.load(std::memory_order_relaxed))
+    {
+        int const r(receive(*server));
+        if(r > 0)
+        {
+            backoff.reset();
+        }
+        else if(r == 0 && f_free_.sizeApprox() == 0)
+        {
+            // all the slots are with the workers
+            backoff.wait();
+        }
+        else
+        {
+            // wake up regularly to notice stop()
+            fd.revents = 0;
+            ::poll(&fd, 1, 100);
+        }
+    }
+}
+
+/** \brief Body of a decode worker.
+ */
+void ReceivePipeline::decodeLoop(Worker *worker)
+{
+    Backoff backoff;
+    uint32_t handle;
+    for(;;)
+    {
+        if(!worker->queue.pop(handle))
+        {
+            if(!f_running_.load(std::memory_order_acquire))
+            {
+                return;
+            }
+            backoff.wait();
+            continue;
+        }
+        backoff.reset();
+
+        Slot& slot(f_slots_[handle]);
+        PipelineResult result;
+        result.message = f_decoder_(f_user_, slot.view);
+        result.flow = slot.flow;
+        result.timestamp_ns = slot.view.timestamp_ns;
+        f_free_.push(handle);
+        worker->decoded.fetch_add(1, std::memory_order_relaxed);
+        if(result.message == NULL)
+        {
+            continue;
+        }
+
+        Backoff full;
+        while(!f_results_.push(result))
+        {
+            if(!f_running_.load(std::memory_order_relaxed))
+            {
+                if(f_discard_ != NULL)
+                {
+                    f_discard_(f_user_, result.message);
+                }
+                break;
+            }
+            full.wait();
+        }
+    }
+}
+
+} // namespace udp_client_server
+#endif
+// vim: ts=4 sw=4 et
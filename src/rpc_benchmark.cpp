@@ -0,0 +1,230 @@
+// RPC Benchmark -- throughput and latency of RpcClient and RpcServer on loopback
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+// Usage: rpc_benchmark [<calls in flight> [<payload size> [<seconds> [<port>]]]]
+//
+// Runs an echo RpcServer in a thread and keeps a fixed number of calls in
+// flight from a single-threaded RpcClient, both on 127.0.0.1. Prints the
+// throughput, the latency percentiles and the number of retransmissions.
+// The defaults are 1000 calls of 64 bytes for 5 seconds.
+
+#include <udp_rpc.h>
+#include <monotonic_clock.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace udp_client_server;
+
+namespace
+{
+
+const uint64_t CALL_DEADLINE_NS = 1000000000ULL;
+
+/** \brief First retransmission delay of the calls.
+ *
+ * With a thousand calls in flight the closed-loop latency reaches several
+ * milliseconds, so the default 10 ms delay of RpcRetryPolicy retransmits
+ * calls that were only waiting in the server queue and the benchmark
+ * measures its own duplicates. The delay is kept well above the latency;
+ * a lost datagram is still retried before the deadline.
+ */
+const uint64_t RETRY_INITIAL_NS = 250000000ULL;
+
+/** \brief Receive buffer of both sockets.
+ *
+ * With the default buffer a burst of a thousand requests overflows the
+ * server socket and the benchmark measures retransmissions. The kernel
+ * caps the value to net.core.rmem_max.
+ */
+const int SOCKET_BUFFER_SIZE = 4 * 1024 * 1024;
+
+int echo(void *user, uint16_t method, const char *request, size_t size, char *response, size_t max_size)
+{
+    static_cast<void>(user);
+    static_cast<void>(method);
+    if(size > max_size)
+    {
+        return -1;
+    }
+    memcpy(response, request, size);
+    return static_cast<int>(size);
+}
+
+struct Benchmark;
+
+/** \brief One of the calls kept in flight; restarted as soon as it completes.
+ */
+struct Slot
+{
+    Benchmark *         benchmark;
+    uint64_t            start_ns;
+};
+
+struct Benchmark
+{
+    RpcClient *         client;
+    std::vector<char>   payload;
+    std::vector<uint64_t> latencies;
+    uint64_t            end_ns;
+    uint64_t            failed;
+};
+
+void start(Slot& slot);
+
+void completed(void *user, RpcStatus status, const char *response, size_t size)
+{
+    static_cast<void>(response);
+    static_cast<void>(size);
+    Slot& slot(*static_cast<Slot *>(user));
+    Benchmark& b(*slot.benchmark);
+    uint64_t const now(monotonicNowNs());
+    if(status == RPC_OK)
+    {
+        b.latencies.push_back(now - slot.start_ns);
+    }
+    else
+    {
+        ++b.failed;
+    }
+    if(now < b.end_ns)
+    {
+        start(slot);
+    }
+}
+
+void start(Slot& slot)
+{
+    Benchmark& b(*slot.benchmark);
+    slot.start_ns = monotonicNowNs();
+    if(b.client->call(1, b.payload.data(), b.payload.size(), slot.start_ns + CALL_DEADLINE_NS, completed, &slot) < 0)
+    {
+        perror("call");
+        exit(1);
+    }
+}
+
+double percentileMs(const std::vector<uint64_t>& sorted, double p)
+{
+    if(sorted.empty())
+    {
+        return 0.0;
+    }
+    size_t const index(std::min(sorted.size() - 1, static_cast<size_t>(p * static_cast<double>(sorted.size()))));
+    return static_cast<double>(sorted[index]) / 1000000.0;
+}
+
+} // no name namespace
+
+
+int main(int argc, char *argv[])
+{
+    size_t const in_flight(argc >= 2 ? strtoul(argv[1], NULL, 0) : 1000);
+    size_t const payload_size(argc >= 3 ? strtoul(argv[2], NULL, 0) : 64);
+    int const seconds(argc >= 4 ? atoi(argv[3]) : 5);
+    int const port(argc >= 5 ? atoi(argv[4]) : 46065);
+    if(in_flight == 0 || in_flight > RpcClient::MAX_IN_FLIGHT || seconds <= 0)
+    {
+        fprintf(stderr, "Usage: %s [<calls in flight> [<payload size> [<seconds> [<port>]]]]\n", argv[0]);
+        return 1;
+    }
+
+    try
+    {
+        UdpServer server_socket("127.0.0.1", port);
+        UdpClient client_socket("127.0.0.1", port);
+        setsockopt(server_socket.getSocket(), SOL_SOCKET, SO_RCVBUF, &SOCKET_BUFFER_SIZE, sizeof(SOCKET_BUFFER_SIZE));
+        setsockopt(client_socket.getSocket(), SOL_SOCKET, SO_RCVBUF, &SOCKET_BUFFER_SIZE, sizeof(SOCKET_BUFFER_SIZE));
+        RpcServer server(server_socket, echo, NULL);
+        RpcClient client(client_socket, in_flight);
+        RpcRetryPolicy policy;
+        policy.initial_ns = RETRY_INITIAL_NS;
+        policy.max_ns = CALL_DEADLINE_NS;
+        client.setRetryPolicy(policy);
+
+        std::atomic<bool> done(false);
+        std::thread server_thread([&]()
+            {
+                struct pollfd fd;
+                fd.fd = server_socket.getSocket();
+                fd.events = POLLIN;
+                while(!done.load())
+                {
+                    if(::poll(&fd, 1, 10) > 0)
+                    {
+                        server.poll();
+                    }
+                }
+            });
+
+        Benchmark b;
+        b.client = &client;
+        b.payload.assign(payload_size, 'x');
+        b.failed = 0;
+        uint64_t const begin(monotonicNowNs());
+        b.end_ns = begin + static_cast<uint64_t>(seconds) * 1000000000ULL;
+        std::vector<Slot> slots(in_flight);
+        for(size_t i(0); i < in_flight; ++i)
+        {
+            slots[i].benchmark = &b;
+            start(slots[i]);
+        }
+
+        struct pollfd fd;
+        fd.fd = client_socket.getSocket();
+        fd.events = POLLIN;
+        while(client.getInFlight() > 0)
+        {
+            ::poll(&fd, 1, 1);
+            if(client.poll(monotonicNowNs()) < 0)
+            {
+                perror("poll");
+                break;
+            }
+        }
+        uint64_t const elapsed(monotonicNowNs() - begin);
+        done = true;
+        server_thread.join();
+
+        std::sort(b.latencies.begin(), b.latencies.end());
+        printf("calls in flight: %zu, payload: %zu bytes, duration: %.2f s\n",
+               in_flight, payload_size, static_cast<double>(elapsed) / 1e9);
+        printf("completed: %zu, failed: %llu, retransmitted: %llu\n",
+               b.latencies.size(),
+               static_cast<unsigned long long>(b.failed),
+               static_cast<unsigned long long>(client.getRetransmitCount()));
+        printf("throughput: %.0f calls/s\n",
+               static_cast<double>(b.latencies.size()) * 1e9 / static_cast<double>(elapsed));
+        printf("latency: p50 %.2f ms, p99 %.2f ms, p99.9 %.2f ms\n",
+               percentileMs(b.latencies, 0.50),
+               percentileMs(b.latencies, 0.99),
+               percentileMs(b.latencies, 0.999));
+    }
+    catch(const UdpClientServerRuntimeError& e)
+    {
+        fprintf(stderr, "%s: %s\n", argv[0], e.what());
+        return 1;
+    }
+    return 0;
+}
+
+// vim: ts=4 sw=4 et
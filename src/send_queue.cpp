@@ -0,0 +1,173 @@
+// Send Queue -- bounded user-space queue of datagrams waiting for the socket
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_SEND_QUEUE_CPP
+#define UDP_CLIENT_SERVER_SEND_QUEUE_CPP
+
+#include <send_queue.h>
+#include <string.h>
+
+namespace udp_client_server
+{
+
+/** \brief Allocate a queue of \p capacity messages of up to \p slot_size bytes.
+ *
+ * \param[in] capacity  The maximum number of queued messages.
+ * \param[in] slot_size  The maximum size of a queued message.
+ * \param[in] policy  What push() does when the queue is full.
+ */
+SendQueue::SendQueue(size_t capacity, size_t slot_size, SendQueueOverflow policy)
+    : f_capacity_(capacity == 0 ? 1 : capacity)
+    , f_slot_size_(slot_size)
+    , f_policy_(policy)
+    , f_head_(0)
+    , f_count_(0)
+    , f_dropped_(0)
+    , f_data_(f_capacity_ * slot_size)
+    , f_sizes_(f_capacity_)
+{
+}
+
+/** \brief Copy a message at the end of the queue.
+ *
+ * When the queue is full, the overflow policy applies: the new message
+ * or the oldest one is dropped (and counted), or the push is rejected.
+ *
+ * \param[in] iov  The buffers making up the message.
+ * \param[in] iovcnt  The number of entries in \p iov.
+ *
+ * \return false if the message was rejected: it is larger than a slot,
+ * or the queue is full and the policy is SEND_QUEUE_REJECT.
+ */
+bool SendQueue::push(const struct iovec *iov, size_t iovcnt)
+{
+    size_t size(0);
+    for(size_t i(0); i < iovcnt; ++i)
+    {
+        size += iov[i].iov_len;
+    }
+    if(size > f_slot_size_)
+    {
+        return false;
+    }
+    if(f_count_ == f_capacity_)
+    {
+        switch(f_policy_)
+        {
+        case SEND_QUEUE_DROP_NEWEST:
+            ++f_dropped_;
+            return true;
+
+        case SEND_QUEUE_DROP_OLDEST:
+            ++f_dropped_;
+            pop(1);
+            break;
+
+        case SEND_QUEUE_REJECT:
+            return false;
+
+        }
+    }
+
+    size_t const slot((f_head_ + f_count_) % f_capacity_);
+    char *dst(&f_data_[slot * f_slot_size_]);
+    for(size_t i(0); i < iovcnt; ++i)
+    {
+        memcpy(dst, iov[i].iov_base, iov[i].iov_len);
+        dst += iov[i].iov_len;
+    }
+    f_sizes_[slot] = size;
+    ++f_count_;
+    return true;
+}
+
+/** \brief Describe the messages at the front of the queue.
+ *
+ * \param[out] iov  One entry per message, pointing in the queue storage.
+ * \param[in] max_count  The number of entries available in \p iov.
+ *
+ * \return The number of entries filled.
+ */
+size_t SendQueue::peek(struct iovec *iov, size_t max_count) const
+{
+    size_t const count(f_count_ < max_count ? f_count_ : max_count);
+    for(size_t i(0); i < count; ++i)
+    {
+        size_t const slot((f_head_ + i) % f_capacity_);
+        iov[i].iov_base = const_cast<char *>(&f_data_[slot * f_slot_size_]);
+        iov[i].iov_len = f_sizes_[slot];
+    }
+    return count;
+}
+
+/** \brief Remove \p count messages from the front of the queue.
+ */
+void SendQueue::pop(size_t count)
+{
+    if(count > f_count_)
+    {
+        count = f_count_;
+    }
+    f_head_ = (f_head_ + count) % f_capacity_;
+    f_count_ -= count;
+}
+
+/** \brief Check whether the queue holds no messages.
+ */
+bool SendQueue::empty() const
+{
+    return f_count_ == 0;
+}
+
+/** \brief Number of messages in the queue.
+ */
+size_t SendQueue::size() const
+{
+    return f_count_;
+}
+
+/** \brief Maximum number of messages in the queue.
+ */
+size_t SendQueue::capacity() const
+{
+    return f_capacity_;
+}
+
+/** \brief Maximum size of a queued message.
+ */
+size_t SendQueue::slotSize() const
+{
+    return f_slot_size_;
+}
+
+/** \brief Return the overflow policy of the queue.
+ */
+SendQueueOverflow SendQueue::getPolicy() const
+{
+    return f_policy_;
+}
+
+/** \brief Number of messages dropped because the queue was full.
+ */
+uint64_t SendQueue::getDroppedCount() const
+{
+    return f_dropped_;
+}
+
+} // namespace udp_client_server
+#endif
+// vim: ts=4 sw=4 et
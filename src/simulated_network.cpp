@@ -0,0 +1,717 @@
+// Simulated Network -- in-process UDP transport with a virtual clock
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_SIMULATED_NETWORK_CPP
+#define UDP_CLIENT_SERVER_SIMULATED_NETWORK_CPP
+
+#include <simulated_network.h>
+#include <basic_udp_socket.h>
+#include <errno.h>
+#include <string.h>
+#include <algorithm>
+
+namespace udp_client_server
+{
+
+namespace
+{
+
+/** \brief Largest UDP payload accepted by the simulated sockets.
+ */
+const size_t MAX_DATAGRAM_SIZE = 65507;
+
+/** \brief First port given to the simulated clients as their source.
+ */
+const uint16_t FIRST_EPHEMERAL_PORT = 32768;
+
+/** \brief Size of the IP and UDP headers preceding the payload.
+ */
+size_t ipUdpHeaderSize(int family)
+{
+    return (family == AF_INET6 ? 40 : 20) + 8;
+}
+
+/** \brief The key of the wildcard address of \p family on \p port.
+ */
+PeerKey wildcardKey(int family, uint16_t port)
+{
+    PeerKey key;
+    if(family == AF_INET)
+    {
+        key.address[10] = 0xFF;
+        key.address[11] = 0xFF;
+    }
+    key.port = port;
+    key.family = static_cast<uint16_t>(family);
+    return key;
+}
+
+} // no name namespace
+
+
+// ========================= NETWORK =========================
+
+const size_t SimulatedNetwork::DEFAULT_RECEIVE_BUFFER_SIZE;
+const size_t SimulatedNetwork::DEFAULT_MTU;
+
+/** \brief Initialize a simulated network.
+ *
+ * The simulated network replaces the kernel for SimulatedUdpClient and
+ * SimulatedUdpServer objects attached to it. Datagrams travel through an
+ * in-memory event queue ordered by delivery time and a virtual clock,
+ * starting at 0, only moves when advance() or advanceTo() are called (or
+ * while a SimulatedUdpServer::timedRecv() waits.) A benchmark can therefore
+ * simulate hours of traffic in seconds and get the exact same results on
+ * each run with the same \p seed.
+ *
+ * Links are perfect until setImpairment() is called.
+ *
+ * \note
+ * The simulated network is not thread safe. It is expected to be driven
+ * by a single thread, the one running the code under test.
+ *
+ * \param[in] seed  The seed used to draw loss, jitter, duplication and
+ * reordering.
+ */
+SimulatedNetwork::SimulatedNetwork(uint64_t seed)
+    : f_model_(seed)
+    , f_receive_buffer_size_(DEFAULT_RECEIVE_BUFFER_SIZE)
+    , f_mtu_(DEFAULT_MTU)
+    , f_next_port_(FIRST_EPHEMERAL_PORT)
+    , f_now_(0)
+    , f_sequence_(0)
+{
+}
+
+/** \brief Set the impairment of all the links without a specific one.
+ *
+ * \param[in] impairment  The default link behavior.
+ */
+void SimulatedNetwork::setImpairment(const NetworkImpairment& impairment)
+{
+    f_default_impairment_ = impairment;
+}
+
+/** \brief Set the impairment of the link toward one endpoint.
+ *
+ * The bandwidth limit applies to all the traffic sent to that endpoint,
+ * as if it were behind a single bottleneck link.
+ *
+ * \exception UdpClientServerRuntimeError
+ * The address cannot be resolved.
+ *
+ * \param[in] addr  The address of the destination, as given to the
+ * SimulatedUdpClient constructor.
+ * \param[in] port  The port of the destination.
+ * \param[in] impairment  The behavior of the link toward that endpoint.
+ */
+void SimulatedNetwork::setImpairment(const std::string& addr, int port, const NetworkImpairment& impairment)
+{
+    Endpoint& ep(endpoint(endpointKey(addr, port)));
+    ep.impairment = impairment;
+    ep.has_impairment = true;
+}
+
+/** \brief Set the receive buffer size of the simulated servers.
+ *
+ * Like the kernel SO_RCVBUF, datagrams arriving at a server which already
+ * has \p size bytes queued are dropped and counted as overflowed.
+ *
+ * \param[in] size  The number of bytes each server can queue.
+ */
+void SimulatedNetwork::setReceiveBufferSize(size_t size)
+{
+    f_receive_buffer_size_ = size;
+}
+
+/** \brief Set the MTU of the simulated links.
+ *
+ * The MTU does not limit the datagrams sent, like a real link would
+ * fragment them; it only defines SimulatedUdpClient::maxPayload().
+ *
+ * \param[in] mtu  The MTU in bytes, including the IP and UDP headers.
+ */
+void SimulatedNetwork::setMtu(size_t mtu)
+{
+    f_mtu_ = mtu;
+}
+
+/** \brief Return the MTU of the simulated links.
+ */
+size_t SimulatedNetwork::getMtu() const
+{
+    return f_mtu_;
+}
+
+/** \brief Return the current virtual time in nanoseconds.
+ */
+uint64_t SimulatedNetwork::now() const
+{
+    return f_now_;
+}
+
+/** \brief Move the virtual clock forward by \p ns nanoseconds.
+ *
+ * All the datagrams due within that time are delivered.
+ */
+void SimulatedNetwork::advance(uint64_t ns)
+{
+    advanceTo(f_now_ + ns);
+}
+
+/** \brief Move the virtual clock forward to \p time_ns.
+ *
+ * Datagrams are delivered in order of arrival time and the clock is set
+ * to each arrival time in turn. A time in the past is ignored.
+ *
+ * \param[in] time_ns  The new virtual time in nanoseconds.
+ */
+void SimulatedNetwork::advanceTo(uint64_t time_ns)
+{
+    while(!f_in_flight_.empty() && f_in_flight_.top().deliver_at <= time_ns)
+    {
+        InFlight const packet(f_in_flight_.top());
+        f_in_flight_.pop();
+        f_now_ = std::max(f_now_, packet.deliver_at);
+
+        Endpoint *ep(route(packet.destination));
+        if(ep == NULL)
+        {
+            ++f_stats_.unroutable;
+        }
+        else if(ep->queued_bytes + packet.datagram.payload->size() > f_receive_buffer_size_)
+        {
+            ++f_stats_.overflowed;
+        }
+        else
+        {
+            ep->queue.push_back(packet.datagram);
+            ep->queued_bytes += packet.datagram.payload->size();
+            ++f_stats_.delivered;
+        }
+    }
+    f_now_ = std::max(f_now_, time_ns);
+}
+
+/** \brief Retrieve the time of the next delivery.
+ *
+ * \param[out] time_ns  The arrival time of the next datagram in flight.
+ *
+ * \return false if no datagrams are in flight.
+ */
+bool SimulatedNetwork::nextEventTime(uint64_t& time_ns) const
+{
+    if(f_in_flight_.empty())
+    {
+        return false;
+    }
+    time_ns = f_in_flight_.top().deliver_at;
+    return true;
+}
+
+/** \brief Deliver all the datagrams in flight.
+ *
+ * The clock ends at the arrival time of the last datagram.
+ */
+void SimulatedNetwork::runUntilIdle()
+{
+    uint64_t t;
+    while(nextEventTime(t))
+    {
+        advanceTo(t);
+    }
+}
+
+/** \brief Return the counters of the simulated network.
+ */
+const SimulatedNetwork::Stats& SimulatedNetwork::getStats() const
+{
+    return f_stats_;
+}
+
+/** \brief Resolve \p addr and \p port to the key of an endpoint.
+ *
+ * Addresses are resolved once, when the simulated sockets are created,
+ * so the send path only hashes a PeerKey.
+ *
+ * \exception UdpClientServerRuntimeError
+ * The address cannot be resolved.
+ */
+PeerKey SimulatedNetwork::endpointKey(const std::string& addr, int port)
+{
+    struct sockaddr_storage resolved;
+    resolveUdpAddress(addr, port, AF_UNSPEC, resolved);
+    return PeerKey(reinterpret_cast<const struct sockaddr *>(&resolved));
+}
+
+/** \brief Give a new client a source address to send from.
+ *
+ * The source is the loopback address of the family of \p destination
+ * with the next ephemeral port, so servers can tell clients apart and
+ * reply with recvFrom().
+ */
+PeerKey SimulatedNetwork::allocateSource(const PeerKey& destination)
+{
+    PeerKey source(wildcardKey(destination.family, f_next_port_));
+    source.address[15] = 1;
+    ++f_next_port_;
+    if(f_next_port_ == 0)
+    {
+        f_next_port_ = FIRST_EPHEMERAL_PORT;
+    }
+    return source;
+}
+
+void SimulatedNetwork::bind(const PeerKey& key)
+{
+    endpoint(key).bound = true;
+}
+
+void SimulatedNetwork::unbind(const PeerKey& key)
+{
+    Endpoint& ep(endpoint(key));
+    ep.bound = false;
+    ep.queue.clear();
+    ep.queued_bytes = 0;
+}
+
+/** \brief Put a datagram in flight toward \p key.
+ *
+ * Like a real UDP socket, sending succeeds even when the datagram is
+ * lost on the way.
+ */
+int SimulatedNetwork::send(const PeerKey& source, const PeerKey& destination, const Payload& payload)
+{
+    ++f_stats_.sent;
+    Endpoint& link(endpoint(destination));
+    NetworkImpairment const& impairment(link.has_impairment ? link.impairment : f_default_impairment_);
+    if(f_model_.drop(impairment))
+    {
+        ++f_stats_.lost;
+        return static_cast<int>(payload->size());
+    }
+
+    uint64_t const departure(std::max(f_now_, link.busy_until)
+                           + ImpairmentModel::transmitTime(impairment, payload->size()));
+    link.busy_until = departure;
+
+    int copies(1);
+    if(f_model_.duplicate(impairment))
+    {
+        ++f_stats_.duplicated;
+        copies = 2;
+    }
+    for(int i(0); i < copies; ++i)
+    {
+        InFlight packet;
+        packet.deliver_at = departure + f_model_.delay(impairment);
+        packet.sequence = f_sequence_++;
+        packet.destination = destination;
+        packet.datagram.source = source;
+        packet.datagram.payload = payload;
+        f_in_flight_.push(packet);
+    }
+    return static_cast<int>(payload->size());
+}
+
+/** \brief Find the bound endpoint receiving datagrams sent to \p key.
+ *
+ * A server bound to a wildcard address receives the datagrams sent to
+ * any address on its port.
+ */
+SimulatedNetwork::Endpoint *SimulatedNetwork::route(const PeerKey& key)
+{
+    std::unordered_map<PeerKey, Endpoint, PeerKeyHash>::iterator it(f_endpoints_.find(key));
+    if(it != f_endpoints_.end() && it->second.bound)
+    {
+        return &it->second;
+    }
+    if(key.family == AF_INET)
+    {
+        it = f_endpoints_.find(wildcardKey(AF_INET, key.port));
+        if(it != f_endpoints_.end() && it->second.bound)
+        {
+            return &it->second;
+        }
+    }
+    it = f_endpoints_.find(wildcardKey(AF_INET6, key.port));
+    if(it != f_endpoints_.end() && it->second.bound)
+    {
+        return &it->second;
+    }
+    return NULL;
+}
+
+SimulatedNetwork::Endpoint& SimulatedNetwork::endpoint(const PeerKey& key)
+{
+    return f_endpoints_[key];
+}
+
+
+
+// ========================= CLIENT =========================
+
+/** \brief Initialize a simulated UDP client.
+ *
+ * The address is resolved but no socket is created; it is only used to
+ * find the simulated server bound to the same address and port. The
+ * client gets a loopback source address with its own port.
+ *
+ * \exception UdpClientServerRuntimeError
+ * The address cannot be resolved.
+ *
+ * \param[in] network  The network this client sends on.
+ * \param[in] addr  The address of the destination.
+ * \param[in] port  The port of the destination.
+ */
+SimulatedUdpClient::SimulatedUdpClient(SimulatedNetwork& network, const std::string& addr, int port)
+    : f_network_(network)
+    , f_port_(port)
+    , f_addr_(addr)
+    , f_key_(SimulatedNetwork::endpointKey(addr, port))
+    , f_source_(network.allocateSource(f_key_))
+{
+}
+
+/** \brief Simulated clients have no socket.
+ *
+ * \return Always -1.
+ */
+int SimulatedUdpClient::getSocket() const
+{
+    return -1;
+}
+
+/** \brief Retrieve the port of the destination.
+ */
+int SimulatedUdpClient::getPort() const
+{
+    return f_port_;
+}
+
+/** \brief Retrieve the address of the destination.
+ */
+std::string SimulatedUdpClient::getAddr() const
+{
+    return f_addr_;
+}
+
+/** \brief Send the next messages to another simulated server.
+ *
+ * \param[in] addr  The address of the new destination.
+ * \param[in] port  The port of the new destination.
+ *
+ * \return 0 on success, -1 with errno set to EINVAL if the address
+ * cannot be resolved.
+ */
+int SimulatedUdpClient::setDestination(const std::string& addr, int port)
+{
+    try
+    {
+        f_key_ = SimulatedNetwork::endpointKey(addr, port);
+    }
+    catch(const UdpClientServerRuntimeError&)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    f_addr_ = addr;
+    f_port_ = port;
+    return 0;
+}
+
+/** \brief Send a message on the simulated network.
+ *
+ * \param[in] msg  The message to send.
+ * \param[in] size  The number of bytes representing this message.
+ *
+ * \return -1 with errno set to EMSGSIZE if the message does not fit in a
+ * UDP datagram, otherwise \p size.
+ */
+int SimulatedUdpClient::send(const char *msg, size_t size)
+{
+    if(size > MAX_DATAGRAM_SIZE)
+    {
+        errno = EMSGSIZE;
+        return -1;
+    }
+    return f_network_.send(f_source_, f_key_, std::make_shared<const std::string>(msg, size));
+}
+
+/** \brief Send a message made of several buffers on the simulated network.
+ *
+ * \param[in] iov  The buffers making up the message, in order.
+ * \param[in] iovcnt  The number of entries in \p iov.
+ *
+ * \return -1 with errno set to EMSGSIZE if the message does not fit in a
+ * UDP datagram, otherwise the number of bytes sent.
+ */
+int SimulatedUdpClient::sendv(const struct iovec *iov, size_t iovcnt)
+{
+    std::string msg;
+    for(size_t i(0); i < iovcnt; ++i)
+    {
+        msg.append(static_cast<const char *>(iov[i].iov_base), iov[i].iov_len);
+    }
+    if(msg.size() > MAX_DATAGRAM_SIZE)
+    {
+        errno = EMSGSIZE;
+        return -1;
+    }
+    return f_network_.send(f_source_, f_key_, std::make_shared<const std::string>(msg));
+}
+
+/** \brief Send several scatter-gather messages on the simulated network.
+ *
+ * \return -1 if the very first message could not be sent, otherwise the
+ * number of messages sent.
+ */
+int SimulatedUdpClient::sendBatchv(const UdpSendVector *vectors, unsigned int count)
+{
+    for(unsigned int i(0); i < count; ++i)
+    {
+        if(sendv(vectors[i].iov, vectors[i].iovcnt) < 0)
+        {
+            return i == 0 ? -1 : static_cast<int>(i);
+        }
+    }
+    return static_cast<int>(count);
+}
+
+/** \brief The largest payload that fits in one simulated datagram.
+ *
+ * This is the MTU of the network (see SimulatedNetwork::setMtu()) minus
+ * the IP and UDP headers of the family of the destination.
+ */
+size_t SimulatedUdpClient::maxPayload() const
+{
+    size_t const headers(ipUdpHeaderSize(f_key_.family));
+    size_t const mtu(f_network_.getMtu());
+    return std::min(mtu > headers ? mtu - headers : 0, MAX_DATAGRAM_SIZE);
+}
+
+
+
+// ========================= SERVER =========================
+
+/** \brief Initialize a simulated UDP server.
+ *
+ * \exception UdpClientServerRuntimeError
+ * Another simulated server is already bound to the same address and port.
+ *
+ * \param[in] network  The network this server receives from.
+ * \param[in] addr  The address we receive on.
+ * \param[in] port  The port we receive from.
+ */
+SimulatedUdpServer::SimulatedUdpServer(SimulatedNetwork& network, const std::string& addr, int port)
+    : f_network_(network)
+    , f_port_(port)
+    , f_addr_(addr)
+    , f_key_(SimulatedNetwork::endpointKey(addr, port))
+{
+    if(f_network_.endpoint(f_key_).bound)
+    {
+        throw UdpClientServerRuntimeError(("could not bind simulated UDP socket with: \"" + f_key_.toString() + "\"").c_str());
+    }
+    f_network_.bind(f_key_);
+}
+
+/** \brief Unbind the simulated server.
+ *
+ * Pending datagrams are discarded.
+ */
+SimulatedUdpServer::~SimulatedUdpServer()
+{
+    f_network_.unbind(f_key_);
+}
+
+/** \brief Simulated servers have no socket.
+ *
+ * \return Always -1.
+ */
+int SimulatedUdpServer::getSocket() const
+{
+    return -1;
+}
+
+/** \brief Return the port used by this simulated server.
+ */
+int SimulatedUdpServer::getPort() const
+{
+    return f_port_;
+}
+
+/** \brief Return the address of this simulated server.
+ */
+std::string SimulatedUdpServer::getAddr() const
+{
+    return f_addr_;
+}
+
+/** \brief Receive a delivered message, without moving the clock.
+ *
+ * \return The number of bytes read or -1 with errno set to EAGAIN if no
+ * messages were delivered yet.
+ */
+int SimulatedUdpServer::recv(char *msg, size_t max_size)
+{
+    return recvFrom(msg, max_size, NULL, NULL);
+}
+
+/** \brief Receive a delivered message and the address of its client.
+ *
+ * \param[in] msg  The buffer where the message is saved.
+ * \param[in] max_size  The size of \p msg.
+ * \param[out] from  The source address of the client, may be NULL.
+ * \param[in,out] from_len  The size of \p from on entry, the size of
+ * the address on return.
+ *
+ * \return The number of bytes read or -1 with errno set to EAGAIN if no
+ * messages were delivered yet.
+ */
+int SimulatedUdpServer::recvFrom(char *msg, size_t max_size, struct sockaddr_storage *from, socklen_t *from_len)
+{
+    SimulatedNetwork::Datagram const datagram(pop());
+    if(!datagram.payload)
+    {
+        return -1;
+    }
+    if(from != NULL && from_len != NULL)
+    {
+        *from_len = datagram.source.toSockaddr(*from);
+    }
+    size_t const size(std::min(max_size, datagram.payload->size()));
+    memcpy(msg, datagram.payload->data(), size);
+    return static_cast<int>(size);
+}
+
+/** \brief Receive a delivered message into several buffers.
+ *
+ * MSG_TRUNC is set in \p msg_flags when the message did not fit.
+ */
+int SimulatedUdpServer::recvv(const struct iovec *iov, size_t iovcnt, int *msg_flags)
+{
+    if(msg_flags != NULL)
+    {
+        *msg_flags = 0;
+    }
+    SimulatedNetwork::Payload const payload(pop().payload);
+    if(!payload)
+    {
+        return -1;
+    }
+    size_t offset(0);
+    for(size_t i(0); i < iovcnt && offset < payload->size(); ++i)
+    {
+        size_t const size(std::min(iov[i].iov_len, payload->size() - offset));
+        memcpy(iov[i].iov_base, payload->data() + offset, size);
+        offset += size;
+    }
+    if(offset < payload->size() && msg_flags != NULL)
+    {
+        *msg_flags = MSG_TRUNC;
+    }
+    return static_cast<int>(offset);
+}
+
+/** \brief Receive a delivered message and report its real size.
+ */
+int SimulatedUdpServer::recvTrunc(char *msg, size_t max_size)
+{
+    SimulatedNetwork::Payload const payload(pop().payload);
+    if(!payload)
+    {
+        return -1;
+    }
+    memcpy(msg, payload->data(), std::min(max_size, payload->size()));
+    return static_cast<int>(payload->size());
+}
+
+/** \brief Retrieve the size of the next delivered message.
+ */
+int SimulatedUdpServer::peekSize()
+{
+    SimulatedNetwork::Endpoint& ep(f_network_.endpoint(f_key_));
+    if(ep.queue.empty())
+    {
+        errno = EAGAIN;
+        return -1;
+    }
+    return static_cast<int>(ep.queue.front().payload->size());
+}
+
+/** \brief Wait on the virtual clock for a message.
+ *
+ * If no messages were delivered yet, the virtual clock moves forward
+ * from one arrival to the next until a message reaches this server or
+ * \p max_wait_ms elapsed. No wall-clock time is spent waiting.
+ *
+ * A negative \p max_wait_ms waits without limit, as with UdpServer. Since
+ * nothing else can send while the caller waits, the wait ends (with
+ * EAGAIN) once no datagrams are left in flight.
+ *
+ * \param[in] msg  The buffer where the message is saved.
+ * \param[in] max_size  The maximum size the message (i.e. size of the \p msg buffer.)
+ * \param[in] max_wait_ms  The maximum virtual time to wait, in milliseconds,
+ * or -1 to wait for the next message.
+ *
+ * \return The number of bytes read or -1 with errno set to EAGAIN if the
+ * time elapsed without a message.
+ */
+int SimulatedUdpServer::timedRecv(char *msg, size_t max_size, int max_wait_ms)
+{
+    bool const forever(max_wait_ms < 0);
+    uint64_t const deadline(forever ? 0 : f_network_.now() + static_cast<uint64_t>(max_wait_ms) * 1000000ULL);
+    SimulatedNetwork::Endpoint& ep(f_network_.endpoint(f_key_));
+    while(ep.queue.empty())
+    {
+        uint64_t next;
+        if(!f_network_.nextEventTime(next))
+        {
+            if(!forever)
+            {
+                f_network_.advanceTo(deadline);
+            }
+            break;
+        }
+        if(!forever && next > deadline)
+        {
+            f_network_.advanceTo(deadline);
+            break;
+        }
+        f_network_.advanceTo(next);
+    }
+    return recv(msg, max_size);
+}
+
+SimulatedNetwork::Datagram SimulatedUdpServer::pop()
+{
+    SimulatedNetwork::Endpoint& ep(f_network_.endpoint(f_key_));
+    if(ep.queue.empty())
+    {
+        errno = EAGAIN;
+        return SimulatedNetwork::Datagram();
+    }
+    SimulatedNetwork::Datagram const datagram(ep.queue.front());
+    ep.queue.pop_front();
+    ep.queued_bytes -= datagram.payload->size();
+    return datagram;
+}
+
+} // namespace udp_client_server
+#endif
+// vim: ts=4 sw=4 et
@@ -0,0 +1,143 @@
+// Traffic Statistics -- per-flow arrival jitter and sequence loss
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_TRAFFIC_STATS_CPP
+#define UDP_CLIENT_SERVER_TRAFFIC_STATS_CPP
+
+#include <traffic_stats.h>
+
+namespace udp_client_server
+{
+
+/** \brief Initialize statistics for up to \p max_flows sources.
+ *
+ * A flow is identified by its source address and port. Packets of new
+ * flows are counted as untracked once the table is full.
+ */
+TrafficStats::TrafficStats(size_t max_flows)
+    : f_flows_(max_flows)
+    , f_sequence_offset_(0)
+    , f_sequence_width_(0)
+    , f_untracked_(0)
+{
+}
+
+/** \brief Tell where the datagrams carry a sequence number.
+ *
+ * The sequence number is a big endian counter incremented by one for
+ * each datagram of the flow, i.e. the sequence of a PubSubHeader is at
+ * offset 2 with a width of 2.
+ *
+ * \param[in] offset  The offset of the sequence number in the payload.
+ * \param[in] width  The size of the sequence number: 1, 2 or 4 bytes,
+ * 0 when the datagrams have no sequence number.
+ */
+void TrafficStats::setSequenceField(size_t offset, size_t width)
+{
+    f_sequence_offset_ = offset;
+    f_sequence_width_ = width == 1 || width == 2 || width == 4 ? width : 0;
+}
+
+/** \brief Account for one received datagram.
+ *
+ * Views from UdpServer::recvView() and PacketMonitor can be mixed, as
+ * long as the arrival times are on the same clock.
+ */
+void TrafficStats::observe(const UdpPacketView& view)
+{
+    Table::Entry *flow(f_flows_.touch(view.source, view.timestamp_ns, view.wire_size));
+    if(flow == NULL)
+    {
+        ++f_untracked_;
+        return;
+    }
+    FlowStats& stats(flow->state);
+    if(view.truncated())
+    {
+        ++stats.truncated;
+    }
+
+    if(flow->packets > 1 && view.timestamp_ns >= stats.last_arrival_ns)
+    {
+        double const interarrival(static_cast<double>(view.timestamp_ns - stats.last_arrival_ns));
+        if(flow->packets == 2)
+        {
+            stats.mean_interarrival_ns = interarrival;
+        }
+        double const deviation(interarrival - stats.mean_interarrival_ns);
+        stats.mean_interarrival_ns += deviation / 16.0;
+        stats.jitter_ns += ((deviation < 0.0 ? -deviation : deviation) - stats.jitter_ns) / 16.0;
+    }
+    stats.last_arrival_ns = view.timestamp_ns;
+
+    if(f_sequence_width_ == 0
+    || f_sequence_offset_ + f_sequence_width_ > view.size)
+    {
+        return;
+    }
+    uint32_t sequence(0);
+    const unsigned char *field(reinterpret_cast<const unsigned char *>(view.data + f_sequence_offset_));
+    for(size_t i(0); i < f_sequence_width_; ++i)
+    {
+        sequence = (sequence << 8) | field[i];
+    }
+    uint32_t const mask(f_sequence_width_ == 4 ? 0xFFFFFFFFU : (1U << (f_sequence_width_ * 8)) - 1);
+    if(stats.sequenced)
+    {
+        uint32_t const gap((sequence - stats.next_sequence) & mask);
+        if(gap > mask / 2)
+        {
+            // older than expected: a late packet already counted as lost
+            ++stats.reordered;
+            if(stats.lost > 0)
+            {
+                --stats.lost;
+            }
+            return;
+        }
+        stats.lost += gap;
+    }
+    stats.sequenced = true;
+    stats.next_sequence = (sequence + 1) & mask;
+}
+
+/** \brief Forget the flows not heard from in the last \p idle_ns nanoseconds.
+ *
+ * \return The number of flows removed.
+ */
+size_t TrafficStats::evictIdle(uint64_t now_ns, uint64_t idle_ns)
+{
+    return f_flows_.evictIdle(now_ns, idle_ns);
+}
+
+/** \brief Return the table of flows, i.e. to report them.
+ */
+TrafficStats::Table& TrafficStats::getFlows()
+{
+    return f_flows_;
+}
+
+/** \brief Number of datagrams not accounted because the flow table was full.
+ */
+uint64_t TrafficStats::getUntrackedCount() const
+{
+    return f_untracked_;
+}
+
+} // namespace udp_client_server
+#endif
+// vim: ts=4 sw=4 et
@@ -24,14 +24,175 @@
 #define SNAP_UDP_CLIENT_SERVER_CPP
 
 #include <udp_client_server.h>
+#include <basic_udp_socket.h>
+#include <numa_placement.h>
+#include <udp_probes.h>
+#include <peer_table.h>
 #include <string.h>
 #include <unistd.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <net/if.h>
+#include <poll.h>
+#include <linux/sockios.h>
+#include <linux/sock_diag.h>
+#include <linux/errqueue.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <algorithm>
+#include <thread>
 
 namespace udp_client_server
 {
 
+namespace
+{
+
+/** \brief MTU assumed until the path MTU is known (Ethernet.)
+ */
+const int DEFAULT_MTU = 1500;
+
+/** \brief Size of the IP and UDP headers preceding the payload.
+ */
+int ipUdpHeaderSize(int family)
+{
+    return (family == AF_INET6 ? 40 : 20) + 8;
+}
+
+/** \brief Size of the next datagram in the receive queue of \p s.
+ */
+int socketNextDatagramSize(int s)
+{
+    int value(0);
+    return ioctl(s, SIOCINQ, &value) == 0 ? value : -1;
+}
+
+/** \brief Number of bytes not yet sent in the send queue of \p s.
+ */
+int socketPendingSendBytes(int s)
+{
+    int value(0);
+    return ioctl(s, SIOCOUTQ, &value) == 0 ? value : -1;
+}
+
+/** \brief Read the SO_MEMINFO counters of \p s.
+ */
+int socketMemInfo(int s, SocketMemInfo& info)
+{
+    memset(&info, 0, sizeof(info));
+#ifdef SO_MEMINFO
+    uint32_t meminfo[SK_MEMINFO_VARS];
+    memset(meminfo, 0, sizeof(meminfo));
+    socklen_t len(sizeof(meminfo));
+    if(getsockopt(s, SOL_SOCKET, SO_MEMINFO, meminfo, &len) != 0)
+    {
+        return -1;
+    }
+    info.rmem_alloc = meminfo[SK_MEMINFO_RMEM_ALLOC];
+    info.rcvbuf = meminfo[SK_MEMINFO_RCVBUF];
+    info.wmem_alloc = meminfo[SK_MEMINFO_WMEM_ALLOC];
+    info.sndbuf = meminfo[SK_MEMINFO_SNDBUF];
+    info.fwd_alloc = meminfo[SK_MEMINFO_FWD_ALLOC];
+    info.wmem_queued = meminfo[SK_MEMINFO_WMEM_QUEUED];
+    info.optmem = meminfo[SK_MEMINFO_OPTMEM];
+    info.backlog = meminfo[SK_MEMINFO_BACKLOG];
+    info.drops = meminfo[SK_MEMINFO_DROPS];
+    return 0;
+#else
+    static_cast<void>(s);
+    errno = ENOPROTOOPT;
+    return -1;
+#endif
+}
+
+} // no name namespace
+
+
+// ========================= SOCKET INFO =========================
+
+/** \brief Fraction of the receive buffer in use, from 0.0 to 1.0.
+ *
+ * Drops start when this gets close to 1.0, so this is the value to watch
+ * (and to base batch sizes on) to react before packets are lost.
+ */
+double SocketMemInfo::receiveFill() const
+{
+    return rcvbuf == 0 ? 0.0 : static_cast<double>(rmem_alloc) / static_cast<double>(rcvbuf);
+}
+
+/** \brief Fraction of the send buffer in use, from 0.0 to 1.0.
+ *
+ * When this reaches 1.0, sending fails with EAGAIN.
+ */
+double SocketMemInfo::sendFill() const
+{
+    return sndbuf == 0 ? 0.0 : static_cast<double>(wmem_alloc) / static_cast<double>(sndbuf);
+}
+
 // ========================= CLIENT =========================
 
+/** \brief A resolved destination of a UdpClient.
+ *
+ * Destinations are immutable once published so the send path can use
+ * them without locking.
+ */
+struct UdpClient::Destination
+{
+    struct sockaddr_storage addr;
+    socklen_t           addrlen;
+    std::string         name;
+    int                 port;
+};
+
+/** \brief Keep the current destination alive while a send uses it.
+ *
+ * The reference registers itself in the reader count of the current
+ * epoch before loading the destination. swapDestination() moves to the
+ * next epoch and waits for the readers of the previous one before it
+ * frees the destination it replaced, so the pointer stays valid for the
+ * lifetime of this object. Registering retries if the epoch changed in
+ * between, which keeps new readers from delaying the swap.
+ */
+class UdpClient::DestinationRef
+{
+public:
+    explicit DestinationRef(const UdpClient& client)
+        : f_client_(client)
+    {
+        for(;;)
+        {
+            f_epoch_ = client.f_destination_epoch_.load() & 1;
+            client.f_destination_readers_[f_epoch_].fetch_add(1);
+            if((client.f_destination_epoch_.load() & 1) == f_epoch_)
+            {
+                break;
+            }
+            client.f_destination_readers_[f_epoch_].fetch_sub(1);
+        }
+        f_destination_ = client.f_destination_.load();
+    }
+
+    ~DestinationRef()
+    {
+        f_client_.f_destination_readers_[f_epoch_].fetch_sub(1);
+    }
+
+    const Destination * operator -> () const
+    {
+        return f_destination_;
+    }
+
+    const Destination * get() const
+    {
+        return f_destination_;
+    }
+
+private:
+    const UdpClient&    f_client_;
+    unsigned int        f_epoch_;
+    const Destination * f_destination_;
+};
+
 /** \brief Initialize a UDP client object.
  *
  * This function initializes the UDP client object using the address and the
@@ -61,38 +222,40 @@ namespace udp_client_server
  * \param[in] port  The port number.
  */
 UdpClient::UdpClient(const std::string& addr, int port)
-    : f_port_(port)
-    , f_addr_(addr)
+    : f_socket_(-1)
+    , f_family_(AF_UNSPEC)
+    , f_destination_(NULL)
+    , f_destination_epoch_(0)
+    , f_connected_(false)
+    , f_mtu_(DEFAULT_MTU)
+    , f_send_queue_(NULL)
+    , f_error_callback_(NULL)
+    , f_error_user_(NULL)
 {
-    char decimal_port[16];
-    snprintf(decimal_port, sizeof(decimal_port), "%d", f_port_);
-    decimal_port[sizeof(decimal_port) / sizeof(decimal_port[0]) - 1] = '\0';
-    struct addrinfo hints;
-    memset(&hints, 0, sizeof(hints));
-    hints.ai_family = AF_UNSPEC; // Allows IPv4 or IPv6
-    hints.ai_socktype = SOCK_DGRAM; // Specifies UDP
-    hints.ai_protocol = IPPROTO_UDP; // Specifies UDP
-    int r(getaddrinfo(addr.c_str(), decimal_port, &hints, &f_addrinfo_));
-    if(r != 0 || f_addrinfo_ == NULL)
-    {
-        throw UdpClientServerRuntimeError(("invalid address or port: \"" + addr + ":" + decimal_port + "\"").c_str());
-    }
-    f_socket_ = socket(f_addrinfo_->ai_family, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, IPPROTO_UDP);
-    if(f_socket_ == -1)
-    {
-        freeaddrinfo(f_addrinfo_);
-        throw UdpClientServerRuntimeError(("could not create socket for: \"" + addr + ":" + decimal_port + "\"").c_str());
-    }
+    f_destination_readers_[0].store(0);
+    f_destination_readers_[1].store(0);
+
+    struct addrinfo *info(NULL);
+    f_socket_ = openUdpSocket(addr, port, AF_UNSPEC, SOCK_NONBLOCK, false, info);
+    Destination *destination(new Destination);
+    memcpy(&destination->addr, info->ai_addr, info->ai_addrlen);
+    destination->addrlen = info->ai_addrlen;
+    destination->name = addr;
+    destination->port = port;
+    f_family_ = info->ai_family;
+    f_destination_.store(destination);
+    freeaddrinfo(info);
 }
 
 /** \brief Clean up the UDP client object.
  *
- * This function frees the address information structure and close the socket
- * before returning.
+ * This function frees the destination and close the socket before
+ * returning.
  */
 UdpClient::~UdpClient()
 {
-    freeaddrinfo(f_addrinfo_);
+    delete f_send_queue_;
+    delete f_destination_.load();
     close(f_socket_);
 }
 
@@ -113,39 +276,117 @@ int UdpClient::getSocket() const
  * This function returns the port used by this UDP client. The port is
  * defined as an integer, host side.
  *
- * \return The port as expected in a host integer.
+ * \return The port of the current destination as expected in a host integer.
  */
 int UdpClient::getPort() const
 {
-    return f_port_;
+    return DestinationRef(*this)->port;
 }
 
 /** \brief Retrieve a copy of the address.
  *
  * This function returns a copy of the address as it was specified in the
- * constructor. This does not return a canonalized version of the address.
+ * constructor or the last setDestination(). This does not return a
+ * canonalized version of the address.
  *
- * The address cannot be modified. If you need to send data on a different
- * address, create a new UDP client.
+ * To send data to a different address, use setDestination().
  *
- * \return A string with a copy of the constructor input address.
+ * \return A string with a copy of the current destination address.
  */
 std::string UdpClient::getAddr() const
 {
-    return f_addr_;
+    return DestinationRef(*this)->name;
+}
+
+/** \brief Send the next messages to another address.
+ *
+ * The address is resolved the same way as in the constructor, then
+ * swapped in atomically: the socket is kept, so there is no new file
+ * descriptor to register, and threads sending at the same time use
+ * either the old or the new destination, without locking. The function
+ * returns once the sends still using the old destination are done.
+ *
+ * The new address must be of the same family (IPv4 or IPv6) as the
+ * socket. Messages waiting in the send queue go to the new destination.
+ *
+ * \exception UdpClientServerRuntimeError
+ * The address and port cannot be resolved in the family of the socket.
+ *
+ * \param[in] addr  The new address to convert to a numeric IP.
+ * \param[in] port  The new port number.
+ *
+ * \return 0 on success, -1 if the socket could not be reconnected (see
+ * enablePmtuDiscovery().) errno is set accordingly on error.
+ */
+int UdpClient::setDestination(const std::string& addr, int port)
+{
+    struct sockaddr_storage resolved;
+    socklen_t const resolved_len(resolveUdpAddress(addr, port, f_family_, resolved));
+    Destination *destination(new Destination);
+    memcpy(&destination->addr, &resolved, sizeof(resolved));
+    destination->addrlen = resolved_len;
+    destination->name = addr;
+    destination->port = port;
+    return swapDestination(destination);
+}
+
+/** \brief Send the next messages to an already resolved address.
+ *
+ * This is the fastest way to fail over: resolve the addresses of the
+ * backup peers ahead of time and switch with this function, which does
+ * no name resolution at all. See the other setDestination() for details.
+ *
+ * \param[in] addr  The new destination.
+ * \param[in] addrlen  The size of \p addr.
+ *
+ * \return 0 on success, -1 if an error occurs. errno is set to
+ * EAFNOSUPPORT if \p addr is not of the family of the socket.
+ */
+int UdpClient::setDestination(const struct sockaddr *addr, socklen_t addrlen)
+{
+    if(addr == NULL
+    || addr->sa_family != f_family_
+    || addrlen > sizeof(struct sockaddr_storage))
+    {
+        errno = EAFNOSUPPORT;
+        return -1;
+    }
+    Destination *destination(new Destination);
+    memcpy(&destination->addr, addr, addrlen);
+    destination->addrlen = addrlen;
+    char host[NI_MAXHOST];
+    char service[NI_MAXSERV];
+    if(getnameinfo(addr, addrlen, host, sizeof(host), service, sizeof(service), NI_NUMERICHOST | NI_NUMERICSERV) == 0)
+    {
+        destination->name = host;
+        destination->port = atoi(service);
+    }
+    else
+    {
+        destination->port = 0;
+    }
+    return swapDestination(destination);
 }
 
 /** \brief Send a message through this UDP client.
  *
  * This function sends \p msg through the UDP client socket. The function
- * cannot be used to change the destination as it was defined when creating
- * the UdpClient object.
+ * sends to the destination defined when creating the UdpClient object or
+ * by the last call to setDestination().
  *
  * The size must be small enough for the message to fit. In most cases we
  * use these in Snap! to send very small signals (i.e. 4 bytes commands.)
  * Any data we would want to share remains in the Cassandra database so
  * that way we can avoid losing it because of a UDP message.
  *
+ * Use maxPayload() to find out how large a message can be without being
+ * fragmented.
+ *
+ * When the send queue is enabled (see enableSendQueue()), a message the
+ * socket cannot take right away is queued and counted as sent, unless
+ * it is larger than the queue slots, in which case send() fails with
+ * EMSGSIZE.
+ *
  * \param[in] msg  The message to send.
  * \param[in] size  The number of bytes representing this message.
  *
@@ -154,7 +395,659 @@ std::string UdpClient::getAddr() const
  */
 int UdpClient::send(const char *msg, size_t size)
 {
-    return sendto(f_socket_, msg, size, 0, f_addrinfo_->ai_addr, f_addrinfo_->ai_addrlen);
+    UDP_PROBE(client_send_entry, f_socket_, size);
+    int r;
+    if(f_send_queue_ != NULL)
+    {
+        struct iovec iov;
+        iov.iov_base = const_cast<char *>(msg);
+        iov.iov_len = size;
+        r = queuedSendv(&iov, 1);
+    }
+    else
+    {
+        DestinationRef const d(*this);
+        r = sendResult(sendto(f_socket_, msg, size, 0, reinterpret_cast<const struct sockaddr *>(&d->addr), d->addrlen));
+    }
+    UDP_PROBE(client_send_return, f_socket_, size, r);
+    return r;
+}
+
+/** \brief Send a message made of several buffers.
+ *
+ * This function gathers the \p iov buffers into a single datagram with
+ * sendmsg(), so a header, the payload segments and a trailer can live in
+ * separate buffers and the payload never needs to be copied in user space
+ * to prepend the header.
+ *
+ * \param[in] iov  The buffers making up the message, in order.
+ * \param[in] iovcnt  The number of entries in \p iov (at most IOV_MAX.)
+ *
+ * \return -1 if an error occurs, otherwise the number of bytes sent. errno
+ * is set accordingly on error.
+ */
+int UdpClient::sendv(const struct iovec *iov, size_t iovcnt)
+{
+    UDP_PROBE(client_sendv_entry, f_socket_, iovcnt);
+    int const r(f_send_queue_ != NULL ? queuedSendv(iov, iovcnt) : sendvNow(iov, iovcnt));
+    UDP_PROBE(client_sendv_return, f_socket_, iovcnt, r);
+    return r;
+}
+
+/** \brief Send a message made of several buffers, bypassing the send queue.
+ */
+int UdpClient::sendvNow(const struct iovec *iov, size_t iovcnt)
+{
+    DestinationRef const d(*this);
+    struct msghdr hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.msg_name = const_cast<struct sockaddr_storage *>(&d->addr);
+    hdr.msg_namelen = d->addrlen;
+    hdr.msg_iov = const_cast<struct iovec *>(iov);
+    hdr.msg_iovlen = iovcnt;
+    return sendResult(sendmsg(f_socket_, &hdr, 0));
+}
+
+/** \brief Send several scatter-gather messages with a single system call.
+ *
+ * Each entry of \p vectors becomes one datagram, gathered the same way
+ * as sendv() does. The messages are submitted with sendmmsg() in chunks
+ * of up to SEND_BATCH_SIZE messages.
+ *
+ * Since the socket is non-blocking, the kernel may accept only part of
+ * the batch. The function stops at the first message that could not be
+ * sent and returns the number of messages sent so far. When the send
+ * queue is enabled, the remaining messages are queued instead, up to the
+ * first one the queue rejects. If that is the very first message, the
+ * function fails with EMSGSIZE when it is larger than the queue slots and
+ * EAGAIN when the queue is full.
+ *
+ * \param[in] vectors  The messages to send.
+ * \param[in] count  The number of entries in \p vectors.
+ *
+ * \return -1 if the very first message could not be sent, otherwise the
+ * number of messages sent. errno is set accordingly on error.
+ */
+int UdpClient::sendBatchv(const UdpSendVector *vectors, unsigned int count)
+{
+    UDP_PROBE(client_send_batch_entry, f_socket_, count);
+    int const r(sendBatchvNow(vectors, count));
+    UDP_PROBE(client_send_batch_return, f_socket_, count, r);
+    return r;
+}
+
+/** \brief Implementation of sendBatchv(), between its probes.
+ */
+int UdpClient::sendBatchvNow(const UdpSendVector *vectors, unsigned int count)
+{
+    static const unsigned int SEND_BATCH_SIZE = 64;
+    struct mmsghdr msgs[SEND_BATCH_SIZE];
+
+    if(f_send_queue_ != NULL && !f_send_queue_->empty())
+    {
+        flushSendQueue();
+    }
+
+    unsigned int sent(0);
+    while(sent < count && (f_send_queue_ == NULL || f_send_queue_->empty()))
+    {
+        unsigned int const chunk(std::min(count - sent, SEND_BATCH_SIZE));
+        DestinationRef const d(*this);
+        memset(msgs, 0, sizeof(msgs[0]) * chunk);
+        for(unsigned int i(0); i < chunk; ++i)
+        {
+            msgs[i].msg_hdr.msg_name = const_cast<struct sockaddr_storage *>(&d->addr);
+            msgs[i].msg_hdr.msg_namelen = d->addrlen;
+            msgs[i].msg_hdr.msg_iov = const_cast<struct iovec *>(vectors[sent + i].iov);
+            msgs[i].msg_hdr.msg_iovlen = vectors[sent + i].iovcnt;
+        }
+        int const r(sendResult(sendmmsg(f_socket_, msgs, chunk, 0)));
+        if(r < 0)
+        {
+            if(f_send_queue_ != NULL && (errno == EAGAIN || errno == EWOULDBLOCK))
+            {
+                break;
+            }
+            return sent == 0 ? -1 : static_cast<int>(sent);
+        }
+        sent += static_cast<unsigned int>(r);
+        if(static_cast<unsigned int>(r) < chunk)
+        {
+            break;
+        }
+    }
+
+    // with a send queue, what the socket did not take waits in the queue
+    if(f_send_queue_ != NULL)
+    {
+        while(sent < count && f_send_queue_->push(vectors[sent].iov, vectors[sent].iovcnt))
+        {
+            ++sent;
+        }
+        if(sent == 0 && count != 0)
+        {
+            // the first message is either larger than a slot or the
+            // queue is full and rejects it
+            size_t size(0);
+            for(size_t i(0); i < vectors[0].iovcnt; ++i)
+            {
+                size += vectors[0].iov[i].iov_len;
+            }
+            errno = size > f_send_queue_->slotSize() ? EMSGSIZE : EAGAIN;
+            return -1;
+        }
+    }
+    return static_cast<int>(sent);
+}
+
+/** \brief Turn on path MTU discovery for this client.
+ *
+ * This function sets the Don't Fragment behavior on the socket
+ * (IP_MTU_DISCOVER or IPV6_MTU_DISCOVER set to PMTUDISC_DO) so the kernel
+ * tracks the path MTU to the destination, and connects the socket to the
+ * destination so that MTU can be queried with getMtu().
+ *
+ * Once enabled, a send() of a message larger than the path MTU fails with
+ * EMSGSIZE instead of being fragmented, and maxPayload() is refreshed so
+ * the caller can split the message and try again.
+ *
+ * \note
+ * Because the socket gets connected, ICMP errors from the destination
+ * (i.e. port unreachable) are reported by later calls to send() as
+ * ECONNREFUSED.
+ *
+ * \return 0 on success, -1 if an error occurs. errno is set accordingly
+ * on error.
+ */
+int UdpClient::enablePmtuDiscovery()
+{
+    int r;
+    if(f_family_ == AF_INET6)
+    {
+        int const mode(IPV6_PMTUDISC_DO);
+        r = setsockopt(f_socket_, IPPROTO_IPV6, IPV6_MTU_DISCOVER, &mode, sizeof(mode));
+    }
+    else
+    {
+        int const mode(IP_PMTUDISC_DO);
+        r = setsockopt(f_socket_, IPPROTO_IP, IP_MTU_DISCOVER, &mode, sizeof(mode));
+    }
+    if(r != 0)
+    {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(f_destination_mutex_);
+    const Destination *d(f_destination_.load());
+    if(connect(f_socket_, reinterpret_cast<const struct sockaddr *>(&d->addr), d->addrlen) != 0)
+    {
+        return -1;
+    }
+    f_connected_ = true;
+    refreshMtu();
+    return 0;
+}
+
+/** \brief Query the kernel for the current path MTU.
+ *
+ * The value is only available once enablePmtuDiscovery() was called since
+ * the kernel needs a connected socket to answer.
+ *
+ * \return The path MTU in bytes, or -1 if an error occurs. errno is set
+ * accordingly on error (ENOTCONN when discovery is not enabled.)
+ */
+int UdpClient::getMtu() const
+{
+    int mtu(0);
+    socklen_t len(sizeof(mtu));
+    int const r(f_family_ == AF_INET6
+            ? getsockopt(f_socket_, IPPROTO_IPV6, IPV6_MTU, &mtu, &len)
+            : getsockopt(f_socket_, IPPROTO_IP, IP_MTU, &mtu, &len));
+    return r == 0 ? mtu : -1;
+}
+
+/** \brief The largest payload that fits in one datagram without fragmentation.
+ *
+ * This is the last known path MTU minus the IP and UDP headers. Until
+ * enablePmtuDiscovery() is called, an Ethernet MTU of 1500 is assumed.
+ *
+ * The value is cached, so calling this function on each packet is cheap.
+ * The cache is refreshed whenever a send fails with EMSGSIZE.
+ *
+ * \return The maximum payload size in bytes.
+ */
+size_t UdpClient::maxPayload() const
+{
+    int const payload(f_mtu_ - ipUdpHeaderSize(f_family_));
+    return static_cast<size_t>(std::min(payload, 65535 - ipUdpHeaderSize(f_family_)));
+}
+
+/** \brief Report the ICMP errors of the datagrams sent through a callback.
+ *
+ * This function turns on IP_RECVERR (IPV6_RECVERR for an IPv6 client)
+ * so the kernel queues the errors received for this socket, such as
+ * the ICMP port unreachable sent back while the peer application is
+ * not running, or a host unreachable while it reboots. pollErrors()
+ * reads that queue and calls \p callback for each error.
+ *
+ * The socket reports POLLERR while errors are queued; watch for it (it
+ * is always reported by poll() and epoll) and call pollErrors() then.
+ *
+ * \note
+ * With IP_RECVERR, the kernel also reports the last error to the next
+ * send(), even on a socket that is not connected. That send fails
+ * (ECONNREFUSED, EHOSTUNREACH...) and its message is not sent; the
+ * error stays in the queue for pollErrors().
+ *
+ * \param[in] callback  The function called for each error, NULL to
+ * just drain the queue in pollErrors().
+ * \param[in] user  A pointer passed back to \p callback.
+ *
+ * \return 0 on success, -1 if an error occurs. errno is set accordingly
+ * on error.
+ */
+int UdpClient::enableErrorReporting(ErrorCallback callback, void *user)
+{
+    int const on(1);
+    int const r(f_family_ == AF_INET6
+            ? setsockopt(f_socket_, IPPROTO_IPV6, IPV6_RECVERR, &on, sizeof(on))
+            : setsockopt(f_socket_, IPPROTO_IP, IP_RECVERR, &on, sizeof(on)));
+    if(r != 0)
+    {
+        return -1;
+    }
+    f_error_callback_ = callback;
+    f_error_user_ = user;
+    return 0;
+}
+
+/** \brief Read the socket error queue and report each error.
+ *
+ * Port unreachable, host (or network) unreachable and fragmentation
+ * needed errors get their own kind; the others are reported as
+ * UDP_ERROR_OTHER. A fragmentation needed error for the current
+ * destination also updates the cached MTU, so maxPayload() reflects
+ * the new path MTU right away.
+ *
+ * The callback is called from this function, in the calling thread.
+ *
+ * \return The number of errors read, or -1 if an error occurs. errno is
+ * set accordingly on error.
+ */
+int UdpClient::pollErrors()
+{
+    int count(0);
+    for(;;)
+    {
+        UdpErrorEvent event;
+        memset(&event, 0, sizeof(event));
+        char payload[64];
+        struct iovec iov;
+        iov.iov_base = payload;
+        iov.iov_len = sizeof(payload);
+        char control[512];
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_name = &event.destination;
+        msg.msg_namelen = sizeof(event.destination);
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        if(recvmsg(f_socket_, &msg, MSG_ERRQUEUE) < 0)
+        {
+            if(errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+        event.destination_len = msg.msg_namelen;
+
+        const struct sock_extended_err *ee(NULL);
+        for(struct cmsghdr *cmsg(CMSG_FIRSTHDR(&msg)); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg))
+        {
+            if((cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_RECVERR)
+            || (cmsg->cmsg_level == IPPROTO_IPV6 && cmsg->cmsg_type == IPV6_RECVERR))
+            {
+                ee = reinterpret_cast<const struct sock_extended_err *>(CMSG_DATA(cmsg));
+                break;
+            }
+        }
+        if(ee == NULL)
+        {
+            continue;
+        }
+        event.error = static_cast<int>(ee->ee_errno);
+        event.origin = ee->ee_origin;
+        event.type = ee->ee_type;
+        event.code = ee->ee_code;
+        const struct sockaddr *offender(SO_EE_OFFENDER(ee));
+        if(offender->sa_family == AF_INET)
+        {
+            memcpy(&event.offender, offender, sizeof(struct sockaddr_in));
+            event.offender_len = sizeof(struct sockaddr_in);
+        }
+        else if(offender->sa_family == AF_INET6)
+        {
+            memcpy(&event.offender, offender, sizeof(struct sockaddr_in6));
+            event.offender_len = sizeof(struct sockaddr_in6);
+        }
+        switch(event.error)
+        {
+        case ECONNREFUSED:
+            event.kind = UDP_ERROR_PORT_UNREACHABLE;
+            break;
+
+        case EHOSTUNREACH:
+        case ENETUNREACH:
+        case EHOSTDOWN:
+            event.kind = UDP_ERROR_HOST_UNREACHABLE;
+            break;
+
+        case EMSGSIZE:
+            event.kind = UDP_ERROR_FRAGMENTATION_NEEDED;
+            event.mtu = ee->ee_info;
+            break;
+
+        default:
+            event.kind = UDP_ERROR_OTHER;
+            break;
+
+        }
+
+        if(event.kind == UDP_ERROR_FRAGMENTATION_NEEDED
+        && event.mtu > 0
+        && event.destination_len > 0
+        && PeerKey(reinterpret_cast<const struct sockaddr *>(&event.destination))
+                == PeerKey(reinterpret_cast<const struct sockaddr *>(&DestinationRef(*this)->addr)))
+        {
+            f_mtu_ = static_cast<int>(event.mtu);
+        }
+
+        ++count;
+        if(f_error_callback_ != NULL)
+        {
+            f_error_callback_(f_error_user_, event);
+        }
+    }
+    return count;
+}
+
+/** \brief Hold messages refused by the socket instead of losing them.
+ *
+ * The socket is non-blocking, so when its send buffer is full, send()
+ * fails with EAGAIN and the message is lost unless the caller retries.
+ * Once the send queue is enabled, such messages are copied in a bounded
+ * user-space queue instead and send() reports success. Later sends go
+ * to the queue as long as it is not empty, so the order of the messages
+ * is preserved.
+ *
+ * The caller watches the socket for EPOLLOUT while hasQueuedSends() is
+ * true and calls flushSendQueue() when it becomes writable. The queue
+ * is flushed with sendmmsg(), up to 64 messages per system call.
+ *
+ * Calling this function again replaces the queue; queued messages are
+ * lost.
+ *
+ * \param[in] capacity  The maximum number of queued messages.
+ * \param[in] policy  What happens to a message sent while the queue is full.
+ * \param[in] max_message_size  The largest message that can be queued,
+ * 0 to use maxPayload(). All the memory is allocated here.
+ *
+ * \note
+ * A message larger than \p max_message_size is still sent when the
+ * socket takes it right away, but it cannot be queued: if the socket
+ * refuses it with EAGAIN, send() fails with EMSGSIZE. Pass the size of
+ * the largest message the application sends (at most 65507 bytes over
+ * IPv4) when it sends messages larger than maxPayload().
+ *
+ * \return 0 on success, -1 with errno set to EINVAL if \p capacity is 0.
+ */
+int UdpClient::enableSendQueue(size_t capacity, SendQueueOverflow policy, size_t max_message_size)
+{
+    if(capacity == 0)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    delete f_send_queue_;
+    f_send_queue_ = NULL;
+    f_send_queue_ = new SendQueue(capacity, max_message_size == 0 ? maxPayload() : max_message_size, policy);
+    return 0;
+}
+
+/** \brief Send as many queued messages as the socket accepts.
+ *
+ * Call this function when the socket becomes writable (EPOLLOUT.) A
+ * queued message that fails for a reason other than EAGAIN (i.e. it is
+ * larger than the path MTU) is dropped so it cannot block the queue.
+ *
+ * \return The number of messages sent, or -1 if an error other than
+ * EAGAIN occurred before any message could be sent. errno is set
+ * accordingly on error.
+ */
+int UdpClient::flushSendQueue()
+{
+    static const size_t FLUSH_BATCH_SIZE = 64;
+
+    if(f_send_queue_ == NULL)
+    {
+        return 0;
+    }
+    int total(0);
+    while(!f_send_queue_->empty())
+    {
+        struct iovec iov[FLUSH_BATCH_SIZE];
+        struct mmsghdr msgs[FLUSH_BATCH_SIZE];
+        size_t const count(f_send_queue_->peek(iov, FLUSH_BATCH_SIZE));
+        DestinationRef const d(*this);
+        memset(msgs, 0, sizeof(msgs[0]) * count);
+        for(size_t i(0); i < count; ++i)
+        {
+            msgs[i].msg_hdr.msg_name = const_cast<struct sockaddr_storage *>(&d->addr);
+            msgs[i].msg_hdr.msg_namelen = d->addrlen;
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+        int const r(sendResult(sendmmsg(f_socket_, msgs, static_cast<unsigned int>(count), 0)));
+        if(r < 0)
+        {
+            if(errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+            f_send_queue_->pop(1);
+            return total == 0 ? -1 : total;
+        }
+        f_send_queue_->pop(static_cast<size_t>(r));
+        total += r;
+        if(static_cast<size_t>(r) < count)
+        {
+            break;
+        }
+    }
+    return total;
+}
+
+/** \brief Check whether messages wait in the send queue.
+ *
+ * While this returns true, the caller should wait for EPOLLOUT on the
+ * socket and call flushSendQueue().
+ */
+bool UdpClient::hasQueuedSends() const
+{
+    return f_send_queue_ != NULL && !f_send_queue_->empty();
+}
+
+/** \brief Return the send queue, i.e. to read its counters.
+ *
+ * \return NULL if enableSendQueue() was not called.
+ */
+const SendQueue *UdpClient::getSendQueue() const
+{
+    return f_send_queue_;
+}
+
+/** \brief Send a message through the send queue.
+ *
+ * The message goes straight to the socket when nothing is queued and the
+ * socket accepts it; otherwise it is queued behind the other messages.
+ */
+int UdpClient::queuedSendv(const struct iovec *iov, size_t iovcnt)
+{
+    if(!f_send_queue_->empty())
+    {
+        flushSendQueue();
+    }
+    if(f_send_queue_->empty())
+    {
+        int const r(sendvNow(iov, iovcnt));
+        if(r >= 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+        {
+            return r;
+        }
+    }
+
+    size_t size(0);
+    for(size_t i(0); i < iovcnt; ++i)
+    {
+        size += iov[i].iov_len;
+    }
+    if(size > f_send_queue_->slotSize())
+    {
+        errno = EMSGSIZE;
+        return -1;
+    }
+    if(!f_send_queue_->push(iov, iovcnt))
+    {
+        errno = EAGAIN;
+        return -1;
+    }
+    return static_cast<int>(size);
+}
+
+/** \brief Publish \p destination as the new destination.
+ *
+ * When path MTU discovery connected the socket, it is connected to the
+ * new destination first; if that fails, \p destination is discarded and
+ * the current destination stays in place.
+ *
+ * The previous destination may still be in use by a thread in the middle
+ * of a send. The function moves to the next epoch and waits for the sends
+ * registered in the previous one to return before it frees it, so at most
+ * one destination is ever retired. New sends do not delay the swap since
+ * they register in the new epoch.
+ *
+ * \return 0 on success, -1 if the socket could not be connected to the
+ * new destination. errno is set accordingly on error.
+ */
+int UdpClient::swapDestination(Destination *destination)
+{
+    std::lock_guard<std::mutex> lock(f_destination_mutex_);
+    if(f_connected_)
+    {
+        if(connect(f_socket_, reinterpret_cast<const struct sockaddr *>(&destination->addr), destination->addrlen) != 0)
+        {
+            delete destination;
+            return -1;
+        }
+        refreshMtu();
+    }
+    const Destination *previous(f_destination_.exchange(destination));
+    unsigned int const epoch(f_destination_epoch_.fetch_add(1) & 1);
+    while(f_destination_readers_[epoch].load() != 0)
+    {
+        std::this_thread::yield();
+    }
+    delete previous;
+    return 0;
+}
+
+/** \brief Update the cached path MTU from the kernel.
+ *
+ * The cached value is left alone if the kernel cannot tell. errno is
+ * preserved so this can be called on an error path.
+ */
+void UdpClient::refreshMtu()
+{
+    int const e(errno);
+    int const mtu(getMtu());
+    if(mtu > 0)
+    {
+        f_mtu_ = mtu;
+    }
+    errno = e;
+}
+
+/** \brief Common handling of the result of the send functions.
+ *
+ * When a message was too large for the path MTU, the cached MTU is
+ * refreshed so maxPayload() reflects the new value.
+ *
+ * \param[in] r  The value returned by the system call.
+ *
+ * \return \p r unchanged.
+ */
+int UdpClient::sendResult(int r)
+{
+    if(r < 0 && errno == EMSGSIZE)
+    {
+        refreshMtu();
+    }
+    return r;
+}
+
+/** \brief Retrieve the size of the next datagram waiting in the receive queue.
+ *
+ * For UDP sockets the SIOCINQ ioctl() reports the payload size of the
+ * next datagram only, not the total of the queue; see pendingRecvBytes()
+ * for the latter.
+ *
+ * \return The size in bytes, 0 if the queue is empty, or -1 if an error
+ * occurs.
+ */
+int UdpClient::nextDatagramSize() const
+{
+    return socketNextDatagramSize(f_socket_);
+}
+
+/** \brief Retrieve the number of bytes waiting in the send queue (SIOCOUTQ.)
+ *
+ * \return The number of bytes not yet sent, or -1 if an error occurs.
+ */
+int UdpClient::pendingSendBytes() const
+{
+    return socketPendingSendBytes(f_socket_);
+}
+
+/** \brief Retrieve the kernel memory used by the receive queue.
+ *
+ * This is the SO_MEMINFO receive allocation, which includes the per
+ * packet overhead of the kernel. It is the value compared against
+ * SO_RCVBUF to decide when to drop incoming packets.
+ *
+ * \return The number of bytes, or -1 if an error occurs.
+ */
+int UdpClient::pendingRecvBytes() const
+{
+    SocketMemInfo info;
+    return socketMemInfo(f_socket_, info) == 0 ? static_cast<int>(info.rmem_alloc) : -1;
+}
+
+/** \brief Retrieve the kernel memory accounting of this client socket.
+ *
+ * \param[out] info  The SO_MEMINFO counters.
+ *
+ * \return 0 on success, -1 if an error occurs (ENOPROTOOPT on kernels
+ * older than 4.12.)
+ */
+int UdpClient::getMemInfo(SocketMemInfo& info) const
+{
+    return socketMemInfo(f_socket_, info);
 }
 
 
@@ -197,32 +1090,7 @@ UdpServer::UdpServer(const std::string& addr, int port)
     : f_port_(port)
     , f_addr_(addr)
 {
-    char decimal_port[16];
-    snprintf(decimal_port, sizeof(decimal_port), "%d", f_port_);
-    decimal_port[sizeof(decimal_port) / sizeof(decimal_port[0]) - 1] = '\0';
-    struct addrinfo hints;
-    memset(&hints, 0, sizeof(hints));
-    hints.ai_family = AF_UNSPEC;
-    hints.ai_socktype = SOCK_DGRAM;
-    hints.ai_protocol = IPPROTO_UDP;
-    int r(getaddrinfo(addr.c_str(), decimal_port, &hints, &f_addrinfo_));
-    if(r != 0 || f_addrinfo_ == NULL)
-    {
-        throw UdpClientServerRuntimeError(("invalid address or port for UDP socket: \"" + addr + ":" + decimal_port + "\"").c_str());
-    }
-    f_socket_ = socket(f_addrinfo_->ai_family, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, IPPROTO_UDP);
-    if(f_socket_ == -1)
-    {
-        freeaddrinfo(f_addrinfo_);
-        throw UdpClientServerRuntimeError(("could not create UDP socket for: \"" + addr + ":" + decimal_port + "\"").c_str());
-    }
-    r = bind(f_socket_, f_addrinfo_->ai_addr, f_addrinfo_->ai_addrlen);
-    if(r != 0)
-    {
-        freeaddrinfo(f_addrinfo_);
-        close(f_socket_);
-        throw UdpClientServerRuntimeError(("could not bind UDP socket with: \"" + addr + ":" + decimal_port + ". errno: " + std::to_string(errno) + "\"").c_str());
-    }
+    f_socket_ = openUdpSocket(addr, port, AF_UNSPEC, SOCK_NONBLOCK, true, f_addrinfo_);
 }
 
 /** \brief Clean up the UDP server.
@@ -276,6 +1144,9 @@ std::string UdpServer::getAddr() const
  *  
  * If no messages are available, -1 is returned and errno is set.
  *
+ * A message larger than \p max_size is silently truncated. Use
+ * recvTrunc() or peekSize() when the caller needs to know.
+ *
  * \param[in] msg  The buffer where the message is saved.
  * \param[in] max_size  The maximum size the message (i.e. size of the \p msg buffer.)
  *
@@ -283,7 +1154,349 @@ std::string UdpServer::getAddr() const
  */
 int UdpServer::recv(char *msg, size_t max_size)
 {
-    return ::recv(f_socket_, msg, max_size, 0);
+    UDP_PROBE(server_recv_entry, f_socket_, max_size);
+    int const r(::recv(f_socket_, msg, max_size, 0));
+    UDP_PROBE(server_recv_return, f_socket_, max_size, r);
+    return r;
+}
+
+/** \brief Attempt to receive a message and its source address.
+ *
+ * This function works like recv() and also returns the address of the
+ * sender, i.e. to keep per-peer state or to reply.
+ *
+ * \param[in] msg  The buffer where the message is saved.
+ * \param[in] max_size  The maximum size the message (i.e. size of the \p msg buffer.)
+ * \param[out] from  The address of the sender.
+ * \param[in,out] from_len  On input the size of \p from, on output the
+ * size of the address.
+ *
+ * \return The number of bytes read or -1 if an error occurs.
+ */
+int UdpServer::recvFrom(char *msg, size_t max_size, struct sockaddr_storage *from, socklen_t *from_len)
+{
+    UDP_PROBE(server_recv_from_entry, f_socket_, max_size);
+    int const r(::recvfrom(f_socket_, msg, max_size, 0, reinterpret_cast<struct sockaddr *>(from), from_len));
+    UDP_PROBE(server_recv_from_return, f_socket_, max_size, r);
+    return r;
+}
+
+/** \brief Receive a message directly into several buffers.
+ *
+ * This function uses recvmsg() to scatter the next datagram over \p iov
+ * in order. A typical use is a fixed-size header going into a small
+ * structure and the payload going straight into its final destination
+ * (i.e. a frame buffer slot) instead of a bounce buffer.
+ *
+ * Like recv() this function does not block. If no messages are available,
+ * -1 is returned and errno is set.
+ *
+ * When the datagram is larger than the sum of the \p iov buffers, the
+ * excess is discarded by the kernel. In that case MSG_TRUNC is set in
+ * \p msg_flags so the caller knows its payload buffer was too small.
+ *
+ * \param[in] iov  The buffers where the message is saved, in order.
+ * \param[in] iovcnt  The number of entries in \p iov (at most IOV_MAX.)
+ * \param[out] msg_flags  If not NULL, receives the recvmsg() flags,
+ * including MSG_TRUNC.
+ *
+ * \return The number of bytes saved in \p iov or -1 if an error occurs.
+ */
+int UdpServer::recvv(const struct iovec *iov, size_t iovcnt, int *msg_flags)
+{
+    UDP_PROBE(server_recvv_entry, f_socket_, iovcnt);
+    struct msghdr hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.msg_iov = const_cast<struct iovec *>(iov);
+    hdr.msg_iovlen = iovcnt;
+    int const r(recvmsg(f_socket_, &hdr, 0));
+    if(msg_flags != NULL)
+    {
+        *msg_flags = r < 0 ? 0 : hdr.msg_flags;
+    }
+    UDP_PROBE(server_recvv_return, f_socket_, iovcnt, r);
+    return r;
+}
+
+/** \brief Receive a message and report its real size.
+ *
+ * This function works like recv() except that the return value is the
+ * real size of the datagram, even when it did not fit in \p msg. A
+ * return value larger than \p max_size means the message was truncated
+ * and the excess was lost.
+ *
+ * \param[in] msg  The buffer where the message is saved.
+ * \param[in] max_size  The maximum size the message (i.e. size of the \p msg buffer.)
+ *
+ * \return The size of the datagram or -1 if an error occurs.
+ */
+int UdpServer::recvTrunc(char *msg, size_t max_size)
+{
+    UDP_PROBE(server_recv_trunc_entry, f_socket_, max_size);
+    int const r(::recv(f_socket_, msg, max_size, MSG_TRUNC));
+    UDP_PROBE(server_recv_trunc_return, f_socket_, max_size, r);
+    return r;
+}
+
+/** \brief Receive a message and describe it in a packet view.
+ *
+ * The view gets the source address, the local address of the server,
+ * the real size of the datagram and its arrival time. The arrival time
+ * is the kernel receive time when SO_TIMESTAMPNS is enabled on the
+ * socket, otherwise the time this function returns.
+ *
+ * This is the view PacketMonitor produces too, so statistics such as
+ * TrafficStats work the same on both.
+ *
+ * \param[in] msg  The buffer where the message is saved.
+ * \param[in] max_size  The maximum size the message (i.e. size of the \p msg buffer.)
+ * \param[out] view  The description of the message, pointing to \p msg.
+ *
+ * \return The size of the datagram or -1 if an error occurs.
+ */
+int UdpServer::recvView(char *msg, size_t max_size, UdpPacketView& view)
+{
+    UDP_PROBE(server_recv_view_entry, f_socket_, max_size);
+    struct iovec iov;
+    iov.iov_base = msg;
+    iov.iov_len = max_size;
+    union
+    {
+        char            buf[CMSG_SPACE(sizeof(struct timespec))];
+        struct cmsghdr  align;
+    } control;
+    struct msghdr hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.msg_name = &view.source;
+    hdr.msg_namelen = sizeof(view.source);
+    hdr.msg_iov = &iov;
+    hdr.msg_iovlen = 1;
+    hdr.msg_control = control.buf;
+    hdr.msg_controllen = sizeof(control.buf);
+    int const r(recvmsg(f_socket_, &hdr, MSG_TRUNC));
+    if(r < 0)
+    {
+        UDP_PROBE(server_recv_view_return, f_socket_, max_size, r);
+        return -1;
+    }
+
+    struct timespec stamp;
+    stamp.tv_sec = 0;
+    stamp.tv_nsec = 0;
+    for(struct cmsghdr *cmsg(CMSG_FIRSTHDR(&hdr)); cmsg != NULL; cmsg = CMSG_NXTHDR(&hdr, cmsg))
+    {
+        if(cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS)
+        {
+            memcpy(&stamp, CMSG_DATA(cmsg), sizeof(stamp));
+        }
+    }
+    if(stamp.tv_sec == 0)
+    {
+        clock_gettime(CLOCK_REALTIME, &stamp);
+    }
+
+    view.data = msg;
+    view.wire_size = static_cast<size_t>(r);
+    view.size = std::min(view.wire_size, max_size);
+    view.source_len = hdr.msg_namelen;
+    memcpy(&view.destination, f_addrinfo_->ai_addr, f_addrinfo_->ai_addrlen);
+    view.destination_len = f_addrinfo_->ai_addrlen;
+    view.timestamp_ns = static_cast<uint64_t>(stamp.tv_sec) * 1000000000ULL + static_cast<uint64_t>(stamp.tv_nsec);
+    UDP_PROBE(server_recv_view_return, f_socket_, max_size, r);
+    return r;
+}
+
+/** \brief Retrieve the size of the next pending message.
+ *
+ * This function peeks at the next datagram without copying nor removing
+ * it, so the caller can pick a buffer large enough before calling recv().
+ *
+ * \return The size of the next datagram or -1 if an error occurs. If no
+ * messages are available, errno is set to EAGAIN.
+ */
+int UdpServer::peekSize()
+{
+    UDP_PROBE(server_peek_size_entry, f_socket_, 0);
+    int const r(::recv(f_socket_, NULL, 0, MSG_PEEK | MSG_TRUNC));
+    UDP_PROBE(server_peek_size_return, f_socket_, 0, r);
+    return r;
+}
+
+/** \brief Wait for a message for up to \p max_wait_ms milliseconds.
+ *
+ * This function waits for the socket to become readable with poll(), then
+ * receives the message like recv(). It is the way to block on a server
+ * since its socket is non-blocking.
+ *
+ * \param[in] msg  The buffer where the message is saved.
+ * \param[in] max_size  The maximum size the message (i.e. size of the \p msg buffer.)
+ * \param[in] max_wait_ms  The maximum number of milliseconds to wait,
+ * -1 to wait forever.
+ *
+ * \return The number of bytes read or -1 if an error occurs. When no
+ * message arrived in time, errno is set to EAGAIN.
+ */
+int UdpServer::timedRecv(char *msg, size_t max_size, int max_wait_ms)
+{
+    UDP_PROBE(server_timed_recv_entry, f_socket_, max_size);
+    struct pollfd fd;
+    fd.fd = f_socket_;
+    fd.events = POLLIN;
+    fd.revents = 0;
+    int r(::poll(&fd, 1, max_wait_ms));
+    if(r == 0)
+    {
+        errno = EAGAIN;
+        r = -1;
+    }
+    else if(r > 0)
+    {
+        r = ::recv(f_socket_, msg, max_size, 0);
+    }
+    UDP_PROBE(server_timed_recv_return, f_socket_, max_size, r);
+    return r;
+}
+
+/** \brief Receive the datagrams sent to a multicast group.
+ *
+ * The server must be bound to the wildcard address (or to the group
+ * address) and to the port the group traffic is sent to, otherwise the
+ * kernel does not deliver the group datagrams to this socket.
+ *
+ * \param[in] group  The numeric address of the group, of the same family
+ * as the server address.
+ * \param[in] ifname  The interface to join the group on, empty to let the
+ * kernel pick one from the routing table.
+ *
+ * \return 0 on success, -1 if an error occurs. errno is set accordingly
+ * on error (EINVAL if \p group is not a numeric address of the family of
+ * the server, ENODEV if \p ifname does not exist.)
+ */
+int UdpServer::joinMulticastGroup(const std::string& group, const std::string& ifname)
+{
+    unsigned int ifindex(0);
+    if(!ifname.empty())
+    {
+        ifindex = if_nametoindex(ifname.c_str());
+        if(ifindex == 0)
+        {
+            errno = ENODEV;
+            return -1;
+        }
+    }
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = f_addrinfo_->ai_family;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_flags = AI_NUMERICHOST;
+    struct addrinfo *info(NULL);
+    if(getaddrinfo(group.c_str(), NULL, &hints, &info) != 0 || info == NULL)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    int r;
+    if(info->ai_family == AF_INET6)
+    {
+        struct ipv6_mreq mreq;
+        memset(&mreq, 0, sizeof(mreq));
+        mreq.ipv6mr_multiaddr = reinterpret_cast<struct sockaddr_in6 *>(info->ai_addr)->sin6_addr;
+        mreq.ipv6mr_interface = ifindex;
+        r = setsockopt(f_socket_, IPPROTO_IPV6, IPV6_JOIN_GROUP, &mreq, sizeof(mreq));
+    }
+    else
+    {
+        struct ip_mreqn mreq;
+        memset(&mreq, 0, sizeof(mreq));
+        mreq.imr_multiaddr = reinterpret_cast<struct sockaddr_in *>(info->ai_addr)->sin_addr;
+        mreq.imr_ifindex = static_cast<int>(ifindex);
+        r = setsockopt(f_socket_, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq));
+    }
+    freeaddrinfo(info);
+    return r;
+}
+
+/** \brief Retrieve the size of the next datagram waiting in the receive queue.
+ *
+ * For UDP sockets the SIOCINQ ioctl() reports the payload size of the
+ * next datagram only, not the total of the queue; see pendingRecvBytes()
+ * for the latter.
+ *
+ * \return The size in bytes, 0 if the queue is empty, or -1 if an error
+ * occurs.
+ */
+int UdpServer::nextDatagramSize() const
+{
+    return socketNextDatagramSize(f_socket_);
+}
+
+/** \brief Retrieve the number of bytes waiting in the send queue (SIOCOUTQ.)
+ *
+ * \return The number of bytes not yet sent, or -1 if an error occurs.
+ */
+int UdpServer::pendingSendBytes() const
+{
+    return socketPendingSendBytes(f_socket_);
+}
+
+/** \brief Retrieve the kernel memory used by the receive queue.
+ *
+ * This is the SO_MEMINFO receive allocation, which includes the per
+ * packet overhead of the kernel. It is the value compared against
+ * SO_RCVBUF to decide when to drop incoming packets.
+ *
+ * \return The number of bytes, or -1 if an error occurs.
+ */
+int UdpServer::pendingRecvBytes() const
+{
+    SocketMemInfo info;
+    return socketMemInfo(f_socket_, info) == 0 ? static_cast<int>(info.rmem_alloc) : -1;
+}
+
+/** \brief Retrieve the kernel memory accounting of this server socket.
+ *
+ * \param[out] info  The SO_MEMINFO counters.
+ *
+ * \return 0 on success, -1 if an error occurs (ENOPROTOOPT on kernels
+ * older than 4.12.)
+ */
+int UdpServer::getMemInfo(SocketMemInfo& info) const
+{
+    return socketMemInfo(f_socket_, info);
+}
+
+/** \brief Retrieve the CPU which processed the last received packet.
+ *
+ * This is the CPU where the kernel ran the network stack for this socket
+ * (SO_INCOMING_CPU), normally the one handling the NIC queue interrupt.
+ * Receive workers running on the same NUMA node avoid reading packets
+ * across the interconnect.
+ *
+ * \return The CPU number, or -1 if an error occurs or nothing was
+ * received yet.
+ */
+int UdpServer::incomingCpu() const
+{
+    int cpu(-1);
+    socklen_t len(sizeof(cpu));
+    if(getsockopt(f_socket_, SOL_SOCKET, SO_INCOMING_CPU, &cpu, &len) != 0)
+    {
+        return -1;
+    }
+    return cpu;
+}
+
+/** \brief Retrieve the NUMA node of incomingCpu().
+ *
+ * Use this node for the ReceiveBufferPool and numaPinThreadToNode() of
+ * the worker reading this server.
+ *
+ * \return The node number, or -1 if it cannot be determined.
+ */
+int UdpServer::incomingNumaNode() const
+{
+    int const cpu(incomingCpu());
+    return cpu < 0 ? -1 : numaNodeOfCpu(cpu);
 }
 
 } // namespace udp_client_server
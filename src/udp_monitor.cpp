@@ -0,0 +1,109 @@
+// UDP Monitor -- print the jitter and loss of the UDP flows of an interface
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+// Usage: udp_monitor <interface> [<port> [<sequence offset> <sequence width>]]
+//
+// Prints the statistics of each flow every second. Needs CAP_NET_RAW.
+
+#include <packet_monitor.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+using namespace udp_client_server;
+
+namespace
+{
+
+uint64_t realtimeNowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+} // no name namespace
+
+
+int main(int argc, char *argv[])
+{
+    if(argc < 2)
+    {
+        fprintf(stderr, "Usage: %s <interface> [<port> [<sequence offset> <sequence width>]]\n", argv[0]);
+        return 1;
+    }
+    int const port(argc >= 3 ? atoi(argv[2]) : 0);
+
+    TrafficStats stats;
+    if(argc >= 5)
+    {
+        stats.setSequenceField(strtoul(argv[3], NULL, 0), strtoul(argv[4], NULL, 0));
+    }
+
+    try
+    {
+        PacketMonitor monitor(argv[1], port);
+        monitor.setStats(&stats);
+
+        uint64_t next_report(realtimeNowNs() + 1000000000ULL);
+        for(;;)
+        {
+            if(monitor.poll(100) < 0)
+            {
+                if(errno == EINTR)
+                {
+                    continue;
+                }
+                perror("poll");
+                return 1;
+            }
+            uint64_t const now(realtimeNowNs());
+            if(now < next_report)
+            {
+                continue;
+            }
+            next_report = now + 1000000000ULL;
+
+            stats.evictIdle(now, 10000000000ULL);
+            printf("%-46s %10s %12s %10s %10s %10s %10s\n",
+                   "flow", "packets", "bytes", "gap us", "jitter us", "lost", "reordered");
+            stats.getFlows().forEach([](const PeerKey& key, const TrafficStats::Table::Entry& flow)
+                {
+                    printf("%-46s %10llu %12llu %10.1f %10.1f %10llu %10llu\n",
+                           key.toString().c_str(),
+                           static_cast<unsigned long long>(flow.packets),
+                           static_cast<unsigned long long>(flow.bytes),
+                           flow.state.mean_interarrival_ns / 1000.0,
+                           flow.state.jitter_ns / 1000.0,
+                           static_cast<unsigned long long>(flow.state.lost),
+                           static_cast<unsigned long long>(flow.state.reordered));
+                });
+            printf("kernel drops: %lld, untracked: %llu\n\n",
+                   static_cast<long long>(monitor.getDropCount()),
+                   static_cast<unsigned long long>(stats.getUntrackedCount()));
+            fflush(stdout);
+        }
+    }
+    catch(const UdpClientServerRuntimeError& e)
+    {
+        fprintf(stderr, "%s: %s\n", argv[0], e.what());
+        return 1;
+    }
+}
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,467 @@
+// UDP RPC -- request/response calls with correlation IDs and deadlines
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_UDP_RPC_CPP
+#define UDP_CLIENT_SERVER_UDP_RPC_CPP
+
+#include <udp_rpc.h>
+#include <monotonic_clock.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <string.h>
+#include <algorithm>
+
+namespace udp_client_server
+{
+
+namespace
+{
+
+/** \brief Size of the buffers receiving datagrams, large enough for any of them.
+ */
+const size_t RPC_BUFFER_SIZE = 65536;
+
+/** \brief Resolution of the retransmission timers.
+ */
+const uint64_t RPC_TIMER_TICK_NS = 1000000;
+
+} // no name namespace
+
+const uint8_t RpcHeader::REQUEST;
+const uint8_t RpcHeader::RESPONSE;
+const size_t RpcHeader::SIZE;
+const size_t RpcClient::MAX_IN_FLIGHT;
+
+// ========================= HEADER =========================
+
+/** \brief Save the header in the first SIZE bytes of \p buffer.
+ */
+void RpcHeader::write(char *buffer) const
+{
+    uint16_t const m(htons(method));
+    uint32_t const i(htonl(id));
+    buffer[0] = static_cast<char>(kind);
+    buffer[1] = static_cast<char>(status);
+    memcpy(buffer + 2, &m, sizeof(m));
+    memcpy(buffer + 4, &i, sizeof(i));
+}
+
+/** \brief Load the header from \p buffer.
+ *
+ * \return false if \p buffer is too small or is not an RPC message.
+ */
+bool RpcHeader::read(const char *buffer, size_t size)
+{
+    if(size < SIZE)
+    {
+        return false;
+    }
+    kind = static_cast<uint8_t>(buffer[0]);
+    status = static_cast<uint8_t>(buffer[1]);
+    uint16_t m;
+    uint32_t i;
+    memcpy(&m, buffer + 2, sizeof(m));
+    memcpy(&i, buffer + 4, sizeof(i));
+    method = ntohs(m);
+    id = ntohl(i);
+    return kind == REQUEST || kind == RESPONSE;
+}
+
+// ========================= CLIENT =========================
+
+/** \brief Initialize an RPC client sending its requests with \p client.
+ *
+ * Responses come back to the socket of \p client, which the server
+ * replies to. The client may have up to \p max_in_flight calls waiting
+ * for their response.
+ *
+ * Each call is identified by a correlation ID made of the index of its
+ * slot in a fixed table and a generation counter, so a response finds
+ * its call with one array access, and a late response to a call that
+ * completed already (i.e. the response to a retransmission) does not
+ * match the next call using the same slot.
+ *
+ * \param[in] client  The client used to send requests and receive responses.
+ * \param[in] max_in_flight  The number of outstanding calls, at most
+ * MAX_IN_FLIGHT.
+ */
+RpcClient::RpcClient(UdpClient& client, size_t max_in_flight)
+    : f_client_(client)
+    , f_index_mask_(0)
+    , f_timers_(RPC_TIMER_TICK_NS)
+    , f_buffer_(RPC_BUFFER_SIZE)
+    , f_retransmits_(0)
+    , f_timeouts_(0)
+    , f_stale_(0)
+{
+    size_t count(1);
+    while(count < max_in_flight && count < MAX_IN_FLIGHT)
+    {
+        count <<= 1;
+    }
+    f_index_mask_ = static_cast<uint32_t>(count - 1);
+    f_calls_.resize(count);
+    f_free_.reserve(count);
+    f_expired_.reserve(count);
+    for(size_t i(count); i > 0; --i)
+    {
+        Call& c(f_calls_[i - 1]);
+        c.id = static_cast<uint32_t>(i - 1);
+        c.active = false;
+        c.deadline_ns = 0;
+        c.retry_ns = 0;
+        c.callback = NULL;
+        c.user = NULL;
+        f_free_.push_back(static_cast<uint32_t>(i - 1));
+    }
+}
+
+/** \brief Change the retransmission schedule of the next calls.
+ */
+void RpcClient::setRetryPolicy(const RpcRetryPolicy& policy)
+{
+    f_policy_ = policy;
+}
+
+/** \brief Return the retransmission schedule.
+ */
+const RpcRetryPolicy& RpcClient::getRetryPolicy() const
+{
+    return f_policy_;
+}
+
+/** \brief Send a request.
+ *
+ * The request is sent right away and retransmitted following the retry
+ * policy until its response arrives or \p deadline_ns is reached. Then
+ * \p callback is called exactly once, from poll(), with the response or
+ * RPC_TIMEOUT.
+ *
+ * A request the socket refuses with EAGAIN counts as lost and is simply
+ * retransmitted later.
+ *
+ * \param[in] method  The method number, passed as is to the server handler.
+ * \param[in] request  The request payload.
+ * \param[in] size  The size of \p request.
+ * \param[in] deadline_ns  The monotonic time after which the call fails.
+ * \param[in] callback  The function receiving the result.
+ * \param[in] user  A pointer passed back to \p callback.
+ *
+ * \return The correlation ID of the call, or -1 if an error occurs. errno
+ * is set to EBUSY when all the slots are in use, or to the error of the
+ * send, i.e. EMSGSIZE.
+ */
+int64_t RpcClient::call(uint16_t method, const char *request, size_t size, uint64_t deadline_ns,
+                        Callback callback, void *user)
+{
+    if(f_free_.empty())
+    {
+        errno = EBUSY;
+        return -1;
+    }
+    uint32_t const index(f_free_.back());
+    Call& c(f_calls_[index]);
+
+    RpcHeader header;
+    header.kind = RpcHeader::REQUEST;
+    header.status = RPC_OK;
+    header.method = method;
+    header.id = c.id;
+    c.request.resize(RpcHeader::SIZE + size);
+    header.write(&c.request[0]);
+    if(size > 0)
+    {
+        memcpy(&c.request[RpcHeader::SIZE], request, size);
+    }
+
+    if(f_client_.send(&c.request[0], c.request.size()) < 0
+    && errno != EAGAIN && errno != EWOULDBLOCK)
+    {
+        return -1;
+    }
+
+    f_free_.pop_back();
+    c.active = true;
+    c.deadline_ns = deadline_ns;
+    c.retry_ns = f_policy_.initial_ns;
+    c.callback = callback;
+    c.user = user;
+    uint64_t const now(monotonicNowNs());
+    f_timers_.schedule(std::min(now + c.retry_ns, deadline_ns), c.id);
+    return c.id;
+}
+
+/** \brief Forget a call; its callback will not be called.
+ *
+ * \return false if \p id is not in flight anymore.
+ */
+bool RpcClient::cancel(uint32_t id)
+{
+    Call *c(lookup(id));
+    if(c == NULL)
+    {
+        return false;
+    }
+    c->active = false;
+    c->id += f_index_mask_ + 1;
+    f_free_.push_back(id & f_index_mask_);
+    return true;
+}
+
+/** \brief Process the responses received and the expired timers.
+ *
+ * Call this function when the client socket is readable and at least
+ * every few milliseconds while calls are in flight, so requests get
+ * retransmitted and deadlines enforced. The callbacks are called from
+ * here; they may start new calls.
+ *
+ * At most \p max_responses datagrams are read per call so a flood of
+ * responses (or of garbage) cannot starve the timers and the other
+ * sockets of the caller; the timers are processed in any case. Call
+ * poll() again while the socket stays readable.
+ *
+ * \param[in] now_ns  The current monotonic time.
+ * \param[in] max_responses  The maximum number of datagrams read.
+ *
+ * \return The number of calls completed, including the ones that timed
+ * out, or -1 if the socket reported an error.
+ */
+int RpcClient::poll(uint64_t now_ns, size_t max_responses)
+{
+    int completed(0);
+    for(size_t received(0); received < max_responses; ++received)
+    {
+        int const r(::recv(f_client_.getSocket(), &f_buffer_[0], f_buffer_.size(), 0));
+        if(r < 0)
+        {
+            if(errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+            if(errno == ECONNREFUSED || errno == EINTR)
+            {
+                // the server is not there yet, retransmissions will tell
+                continue;
+            }
+            return -1;
+        }
+        RpcHeader header;
+        Call *c(NULL);
+        if(!header.read(&f_buffer_[0], static_cast<size_t>(r))
+        || header.kind != RpcHeader::RESPONSE
+        || (c = lookup(header.id)) == NULL)
+        {
+            ++f_stale_;
+            continue;
+        }
+        finish(*c
+             , header.status == RPC_OK ? RPC_OK : RPC_REMOTE_ERROR
+             , &f_buffer_[RpcHeader::SIZE]
+             , static_cast<size_t>(r) - RpcHeader::SIZE);
+        ++completed;
+    }
+
+    f_expired_.clear();
+    std::vector<uint32_t>& expired(f_expired_);
+    f_timers_.advance(now_ns, [&expired](uint32_t id)
+        {
+            expired.push_back(id);
+        });
+    for(size_t i(0); i < f_expired_.size(); ++i)
+    {
+        uint64_t const timeouts(f_timeouts_);
+        expire(f_expired_[i], now_ns);
+        completed += static_cast<int>(f_timeouts_ - timeouts);
+    }
+    return completed;
+}
+
+/** \brief Number of calls waiting for their response.
+ */
+size_t RpcClient::getInFlight() const
+{
+    return f_calls_.size() - f_free_.size();
+}
+
+/** \brief Number of requests sent again because no response arrived in time.
+ */
+uint64_t RpcClient::getRetransmitCount() const
+{
+    return f_retransmits_;
+}
+
+/** \brief Number of calls which reached their deadline.
+ */
+uint64_t RpcClient::getTimeoutCount() const
+{
+    return f_timeouts_;
+}
+
+/** \brief Number of responses ignored: duplicates, late or invalid.
+ */
+uint64_t RpcClient::getStaleResponseCount() const
+{
+    return f_stale_;
+}
+
+/** \brief Find the call in flight with correlation ID \p id.
+ */
+RpcClient::Call *RpcClient::lookup(uint32_t id)
+{
+    Call& c(f_calls_[id & f_index_mask_]);
+    return c.active && c.id == id ? &c : NULL;
+}
+
+/** \brief Free the slot of \p c and report the result to its callback.
+ *
+ * The slot gets a new generation first, so the callback can start a new
+ * call and any further response to this one is ignored.
+ */
+void RpcClient::finish(Call& c, RpcStatus status, const char *response, size_t size)
+{
+    Callback const callback(c.callback);
+    void *user(c.user);
+    uint32_t const index(c.id & f_index_mask_);
+    c.active = false;
+    c.id += f_index_mask_ + 1;
+    f_free_.push_back(index);
+    if(callback != NULL)
+    {
+        callback(user, status, response, size);
+    }
+}
+
+/** \brief Handle the timer of call \p id: retransmit or time out.
+ */
+void RpcClient::expire(uint32_t id, uint64_t now_ns)
+{
+    Call *c(lookup(id));
+    if(c == NULL)
+    {
+        // completed or cancelled since the timer was set
+        return;
+    }
+    if(now_ns >= c->deadline_ns)
+    {
+        ++f_timeouts_;
+        finish(*c, RPC_TIMEOUT, NULL, 0);
+        return;
+    }
+    f_client_.send(&c->request[0], c->request.size());
+    ++f_retransmits_;
+    c->retry_ns = std::min(f_policy_.max_ns, static_cast<uint64_t>(static_cast<double>(c->retry_ns) * f_policy_.multiplier));
+    f_timers_.schedule(std::min(now_ns + c->retry_ns, c->deadline_ns), id);
+}
+
+// ========================= SERVER =========================
+
+/** \brief Initialize an RPC server answering the requests received by \p server.
+ *
+ * Responses are sent from the socket of \p server to the address the
+ * request came from.
+ *
+ * A request retransmitted by the client may reach the server more than
+ * once, so \p handler may be called several times for the same call
+ * (at-least-once semantic.) Handlers with side effects must be
+ * idempotent.
+ *
+ * \param[in] server  The server receiving the requests.
+ * \param[in] handler  The function computing a response. It returns the
+ * size of the response, or -1 to send an RPC_REMOTE_ERROR.
+ * \param[in] user  A pointer passed back to \p handler.
+ */
+RpcServer::RpcServer(UdpServer& server, Handler handler, void *user)
+    : f_server_(server)
+    , f_handler_(handler)
+    , f_user_(user)
+    , f_request_(RPC_BUFFER_SIZE)
+    , f_response_(RPC_BUFFER_SIZE)
+    , f_requests_(0)
+    , f_invalid_(0)
+{
+}
+
+/** \brief Answer the requests waiting in the socket.
+ *
+ * \param[in] max_requests  The maximum number of datagrams read by this
+ * call, so one busy socket cannot starve the others. Datagrams which are
+ * not requests count too.
+ *
+ * \return The number of requests handled, or -1 if the socket reported
+ * an error before any request was handled. errno is set accordingly.
+ */
+int RpcServer::poll(size_t max_requests)
+{
+    int handled(0);
+    for(size_t count(0); count < max_requests; ++count)
+    {
+        struct sockaddr_storage from;
+        socklen_t from_len(sizeof(from));
+        int const r(f_server_.recvFrom(&f_request_[0], f_request_.size(), &from, &from_len));
+        if(r < 0)
+        {
+            if(errno == EAGAIN || errno == EWOULDBLOCK || handled > 0)
+            {
+                break;
+            }
+            return -1;
+        }
+        RpcHeader header;
+        if(!header.read(&f_request_[0], static_cast<size_t>(r))
+        || header.kind != RpcHeader::REQUEST)
+        {
+            ++f_invalid_;
+            continue;
+        }
+        ++f_requests_;
+        ++handled;
+
+        int size(f_handler_(f_user_, header.method
+                          , &f_request_[RpcHeader::SIZE], static_cast<size_t>(r) - RpcHeader::SIZE
+                          , &f_response_[RpcHeader::SIZE], f_response_.size() - RpcHeader::SIZE));
+        header.kind = RpcHeader::RESPONSE;
+        header.status = RPC_OK;
+        if(size < 0
+        || static_cast<size_t>(size) > f_response_.size() - RpcHeader::SIZE)
+        {
+            header.status = RPC_REMOTE_ERROR;
+            size = 0;
+        }
+        header.write(&f_response_[0]);
+        sendto(f_server_.getSocket(), &f_response_[0], RpcHeader::SIZE + static_cast<size_t>(size), 0
+             , reinterpret_cast<struct sockaddr *>(&from), from_len);
+    }
+    return handled;
+}
+
+/** \brief Number of requests handled.
+ */
+uint64_t RpcServer::getRequestCount() const
+{
+    return f_requests_;
+}
+
+/** \brief Number of datagrams received which were not RPC requests.
+ */
+uint64_t RpcServer::getInvalidCount() const
+{
+    return f_invalid_;
+}
+
+} // namespace udp_client_server
+#endif
+// vim: ts=4 sw=4 et
@@ -0,0 +1,387 @@
+// Work-Stealing Executor -- run packet handlers on a pool of stealing workers
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_WORK_STEALING_EXECUTOR_CPP
+#define UDP_CLIENT_SERVER_WORK_STEALING_EXECUTOR_CPP
+
+#include <work_stealing_executor.h>
+#include <backoff.h>
+#include <peer_table.h>
+#include <errno.h>
+#include <algorithm>
+#include <system_error>
+
+namespace udp_client_server
+{
+
+namespace
+{
+
+/** \brief Executor and worker index of the calling thread, if a worker.
+ */
+thread_local const WorkStealingExecutor *g_current_executor = NULL;
+thread_local int g_current_worker = -1;
+
+/** \brief Next value of a xorshift generator, to pick steal victims.
+ */
+uint64_t nextRandom(uint64_t& state)
+{
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+} // no name namespace
+
+
+const size_t WorkStealingExecutor::INJECTION_BATCH;
+
+
+/** \brief Initialize an executor of \p worker_count workers.
+ *
+ * Nothing runs until start() is called.
+ *
+ * \param[in] worker_count  The number of worker threads, at least 1.
+ * \param[in] queue_capacity  The capacity of the deque and the pinned
+ * queue of each worker (at least INJECTION_BATCH), and of the injection
+ * queue.
+ * \param[in] slot_count  The number of datagrams dispatch() can have in
+ * flight.
+ * \param[in] slot_size  The size of a datagram slot; longer datagrams
+ * are truncated.
+ *
+ * \exception UdpClientServerRuntimeError
+ * One of the counts or sizes is 0.
+ */
+WorkStealingExecutor::WorkStealingExecutor(size_t worker_count, size_t queue_capacity,
+                                           size_t slot_count, size_t slot_size)
+    : f_injection_(queue_capacity)
+    , f_arena_(slot_count * slot_size)
+    , f_packets_(slot_count)
+    , f_free_packets_(slot_count)
+    , f_slot_size_(slot_size)
+    , f_running_(false)
+    , f_rejected_(0)
+{
+    if(worker_count == 0 || queue_capacity == 0 || slot_count == 0 || slot_size == 0)
+    {
+        throw UdpClientServerRuntimeError("invalid parameters for work-stealing executor");
+    }
+    for(size_t i(0); i < worker_count; ++i)
+    {
+        f_workers_.push_back(std::unique_ptr<Worker>(new Worker(std::max(queue_capacity, INJECTION_BATCH), 0x9E3779B97F4A7C15ULL * (i + 1))));
+    }
+    for(size_t i(0); i < slot_count; ++i)
+    {
+        PacketTask& p(f_packets_[i]);
+        p.run = &WorkStealingExecutor::runPacket;
+        p.executor = this;
+        p.handler = NULL;
+        p.user = NULL;
+        f_free_packets_.push(&p);
+    }
+}
+
+/** \brief Stop the workers.
+ */
+WorkStealingExecutor::~WorkStealingExecutor()
+{
+    stop();
+}
+
+/** \brief Start the worker threads.
+ *
+ * If a thread cannot be created, the threads already started are
+ * stopped and joined before returning.
+ *
+ * \return 0 on success, -1 if the executor is already running (errno is
+ * set to EBUSY) or a thread could not be created (errno is set to
+ * EAGAIN.)
+ */
+int WorkStealingExecutor::start()
+{
+    if(f_running_.exchange(true))
+    {
+        errno = EBUSY;
+        return -1;
+    }
+    try
+    {
+        for(size_t i(0); i < f_workers_.size(); ++i)
+        {
+            f_workers_[i]->thread = std::thread(&WorkStealingExecutor::workerLoop, this, i);
+        }
+    }
+    catch(const std::system_error&)
+    {
+        stop();
+        errno = EAGAIN;
+        return -1;
+    }
+    return 0;
+}
+
+/** \brief Stop the worker threads once all the submitted tasks ran.
+ *
+ * Do not submit tasks from other threads while stopping.
+ */
+void WorkStealingExecutor::stop()
+{
+    f_running_ = false;
+    for(size_t i(0); i < f_workers_.size(); ++i)
+    {
+        if(f_workers_[i]->thread.joinable())
+        {
+            f_workers_[i]->thread.join();
+        }
+    }
+}
+
+/** \brief Submit a task any worker may run.
+ *
+ * From a worker of this executor the task goes to the bottom of its own
+ * deque, so it likely runs next on the same core unless another worker
+ * steals it. From any other thread it goes to the injection queue.
+ *
+ * \return false if the queue is full; the task was not submitted.
+ */
+bool WorkStealingExecutor::submit(ExecutorTask *task)
+{
+    if(g_current_executor == this
+    && f_workers_[g_current_worker]->deque.push(task))
+    {
+        return true;
+    }
+    if(f_injection_.push(task))
+    {
+        return true;
+    }
+    f_rejected_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+/** \brief Submit a task that must run in order with the others of \p flow.
+ *
+ * All the tasks of one flow run on the same worker, one at a time, in
+ * the order they were submitted. They are never stolen.
+ *
+ * \param[in] flow  A value identifying the flow, i.e. a hash of its
+ * source address.
+ * \param[in] task  The task to run.
+ *
+ * \return false if the queue of the worker is full; the task was not
+ * submitted.
+ */
+bool WorkStealingExecutor::submitPinned(uint64_t flow, ExecutorTask *task)
+{
+    uint64_t const hash((flow * 0x9E3779B97F4A7C15ULL) >> 32);
+    size_t const index(static_cast<size_t>((hash * f_workers_.size()) >> 32));
+    if(f_workers_[index]->pinned.push(task))
+    {
+        return true;
+    }
+    f_rejected_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+/** \brief Read datagrams from \p server and run \p handler on each of them.
+ *
+ * Up to \p max_packets datagrams are read without waiting; each is copied
+ * in a packet slot and submitted as a task, pinned to its flow (source
+ * address and port) when \p pin_flows is true. The slot is released when
+ * the handler returns, so the view given to the handler is valid only
+ * during the call.
+ *
+ * When all the slots are in use, reading stops and the datagrams wait in
+ * the socket buffer.
+ *
+ * \return The number of datagrams submitted, or -1 if an error occurs.
+ * errno is set accordingly on error.
+ */
+int WorkStealingExecutor::dispatch(UdpServer& server, PacketHandler handler, void *user,
+                                   bool pin_flows, size_t max_packets)
+{
+    int count(0);
+    PacketTask *packet;
+    for(size_t i(0); i < max_packets && f_free_packets_.pop(packet); ++i)
+    {
+        char *buffer(&f_arena_[(packet - &f_packets_[0]) * f_slot_size_]);
+        int const r(server.recvView(buffer, f_slot_size_, packet->view));
+        if(r < 0)
+        {
+            f_free_packets_.push(packet);
+            if(errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+            return count == 0 ? -1 : count;
+        }
+        packet->handler = handler;
+        packet->user = user;
+        bool submitted;
+        if(pin_flows)
+        {
+            PeerKey const flow(reinterpret_cast<const struct sockaddr *>(&packet->view.source));
+            submitted = submitPinned(PeerKeyHash()(flow), packet);
+        }
+        else
+        {
+            submitted = submit(packet);
+        }
+        if(submitted)
+        {
+            ++count;
+        }
+        else
+        {
+            f_free_packets_.push(packet);
+        }
+    }
+    return count;
+}
+
+/** \brief Number of worker threads.
+ */
+size_t WorkStealingExecutor::getWorkerCount() const
+{
+    return f_workers_.size();
+}
+
+/** \brief Index of the worker running the calling thread.
+ *
+ * \return The worker index, or -1 when not called from a worker.
+ */
+int WorkStealingExecutor::currentWorker()
+{
+    return g_current_worker;
+}
+
+/** \brief Number of tasks run so far.
+ */
+uint64_t WorkStealingExecutor::getExecutedCount() const
+{
+    uint64_t executed(0);
+    for(size_t i(0); i < f_workers_.size(); ++i)
+    {
+        executed += f_workers_[i]->executed.load(std::memory_order_relaxed);
+    }
+    return executed;
+}
+
+/** \brief Number of tasks a worker took from the deque of another.
+ */
+uint64_t WorkStealingExecutor::getStolenCount() const
+{
+    uint64_t stolen(0);
+    for(size_t i(0); i < f_workers_.size(); ++i)
+    {
+        stolen += f_workers_[i]->stolen.load(std::memory_order_relaxed);
+    }
+    return stolen;
+}
+
+/** \brief Number of tasks refused because a queue was full.
+ */
+uint64_t WorkStealingExecutor::getRejectedCount() const
+{
+    return f_rejected_.load(std::memory_order_relaxed);
+}
+
+/** \brief Run the handler of a datagram and release its slot.
+ */
+void WorkStealingExecutor::runPacket(ExecutorTask *task)
+{
+    PacketTask *packet(static_cast<PacketTask *>(task));
+    packet->handler(packet->user, packet->view);
+    packet->executor->f_free_packets_.push(packet);
+}
+
+/** \brief Body of a worker thread.
+ */
+void WorkStealingExecutor::workerLoop(size_t index)
+{
+    g_current_executor = this;
+    g_current_worker = static_cast<int>(index);
+    Worker& worker(*f_workers_[index]);
+    Backoff backoff;
+    for(;;)
+    {
+        ExecutorTask *task(findTask(index));
+        if(task == NULL)
+        {
+            if(!f_running_.load(std::memory_order_acquire))
+            {
+                break;
+            }
+            backoff.wait();
+            continue;
+        }
+        backoff.reset();
+        task->run(task);
+        worker.executed.fetch_add(1, std::memory_order_relaxed);
+    }
+    g_current_executor = NULL;
+    g_current_worker = -1;
+}
+
+/** \brief Find the next task for worker \p index.
+ *
+ * In order: its pinned queue, its own deque, a batch from the injection
+ * queue and finally the deques of the other workers, starting with a
+ * random one.
+ *
+ * \return The task to run, NULL if there is no work anywhere.
+ */
+ExecutorTask *WorkStealingExecutor::findTask(size_t index)
+{
+    Worker& worker(*f_workers_[index]);
+    ExecutorTask *task;
+    if(worker.pinned.pop(task) || worker.deque.pop(task))
+    {
+        return task;
+    }
+
+    if(f_injection_.pop(task))
+    {
+        // move a few more to the deque where idle workers can steal them
+        ExecutorTask *extra;
+        for(size_t i(1); i < INJECTION_BATCH && f_injection_.pop(extra); ++i)
+        {
+            // cannot fail: the deque was empty and holds INJECTION_BATCH tasks
+            worker.deque.push(extra);
+        }
+        return task;
+    }
+
+    size_t const count(f_workers_.size());
+    size_t const first(static_cast<size_t>(nextRandom(worker.rng) % count));
+    for(size_t i(0); i < count; ++i)
+    {
+        size_t const victim((first + i) % count);
+        if(victim != index && f_workers_[victim]->deque.steal(task))
+        {
+            worker.stolen.fetch_add(1, std::memory_order_relaxed);
+            return task;
+        }
+    }
+    return NULL;
+}
+
+} // namespace udp_client_server
+#endif
+// vim: ts=4 sw=4 et
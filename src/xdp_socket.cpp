@@ -0,0 +1,810 @@
+// XDP Socket -- UDP over AF_XDP, bypassing the kernel UDP stack
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+// The BPF objects are created with the bpf() system call directly so the
+// library does not depend on libbpf; the XDP program is small enough to
+// be written as instructions.
+
+#ifndef UDP_CLIENT_SERVER_XDP_SOCKET_CPP
+#define UDP_CLIENT_SERVER_XDP_SOCKET_CPP
+
+#include <xdp_socket.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <net/if_arp.h>
+#include <netinet/in.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <linux/bpf.h>
+#include <linux/if_link.h>
+
+#ifndef AF_XDP
+#define AF_XDP 44
+#endif
+#ifndef SOL_XDP
+#define SOL_XDP 283
+#endif
+
+namespace udp_client_server
+{
+
+namespace
+{
+
+const size_t ETHERNET_HEADER_SIZE = 14;
+const size_t IPV4_HEADER_SIZE = 20;
+const size_t UDP_HEADER_SIZE = 8;
+const size_t HEADERS_SIZE = ETHERNET_HEADER_SIZE + IPV4_HEADER_SIZE + UDP_HEADER_SIZE;
+
+long bpf(int cmd, union bpf_attr& attr)
+{
+    return syscall(__NR_bpf, cmd, &attr, sizeof(attr));
+}
+
+struct bpf_insn instruction(uint8_t code, uint8_t dst, uint8_t src, int16_t off, int32_t imm)
+{
+    struct bpf_insn i;
+    i.code = code;
+    i.dst_reg = dst;
+    i.src_reg = src;
+    i.off = off;
+    i.imm = imm;
+    return i;
+}
+
+/** \brief Build the XDP program redirecting UDP datagrams to \p port.
+ *
+ * The packet is redirected to the socket of its receive queue in
+ * \p map_fd when it is IPv4 without options, not a fragment, UDP and
+ * sent to \p port. Otherwise, or when no socket is bound to that queue,
+ * it is passed to the kernel stack.
+ *
+ * Loads from the packet are in network byte order, so they are compared
+ * with values converted by htons().
+ */
+std::vector<struct bpf_insn> xdpRedirectProgram(int map_fd, uint16_t port)
+{
+    std::vector<struct bpf_insn> p;
+    std::vector<size_t> to_pass;
+
+    p.push_back(instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_6, BPF_REG_1, 0, 0));
+    p.push_back(instruction(BPF_LDX | BPF_MEM | BPF_W, BPF_REG_2, BPF_REG_1, offsetof(struct xdp_md, data), 0));
+    p.push_back(instruction(BPF_LDX | BPF_MEM | BPF_W, BPF_REG_3, BPF_REG_1, offsetof(struct xdp_md, data_end), 0));
+    p.push_back(instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_4, BPF_REG_2, 0, 0));
+    p.push_back(instruction(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_4, 0, 0, HEADERS_SIZE));
+    to_pass.push_back(p.size());
+    p.push_back(instruction(BPF_JMP | BPF_JGT | BPF_X, BPF_REG_4, BPF_REG_3, 0, 0));
+
+    // Ethernet type
+    p.push_back(instruction(BPF_LDX | BPF_MEM | BPF_H, BPF_REG_5, BPF_REG_2, 12, 0));
+    to_pass.push_back(p.size());
+    p.push_back(instruction(BPF_JMP | BPF_JNE | BPF_K, BPF_REG_5, 0, 0, htons(0x0800)));
+
+    // IPv4 version and header length (no options)
+    p.push_back(instruction(BPF_LDX | BPF_MEM | BPF_B, BPF_REG_5, BPF_REG_2, ETHERNET_HEADER_SIZE, 0));
+    to_pass.push_back(p.size());
+    p.push_back(instruction(BPF_JMP | BPF_JNE | BPF_K, BPF_REG_5, 0, 0, 0x45));
+
+    // protocol
+    p.push_back(instruction(BPF_LDX | BPF_MEM | BPF_B, BPF_REG_5, BPF_REG_2, ETHERNET_HEADER_SIZE + 9, 0));
+    to_pass.push_back(p.size());
+    p.push_back(instruction(BPF_JMP | BPF_JNE | BPF_K, BPF_REG_5, 0, 0, IPPROTO_UDP));
+
+    // more fragments flag and fragment offset
+    p.push_back(instruction(BPF_LDX | BPF_MEM | BPF_H, BPF_REG_5, BPF_REG_2, ETHERNET_HEADER_SIZE + 6, 0));
+    to_pass.push_back(p.size());
+    p.push_back(instruction(BPF_JMP | BPF_JSET | BPF_K, BPF_REG_5, 0, 0, htons(0x3FFF)));
+
+    // destination port
+    p.push_back(instruction(BPF_LDX | BPF_MEM | BPF_H, BPF_REG_5, BPF_REG_2, ETHERNET_HEADER_SIZE + IPV4_HEADER_SIZE + 2, 0));
+    to_pass.push_back(p.size());
+    p.push_back(instruction(BPF_JMP | BPF_JNE | BPF_K, BPF_REG_5, 0, 0, htons(port)));
+
+    // return bpf_redirect_map(&map, ctx->rx_queue_index, XDP_PASS);
+    p.push_back(instruction(BPF_LDX | BPF_MEM | BPF_W, BPF_REG_2, BPF_REG_6, offsetof(struct xdp_md, rx_queue_index), 0));
+    p.push_back(instruction(BPF_LD | BPF_DW | BPF_IMM, BPF_REG_1, BPF_PSEUDO_MAP_FD, 0, map_fd));
+    p.push_back(instruction(0, 0, 0, 0, 0));
+    p.push_back(instruction(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_3, 0, 0, XDP_PASS));
+    p.push_back(instruction(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_redirect_map));
+    p.push_back(instruction(BPF_JMP | BPF_EXIT, 0, 0, 0, 0));
+
+    size_t const pass(p.size());
+    p.push_back(instruction(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_0, 0, 0, XDP_PASS));
+    p.push_back(instruction(BPF_JMP | BPF_EXIT, 0, 0, 0, 0));
+
+    for(size_t i(0); i < to_pass.size(); ++i)
+    {
+        p[to_pass[i]].off = static_cast<int16_t>(pass - to_pass[i] - 1);
+    }
+    return p;
+}
+
+/** \brief Add \p size bytes to a one's complement sum.
+ */
+uint32_t checksumAdd(uint32_t sum, const unsigned char *data, size_t size)
+{
+    for(; size > 1; data += 2, size -= 2)
+    {
+        sum += (data[0] << 8) | data[1];
+    }
+    if(size > 0)
+    {
+        sum += data[0] << 8;
+    }
+    return sum;
+}
+
+uint16_t checksumFold(uint32_t sum)
+{
+    while(sum > 0xFFFF)
+    {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return static_cast<uint16_t>(~sum);
+}
+
+} // no name namespace
+
+
+/** \brief Open an AF_XDP socket receiving the UDP datagrams sent to \p port.
+ *
+ * The UMEM of \p frame_count frames is split in two halves, one for
+ * reception and one for transmission.
+ *
+ * \param[in] ifname  The interface to attach to.
+ * \param[in] addr  The local IPv4 address, used as the source of the
+ * datagrams sent.
+ * \param[in] port  The local port; datagrams to this port are redirected.
+ * \param[in] queue_id  The receive queue of the interface to serve.
+ * \param[in] generic_mode  Attach in generic (SKB) mode, which works with
+ * any driver; false lets the driver run the program natively.
+ * \param[in] frame_count  The number of frames, a power of 2.
+ * \param[in] frame_size  The size of a frame: 2048 or 4096.
+ *
+ * \exception UdpClientServerRuntimeError
+ * The parameters are invalid, or the socket, the UMEM or the XDP program
+ * cannot be set up (i.e. missing capabilities or kernel support.)
+ */
+XdpSocket::XdpSocket(const std::string& ifname, const std::string& addr, int port,
+                     int queue_id, bool generic_mode, size_t frame_count, size_t frame_size)
+    : f_socket_(-1)
+    , f_map_fd_(-1)
+    , f_prog_fd_(-1)
+    , f_link_fd_(-1)
+    , f_ifindex_(if_nametoindex(ifname.c_str()))
+    , f_port_(port)
+    , f_addr_(addr)
+    , f_local_ip_(0)
+    , f_dest_ip_(0)
+    , f_dest_port_(0)
+    , f_has_destination_(false)
+    , f_ip_id_(0)
+    , f_umem_(NULL)
+    , f_umem_size_(frame_count * frame_size)
+    , f_frame_size_(frame_size)
+{
+    memset(f_local_mac_, 0, sizeof(f_local_mac_));
+    memset(f_dest_mac_, 0, sizeof(f_dest_mac_));
+    memset(&f_fill_, 0, sizeof(f_fill_));
+    memset(&f_completion_, 0, sizeof(f_completion_));
+    memset(&f_rx_, 0, sizeof(f_rx_));
+    memset(&f_tx_, 0, sizeof(f_tx_));
+
+    if(port <= 0 || port > 65535
+    || frame_count < 2 || (frame_count & (frame_count - 1)) != 0
+    || (frame_size != 2048 && frame_size != 4096)
+    || queue_id < 0)
+    {
+        throw UdpClientServerRuntimeError("invalid parameters for XDP socket");
+    }
+    if(inet_pton(AF_INET, addr.c_str(), &f_local_ip_) != 1)
+    {
+        throw UdpClientServerRuntimeError(("invalid IPv4 address for XDP socket: \"" + addr + "\"").c_str());
+    }
+    if(f_ifindex_ == 0 || ifname.size() >= IFNAMSIZ)
+    {
+        throw UdpClientServerRuntimeError(("unknown interface for XDP socket: \"" + ifname + "\"").c_str());
+    }
+
+    f_socket_ = socket(AF_XDP, SOCK_RAW | SOCK_CLOEXEC, 0);
+    if(f_socket_ == -1)
+    {
+        throw UdpClientServerRuntimeError(("could not create XDP socket, errno: " + std::to_string(errno)).c_str());
+    }
+    try
+    {
+        struct ifreq ifr;
+        memset(&ifr, 0, sizeof(ifr));
+        strncpy(ifr.ifr_name, ifname.c_str(), IFNAMSIZ - 1);
+        if(ioctl(f_socket_, SIOCGIFHWADDR, &ifr) != 0)
+        {
+            // AF_XDP sockets may not support the ioctl, ask an INET one
+            int const s(socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0));
+            int const r(s == -1 ? -1 : ioctl(s, SIOCGIFHWADDR, &ifr));
+            if(s != -1)
+            {
+                close(s);
+            }
+            if(r != 0)
+            {
+                throw UdpClientServerRuntimeError(("could not get hardware address of \"" + ifname + "\"").c_str());
+            }
+        }
+        memcpy(f_local_mac_, ifr.ifr_hwaddr.sa_data, sizeof(f_local_mac_));
+
+        void *umem(mmap(NULL, f_umem_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if(umem == MAP_FAILED)
+        {
+            throw UdpClientServerRuntimeError("could not allocate the XDP UMEM");
+        }
+        f_umem_ = static_cast<unsigned char *>(umem);
+
+        struct xdp_umem_reg reg;
+        memset(&reg, 0, sizeof(reg));
+        reg.addr = reinterpret_cast<uintptr_t>(f_umem_);
+        reg.len = f_umem_size_;
+        reg.chunk_size = static_cast<uint32_t>(frame_size);
+        reg.headroom = 0;
+        if(setsockopt(f_socket_, SOL_XDP, XDP_UMEM_REG, &reg, sizeof(reg)) != 0)
+        {
+            throw UdpClientServerRuntimeError(("could not register the XDP UMEM, errno: " + std::to_string(errno)).c_str());
+        }
+
+        uint32_t const ring_size(static_cast<uint32_t>(frame_count / 2));
+        if(setsockopt(f_socket_, SOL_XDP, XDP_UMEM_FILL_RING, &ring_size, sizeof(ring_size)) != 0
+        || setsockopt(f_socket_, SOL_XDP, XDP_UMEM_COMPLETION_RING, &ring_size, sizeof(ring_size)) != 0
+        || setsockopt(f_socket_, SOL_XDP, XDP_RX_RING, &ring_size, sizeof(ring_size)) != 0
+        || setsockopt(f_socket_, SOL_XDP, XDP_TX_RING, &ring_size, sizeof(ring_size)) != 0)
+        {
+            throw UdpClientServerRuntimeError(("could not create the XDP rings, errno: " + std::to_string(errno)).c_str());
+        }
+
+        struct xdp_mmap_offsets offsets;
+        socklen_t len(sizeof(offsets));
+        if(getsockopt(f_socket_, SOL_XDP, XDP_MMAP_OFFSETS, &offsets, &len) != 0)
+        {
+            throw UdpClientServerRuntimeError(("could not get the XDP ring offsets, errno: " + std::to_string(errno)).c_str());
+        }
+        mapRing(f_fill_, ring_size, offsets.fr, sizeof(uint64_t), XDP_UMEM_PGOFF_FILL_RING);
+        mapRing(f_completion_, ring_size, offsets.cr, sizeof(uint64_t), XDP_UMEM_PGOFF_COMPLETION_RING);
+        mapRing(f_rx_, ring_size, offsets.rx, sizeof(struct xdp_desc), XDP_PGOFF_RX_RING);
+        mapRing(f_tx_, ring_size, offsets.tx, sizeof(struct xdp_desc), XDP_PGOFF_TX_RING);
+
+        // first half of the frames to receive in, second half to send from
+        for(uint32_t i(0); i < ring_size; ++i)
+        {
+            static_cast<uint64_t *>(f_fill_.descs)[i] = i * frame_size;
+        }
+        __atomic_store_n(f_fill_.producer, ring_size, __ATOMIC_RELEASE);
+        f_tx_frames_.reserve(ring_size);
+        for(uint32_t i(0); i < ring_size; ++i)
+        {
+            f_tx_frames_.push_back((ring_size + i) * frame_size);
+        }
+
+        struct sockaddr_xdp sxdp;
+        memset(&sxdp, 0, sizeof(sxdp));
+        sxdp.sxdp_family = AF_XDP;
+        sxdp.sxdp_flags = XDP_USE_NEED_WAKEUP | (generic_mode ? XDP_COPY : 0);
+        sxdp.sxdp_ifindex = f_ifindex_;
+        sxdp.sxdp_queue_id = static_cast<uint32_t>(queue_id);
+        if(bind(f_socket_, reinterpret_cast<struct sockaddr *>(&sxdp), sizeof(sxdp)) != 0)
+        {
+            throw UdpClientServerRuntimeError(("could not bind XDP socket to \"" + ifname + "\", errno: " + std::to_string(errno)).c_str());
+        }
+
+        loadProgram(queue_id, generic_mode);
+    }
+    catch(...)
+    {
+        release();
+        throw;
+    }
+}
+
+/** \brief Detach the XDP program and release the rings and the UMEM.
+ */
+XdpSocket::~XdpSocket()
+{
+    release();
+}
+
+void XdpSocket::release()
+{
+    // closing the link detaches the program from the interface
+    int const fds[] = { f_link_fd_, f_prog_fd_, f_map_fd_, f_socket_ };
+    for(size_t i(0); i < sizeof(fds) / sizeof(fds[0]); ++i)
+    {
+        if(fds[i] != -1)
+        {
+            close(fds[i]);
+        }
+    }
+    Ring * const rings[] = { &f_fill_, &f_completion_, &f_rx_, &f_tx_ };
+    for(size_t i(0); i < sizeof(rings) / sizeof(rings[0]); ++i)
+    {
+        if(rings[i]->map != NULL)
+        {
+            munmap(rings[i]->map, rings[i]->map_size);
+        }
+    }
+    if(f_umem_ != NULL)
+    {
+        munmap(f_umem_, f_umem_size_);
+    }
+}
+
+/** \brief Map one of the rings shared with the kernel.
+ *
+ * \exception UdpClientServerRuntimeError
+ * The ring cannot be mapped.
+ */
+void XdpSocket::mapRing(Ring& ring, uint32_t size, const struct xdp_ring_offset& offset,
+                        size_t desc_size, off_t pgoff)
+{
+    ring.map_size = offset.desc + size * desc_size;
+    void *map(mmap(NULL, ring.map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, f_socket_, pgoff));
+    if(map == MAP_FAILED)
+    {
+        ring.map = NULL;
+        throw UdpClientServerRuntimeError(("could not map an XDP ring, errno: " + std::to_string(errno)).c_str());
+    }
+    unsigned char *base(static_cast<unsigned char *>(map));
+    ring.map = map;
+    ring.producer = reinterpret_cast<uint32_t *>(base + offset.producer);
+    ring.consumer = reinterpret_cast<uint32_t *>(base + offset.consumer);
+    ring.flags = reinterpret_cast<uint32_t *>(base + offset.flags);
+    ring.descs = base + offset.desc;
+    ring.mask = size - 1;
+}
+
+/** \brief Create the socket map, load the program and attach it.
+ *
+ * \exception UdpClientServerRuntimeError
+ * The kernel refuses one of the steps.
+ */
+void XdpSocket::loadProgram(int queue_id, bool generic_mode)
+{
+    union bpf_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.map_type = BPF_MAP_TYPE_XSKMAP;
+    attr.key_size = sizeof(uint32_t);
+    attr.value_size = sizeof(uint32_t);
+    attr.max_entries = static_cast<uint32_t>(queue_id + 1);
+    f_map_fd_ = static_cast<int>(bpf(BPF_MAP_CREATE, attr));
+    if(f_map_fd_ < 0)
+    {
+        f_map_fd_ = -1;
+        throw UdpClientServerRuntimeError(("could not create the XDP socket map, errno: " + std::to_string(errno)).c_str());
+    }
+
+    uint32_t const key(static_cast<uint32_t>(queue_id));
+    uint32_t const value(static_cast<uint32_t>(f_socket_));
+    memset(&attr, 0, sizeof(attr));
+    attr.map_fd = static_cast<uint32_t>(f_map_fd_);
+    attr.key = reinterpret_cast<uintptr_t>(&key);
+    attr.value = reinterpret_cast<uintptr_t>(&value);
+    attr.flags = BPF_ANY;
+    if(bpf(BPF_MAP_UPDATE_ELEM, attr) != 0)
+    {
+        throw UdpClientServerRuntimeError(("could not add the socket to the XDP map, errno: " + std::to_string(errno)).c_str());
+    }
+
+    std::vector<struct bpf_insn> const program(xdpRedirectProgram(f_map_fd_, static_cast<uint16_t>(f_port_)));
+    static char const license[] = "GPL";
+    memset(&attr, 0, sizeof(attr));
+    attr.prog_type = BPF_PROG_TYPE_XDP;
+    attr.expected_attach_type = BPF_XDP;
+    attr.insn_cnt = static_cast<uint32_t>(program.size());
+    attr.insns = reinterpret_cast<uintptr_t>(&program[0]);
+    attr.license = reinterpret_cast<uintptr_t>(license);
+    f_prog_fd_ = static_cast<int>(bpf(BPF_PROG_LOAD, attr));
+    if(f_prog_fd_ < 0)
+    {
+        f_prog_fd_ = -1;
+        throw UdpClientServerRuntimeError(("could not load the XDP program, errno: " + std::to_string(errno)).c_str());
+    }
+
+    memset(&attr, 0, sizeof(attr));
+    attr.link_create.prog_fd = static_cast<uint32_t>(f_prog_fd_);
+    attr.link_create.target_ifindex = f_ifindex_;
+    attr.link_create.attach_type = BPF_XDP;
+    attr.link_create.flags = generic_mode ? XDP_FLAGS_SKB_MODE : XDP_FLAGS_DRV_MODE;
+    f_link_fd_ = static_cast<int>(bpf(BPF_LINK_CREATE, attr));
+    if(f_link_fd_ < 0)
+    {
+        f_link_fd_ = -1;
+        throw UdpClientServerRuntimeError(("could not attach the XDP program, errno: " + std::to_string(errno)).c_str());
+    }
+}
+
+/** \brief Return the AF_XDP socket, i.e. to poll() it.
+ */
+int XdpSocket::getSocket() const
+{
+    return f_socket_;
+}
+
+/** \brief Return the local port.
+ */
+int XdpSocket::getPort() const
+{
+    return f_port_;
+}
+
+/** \brief Return the local address.
+ */
+std::string XdpSocket::getAddr() const
+{
+    return f_addr_;
+}
+
+/** \brief Set where send() and sendv() send the datagrams.
+ *
+ * The frames are built here, so the hardware address of the destination
+ * (or of the gateway) is needed. When \p mac is NULL it is looked up in
+ * the neighbour table of the kernel, which only knows it once some
+ * traffic was exchanged, i.e. after a ping.
+ *
+ * \param[in] addr  The destination IPv4 address.
+ * \param[in] port  The destination port.
+ * \param[in] mac  The 6 byte destination hardware address, or NULL.
+ *
+ * \return 0 on success, -1 if an error occurs. errno is set accordingly
+ * on error (EINVAL for an invalid address, EHOSTUNREACH when the hardware
+ * address is not known.)
+ */
+int XdpSocket::setDestination(const std::string& addr, int port, const uint8_t *mac)
+{
+    struct in_addr ip;
+    if(port <= 0 || port > 65535 || inet_pton(AF_INET, addr.c_str(), &ip) != 1)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    if(mac == NULL)
+    {
+        char ifname[IFNAMSIZ];
+        if(if_indextoname(f_ifindex_, ifname) == NULL)
+        {
+            return -1;
+        }
+        struct arpreq req;
+        memset(&req, 0, sizeof(req));
+        struct sockaddr_in *pa(reinterpret_cast<struct sockaddr_in *>(&req.arp_pa));
+        pa->sin_family = AF_INET;
+        pa->sin_addr = ip;
+        memcpy(req.arp_dev, ifname, sizeof(req.arp_dev));
+        int const s(socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0));
+        int const r(s == -1 ? -1 : ioctl(s, SIOCGARP, &req));
+        if(s != -1)
+        {
+            close(s);
+        }
+        if(r != 0 || (req.arp_flags & ATF_COM) == 0)
+        {
+            errno = EHOSTUNREACH;
+            return -1;
+        }
+        memcpy(f_dest_mac_, req.arp_ha.sa_data, sizeof(f_dest_mac_));
+    }
+    else
+    {
+        memcpy(f_dest_mac_, mac, sizeof(f_dest_mac_));
+    }
+    f_dest_ip_ = ip.s_addr;
+    f_dest_port_ = htons(static_cast<uint16_t>(port));
+    f_has_destination_ = true;
+    return 0;
+}
+
+/** \brief Send a datagram to the destination.
+ *
+ * \return The number of bytes sent, or -1 if an error occurs. errno is
+ * set accordingly on error (EDESTADDRREQ without destination, EMSGSIZE
+ * when the datagram does not fit in a frame, EAGAIN when all the frames
+ * are in flight.)
+ */
+int XdpSocket::send(const char *msg, size_t size)
+{
+    struct iovec iov;
+    iov.iov_base = const_cast<char *>(msg);
+    iov.iov_len = size;
+    return sendv(&iov, 1);
+}
+
+/** \brief Send a datagram gathered from several buffers.
+ *
+ * The payload is copied in a transmission frame behind the Ethernet, IP
+ * and UDP headers, then the kernel is woken up if it needs to be.
+ *
+ * \return The number of bytes sent, or -1 if an error occurs. errno is
+ * set accordingly on error (see send().)
+ */
+int XdpSocket::sendv(const struct iovec *iov, size_t iovcnt)
+{
+    if(!f_has_destination_)
+    {
+        errno = EDESTADDRREQ;
+        return -1;
+    }
+    size_t size(0);
+    for(size_t i(0); i < iovcnt; ++i)
+    {
+        size += iov[i].iov_len;
+    }
+    if(size > f_frame_size_ - HEADERS_SIZE || size > 65507)
+    {
+        errno = EMSGSIZE;
+        return -1;
+    }
+
+    reclaim();
+    uint32_t const prod(*f_tx_.producer);
+    if(f_tx_frames_.empty()
+    || prod - __atomic_load_n(f_tx_.consumer, __ATOMIC_ACQUIRE) > f_tx_.mask)
+    {
+        // let the kernel catch up once before giving up
+        ::sendto(f_socket_, NULL, 0, MSG_DONTWAIT, NULL, 0);
+        reclaim();
+        if(f_tx_frames_.empty())
+        {
+            errno = EAGAIN;
+            return -1;
+        }
+    }
+    uint64_t const addr(f_tx_frames_.back());
+    f_tx_frames_.pop_back();
+
+    unsigned char *frame(f_umem_ + addr);
+    unsigned char *ip(frame + ETHERNET_HEADER_SIZE);
+    unsigned char *udp(ip + IPV4_HEADER_SIZE);
+    unsigned char *payload(udp + UDP_HEADER_SIZE);
+    for(size_t i(0), offset(0); i < iovcnt; offset += iov[i].iov_len, ++i)
+    {
+        memcpy(payload + offset, iov[i].iov_base, iov[i].iov_len);
+    }
+
+    memcpy(frame, f_dest_mac_, 6);
+    memcpy(frame + 6, f_local_mac_, 6);
+    frame[12] = 0x08;
+    frame[13] = 0x00;
+
+    uint16_t const ip_length(htons(static_cast<uint16_t>(IPV4_HEADER_SIZE + UDP_HEADER_SIZE + size)));
+    uint16_t const id(htons(f_ip_id_++));
+    ip[0] = 0x45;
+    ip[1] = 0;
+    memcpy(ip + 2, &ip_length, 2);
+    memcpy(ip + 4, &id, 2);
+    ip[6] = 0x40;               // don't fragment
+    ip[7] = 0;
+    ip[8] = 64;
+    ip[9] = IPPROTO_UDP;
+    ip[10] = 0;
+    ip[11] = 0;
+    memcpy(ip + 12, &f_local_ip_, 4);
+    memcpy(ip + 16, &f_dest_ip_, 4);
+    uint16_t const ip_checksum(htons(checksumFold(checksumAdd(0, ip, IPV4_HEADER_SIZE))));
+    memcpy(ip + 10, &ip_checksum, 2);
+
+    uint16_t const local_port(htons(static_cast<uint16_t>(f_port_)));
+    uint16_t const udp_length(htons(static_cast<uint16_t>(UDP_HEADER_SIZE + size)));
+    memcpy(udp, &local_port, 2);
+    memcpy(udp + 2, &f_dest_port_, 2);
+    memcpy(udp + 4, &udp_length, 2);
+    udp[6] = 0;
+    udp[7] = 0;
+    // pseudo header: addresses, protocol and length
+    uint32_t sum(checksumAdd(0, ip + 12, 8));
+    sum += IPPROTO_UDP + UDP_HEADER_SIZE + size;
+    uint16_t checksum(checksumFold(checksumAdd(sum, udp, UDP_HEADER_SIZE + size)));
+    if(checksum == 0)
+    {
+        checksum = 0xFFFF;
+    }
+    checksum = htons(checksum);
+    memcpy(udp + 6, &checksum, 2);
+
+    struct xdp_desc *desc(static_cast<struct xdp_desc *>(f_tx_.descs) + (prod & f_tx_.mask));
+    desc->addr = addr;
+    desc->len = static_cast<uint32_t>(HEADERS_SIZE + size);
+    desc->options = 0;
+    __atomic_store_n(f_tx_.producer, prod + 1, __ATOMIC_RELEASE);
+
+    if((__atomic_load_n(f_tx_.flags, __ATOMIC_ACQUIRE) & XDP_RING_NEED_WAKEUP) != 0
+    && ::sendto(f_socket_, NULL, 0, MSG_DONTWAIT, NULL, 0) == -1
+    && errno != EAGAIN && errno != EBUSY && errno != ENOBUFS)
+    {
+        return -1;
+    }
+    return static_cast<int>(size);
+}
+
+/** \brief Return the frames the kernel finished sending to the free list.
+ */
+void XdpSocket::reclaim()
+{
+    uint32_t cons(*f_completion_.consumer);
+    uint32_t const prod(__atomic_load_n(f_completion_.producer, __ATOMIC_ACQUIRE));
+    if(cons == prod)
+    {
+        return;
+    }
+    for(; cons != prod; ++cons)
+    {
+        uint64_t const addr(static_cast<uint64_t *>(f_completion_.descs)[cons & f_completion_.mask]);
+        f_tx_frames_.push_back(addr & ~static_cast<uint64_t>(f_frame_size_ - 1));
+    }
+    __atomic_store_n(f_completion_.consumer, cons, __ATOMIC_RELEASE);
+}
+
+/** \brief Give a receive frame back to the kernel.
+ *
+ * Frames are given back one at a time, in the order they were received,
+ * so the fill ring always has room for them.
+ */
+void XdpSocket::refill(uint64_t addr)
+{
+    uint32_t const prod(*f_fill_.producer);
+    static_cast<uint64_t *>(f_fill_.descs)[prod & f_fill_.mask] = addr & ~static_cast<uint64_t>(f_frame_size_ - 1);
+    __atomic_store_n(f_fill_.producer, prod + 1, __ATOMIC_RELEASE);
+}
+
+/** \brief Wait for a datagram and receive it.
+ *
+ * \return The number of bytes read or -1 if an error occurs.
+ */
+int XdpSocket::recv(char *msg, size_t max_size)
+{
+    return receive(msg, max_size, NULL, -1);
+}
+
+/** \brief Wait for a datagram and receive it with its addresses.
+ *
+ * The datagram is copied out of the UMEM, so the view points to \p msg.
+ * The time of arrival is the time it was taken out of the ring.
+ *
+ * \return The number of bytes read or -1 if an error occurs.
+ */
+int XdpSocket::recvView(char *msg, size_t max_size, UdpPacketView& view)
+{
+    return receive(msg, max_size, &view, -1);
+}
+
+/** \brief Wait up to \p max_wait_ms milliseconds for a datagram.
+ *
+ * \return The number of bytes read, or -1 if an error occurs or no
+ * datagram arrived in time (errno is then EAGAIN.)
+ */
+int XdpSocket::timedRecv(char *msg, size_t max_size, int max_wait_ms)
+{
+    return receive(msg, max_size, NULL, max_wait_ms);
+}
+
+/** \brief Wait up to \p max_wait_ms milliseconds for a datagram and
+ * receive it with its addresses.
+ *
+ * The view is filled as with recvView().
+ *
+ * \return The number of bytes read, or -1 if an error occurs or no
+ * datagram arrived in time (errno is then EAGAIN.)
+ */
+int XdpSocket::timedRecvView(char *msg, size_t max_size, UdpPacketView& view, int max_wait_ms)
+{
+    return receive(msg, max_size, &view, max_wait_ms);
+}
+
+int XdpSocket::receive(char *msg, size_t max_size, UdpPacketView *view, int max_wait_ms)
+{
+    for(;;)
+    {
+        uint32_t const cons(*f_rx_.consumer);
+        if(cons == __atomic_load_n(f_rx_.producer, __ATOMIC_ACQUIRE))
+        {
+            struct pollfd fd;
+            fd.fd = f_socket_;
+            fd.events = POLLIN;
+            fd.revents = 0;
+            int const r(::poll(&fd, 1, max_wait_ms));
+            if(r < 0)
+            {
+                return -1;
+            }
+            if(r == 0)
+            {
+                errno = EAGAIN;
+                return -1;
+            }
+            continue;
+        }
+
+        const struct xdp_desc *desc(static_cast<const struct xdp_desc *>(f_rx_.descs) + (cons & f_rx_.mask));
+        uint64_t const addr(desc->addr);
+        const unsigned char *frame(f_umem_ + addr);
+        const unsigned char *ip(frame + ETHERNET_HEADER_SIZE);
+        const unsigned char *udp(ip + IPV4_HEADER_SIZE);
+        size_t const udp_length(desc->len < HEADERS_SIZE ? 0 : (udp[4] << 8) | udp[5]);
+        size_t wire_size(0);
+        if(udp_length >= UDP_HEADER_SIZE
+        && udp_length - UDP_HEADER_SIZE <= desc->len - HEADERS_SIZE)
+        {
+            wire_size = udp_length - UDP_HEADER_SIZE;
+        }
+        size_t const size(wire_size < max_size ? wire_size : max_size);
+        memcpy(msg, udp + UDP_HEADER_SIZE, size);
+        if(view != NULL)
+        {
+            struct sockaddr_in *source(reinterpret_cast<struct sockaddr_in *>(&view->source));
+            struct sockaddr_in *destination(reinterpret_cast<struct sockaddr_in *>(&view->destination));
+            memset(&view->source, 0, sizeof(view->source));
+            memset(&view->destination, 0, sizeof(view->destination));
+            source->sin_family = AF_INET;
+            destination->sin_family = AF_INET;
+            memcpy(&source->sin_addr, ip + 12, 4);
+            memcpy(&destination->sin_addr, ip + 16, 4);
+            memcpy(&source->sin_port, udp, 2);
+            memcpy(&destination->sin_port, udp + 2, 2);
+            view->source_len = sizeof(struct sockaddr_in);
+            view->destination_len = sizeof(struct sockaddr_in);
+            view->data = msg;
+            view->size = size;
+            view->wire_size = wire_size;
+            struct timespec ts;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            view->timestamp_ns = static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+        }
+
+        __atomic_store_n(f_rx_.consumer, cons + 1, __ATOMIC_RELEASE);
+        refill(addr);
+        if((__atomic_load_n(f_fill_.flags, __ATOMIC_ACQUIRE) & XDP_RING_NEED_WAKEUP) != 0)
+        {
+            ::recvfrom(f_socket_, NULL, 0, MSG_DONTWAIT, NULL, NULL);
+        }
+        return static_cast<int>(size);
+    }
+}
+
+/** \brief Number of packets the socket dropped.
+ *
+ * These are the packets redirected to the socket while its receive ring
+ * or the fill ring was full, i.e. because the application was too slow.
+ *
+ * \return The count since the socket was created, or -1 if an error
+ * occurs.
+ */
+int64_t XdpSocket::getRxDropCount() const
+{
+    struct xdp_statistics stats;
+    memset(&stats, 0, sizeof(stats));
+    socklen_t len(sizeof(stats));
+    if(getsockopt(f_socket_, SOL_XDP, XDP_STATISTICS, &stats, &len) != 0)
+    {
+        return -1;
+    }
+    return static_cast<int64_t>(stats.rx_dropped + stats.rx_ring_full + stats.rx_fill_ring_empty_descs);
+}
+
+} // namespace udp_client_server
+#endif
+// vim: ts=4 sw=4 et
@@ -0,0 +1,112 @@
+// Basic UDP Socket Tests -- policy-based sockets
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <basic_udp_socket.h>
+#include <gtest/gtest.h>
+#include "test_helpers.h"
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <type_traits>
+
+using namespace udp_client_server;
+
+namespace
+{
+
+typedef BasicUdpSocket<ServerRole, IPv4Only, Batching<8>, SocketMetrics> BatchServer;
+typedef BasicUdpSocket<IPv4Only, Batching<8>, SocketMetrics> BatchClient;
+typedef BasicUdpSocket<SocketMetrics, KernelTimestamps, ServerRole> StampedServer;
+
+} // no name namespace
+
+
+TEST(BasicUdpSocket, SelectsThePoliciesInAnyOrder)
+{
+    EXPECT_TRUE((std::is_same<StampedServer::Role, ServerRole>::value));
+    EXPECT_TRUE((std::is_same<StampedServer::Timestamping, KernelTimestamps>::value));
+    EXPECT_TRUE((std::is_same<StampedServer::Family, AnyFamily>::value));
+    EXPECT_TRUE((std::is_same<StampedServer::BlockingMode, NonBlocking>::value));
+    EXPECT_TRUE((std::is_same<BasicUdpSocket<>::Metrics, NoMetrics>::value));
+    EXPECT_TRUE((std::is_same<BasicUdpSocket<>::Role, ClientRole>::value));
+    EXPECT_TRUE((detail::PoliciesValid<ServerRole, Blocking>::value));
+    EXPECT_FALSE((detail::PoliciesValid<ServerRole, ClientRole>::value));
+}
+
+TEST(BasicUdpSocket, SendsAndReceivesBatches)
+{
+    BatchServer server("127.0.0.1", 46063);
+    BatchClient client("127.0.0.1", 46063);
+
+    char const *const messages[] = { "one", "three", "five!" };
+    struct iovec iov[3];
+    UdpSendVector vectors[3];
+    for(int i(0); i < 3; ++i)
+    {
+        iov[i].iov_base = const_cast<char *>(messages[i]);
+        iov[i].iov_len = strlen(messages[i]);
+        vectors[i].iov = &iov[i];
+        vectors[i].iovcnt = 1;
+    }
+    ASSERT_EQ(3, client.sendBatch(vectors, 3));
+    EXPECT_EQ(3u, client.getMetrics().sent_packets);
+    EXPECT_EQ(13u, client.getMetrics().sent_bytes);
+
+    waitReadable(server.getSocket());
+    char buffers[4][16];
+    struct iovec receive[4];
+    for(int i(0); i < 4; ++i)
+    {
+        receive[i].iov_base = buffers[i];
+        receive[i].iov_len = sizeof(buffers[i]);
+    }
+    size_t sizes[4];
+    ASSERT_EQ(3, server.recvBatch(receive, 4, sizes));
+    EXPECT_EQ(5u, sizes[1]);
+    EXPECT_EQ("three", std::string(buffers[1], sizes[1]));
+    EXPECT_EQ(3u, server.getMetrics().received_packets);
+
+    // nothing pending is not an error
+    EXPECT_EQ(-1, server.recvBatch(receive, 4, sizes));
+    EXPECT_EQ(EAGAIN, errno);
+    EXPECT_EQ(0u, server.getMetrics().errors);
+}
+
+TEST(BasicUdpSocket, StampsTheDatagramsWithTheKernelTime)
+{
+    StampedServer server("127.0.0.1", 46063);
+    BasicUdpSocket<> client("127.0.0.1", 46063);
+
+    struct timespec before;
+    clock_gettime(CLOCK_REALTIME, &before);
+    ASSERT_EQ(5, client.send("hello", 5));
+    waitReadable(server.getSocket());
+
+    char buffer[16];
+    struct timespec stamp;
+    ASSERT_EQ(5, server.recv(buffer, sizeof(buffer), stamp));
+    EXPECT_GE(stamp.tv_sec, before.tv_sec);
+    EXPECT_EQ(1u, server.getMetrics().received_packets);
+}
+
+TEST(BasicUdpSocket, RejectsAnAddressOfTheWrongFamily)
+{
+    EXPECT_THROW(BasicUdpSocket<IPv6Only> socket("127.0.0.1", 46063), UdpClientServerRuntimeError);
+}
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,248 @@
+// Bulk Stream Tests -- LEDBAT congestion control of bulk transfers
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <bulk_stream.h>
+#include <gtest/gtest.h>
+#include "test_helpers.h"
+#include <algorithm>
+#include <string>
+
+using namespace udp_client_server;
+
+namespace
+{
+
+const uint64_t MS = 1000000ULL;
+
+LedbatParameters parameters()
+{
+    LedbatParameters result;
+    result.mss = 1000;
+    return result;
+}
+
+/** \brief Send datagrams at the pacing rate until the window is full.
+ *
+ * \return The number of datagrams sent; \p now_ns is moved to the time
+ * the last one was sent.
+ */
+int fill(BulkSender& sender, uint64_t& now_ns)
+{
+    std::string const payload(1000 - BulkDataHeader::SIZE, 'x');
+    int sent(0);
+    while(sender.getFlightSize() < sender.getController().getCwnd())
+    {
+        now_ns = std::max(now_ns, sender.nextSendTime());
+        if(sender.send(payload.data(), payload.size(), now_ns) < 0)
+        {
+            break;
+        }
+        ++sent;
+    }
+    return sent;
+}
+
+} // no name namespace
+
+
+TEST(LedbatController, GrowsInSlowStartWithoutQueuingDelay)
+{
+    LedbatController controller(parameters());
+    EXPECT_EQ(4000u, controller.getCwnd());
+    for(int i(1); i <= 5; ++i)
+    {
+        controller.onFeedback(i * 10 * MS, 4000, 0, 5000, 10 * MS, true);
+    }
+    EXPECT_TRUE(controller.inSlowStart());
+    EXPECT_EQ(24000u, controller.getCwnd());
+    EXPECT_EQ(10 * MS, controller.getSrtt());
+}
+
+TEST(LedbatController, ShrinksAboveTheTargetDelay)
+{
+    LedbatController controller(parameters());
+    for(int i(1); i <= 5; ++i)
+    {
+        controller.onFeedback(i * 10 * MS, 4000, 0, 5000, 10 * MS, true);
+    }
+    size_t const before(controller.getCwnd());
+
+    // 50 ms of queuing, twice the target
+    for(int i(6); i <= 15; ++i)
+    {
+        controller.onFeedback(i * 10 * MS, 4000, 0, 55000, 60 * MS, true);
+    }
+    EXPECT_FALSE(controller.inSlowStart());
+    EXPECT_EQ(50 * MS, controller.getQueuingDelay());
+    EXPECT_LT(controller.getCwnd(), before);
+}
+
+TEST(LedbatController, HalvesTheWindowOncePerRoundTripOnLoss)
+{
+    LedbatController controller(parameters());
+    controller.onFeedback(10 * MS, 4000, 0, 5000, 10 * MS, true);
+    EXPECT_EQ(8000u, controller.getCwnd());
+
+    controller.onFeedback(20 * MS, 2000, 2, 5000, 10 * MS, true);
+    EXPECT_EQ(4000u, controller.getCwnd());
+    EXPECT_FALSE(controller.inSlowStart());
+
+    // same congestion event, still within the round trip
+    controller.onFeedback(25 * MS, 2000, 1, 5000, 10 * MS, true);
+    EXPECT_EQ(4000u, controller.getCwnd());
+}
+
+TEST(LedbatController, CollapsesOnTimeout)
+{
+    LedbatController controller(parameters());
+    controller.onFeedback(10 * MS, 4000, 0, 5000, 10 * MS, true);
+    controller.onTimeout(100 * MS);
+    EXPECT_EQ(2000u, controller.getCwnd());
+    EXPECT_FALSE(controller.inSlowStart());
+
+    // the losses of the timed out window do not halve it again
+    controller.onFeedback(105 * MS, 0, 8, 5000, 10 * MS, false);
+    EXPECT_EQ(2000u, controller.getCwnd());
+}
+
+TEST(BulkSender, ProbesAfterTheFeedbackStops)
+{
+    // the server never answers
+    UdpServer server("0.0.0.0", 46074);
+    UdpClient client("127.0.0.1", 46074);
+    BulkSender sender(client, parameters());
+
+    // the first datagram starts the timeout
+    uint64_t const start(1000 * MS);
+    uint64_t now(start);
+    EXPECT_EQ(4, fill(sender, now));
+    std::string const payload(1000 - BulkDataHeader::SIZE, 'x');
+    EXPECT_EQ(-1, sender.send(payload.data(), payload.size(), start + 399 * MS));
+    EXPECT_EQ(EAGAIN, errno);
+    EXPECT_EQ(0u, sender.getTimeoutCount());
+
+    // four times the initial 100 ms round trip
+    EXPECT_EQ(0, sender.poll(start + 400 * MS));
+    EXPECT_EQ(1u, sender.getTimeoutCount());
+    EXPECT_EQ(2000u, sender.getController().getCwnd());
+    EXPECT_EQ(0u, sender.getFlightSize());
+    now = start + 400 * MS;
+    EXPECT_EQ(2, fill(sender, now));
+
+    // the next timeout is backed off
+    EXPECT_EQ(0, sender.poll(start + 1100 * MS));
+    EXPECT_EQ(1u, sender.getTimeoutCount());
+    EXPECT_EQ(0, sender.poll(start + 1200 * MS));
+    EXPECT_EQ(2u, sender.getTimeoutCount());
+}
+
+TEST(BulkSender, UpdatesTheRateFromTheReceiverFeedback)
+{
+    UdpServer server("127.0.0.1", 46074);
+    BulkReceiver receiver(server, 0);
+    UdpClient client("127.0.0.1", 46074);
+    BulkSender sender(client, parameters());
+
+    uint64_t now(1000 * MS);
+    EXPECT_EQ(4, fill(sender, now));
+    int received(0);
+    for(int i(0); i < 100 && received < 4; ++i)
+    {
+        waitReadable(server.getSocket());
+        received += receiver.poll(now + 2 * MS);
+    }
+    ASSERT_EQ(4, received);
+    EXPECT_GE(receiver.getFeedbackCount(), 1u);
+    EXPECT_EQ(0u, receiver.getLostCount());
+
+    waitReadable(client.getSocket());
+    EXPECT_GE(sender.poll(now + 3 * MS), 1);
+    EXPECT_EQ(0u, sender.getFlightSize());
+    EXPECT_EQ(0u, sender.getLostCount());
+    EXPECT_GT(sender.getController().getSrtt(), 0u);
+    EXPECT_EQ(0u, sender.getTimeoutCount());
+}
+
+TEST(BulkSender, PollReadsAtMostMaxFeedbacks)
+{
+    UdpServer server("127.0.0.1", 46074);
+    UdpClient client("127.0.0.1", 46074);
+    BulkSender sender(client, parameters());
+
+    // answer from the server socket as a receiver would
+    std::string const payload(1000 - BulkDataHeader::SIZE, 'x');
+    ASSERT_EQ(static_cast<int>(payload.size()), sender.send(payload.data(), payload.size(), 1000 * MS));
+    struct sockaddr_storage from;
+    socklen_t from_len(sizeof(from));
+    char buffer[1000];
+    ASSERT_EQ(1000, server.recvFrom(buffer, sizeof(buffer), &from, &from_len));
+    for(uint32_t i(1); i <= 3; ++i)
+    {
+        BulkFeedback feedback;
+        feedback.kind = BulkFeedback::FEEDBACK;
+        feedback.flags = 0;
+        feedback.highest_sequence = 1;
+        feedback.received_packets = i;
+        feedback.received_bytes = 1000 * i;
+        feedback.delay_us = 100;
+        feedback.echo_us = 1000000;
+        feedback.hold_us = 0;
+        char datagram[BulkFeedback::SIZE];
+        feedback.write(datagram);
+        ASSERT_EQ(static_cast<int>(sizeof(datagram)), sendto(server.getSocket(), datagram, sizeof(datagram), 0
+                                                           , reinterpret_cast<struct sockaddr *>(&from), from_len));
+    }
+    waitReadable(client.getSocket());
+    EXPECT_EQ(1, sender.poll(1001 * MS, 1));
+    EXPECT_EQ(2, sender.poll(1002 * MS));
+    EXPECT_EQ(3u, sender.getFeedbackCount());
+}
+
+TEST(BulkReceiver, PollReadsAtMostMaxDatagrams)
+{
+    UdpServer server("127.0.0.1", 46074);
+    BulkReceiver receiver(server, 0);
+    UdpClient client("127.0.0.1", 46074);
+
+    // invalid datagrams count against the bound too
+    for(int i(0); i < 3; ++i)
+    {
+        ASSERT_EQ(4, client.send("junk", 4));
+    }
+    waitReadable(server.getSocket());
+    EXPECT_EQ(0, receiver.poll(1000 * MS, 2));
+    EXPECT_EQ(2u, receiver.getInvalidCount());
+    EXPECT_EQ(0, receiver.poll(1000 * MS));
+    EXPECT_EQ(3u, receiver.getInvalidCount());
+}
+
+TEST(BulkReceiver, CountsTruncatedDatagramsAsInvalid)
+{
+    UdpServer server("127.0.0.1", 46074);
+    BulkReceiver receiver(server, 0, 100);
+    UdpClient client("127.0.0.1", 46074);
+    BulkSender sender(client, parameters());
+
+    std::string const payload(1000 - BulkDataHeader::SIZE, 'x');
+    ASSERT_EQ(static_cast<int>(payload.size()), sender.send(payload.data(), payload.size(), 1000 * MS));
+    waitReadable(server.getSocket());
+    EXPECT_EQ(0, receiver.poll(1000 * MS));
+    EXPECT_EQ(1u, receiver.getInvalidCount());
+    EXPECT_EQ(0u, receiver.getReceivedCount());
+}
+
+// vim: ts=4 sw=4 et
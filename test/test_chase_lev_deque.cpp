@@ -0,0 +1,131 @@
+// Chase-Lev Deque Tests -- work-stealing deque
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <chase_lev_deque.h>
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace udp_client_server;
+
+
+TEST(ChaseLevDeque, OwnerPopsLastInFirstOut)
+{
+    ChaseLevDeque<intptr_t> deque(8);
+    for(intptr_t i(1); i <= 3; ++i)
+    {
+        ASSERT_TRUE(deque.push(i));
+    }
+    intptr_t item;
+    ASSERT_TRUE(deque.pop(item));
+    EXPECT_EQ(3, item);
+    ASSERT_TRUE(deque.pop(item));
+    EXPECT_EQ(2, item);
+    ASSERT_TRUE(deque.pop(item));
+    EXPECT_EQ(1, item);
+    EXPECT_FALSE(deque.pop(item));
+}
+
+TEST(ChaseLevDeque, ThievesStealFirstInFirstOut)
+{
+    ChaseLevDeque<intptr_t> deque(8);
+    for(intptr_t i(1); i <= 3; ++i)
+    {
+        ASSERT_TRUE(deque.push(i));
+    }
+    intptr_t item;
+    ASSERT_TRUE(deque.steal(item));
+    EXPECT_EQ(1, item);
+    ASSERT_TRUE(deque.pop(item));
+    EXPECT_EQ(3, item);
+    ASSERT_TRUE(deque.steal(item));
+    EXPECT_EQ(2, item);
+    EXPECT_FALSE(deque.steal(item));
+    EXPECT_FALSE(deque.pop(item));
+    EXPECT_EQ(0u, deque.sizeApprox());
+}
+
+TEST(ChaseLevDeque, PushFailsWhenFull)
+{
+    ChaseLevDeque<intptr_t> deque(3);
+    EXPECT_EQ(4u, deque.capacity());
+    for(intptr_t i(0); i < 4; ++i)
+    {
+        ASSERT_TRUE(deque.push(i));
+    }
+    EXPECT_FALSE(deque.push(4));
+
+    // stealing makes room at the top, reused by the bottom
+    intptr_t item;
+    ASSERT_TRUE(deque.steal(item));
+    EXPECT_TRUE(deque.push(4));
+    EXPECT_EQ(4u, deque.sizeApprox());
+}
+
+TEST(ChaseLevDeque, EveryItemIsTakenOnce)
+{
+    intptr_t const ITEMS = 100000;
+    ChaseLevDeque<intptr_t> deque(256);
+    std::vector<std::atomic<int>> taken(ITEMS);
+    for(intptr_t i(0); i < ITEMS; ++i)
+    {
+        taken[i] = 0;
+    }
+    std::atomic<bool> done(false);
+    std::thread thief([&]()
+        {
+            intptr_t item;
+            while(!done.load())
+            {
+                if(deque.steal(item))
+                {
+                    ++taken[item];
+                }
+            }
+        });
+
+    intptr_t item;
+    for(intptr_t i(0); i < ITEMS; ++i)
+    {
+        while(!deque.push(i))
+        {
+            if(deque.pop(item))
+            {
+                ++taken[item];
+            }
+        }
+        if(i % 3 == 0 && deque.pop(item))
+        {
+            ++taken[item];
+        }
+    }
+    while(deque.pop(item))
+    {
+        ++taken[item];
+    }
+    done = true;
+    thief.join();
+
+    for(intptr_t i(0); i < ITEMS; ++i)
+    {
+        ASSERT_EQ(1, taken[i].load()) << "item " << i;
+    }
+}
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,155 @@
+// Discovery Tests -- beacons advertising the endpoints of the peers
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <discovery.h>
+#include <gtest/gtest.h>
+#include "test_helpers.h"
+#include <arpa/inet.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace udp_client_server;
+
+namespace
+{
+
+struct Endpoint
+{
+    const char *        name;
+    uint16_t            port;
+};
+
+std::string beacon(uint32_t node, const Endpoint *endpoints, size_t count)
+{
+    std::string result("UDSC");
+    result += static_cast<char>(1);
+    result += static_cast<char>(count);
+    result += std::string(2, '\0');
+    uint32_t const n(htonl(node));
+    result.append(reinterpret_cast<const char *>(&n), sizeof(n));
+    for(size_t i(0); i < count; ++i)
+    {
+        uint16_t const port(htons(endpoints[i].port));
+        result.append(reinterpret_cast<const char *>(&port), sizeof(port));
+        result += static_cast<char>(strlen(endpoints[i].name));
+        result += endpoints[i].name;
+    }
+    return result;
+}
+
+struct Events
+{
+    std::vector<DiscoveryEvent> kinds;
+    std::vector<std::string> names;
+};
+
+void listen(void *user, DiscoveryEvent event, const DiscoveredEndpoint& endpoint)
+{
+    Events& events(*static_cast<Events *>(user));
+    events.kinds.push_back(event);
+    events.names.push_back(endpoint.name);
+}
+
+/** \brief Deliver \p datagram to \p discovery through its socket.
+ */
+void deliver(Discovery& discovery, UdpServer& server, UdpClient& peer, const std::string& datagram, uint64_t now_ns)
+{
+    ASSERT_EQ(static_cast<int>(datagram.size()), peer.send(datagram.data(), datagram.size()));
+    waitReadable(server.getSocket());
+    discovery.poll(now_ns);
+}
+
+const Endpoint BOTH[] = { { "robot/cmd", 7000 }, { "robot/video", 7001 } };
+
+} // no name namespace
+
+
+TEST(Discovery, FindsTheEndpointsOfABeacon)
+{
+    UdpServer server("0.0.0.0", 46067);
+    Discovery discovery(server, "127.0.0.1", 46067);
+    Events events;
+    discovery.setListener(listen, &events);
+    UdpClient peer("127.0.0.1", 46067);
+
+    deliver(discovery, server, peer, beacon(42, BOTH, 2), 1);
+    ASSERT_EQ(2u, events.kinds.size());
+    EXPECT_EQ(DISCOVERY_FOUND, events.kinds[0]);
+    EXPECT_EQ(DISCOVERY_FOUND, events.kinds[1]);
+
+    DiscoveredEndpoint video;
+    ASSERT_TRUE(discovery.find("robot/video", video));
+    EXPECT_EQ(42u, video.node_id);
+    EXPECT_EQ(7001, ntohs(reinterpret_cast<struct sockaddr_in *>(&video.addr)->sin_port));
+}
+
+TEST(Discovery, IgnoresTruncatedBeacons)
+{
+    UdpServer server("0.0.0.0", 46067);
+    Discovery discovery(server, "127.0.0.1", 46067);
+    Events events;
+    discovery.setListener(listen, &events);
+    UdpClient peer("127.0.0.1", 46067);
+
+    deliver(discovery, server, peer, beacon(42, BOTH, 2), 1);
+    ASSERT_EQ(2u, discovery.getEndpoints().size());
+
+    // the second record is cut in the middle of its name
+    std::string const full(beacon(42, BOTH, 2));
+    deliver(discovery, server, peer, full.substr(0, full.size() - 3), 2);
+    // one record too many
+    deliver(discovery, server, peer, full + "\x1b\x5a\x01x", 3);
+
+    EXPECT_EQ(2u, events.kinds.size());
+    EXPECT_EQ(2u, discovery.getEndpoints().size());
+}
+
+TEST(Discovery, WithdrawsEndpointsMissingFromABeacon)
+{
+    UdpServer server("0.0.0.0", 46067);
+    Discovery discovery(server, "127.0.0.1", 46067);
+    Events events;
+    discovery.setListener(listen, &events);
+    UdpClient peer("127.0.0.1", 46067);
+
+    deliver(discovery, server, peer, beacon(42, BOTH, 2), 1);
+    deliver(discovery, server, peer, beacon(42, BOTH, 1), 2);
+
+    ASSERT_EQ(3u, events.kinds.size());
+    EXPECT_EQ(DISCOVERY_LOST, events.kinds[2]);
+    EXPECT_EQ("robot/video", events.names[2]);
+    EXPECT_EQ(1u, discovery.getEndpoints().size());
+}
+
+TEST(Discovery, PollReadsAtMostMaxBeacons)
+{
+    UdpServer server("0.0.0.0", 46067);
+    Discovery discovery(server, "127.0.0.1", 46067);
+    UdpClient peer("127.0.0.1", 46067);
+
+    std::string const datagram(beacon(42, BOTH, 2));
+    for(int i(0); i < 3; ++i)
+    {
+        ASSERT_EQ(static_cast<int>(datagram.size()), peer.send(datagram.data(), datagram.size()));
+    }
+    waitReadable(server.getSocket());
+    EXPECT_EQ(1, discovery.poll(1, 1));
+    EXPECT_GE(discovery.poll(2), 2);
+}
+
+// vim: ts=4 sw=4 et
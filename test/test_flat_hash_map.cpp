@@ -0,0 +1,151 @@
+// Flat Hash Map Tests -- lookups, erasure and tombstone reclamation
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <flat_hash_map.h>
+#include <gtest/gtest.h>
+#include <set>
+
+using namespace udp_client_server;
+
+namespace
+{
+
+struct MixHash
+{
+    uint64_t operator () (uint64_t key) const
+    {
+        key ^= key >> 33;
+        key *= 0xFF51AFD7ED558CCDULL;
+        key ^= key >> 33;
+        key *= 0xC4CEB9FE1A85EC53ULL;
+        key ^= key >> 33;
+        return key;
+    }
+};
+
+/** \brief A poor hash sending every key to the same group.
+ */
+struct CollidingHash
+{
+    uint64_t operator () (uint64_t key) const
+    {
+        return key & 0x7F;
+    }
+};
+
+typedef FlatHashMap<uint64_t, uint64_t, MixHash> Map;
+
+} // no name namespace
+
+
+TEST(FlatHashMap, InsertFindErase)
+{
+    Map map(100);
+    for(uint64_t k(0); k < 100; ++k)
+    {
+        bool inserted(false);
+        uint64_t *v(map.insert(k, &inserted));
+        ASSERT_TRUE(v != NULL);
+        EXPECT_TRUE(inserted);
+        *v = k * 10;
+    }
+    EXPECT_EQ(100U, map.size());
+    EXPECT_TRUE(map.insert(1000) == NULL);
+
+    bool inserted(true);
+    EXPECT_EQ(50U, *map.insert(5, &inserted));
+    EXPECT_FALSE(inserted);
+
+    EXPECT_TRUE(map.erase(5));
+    EXPECT_FALSE(map.erase(5));
+    EXPECT_TRUE(map.find(5) == NULL);
+    ASSERT_TRUE(map.find(6) != NULL);
+    EXPECT_EQ(60U, *map.find(6));
+
+    EXPECT_EQ(50U, map.eraseIf([](uint64_t k, uint64_t) { return k % 2 == 0; }));
+    EXPECT_EQ(49U, map.size());
+    size_t count(0);
+    map.forEach([&count](uint64_t k, uint64_t& v) { EXPECT_EQ(k * 10, v); ++count; });
+    EXPECT_EQ(49U, count);
+}
+
+TEST(FlatHashMap, ChurnKeepsTombstonesBounded)
+{
+    // the keys of a full map come and go, as peers do in a PeerTable
+    Map map(1000);
+    std::set<uint64_t> present;
+    uint64_t next(0);
+    for(; next < 1000; ++next)
+    {
+        ASSERT_TRUE(map.insert(next) != NULL);
+        present.insert(next);
+    }
+    size_t const slots(2048);
+    for(int round(0); round < 200; ++round)
+    {
+        // erase the oldest 100, insert 100 new ones
+        for(int i(0); i < 100; ++i)
+        {
+            ASSERT_TRUE(map.erase(*present.begin()));
+            present.erase(present.begin());
+        }
+        for(int i(0); i < 100; ++i, ++next)
+        {
+            ASSERT_TRUE(map.insert(next) != NULL);
+            present.insert(next);
+        }
+        EXPECT_LT(map.tombstones(), slots / 8);
+    }
+    EXPECT_EQ(present.size(), map.size());
+    for(std::set<uint64_t>::const_iterator it(present.begin()); it != present.end(); ++it)
+    {
+        ASSERT_TRUE(map.find(*it) != NULL) << *it;
+    }
+    for(uint64_t k(0); k < next - 1000; ++k)
+    {
+        ASSERT_TRUE(map.find(k) == NULL) << k;
+    }
+}
+
+TEST(FlatHashMap, RehashKeepsCollidingKeysReachable)
+{
+    // every key lands in one group, so erasing in full groups leaves
+    // tombstones and forces in-place rehashes with long probe sequences
+    FlatHashMap<uint64_t, uint64_t, CollidingHash> map(200);
+    for(uint64_t k(0); k < 200; ++k)
+    {
+        *map.insert(k) = k;
+    }
+    for(int round(0); round < 50; ++round)
+    {
+        EXPECT_EQ(100U, map.eraseIf([](uint64_t k, uint64_t) { return k % 2 == 0; }));
+        EXPECT_LT(map.tombstones(), 256U / 8);
+        for(uint64_t k(0); k < 200; k += 2)
+        {
+            ASSERT_TRUE(map.insert(k) != NULL);
+            *map.find(k) = k;
+        }
+        for(uint64_t k(0); k < 200; ++k)
+        {
+            uint64_t *v(map.find(k));
+            ASSERT_TRUE(v != NULL) << k;
+            EXPECT_EQ(k, *v);
+        }
+    }
+}
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,181 @@
+// Frame Stream Tests -- reassembly of chunked frames
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <frame_stream.h>
+#include <gtest/gtest.h>
+#include "test_helpers.h"
+#include <string>
+#include <vector>
+
+using namespace udp_client_server;
+
+namespace
+{
+
+const size_t CHUNK_SIZE = 1000;
+
+struct Frames
+{
+    std::vector<std::string> data;
+    std::vector<bool> complete;
+};
+
+void collect(void *user, const FrameView& frame)
+{
+    Frames& frames(*static_cast<Frames *>(user));
+    frames.data.push_back(std::string(frame.data, frame.size));
+    frames.complete.push_back(frame.complete);
+}
+
+std::string pattern(size_t size)
+{
+    std::string result(size, '\0');
+    for(size_t i(0); i < size; ++i)
+    {
+        result[i] = static_cast<char>(i * 7 + i / CHUNK_SIZE);
+    }
+    return result;
+}
+
+/** \brief Send chunk \p index of \p frame by itself and let \p receiver read it.
+ */
+void sendChunk(FrameReceiver& receiver, UdpServer& server, UdpClient& client, uint32_t frame_id, const std::string& frame, size_t index)
+{
+    FrameChunkHeader header;
+    header.kind = FrameChunkHeader::CHUNK;
+    header.flags = 0;
+    header.chunk_size = CHUNK_SIZE;
+    header.frame_id = frame_id;
+    header.frame_size = static_cast<uint32_t>(frame.size());
+    header.offset = static_cast<uint32_t>(index * CHUNK_SIZE);
+    std::string datagram(FrameChunkHeader::SIZE, '\0');
+    header.write(&datagram[0]);
+    datagram += frame.substr(header.offset, CHUNK_SIZE);
+    ASSERT_EQ(static_cast<int>(datagram.size()), client.send(datagram.data(), datagram.size()));
+    waitReadable(server.getSocket());
+    ASSERT_EQ(1, receiver.poll(1));
+}
+
+} // no name namespace
+
+
+TEST(FrameReceiver, ReassemblesInOrderChunksWithoutCopies)
+{
+    UdpServer server("0.0.0.0", 46073);
+    UdpClient client("127.0.0.1", 46073);
+    FrameReceiver receiver(server, 8000, 2, CHUNK_SIZE);
+    Frames frames;
+    receiver.setCallback(collect, &frames);
+
+    std::string const frame(pattern(4500));
+    for(size_t i(0); i < 5; ++i)
+    {
+        sendChunk(receiver, server, client, 1, frame, i);
+    }
+    ASSERT_EQ(1u, frames.data.size());
+    EXPECT_TRUE(frames.complete[0]);
+    EXPECT_TRUE(frames.data[0] == frame);
+    EXPECT_EQ(0u, receiver.getCopiedChunkCount());
+}
+
+TEST(FrameReceiver, ReassemblesReorderedChunks)
+{
+    UdpServer server("0.0.0.0", 46073);
+    UdpClient client("127.0.0.1", 46073);
+    FrameReceiver receiver(server, 8000, 2, CHUNK_SIZE);
+    Frames frames;
+    receiver.setCallback(collect, &frames);
+
+    // after chunk 1 the receiver expects chunk 2, which is already there
+    std::string const frame(pattern(4500));
+    size_t const order[] = { 0, 2, 1, 3, 4 };
+    for(size_t i(0); i < 5; ++i)
+    {
+        sendChunk(receiver, server, client, 1, frame, order[i]);
+    }
+    ASSERT_EQ(1u, frames.data.size());
+    EXPECT_TRUE(frames.complete[0]);
+    EXPECT_TRUE(frames.data[0] == frame);
+}
+
+TEST(FrameReceiver, IgnoresDuplicateChunks)
+{
+    UdpServer server("0.0.0.0", 46073);
+    UdpClient client("127.0.0.1", 46073);
+    FrameReceiver receiver(server, 8000, 2, CHUNK_SIZE);
+    Frames frames;
+    receiver.setCallback(collect, &frames);
+
+    std::string const frame(pattern(4500));
+    size_t const order[] = { 0, 2, 2, 1, 1, 3, 0, 4 };
+    for(size_t i(0); i < 8; ++i)
+    {
+        sendChunk(receiver, server, client, 1, frame, order[i]);
+    }
+    ASSERT_EQ(1u, frames.data.size());
+    EXPECT_TRUE(frames.complete[0]);
+    EXPECT_TRUE(frames.data[0] == frame);
+    EXPECT_EQ(3u, receiver.getLateChunkCount());
+}
+
+TEST(FrameReceiver, InterleavedFramesKeepTheirData)
+{
+    UdpServer server("0.0.0.0", 46073);
+    UdpClient client("127.0.0.1", 46073);
+    FrameReceiver receiver(server, 8000, 2, CHUNK_SIZE);
+    Frames frames;
+    receiver.setCallback(collect, &frames);
+
+    std::string const first(pattern(3000));
+    std::string second(pattern(2500));
+    for(size_t i(0); i < second.size(); ++i)
+    {
+        second[i] = static_cast<char>(~second[i]);
+    }
+    sendChunk(receiver, server, client, 1, first, 0);
+    sendChunk(receiver, server, client, 2, second, 1);
+    sendChunk(receiver, server, client, 1, first, 2);
+    sendChunk(receiver, server, client, 2, second, 0);
+    sendChunk(receiver, server, client, 1, first, 1);
+    sendChunk(receiver, server, client, 2, second, 2);
+
+    ASSERT_EQ(2u, frames.data.size());
+    EXPECT_TRUE(frames.data[0] == first);
+    EXPECT_TRUE(frames.data[1] == second);
+}
+
+TEST(FrameReceiver, DeliversPartialFramesOnTheDeadline)
+{
+    UdpServer server("0.0.0.0", 46073);
+    UdpClient client("127.0.0.1", 46073);
+    FrameReceiver receiver(server, 8000, 2, CHUNK_SIZE);
+    Frames frames;
+    receiver.setCallback(collect, &frames);
+    receiver.setPartialDelivery(true);
+    receiver.setDeadline(1000);
+
+    std::string const frame(pattern(3000));
+    sendChunk(receiver, server, client, 1, frame, 0);
+    sendChunk(receiver, server, client, 1, frame, 2);
+    EXPECT_EQ(0, receiver.poll(1001));
+
+    ASSERT_EQ(1u, frames.data.size());
+    EXPECT_FALSE(frames.complete[0]);
+    EXPECT_EQ(1u, receiver.getPartialCount());
+}
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,52 @@
+// Tests -- helpers shared by the unit tests
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef UDP_CLIENT_SERVER_TEST_HELPERS_H
+#define UDP_CLIENT_SERVER_TEST_HELPERS_H
+
+#include <poll.h>
+
+/** \brief Wait up to one second for \p events on \p socket.
+ *
+ * Errors and hang ups are always reported by poll(), so \p events may be
+ * 0 to wait for an error only.
+ */
+inline void waitForEvents(int socket, short events)
+{
+    struct pollfd fd;
+    fd.fd = socket;
+    fd.events = events;
+    ::poll(&fd, 1, 1000);
+}
+
+/** \brief Wait up to one second for a datagram on \p socket.
+ */
+inline void waitReadable(int socket)
+{
+    waitForEvents(socket, POLLIN);
+}
+
+/** \brief Wait up to one second for an error on \p socket.
+ */
+inline void waitForError(int socket)
+{
+    waitForEvents(socket, 0);
+}
+
+#endif
+// UDP_CLIENT_SERVER_TEST_HELPERS_H
+// vim: ts=4 sw=4 et
@@ -0,0 +1,189 @@
+// Impaired Socket Tests -- loss, delay and duplication on real sockets
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <impaired_socket.h>
+#include <gtest/gtest.h>
+#include "test_helpers.h"
+#include <errno.h>
+#include <time.h>
+#include <string>
+
+using namespace udp_client_server;
+
+namespace
+{
+
+const uint64_t MS = 1000000ULL;
+
+} // no name namespace
+
+
+TEST(PacketImpairer, PassesPacketsThroughAPerfectLink)
+{
+    PacketImpairer impairer;
+    impairer.submit(1000, "one", 3);
+    impairer.submit(1000, "two", 3);
+
+    std::string msg;
+    ASSERT_TRUE(impairer.release(1000, msg));
+    EXPECT_EQ("one", msg);
+    ASSERT_TRUE(impairer.release(1000, msg));
+    EXPECT_EQ("two", msg);
+    EXPECT_FALSE(impairer.release(1000, msg));
+    EXPECT_EQ(2u, impairer.getStats().released);
+}
+
+TEST(PacketImpairer, HoldsPacketsForTheLatency)
+{
+    PacketImpairer impairer;
+    NetworkImpairment impairment;
+    impairment.latency_ns = 5 * MS;
+    impairer.setImpairment(impairment);
+
+    impairer.submit(10 * MS, "late", 4);
+    std::string msg;
+    EXPECT_FALSE(impairer.release(14 * MS, msg));
+    EXPECT_EQ(1u, impairer.pending());
+    ASSERT_TRUE(impairer.release(15 * MS, msg));
+    EXPECT_EQ("late", msg);
+    EXPECT_EQ(0u, impairer.pending());
+}
+
+TEST(PacketImpairer, DropsAndDuplicatesPackets)
+{
+    PacketImpairer impairer;
+    NetworkImpairment impairment;
+    impairment.loss = 1.0;
+    impairer.setImpairment(impairment);
+    impairer.submit(1000, "lost", 4);
+    EXPECT_EQ(1u, impairer.getStats().lost);
+    EXPECT_EQ(0u, impairer.pending());
+
+    impairment.loss = 0.0;
+    impairment.duplicate = 1.0;
+    impairer.setImpairment(impairment);
+    impairer.submit(1000, "twice", 5);
+    EXPECT_EQ(1u, impairer.getStats().duplicated);
+    EXPECT_EQ(2u, impairer.pending());
+}
+
+TEST(PacketImpairer, SerializesPacketsAtTheBandwidth)
+{
+    PacketImpairer impairer;
+    NetworkImpairment impairment;
+    // 1000 bytes take 1 ms at 8 Mbps
+    impairment.bandwidth_bps = 8000000;
+    impairer.setImpairment(impairment);
+
+    std::string const packet(1000, 'x');
+    impairer.submit(0, packet.data(), packet.size());
+    impairer.submit(0, packet.data(), packet.size());
+    std::string msg;
+    EXPECT_FALSE(impairer.release(MS - 1, msg));
+    EXPECT_TRUE(impairer.release(MS, msg));
+    EXPECT_FALSE(impairer.release(2 * MS - 1, msg));
+    EXPECT_TRUE(impairer.release(2 * MS, msg));
+}
+
+TEST(PacketImpairer, ReplaysTheSameRunWithTheSameSeed)
+{
+    NetworkImpairment impairment;
+    impairment.loss = 0.5;
+    PacketImpairer a(42);
+    PacketImpairer b(42);
+    a.setImpairment(impairment);
+    b.setImpairment(impairment);
+    for(int i(0); i < 100; ++i)
+    {
+        a.submit(0, "x", 1);
+        b.submit(0, "x", 1);
+    }
+    EXPECT_EQ(a.getStats().lost, b.getStats().lost);
+    EXPECT_GT(a.getStats().lost, 0u);
+    EXPECT_LT(a.getStats().lost, 100u);
+}
+
+TEST(ImpairedUdpServer, DelaysTheDatagramsReceived)
+{
+    UdpServer server("127.0.0.1", 46057);
+    UdpClient client("127.0.0.1", 46057);
+    ImpairedUdpServer impaired(server);
+    NetworkImpairment impairment;
+    impairment.latency_ns = 20 * MS;
+    impaired.setImpairment(impairment);
+
+    ASSERT_EQ(5, client.send("hello", 5));
+    waitReadable(server.getSocket());
+    char buffer[16];
+    EXPECT_EQ(-1, impaired.recv(buffer, sizeof(buffer)));
+    EXPECT_EQ(EAGAIN, errno);
+    EXPECT_EQ(1u, impaired.getImpairer().pending());
+
+    int r(-1);
+    for(int i(0); i < 100 && r < 0; ++i)
+    {
+        struct timespec pause = { 0, 1000000 };
+        nanosleep(&pause, NULL);
+        r = impaired.recv(buffer, sizeof(buffer));
+    }
+    ASSERT_EQ(5, r);
+    EXPECT_EQ("hello", std::string(buffer, 5));
+}
+
+TEST(ImpairedUdpServer, ReadsAtMostMaxPacketsPerCall)
+{
+    UdpServer server("127.0.0.1", 46057);
+    UdpClient client("127.0.0.1", 46057);
+    ImpairedUdpServer impaired(server);
+
+    for(int i(0); i < 3; ++i)
+    {
+        ASSERT_EQ(5, client.send("hello", 5));
+    }
+    waitReadable(server.getSocket());
+    char buffer[16];
+    EXPECT_EQ(5, impaired.recv(buffer, sizeof(buffer), 1));
+    EXPECT_EQ(0u, impaired.getImpairer().pending());
+    EXPECT_EQ(1u, impaired.getImpairer().getStats().submitted);
+
+    EXPECT_EQ(5, impaired.recv(buffer, sizeof(buffer)));
+    EXPECT_EQ(3u, impaired.getImpairer().getStats().submitted);
+}
+
+TEST(ImpairedUdpClient, DropsEverythingOnATotalLoss)
+{
+    UdpServer server("127.0.0.1", 46057);
+    UdpClient client("127.0.0.1", 46057);
+    ImpairedUdpClient impaired(client);
+    NetworkImpairment impairment;
+    impairment.loss = 1.0;
+    impaired.setImpairment(impairment);
+
+    // still reported sent, as on a real network
+    EXPECT_EQ(5, impaired.send("hello", 5));
+    EXPECT_EQ(1u, impaired.getImpairer().getStats().lost);
+    char buffer[16];
+    EXPECT_EQ(-1, server.recv(buffer, sizeof(buffer)));
+    EXPECT_EQ(EAGAIN, errno);
+
+    impaired.setImpairment(NetworkImpairment());
+    EXPECT_EQ(5, impaired.send("again", 5));
+    waitReadable(server.getSocket());
+    EXPECT_EQ(5, server.recv(buffer, sizeof(buffer)));
+}
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,126 @@
+// Message Dispatcher Tests -- jump table and counters
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <message_dispatcher.h>
+#include <gtest/gtest.h>
+#include <errno.h>
+#include <poll.h>
+#include <string>
+
+using namespace udp_client_server;
+
+namespace
+{
+
+struct Robot
+{
+    Robot() : poses(0), last_size(0) {}
+
+    int                 poses;
+    std::string         status;
+    size_t              last_size;
+};
+
+struct PoseHandler
+{
+    static const uint8_t ID = 3;
+
+    static void handle(Robot& robot, const char *, size_t size)
+    {
+        ++robot.poses;
+        robot.last_size = size;
+    }
+};
+
+struct StatusHandler
+{
+    static const uint8_t ID = 200;
+
+    static void handle(Robot& robot, const char *msg, size_t size)
+    {
+        robot.status.assign(msg + 1, size - 1);
+        robot.last_size = size;
+    }
+};
+
+typedef MessageDispatcher<Robot, PoseHandler, StatusHandler> RobotDispatcher;
+
+} // no name namespace
+
+
+TEST(MessageDispatcher, CallsTheHandlerOfTheFirstByte)
+{
+    RobotDispatcher dispatcher;
+    Robot robot;
+
+    char const pose[] = { 3, 1, 2, 3 };
+    dispatcher.dispatch(robot, pose, sizeof(pose));
+    dispatcher.dispatch(robot, pose, sizeof(pose));
+    char const status[] = { static_cast<char>(200), 'o', 'k' };
+    dispatcher.dispatch(robot, status, sizeof(status));
+
+    EXPECT_EQ(2, robot.poses);
+    EXPECT_EQ("ok", robot.status);
+    EXPECT_EQ(3U, robot.last_size);
+    EXPECT_EQ(2U, dispatcher.getCount(3));
+    EXPECT_EQ(1U, dispatcher.getCount(200));
+    EXPECT_EQ(0U, dispatcher.getUnhandledCount());
+}
+
+TEST(MessageDispatcher, CountsUnhandledAndEmptyMessages)
+{
+    RobotDispatcher dispatcher;
+    Robot robot;
+
+    char const unknown[] = { 4, 0 };
+    dispatcher.dispatch(robot, unknown, sizeof(unknown));
+    dispatcher.dispatch(robot, unknown, 0);
+
+    EXPECT_EQ(0, robot.poses);
+    EXPECT_EQ(1U, dispatcher.getCount(4));
+    EXPECT_EQ(1U, dispatcher.getUnhandledCount());
+    EXPECT_EQ(1U, dispatcher.getEmptyCount());
+
+    dispatcher.resetCounts();
+    EXPECT_EQ(0U, dispatcher.getCount(4));
+    EXPECT_EQ(0U, dispatcher.getUnhandledCount());
+    EXPECT_EQ(0U, dispatcher.getEmptyCount());
+}
+
+TEST(MessageDispatcher, PollsAServer)
+{
+    UdpServer server("127.0.0.1", 46051);
+    UdpClient client("127.0.0.1", 46051);
+    RobotDispatcher dispatcher;
+    Robot robot;
+    char buffer[64];
+
+    errno = 0;
+    EXPECT_EQ(-1, dispatcher.poll(server, robot, buffer, sizeof(buffer)));
+    EXPECT_EQ(EAGAIN, errno);
+
+    char const pose[] = { 3, 9 };
+    ASSERT_EQ(2, client.send(pose, sizeof(pose)));
+    struct pollfd fd;
+    fd.fd = server.getSocket();
+    fd.events = POLLIN;
+    ASSERT_EQ(1, ::poll(&fd, 1, 1000));
+    EXPECT_EQ(2, dispatcher.poll(server, robot, buffer, sizeof(buffer)));
+    EXPECT_EQ(1, robot.poses);
+}
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,139 @@
+// MPMC Queue Tests -- bounded lock-free multi-producer multi-consumer queue
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <mpmc_queue.h>
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace udp_client_server;
+
+
+TEST(MpmcQueue, RoundsTheCapacityToAPowerOfTwo)
+{
+    EXPECT_EQ(8u, MpmcQueue<int>(5).capacity());
+    EXPECT_EQ(8u, MpmcQueue<int>(8).capacity());
+    EXPECT_EQ(2u, MpmcQueue<int>(0).capacity());
+}
+
+TEST(MpmcQueue, IsFirstInFirstOut)
+{
+    MpmcQueue<int> queue(4);
+    int item;
+    EXPECT_FALSE(queue.pop(item));
+    for(int i(0); i < 4; ++i)
+    {
+        EXPECT_TRUE(queue.push(i));
+    }
+    EXPECT_FALSE(queue.push(4));
+    EXPECT_EQ(4u, queue.sizeApprox());
+    for(int i(0); i < 4; ++i)
+    {
+        ASSERT_TRUE(queue.pop(item));
+        EXPECT_EQ(i, item);
+    }
+    EXPECT_FALSE(queue.pop(item));
+}
+
+TEST(MpmcQueue, WrapsAroundManyTimes)
+{
+    MpmcQueue<int> queue(4);
+    int item;
+    for(int i(0); i < 1000; ++i)
+    {
+        ASSERT_TRUE(queue.push(i));
+        ASSERT_TRUE(queue.push(i + 1));
+        ASSERT_TRUE(queue.pop(item));
+        EXPECT_EQ(i, item);
+        ASSERT_TRUE(queue.pop(item));
+        EXPECT_EQ(i + 1, item);
+    }
+}
+
+TEST(MpmcQueue, DeliversEveryItemOnceAcrossThreads)
+{
+    size_t const PRODUCERS = 2;
+    size_t const CONSUMERS = 2;
+    uint32_t const ITEMS = 50000;
+
+    // items are the producer index in the high bits, a counter below
+    MpmcQueue<uint32_t> queue(64);
+    std::vector<std::thread> threads;
+    for(size_t p(0); p < PRODUCERS; ++p)
+    {
+        threads.push_back(std::thread([&queue, p, ITEMS]()
+            {
+                for(uint32_t i(0); i < ITEMS; ++i)
+                {
+                    while(!queue.push(static_cast<uint32_t>(p << 24) | i))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            }));
+    }
+    std::vector<std::vector<uint32_t>> received(CONSUMERS);
+    std::atomic<uint32_t> remaining(static_cast<uint32_t>(PRODUCERS * ITEMS));
+    for(size_t c(0); c < CONSUMERS; ++c)
+    {
+        std::vector<uint32_t> *mine(&received[c]);
+        threads.push_back(std::thread([&queue, &remaining, mine]()
+            {
+                uint32_t item;
+                while(remaining.load() > 0)
+                {
+                    if(queue.pop(item))
+                    {
+                        mine->push_back(item);
+                        --remaining;
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            }));
+    }
+    for(size_t i(0); i < threads.size(); ++i)
+    {
+        threads[i].join();
+    }
+
+    std::vector<int> seen(PRODUCERS * ITEMS, 0);
+    for(size_t c(0); c < CONSUMERS; ++c)
+    {
+        // a consumer sees the items of one producer in the order they were pushed
+        std::vector<int64_t> last(PRODUCERS, -1);
+        for(size_t i(0); i < received[c].size(); ++i)
+        {
+            size_t const p(received[c][i] >> 24);
+            uint32_t const n(received[c][i] & 0xFFFFFF);
+            ASSERT_LT(p, PRODUCERS);
+            EXPECT_LT(last[p], static_cast<int64_t>(n));
+            last[p] = n;
+            ++seen[p * ITEMS + n];
+        }
+    }
+    for(size_t i(0); i < seen.size(); ++i)
+    {
+        ASSERT_EQ(1, seen[i]) << "item " << i;
+    }
+}
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,94 @@
+// NUMA Placement Tests -- node lookup and node-bound allocations
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <numa_placement.h>
+#include <receive_buffer_pool.h>
+#include <gtest/gtest.h>
+#include <errno.h>
+#include <cstdlib>
+
+using namespace udp_client_server;
+
+
+TEST(NumaPlacement, ComputesTheRemoteRatio)
+{
+    NumaAllocStats stats;
+    EXPECT_EQ(0.0, stats.remoteRatio());
+    stats.local = 3;
+    stats.remote = 1;
+    EXPECT_EQ(0.25, stats.remoteRatio());
+}
+
+TEST(NumaPlacement, FindsTheNodeOfTheCurrentCpu)
+{
+    EXPECT_GE(numaNodeCount(), 1);
+    int const node(numaCurrentNode());
+    ASSERT_GE(node, 0);
+    EXPECT_LT(node, numaNodeCount());
+}
+
+TEST(NumaPlacement, RejectsUnknownNodesAndInterfaces)
+{
+    EXPECT_TRUE(numaCpusOfNode(9999).empty());
+    EXPECT_EQ(-1, numaPinThreadToNode(9999));
+    EXPECT_EQ(EINVAL, errno);
+    NumaAllocStats stats;
+    EXPECT_EQ(-1, numaReadAllocStats(9999, stats));
+    EXPECT_EQ(-1, numaNodeOfInterface("../../../etc"));
+    EXPECT_EQ(-1, numaNodeOfInterface("no-such-interface"));
+}
+
+TEST(NumaPlacement, AllocatesZeroedMemoryOnANode)
+{
+    int const node(numaCurrentNode());
+    ASSERT_GE(node, 0);
+    size_t const size(3 * 4096);
+    char *ptr(static_cast<char *>(numaAlloc(size, node)));
+    ASSERT_TRUE(ptr != NULL);
+    for(size_t i(0); i < size; ++i)
+    {
+        ASSERT_EQ(0, ptr[i]);
+    }
+    int const actual(numaNodeOfAddress(ptr));
+    if(actual >= 0)
+    {
+        EXPECT_EQ(node, actual);
+    }
+    numaFree(ptr, size);
+
+    EXPECT_TRUE(numaAlloc(size, 100000) == NULL);
+    EXPECT_EQ(EINVAL, errno);
+}
+
+TEST(NumaPlacement, PoolCarvesBuffersFromNodeSlabs)
+{
+    int const node(numaCurrentNode());
+    ASSERT_GE(node, 0);
+    ReceiveBufferPool pool(ReceiveBufferPool::RECV_PEEK_SIZE, 64, node);
+    EXPECT_EQ(node, pool.getNumaNode());
+
+    ReceiveBuffer a;
+    ReceiveBuffer b;
+    ASSERT_TRUE(pool.acquire(1000, a));
+    ASSERT_TRUE(pool.acquire(1000, b));
+    // consecutive buffers of the same slab
+    EXPECT_EQ(1024, std::abs(a.data - b.data));
+    pool.release(a);
+    pool.release(b);
+}
+
+// vim: ts=4 sw=4 et
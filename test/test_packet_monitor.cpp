@@ -0,0 +1,121 @@
+// Packet Monitor Tests -- TPACKET_V3 capture of the loopback traffic
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <packet_monitor.h>
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace udp_client_server;
+
+namespace
+{
+
+struct Captured
+{
+    std::vector<std::string> payloads;
+    std::vector<uint16_t> ports;
+};
+
+void capture(void *user, const UdpPacketView& view)
+{
+    Captured& captured(*static_cast<Captured *>(user));
+    captured.payloads.push_back(std::string(view.data, view.size));
+    captured.ports.push_back(ntohs(reinterpret_cast<const struct sockaddr_in *>(&view.destination)->sin_port));
+}
+
+/** \brief Open a monitor on lo, or explain why it cannot be.
+ *
+ * This needs CAP_NET_RAW; the tests are skipped otherwise.
+ */
+std::unique_ptr<PacketMonitor> open(int udp_port, std::string& reason)
+{
+    try
+    {
+        return std::unique_ptr<PacketMonitor>(new PacketMonitor("lo", udp_port, 64 * 1024, 4));
+    }
+    catch(UdpClientServerRuntimeError const& e)
+    {
+        reason = e.what();
+        return std::unique_ptr<PacketMonitor>();
+    }
+}
+
+/** \brief Poll \p monitor until it processed \p expected datagrams or a second elapsed.
+ */
+int drain(PacketMonitor& monitor, int expected)
+{
+    int count(0);
+    for(int i(0); i < 20 && count < expected; ++i)
+    {
+        int const r(monitor.poll(50));
+        if(r > 0)
+        {
+            count += r;
+        }
+    }
+    return count;
+}
+
+} // no name namespace
+
+
+TEST(PacketMonitor, RejectsAnUnknownInterface)
+{
+    EXPECT_THROW(PacketMonitor("no-such-interface"), UdpClientServerRuntimeError);
+}
+
+TEST(PacketMonitor, CapturesTheDatagramsOfItsPortOnce)
+{
+    std::string reason;
+    std::unique_ptr<PacketMonitor> monitor(open(46068, reason));
+    if(!monitor)
+    {
+        GTEST_SKIP() << reason;
+    }
+    Captured captured;
+    monitor->setHandler(capture, &captured);
+    TrafficStats stats;
+    monitor->setStats(&stats);
+
+    UdpServer server("127.0.0.1", 46068);
+    UdpClient client("127.0.0.1", 46068);
+    UdpServer other_server("127.0.0.1", 46168);
+    UdpClient other("127.0.0.1", 46168);
+    ASSERT_EQ(5, other.send("other", 5));
+    ASSERT_EQ(5, client.send("first", 5));
+    ASSERT_EQ(6, client.send("second", 6));
+
+    // the kernel hands a block over after at most 10 ms
+    EXPECT_EQ(2, drain(*monitor, 2));
+    ASSERT_EQ(2u, captured.payloads.size());
+    EXPECT_EQ("first", captured.payloads[0]);
+    EXPECT_EQ("second", captured.payloads[1]);
+    EXPECT_EQ(46068, captured.ports[0]);
+    // one flow, the client socket
+    EXPECT_EQ(1u, stats.getFlows().size());
+    EXPECT_EQ(0, monitor->poll(50));
+
+    // the datagrams still reach the server
+    char buffer[16];
+    EXPECT_EQ(5, server.recv(buffer, sizeof(buffer)));
+    EXPECT_EQ(0, monitor->getDropCount());
+}
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,127 @@
+// Peer Table Tests -- per-peer state keyed by source endpoint
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <peer_table.h>
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <string.h>
+
+using namespace udp_client_server;
+
+namespace
+{
+
+struct sockaddr_storage ipv4(const char *address, uint16_t port)
+{
+    struct sockaddr_storage result;
+    memset(&result, 0, sizeof(result));
+    struct sockaddr_in *in(reinterpret_cast<struct sockaddr_in *>(&result));
+    in->sin_family = AF_INET;
+    in->sin_port = htons(port);
+    inet_pton(AF_INET, address, &in->sin_addr);
+    return result;
+}
+
+struct Counter
+{
+    int                 value;
+};
+
+} // no name namespace
+
+
+TEST(PeerKey, RoundTripsIpv4AndIpv6Addresses)
+{
+    struct sockaddr_storage const addr(ipv4("10.1.2.3", 7000));
+    PeerKey const key(reinterpret_cast<const struct sockaddr *>(&addr));
+    EXPECT_EQ("10.1.2.3:7000", key.toString());
+
+    struct sockaddr_storage back;
+    ASSERT_EQ(static_cast<socklen_t>(sizeof(struct sockaddr_in)), key.toSockaddr(back));
+    EXPECT_EQ(key, PeerKey(reinterpret_cast<const struct sockaddr *>(&back)));
+
+    struct sockaddr_in6 in6;
+    memset(&in6, 0, sizeof(in6));
+    in6.sin6_family = AF_INET6;
+    in6.sin6_port = htons(7001);
+    inet_pton(AF_INET6, "fe80::1", &in6.sin6_addr);
+    PeerKey const key6(reinterpret_cast<const struct sockaddr *>(&in6));
+    EXPECT_EQ("[fe80::1]:7001", key6.toString());
+    EXPECT_NE(key, key6);
+}
+
+TEST(PeerKey, DistinguishesPorts)
+{
+    struct sockaddr_storage const a(ipv4("10.1.2.3", 7000));
+    struct sockaddr_storage const b(ipv4("10.1.2.3", 7001));
+    PeerKey const ka(reinterpret_cast<const struct sockaddr *>(&a));
+    PeerKey const kb(reinterpret_cast<const struct sockaddr *>(&b));
+    EXPECT_NE(ka, kb);
+    EXPECT_NE(PeerKeyHash()(ka), PeerKeyHash()(kb));
+}
+
+TEST(PeerTable, AccountsForThePacketsOfEachPeer)
+{
+    PeerTable<Counter> peers(16);
+    struct sockaddr_storage const a(ipv4("10.0.0.1", 5000));
+    struct sockaddr_storage const b(ipv4("10.0.0.2", 5000));
+
+    PeerTable<Counter>::Entry *entry(peers.touch(a, 100, 10));
+    ASSERT_TRUE(entry != NULL);
+    entry->state.value = 7;
+    peers.touch(b, 150, 20);
+    entry = peers.touch(a, 200, 30);
+    ASSERT_TRUE(entry != NULL);
+
+    EXPECT_EQ(2u, peers.size());
+    EXPECT_EQ(100u, entry->first_seen_ns);
+    EXPECT_EQ(200u, entry->last_seen_ns);
+    EXPECT_EQ(2u, entry->packets);
+    EXPECT_EQ(40u, entry->bytes);
+    EXPECT_EQ(7, entry->state.value);
+
+    EXPECT_TRUE(peers.erase(PeerKey(reinterpret_cast<const struct sockaddr *>(&b))));
+    EXPECT_TRUE(peers.find(PeerKey(reinterpret_cast<const struct sockaddr *>(&b))) == NULL);
+    EXPECT_EQ(1u, peers.size());
+}
+
+TEST(PeerTable, RefusesNewPeersWhenFull)
+{
+    PeerTable<Counter> peers(4);
+    size_t const capacity(peers.capacity());
+    for(size_t i(0); i < capacity; ++i)
+    {
+        EXPECT_TRUE(peers.touch(ipv4("10.0.0.1", static_cast<uint16_t>(1000 + i)), 1, 1) != NULL);
+    }
+    EXPECT_TRUE(peers.touch(ipv4("10.0.0.2", 1000), 1, 1) == NULL);
+    // known peers are still accounted for
+    EXPECT_TRUE(peers.touch(ipv4("10.0.0.1", 1000), 2, 1) != NULL);
+}
+
+TEST(PeerTable, EvictsIdlePeers)
+{
+    PeerTable<Counter> peers(16);
+    peers.touch(ipv4("10.0.0.1", 5000), 100, 1);
+    peers.touch(ipv4("10.0.0.2", 5000), 900, 1);
+
+    EXPECT_EQ(1u, peers.evictIdle(1000, 500));
+    EXPECT_EQ(1u, peers.size());
+    struct sockaddr_storage const kept(ipv4("10.0.0.2", 5000));
+    EXPECT_TRUE(peers.find(PeerKey(reinterpret_cast<const struct sockaddr *>(&kept))) != NULL);
+}
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,217 @@
+// Pub/Sub Tests -- topics, subscriptions and their cookies
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <pubsub.h>
+#include <gtest/gtest.h>
+#include "test_helpers.h"
+#include <arpa/inet.h>
+#include <string.h>
+#include <string>
+
+using namespace udp_client_server;
+
+namespace
+{
+
+const uint32_t ODOMETRY = topicId("/robot/odometry");
+const uint32_t STATUS = topicId("/robot/status");
+
+void record(void *user, uint32_t topic, const char *msg, size_t size)
+{
+    static_cast<void>(topic);
+    static_cast<std::string *>(user)->assign(msg, size);
+}
+
+/** \brief Run the subscription handshake of \p subscriber with \p publisher.
+ */
+void handshake(Publisher& publisher, UdpServer& publisher_socket, Subscriber& subscriber, UdpServer& subscriber_socket)
+{
+    waitReadable(publisher_socket.getSocket());
+    publisher.poll(1);
+    waitReadable(subscriber_socket.getSocket());
+    subscriber.poll(1);
+    waitReadable(publisher_socket.getSocket());
+    publisher.poll(1);
+}
+
+int sendControl(UdpClient& client, uint8_t kind, uint32_t topic, const char *cookie)
+{
+    char buffer[PubSubHeader::SIZE + PubSubHeader::COOKIE_SIZE];
+    PubSubHeader header;
+    header.kind = kind;
+    header.flags = 0;
+    header.sequence = 0;
+    header.topic = topic;
+    header.write(buffer);
+    memcpy(buffer + PubSubHeader::SIZE, cookie, PubSubHeader::COOKIE_SIZE);
+    return client.send(buffer, sizeof(buffer));
+}
+
+} // no name namespace
+
+
+TEST(Publisher, SubscriptionStartsAfterTheChallenge)
+{
+    UdpServer publisher_socket("127.0.0.1", 46066);
+    UdpServer subscriber_socket("127.0.0.2", 46066);
+    Publisher publisher(publisher_socket);
+    Subscriber subscriber(subscriber_socket, "127.0.0.1", 46066);
+
+    std::string received;
+    ASSERT_EQ(0, subscriber.subscribe(ODOMETRY, record, &received));
+    waitReadable(publisher_socket.getSocket());
+    EXPECT_EQ(0, publisher.poll(1));
+    EXPECT_EQ(0u, publisher.getSubscriberCount(ODOMETRY));
+
+    waitReadable(subscriber_socket.getSocket());
+    EXPECT_EQ(0, subscriber.poll(1));
+    waitReadable(publisher_socket.getSocket());
+    EXPECT_EQ(1, publisher.poll(1));
+    EXPECT_EQ(1u, publisher.getSubscriberCount(ODOMETRY));
+
+    EXPECT_EQ(1, publisher.publish(ODOMETRY, "pose", 4));
+    waitReadable(subscriber_socket.getSocket());
+    EXPECT_EQ(1, subscriber.poll(1));
+    EXPECT_EQ("pose", received);
+}
+
+TEST(Publisher, IgnoresCookiesOfOtherAddresses)
+{
+    UdpServer publisher_socket("127.0.0.1", 46066);
+    UdpServer subscriber_socket("127.0.0.2", 46066);
+    Publisher publisher(publisher_socket);
+    UdpClient client("127.0.0.1", 46066);
+
+    char const zero[PubSubHeader::COOKIE_SIZE] = {};
+    ASSERT_GT(sendControl(client, PubSubHeader::SUBSCRIBE, ODOMETRY, zero), 0);
+    waitReadable(publisher_socket.getSocket());
+    EXPECT_EQ(0, publisher.poll(1));
+
+    // the challenge went back to the client, get the cookie of its address
+    char challenge[64];
+    waitReadable(client.getSocket());
+    ASSERT_EQ(static_cast<int>(PubSubHeader::SIZE + PubSubHeader::COOKIE_SIZE),
+              ::recv(client.getSocket(), challenge, sizeof(challenge), 0));
+    PubSubHeader header;
+    ASSERT_TRUE(header.read(challenge, sizeof(challenge)));
+    EXPECT_EQ(PubSubHeader::CHALLENGE, header.kind);
+
+    // the cookie of the client is worthless from another address
+    UdpClient other("127.0.0.1", 46066);
+    ASSERT_GT(sendControl(other, PubSubHeader::SUBSCRIBE, ODOMETRY, challenge + PubSubHeader::SIZE), 0);
+    waitReadable(publisher_socket.getSocket());
+    EXPECT_EQ(0, publisher.poll(1));
+    EXPECT_EQ(0u, publisher.getSubscriberCount(ODOMETRY));
+
+    ASSERT_GT(sendControl(client, PubSubHeader::SUBSCRIBE, ODOMETRY, challenge + PubSubHeader::SIZE), 0);
+    waitReadable(publisher_socket.getSocket());
+    EXPECT_EQ(1, publisher.poll(1));
+    EXPECT_EQ(1u, publisher.getSubscriberCount(ODOMETRY));
+}
+
+TEST(Publisher, CapsTheMembersOfATopic)
+{
+    UdpServer publisher_socket("127.0.0.1", 46066);
+    UdpServer first_socket("127.0.0.2", 46066);
+    UdpServer second_socket("127.0.0.3", 46066);
+    Publisher publisher(publisher_socket, 16, 1);
+    Subscriber first(first_socket, "127.0.0.1", 46066);
+    Subscriber second(second_socket, "127.0.0.1", 46066);
+
+    std::string received;
+    ASSERT_EQ(0, first.subscribe(ODOMETRY, record, &received));
+    handshake(publisher, publisher_socket, first, first_socket);
+    ASSERT_EQ(0, second.subscribe(ODOMETRY, record, &received));
+    handshake(publisher, publisher_socket, second, second_socket);
+
+    EXPECT_EQ(1u, publisher.getSubscriberCount(ODOMETRY));
+}
+
+TEST(Publisher, RemovesExpiredTopics)
+{
+    UdpServer publisher_socket("127.0.0.1", 46066);
+    UdpServer subscriber_socket("127.0.0.2", 46066);
+    Publisher publisher(publisher_socket, 1);
+    publisher.setSubscriptionTimeout(1000000000ULL);
+    Subscriber subscriber(subscriber_socket, "127.0.0.1", 46066);
+
+    std::string received;
+    ASSERT_EQ(0, subscriber.subscribe(ODOMETRY, record, &received));
+    handshake(publisher, publisher_socket, subscriber, subscriber_socket);
+    ASSERT_EQ(1u, publisher.getSubscriberCount(ODOMETRY));
+
+    publisher.poll(5000000000ULL);
+    EXPECT_EQ(0u, publisher.getSubscriberCount(ODOMETRY));
+
+    // the table holds a single topic: the expired one must be gone
+    ASSERT_EQ(0, subscriber.unsubscribe(ODOMETRY));
+    ASSERT_EQ(0, subscriber.subscribe(STATUS, record, &received));
+    waitReadable(publisher_socket.getSocket());
+    publisher.poll(5000000001ULL);
+    waitReadable(subscriber_socket.getSocket());
+    subscriber.poll(5000000001ULL);
+    waitReadable(publisher_socket.getSocket());
+    publisher.poll(5000000001ULL);
+    EXPECT_EQ(1u, publisher.getSubscriberCount(STATUS));
+}
+
+TEST(Publisher, PollReadsAtMostMaxMessages)
+{
+    UdpServer publisher_socket("127.0.0.1", 46066);
+    Publisher publisher(publisher_socket);
+    UdpClient client("127.0.0.1", 46066);
+
+    for(int i(0); i < 3; ++i)
+    {
+        ASSERT_EQ(4, client.send("junk", 4));
+    }
+    waitReadable(publisher_socket.getSocket());
+    EXPECT_EQ(0, publisher.poll(1, 1));
+
+    int left(0);
+    char buffer[16];
+    while(::recv(publisher_socket.getSocket(), buffer, sizeof(buffer), MSG_DONTWAIT) > 0)
+    {
+        ++left;
+    }
+    EXPECT_EQ(2, left);
+}
+
+TEST(Subscriber, PollReadsAtMostMaxMessages)
+{
+    UdpServer subscriber_socket("127.0.0.2", 46066);
+    Subscriber subscriber(subscriber_socket, "127.0.0.1", 46066);
+    UdpClient client("127.0.0.2", 46066);
+
+    // datagrams which are not delivered count against the bound too
+    for(int i(0); i < 3; ++i)
+    {
+        ASSERT_EQ(4, client.send("junk", 4));
+    }
+    waitReadable(subscriber_socket.getSocket());
+    EXPECT_EQ(0, subscriber.poll(1, 2));
+
+    int left(0);
+    char buffer[16];
+    while(::recv(subscriber_socket.getSocket(), buffer, sizeof(buffer), MSG_DONTWAIT) > 0)
+    {
+        ++left;
+    }
+    EXPECT_EQ(1, left);
+}
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,172 @@
+// Rate Limiter Tests -- per-peer token buckets
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <rate_limiter.h>
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+
+using namespace udp_client_server;
+
+namespace
+{
+
+struct sockaddr_storage peer(uint16_t port)
+{
+    struct sockaddr_storage addr;
+    memset(&addr, 0, sizeof(addr));
+    struct sockaddr_in *in(reinterpret_cast<struct sockaddr_in *>(&addr));
+    in->sin_family = AF_INET;
+    in->sin_port = htons(port);
+    in->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return addr;
+}
+
+/** \brief Wait until \p server has a datagram to read.
+ *
+ * On the loopback the datagrams sent are queued before send() returns,
+ * so once one is there they all are.
+ */
+bool readable(UdpServer& server)
+{
+    struct pollfd fd;
+    fd.fd = server.getSocket();
+    fd.events = POLLIN;
+    fd.revents = 0;
+    return ::poll(&fd, 1, 1000) == 1;
+}
+
+} // no name namespace
+
+
+TEST(PeerRateLimiter, DefaultBurstAdmitsNewPeers)
+{
+    RateLimit limit;
+    limit.packets_per_sec = 10.0;
+    PeerRateLimiter limiter(limit, 16);
+
+    // a burst of 0 is one second of the rate: 10 packets
+    for(int i(0); i < 10; ++i)
+    {
+        EXPECT_TRUE(limiter.admit(peer(1000), 100, 1000000000ULL)) << i;
+    }
+    EXPECT_FALSE(limiter.admit(peer(1000), 100, 1000000000ULL));
+
+    // another peer has its own full bucket
+    EXPECT_TRUE(limiter.admit(peer(1001), 100, 1000000000ULL));
+
+    // 100 ms refill one token
+    EXPECT_TRUE(limiter.admit(peer(1000), 100, 1100000000ULL));
+    EXPECT_FALSE(limiter.admit(peer(1000), 100, 1100000000ULL));
+    EXPECT_EQ(2U, limiter.getDroppedCount());
+}
+
+TEST(PeerRateLimiter, SlowRateStillAdmitsTheFirstPacket)
+{
+    RateLimit limit;
+    limit.packets_per_sec = 0.5;
+    limit.bytes_per_sec = 100.0;
+    PeerRateLimiter limiter(limit, 16);
+
+    EXPECT_TRUE(limiter.admit(peer(1000), 1000, 0));
+    EXPECT_FALSE(limiter.admit(peer(1000), 10, 0));
+}
+
+TEST(PeerRateLimiter, ByteBudget)
+{
+    RateLimit limit;
+    limit.bytes_per_sec = 1000.0;
+    limit.byte_burst = 1500.0;
+    PeerRateLimiter limiter(limit, 16);
+
+    EXPECT_TRUE(limiter.admit(peer(1000), 1000, 0));
+    EXPECT_FALSE(limiter.admit(peer(1000), 1000, 0));
+    EXPECT_TRUE(limiter.admit(peer(1000), 500, 0));
+    EXPECT_TRUE(limiter.admit(peer(1000), 1000, 1000000000ULL));
+}
+
+TEST(PeerRateLimiter, FullTableDropsNewPeers)
+{
+    RateLimit limit;
+    limit.packets_per_sec = 10.0;
+    PeerRateLimiter limiter(limit, 2);
+
+    EXPECT_TRUE(limiter.admit(peer(1000), 10, 0));
+    EXPECT_TRUE(limiter.admit(peer(1001), 10, 0));
+    EXPECT_FALSE(limiter.admit(peer(1002), 10, 0));
+    EXPECT_EQ(1U, limiter.getUntrackedDropCount());
+    EXPECT_EQ(2U, limiter.evictIdle(2000000000ULL, 1000000000ULL));
+    EXPECT_TRUE(limiter.admit(peer(1002), 10, 2000000000ULL));
+}
+
+TEST(PeerRateLimiter, FloodDoesNotKeepRecvBusy)
+{
+    UdpServer server("127.0.0.1", 46059);
+    UdpClient client("127.0.0.1", 46059);
+    RateLimit limit;
+    limit.packets_per_sec = 1.0;
+    limit.packet_burst = 1.0;
+    PeerRateLimiter limiter(limit, 16);
+
+    size_t const flood(PeerRateLimiter::MAX_REJECTED_PER_CALL * 2 + 1);
+    for(size_t i(0); i < flood; ++i)
+    {
+        ASSERT_EQ(1, client.send("x", 1));
+    }
+    ASSERT_TRUE(readable(server));
+
+    char buffer[16];
+    EXPECT_EQ(1, limiter.recv(server, buffer, sizeof(buffer)));
+
+    errno = 0;
+    EXPECT_EQ(-1, limiter.recv(server, buffer, sizeof(buffer)));
+    EXPECT_EQ(EAGAIN, errno);
+    EXPECT_EQ(PeerRateLimiter::MAX_REJECTED_PER_CALL, limiter.getDroppedCount());
+    EXPECT_GT(server.nextDatagramSize(), 0);
+
+    EXPECT_EQ(-1, limiter.recv(server, buffer, sizeof(buffer)));
+    EXPECT_EQ(PeerRateLimiter::MAX_REJECTED_PER_CALL * 2, limiter.getDroppedCount());
+}
+
+TEST(PeerRateLimiter, DeferredMessagesComeAfterTheSocketIsDrained)
+{
+    UdpServer server("127.0.0.1", 46059);
+    UdpClient client("127.0.0.1", 46059);
+    RateLimit limit;
+    limit.packets_per_sec = 1.0;
+    limit.packet_burst = 1.0;
+    PeerRateLimiter limiter(limit, 16, PeerRateLimiter::OVER_BUDGET_DEFER);
+
+    ASSERT_EQ(1, client.send("a", 1));
+    ASSERT_EQ(1, client.send("b", 1));
+    ASSERT_EQ(1, client.send("c", 1));
+    ASSERT_TRUE(readable(server));
+
+    char buffer[16];
+    ASSERT_EQ(1, limiter.recv(server, buffer, sizeof(buffer)));
+    EXPECT_EQ('a', buffer[0]);
+    ASSERT_EQ(1, limiter.recv(server, buffer, sizeof(buffer)));
+    EXPECT_EQ('b', buffer[0]);
+    ASSERT_EQ(1, limiter.recv(server, buffer, sizeof(buffer)));
+    EXPECT_EQ('c', buffer[0]);
+    EXPECT_EQ(-1, limiter.recv(server, buffer, sizeof(buffer)));
+    EXPECT_EQ(0U, limiter.getDroppedCount());
+}
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,104 @@
+// Receive Buffer Pool Tests -- size-classed buffers and truncation
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <receive_buffer_pool.h>
+#include <gtest/gtest.h>
+#include "test_helpers.h"
+#include <errno.h>
+#include <string>
+
+using namespace udp_client_server;
+
+TEST(ReceiveBufferPool, RoundsSizesUpToTheirClass)
+{
+    EXPECT_EQ(0u, ReceiveBufferPool::classOf(1));
+    EXPECT_EQ(0u, ReceiveBufferPool::classOf(256));
+    EXPECT_EQ(1u, ReceiveBufferPool::classOf(257));
+    EXPECT_EQ(ReceiveBufferPool::CLASS_COUNT - 1, ReceiveBufferPool::classOf(65507));
+    EXPECT_GE(ReceiveBufferPool::MAX_CLASS_SIZE, 65507u);
+
+    ReceiveBufferPool pool;
+    ReceiveBuffer buffer;
+    ASSERT_TRUE(pool.acquire(1000, buffer));
+    EXPECT_EQ(1024u, buffer.capacity);
+    pool.release(buffer);
+    EXPECT_TRUE(buffer.data == NULL);
+    EXPECT_FALSE(pool.acquire(ReceiveBufferPool::MAX_CLASS_SIZE + 1, buffer));
+}
+
+TEST(ReceiveBufferPool, ReusesReleasedBuffers)
+{
+    ReceiveBufferPool pool;
+    ReceiveBuffer buffer;
+    ASSERT_TRUE(pool.acquire(300, buffer));
+    char *const data(buffer.data);
+    pool.release(buffer);
+    ASSERT_TRUE(pool.acquire(500, buffer));
+    EXPECT_EQ(data, buffer.data);
+    pool.release(buffer);
+}
+
+TEST(ReceiveBufferPool, PeekModeNeverTruncates)
+{
+    UdpServer server("127.0.0.1", 46054);
+    UdpClient client("127.0.0.1", 46054);
+    ReceiveBufferPool pool(ReceiveBufferPool::RECV_PEEK_SIZE);
+
+    std::string const large(5000, 'x');
+    ASSERT_EQ(5000, client.send(large.data(), large.size()));
+    waitReadable(server.getSocket());
+    ReceiveBuffer buffer;
+    ASSERT_EQ(5000, pool.recv(server, buffer));
+    EXPECT_FALSE(buffer.truncated);
+    EXPECT_EQ(5000u, buffer.size);
+    EXPECT_EQ(8192u, buffer.capacity);
+    EXPECT_EQ(0u, pool.getTruncatedCount());
+    pool.release(buffer);
+
+    EXPECT_EQ(-1, pool.recv(server, buffer));
+    EXPECT_EQ(EAGAIN, errno);
+}
+
+TEST(ReceiveBufferPool, DetectModeLearnsFromTruncation)
+{
+    UdpServer server("127.0.0.1", 46054);
+    UdpClient client("127.0.0.1", 46054);
+    ReceiveBufferPool pool(ReceiveBufferPool::RECV_DETECT_TRUNC);
+    EXPECT_EQ(256u, pool.getPreferredSize());
+
+    std::string const large(5000, 'x');
+    ReceiveBuffer buffer;
+    for(int i(0); i < 2; ++i)
+    {
+        ASSERT_EQ(5000, client.send(large.data(), large.size()));
+    }
+    waitReadable(server.getSocket());
+
+    // the first one is cut to the preferred size, the second one fits
+    ASSERT_EQ(5000, pool.recv(server, buffer));
+    EXPECT_TRUE(buffer.truncated);
+    EXPECT_EQ(256u, buffer.size);
+    EXPECT_EQ(1u, pool.getTruncatedCount());
+    EXPECT_EQ(8192u, pool.getPreferredSize());
+
+    ASSERT_EQ(5000, pool.recv(server, buffer));
+    EXPECT_FALSE(buffer.truncated);
+    EXPECT_EQ(5000u, buffer.size);
+    pool.release(buffer);
+}
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,169 @@
+// Receive Pipeline Tests -- per-flow ordering of the decoded datagrams
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <receive_pipeline.h>
+#include <monotonic_clock.h>
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <string.h>
+#include <map>
+#include <vector>
+
+using namespace udp_client_server;
+
+namespace
+{
+
+struct Decoded
+{
+    uint32_t            sequence;
+};
+
+void *decodeSequence(void *user, const UdpPacketView& packet)
+{
+    static_cast<void>(user);
+    if(packet.size < sizeof(uint32_t))
+    {
+        return NULL;
+    }
+    uint32_t sequence;
+    memcpy(&sequence, packet.data, sizeof(sequence));
+    Decoded *decoded(new Decoded);
+    decoded->sequence = ntohl(sequence);
+    return decoded;
+}
+
+void sendSequence(UdpClient& client, uint32_t sequence)
+{
+    uint32_t const n(htonl(sequence));
+    ASSERT_EQ(4, client.send(reinterpret_cast<const char *>(&n), sizeof(n)));
+}
+
+/** \brief Pop \p count results, or as many as arrive within 5 seconds.
+ */
+std::vector<PipelineResult> popResults(ReceivePipeline& pipeline, size_t count)
+{
+    std::vector<PipelineResult> results;
+    uint64_t const deadline(monotonicNowNs() + 5000000000ULL);
+    while(results.size() < count && monotonicNowNs() < deadline)
+    {
+        PipelineResult result;
+        if(pipeline.popResult(result))
+        {
+            results.push_back(result);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    return results;
+}
+
+} // no name namespace
+
+
+TEST(ReceivePipeline, RejectsInvalidParameters)
+{
+    EXPECT_THROW(ReceivePipeline(0, decodeSequence, NULL), UdpClientServerRuntimeError);
+    EXPECT_THROW(ReceivePipeline(2, decodeSequence, NULL, 0), UdpClientServerRuntimeError);
+    EXPECT_THROW(ReceivePipeline(2, decodeSequence, NULL, 16, 0), UdpClientServerRuntimeError);
+}
+
+TEST(ReceivePipeline, StartTwiceFails)
+{
+    ReceivePipeline pipeline(2, decodeSequence, NULL, 16);
+    EXPECT_EQ(0, pipeline.start());
+    errno = 0;
+    EXPECT_EQ(-1, pipeline.start());
+    EXPECT_EQ(EBUSY, errno);
+    pipeline.stop();
+}
+
+TEST(ReceivePipeline, KeepsTheOrderOfEachFlow)
+{
+    UdpServer server("127.0.0.1", 46071);
+    UdpClient first("127.0.0.1", 46071);
+    UdpClient second("127.0.0.1", 46071);
+    // enough slots for all the results to wait in the result queue
+    ReceivePipeline pipeline(4, decodeSequence, NULL, 256);
+    ASSERT_EQ(0, pipeline.start());
+
+    uint32_t const COUNT = 100;
+    for(uint32_t i(0); i < COUNT; ++i)
+    {
+        sendSequence(first, i);
+        sendSequence(second, i);
+    }
+
+    // run the receive stage here so no datagram is dropped
+    size_t handed(0);
+    uint64_t const deadline(monotonicNowNs() + 5000000000ULL);
+    while(handed < COUNT * 2 && monotonicNowNs() < deadline)
+    {
+        int const r(pipeline.receive(server));
+        ASSERT_GE(r, 0);
+        handed += static_cast<size_t>(r);
+        if(r == 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+    ASSERT_EQ(COUNT * 2, handed);
+
+    std::vector<PipelineResult> const results(popResults(pipeline, COUNT * 2));
+    pipeline.stop();
+    ASSERT_EQ(COUNT * 2, results.size());
+    EXPECT_EQ(COUNT * 2, pipeline.getDecodedCount());
+    EXPECT_EQ(0u, pipeline.getDroppedCount());
+
+    std::map<uint16_t, uint32_t> next;
+    for(size_t i(0); i < results.size(); ++i)
+    {
+        Decoded *decoded(static_cast<Decoded *>(results[i].message));
+        uint32_t& expected(next[results[i].flow.port]);
+        EXPECT_EQ(expected, decoded->sequence);
+        expected = decoded->sequence + 1;
+        delete decoded;
+    }
+    EXPECT_EQ(2u, next.size());
+}
+
+TEST(ReceivePipeline, ReceiveThreadFeedsTheWorkers)
+{
+    UdpServer server("127.0.0.1", 46071);
+    UdpClient client("127.0.0.1", 46071);
+    ReceivePipeline pipeline(2, decodeSequence, NULL, 64);
+    ASSERT_EQ(0, pipeline.start(&server));
+
+    for(uint32_t i(0); i < 10; ++i)
+    {
+        sendSequence(client, i);
+    }
+    std::vector<PipelineResult> const results(popResults(pipeline, 10));
+    pipeline.stop();
+    ASSERT_EQ(10u, results.size());
+    for(size_t i(0); i < results.size(); ++i)
+    {
+        Decoded *decoded(static_cast<Decoded *>(results[i].message));
+        EXPECT_EQ(i, decoded->sequence);
+        delete decoded;
+    }
+}
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,138 @@
+// Send Queue Tests -- bounded queue of datagrams waiting for the socket
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <send_queue.h>
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace udp_client_server;
+
+namespace
+{
+
+bool pushString(SendQueue& queue, const std::string& message)
+{
+    struct iovec iov;
+    iov.iov_base = const_cast<char *>(message.data());
+    iov.iov_len = message.size();
+    return queue.push(&iov, 1);
+}
+
+std::string front(const SendQueue& queue)
+{
+    struct iovec iov;
+    if(queue.peek(&iov, 1) != 1)
+    {
+        return std::string();
+    }
+    return std::string(static_cast<const char *>(iov.iov_base), iov.iov_len);
+}
+
+} // no name namespace
+
+
+TEST(SendQueue, KeepsMessagesInOrder)
+{
+    SendQueue queue(4, 16, SEND_QUEUE_REJECT);
+    EXPECT_TRUE(pushString(queue, "one"));
+    EXPECT_TRUE(pushString(queue, "two"));
+    EXPECT_TRUE(pushString(queue, "three"));
+    EXPECT_EQ(3u, queue.size());
+
+    struct iovec iov[4];
+    ASSERT_EQ(3u, queue.peek(iov, 4));
+    EXPECT_EQ(5u, iov[2].iov_len);
+
+    EXPECT_EQ("one", front(queue));
+    queue.pop(1);
+    EXPECT_EQ("two", front(queue));
+    queue.pop(2);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(SendQueue, GathersBuffersInOneSlot)
+{
+    SendQueue queue(2, 16, SEND_QUEUE_REJECT);
+    char header[] = "hdr:";
+    char payload[] = "body";
+    struct iovec iov[2];
+    iov[0].iov_base = header;
+    iov[0].iov_len = 4;
+    iov[1].iov_base = payload;
+    iov[1].iov_len = 4;
+    ASSERT_TRUE(queue.push(iov, 2));
+    EXPECT_EQ("hdr:body", front(queue));
+}
+
+TEST(SendQueue, RejectsMessagesLargerThanASlot)
+{
+    SendQueue queue(4, 8, SEND_QUEUE_DROP_NEWEST);
+    EXPECT_EQ(8u, queue.slotSize());
+    EXPECT_TRUE(pushString(queue, "12345678"));
+    EXPECT_FALSE(pushString(queue, "123456789"));
+    EXPECT_EQ(1u, queue.size());
+    EXPECT_EQ(0u, queue.getDroppedCount());
+}
+
+TEST(SendQueue, DropNewestWhenFull)
+{
+    SendQueue queue(2, 8, SEND_QUEUE_DROP_NEWEST);
+    EXPECT_TRUE(pushString(queue, "a"));
+    EXPECT_TRUE(pushString(queue, "b"));
+    EXPECT_TRUE(pushString(queue, "c"));
+    EXPECT_EQ(2u, queue.size());
+    EXPECT_EQ(1u, queue.getDroppedCount());
+    EXPECT_EQ("a", front(queue));
+}
+
+TEST(SendQueue, DropOldestWhenFull)
+{
+    SendQueue queue(2, 8, SEND_QUEUE_DROP_OLDEST);
+    EXPECT_TRUE(pushString(queue, "a"));
+    EXPECT_TRUE(pushString(queue, "b"));
+    EXPECT_TRUE(pushString(queue, "c"));
+    EXPECT_EQ(2u, queue.size());
+    EXPECT_EQ(1u, queue.getDroppedCount());
+    EXPECT_EQ("b", front(queue));
+    queue.pop(1);
+    EXPECT_EQ("c", front(queue));
+}
+
+TEST(SendQueue, RejectWhenFull)
+{
+    SendQueue queue(2, 8, SEND_QUEUE_REJECT);
+    EXPECT_TRUE(pushString(queue, "a"));
+    EXPECT_TRUE(pushString(queue, "b"));
+    EXPECT_FALSE(pushString(queue, "c"));
+    EXPECT_EQ(0u, queue.getDroppedCount());
+    EXPECT_EQ("a", front(queue));
+}
+
+TEST(SendQueue, WrapsAroundTheRing)
+{
+    SendQueue queue(3, 8, SEND_QUEUE_REJECT);
+    for(int i(0); i < 10; ++i)
+    {
+        std::string const message(1, static_cast<char>('a' + i));
+        ASSERT_TRUE(pushString(queue, message));
+        EXPECT_EQ(message, front(queue));
+        queue.pop(1);
+    }
+    EXPECT_TRUE(queue.empty());
+}
+
+// vim: ts=4 sw=4 et
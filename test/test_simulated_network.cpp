@@ -0,0 +1,151 @@
+// Simulated Network Tests -- behavior of the in-process network
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <simulated_network.h>
+#include <gtest/gtest.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <string>
+
+using namespace udp_client_server;
+
+namespace
+{
+
+/** \brief Code written once for the real and the simulated sockets.
+ */
+template<typename Client, typename Server>
+std::string roundTrip(Client& client, Server& server, const std::string& msg)
+{
+    if(client.send(msg.c_str(), msg.size()) != static_cast<int>(msg.size()))
+    {
+        return "send failed";
+    }
+    char buffer[256];
+    int const r(server.timedRecv(buffer, sizeof(buffer), 1000));
+    if(r < 0)
+    {
+        return "timed out";
+    }
+    return std::string(buffer, r);
+}
+
+} // no name namespace
+
+
+TEST(SimulatedNetwork, SameCodeRunsOnRealAndSimulatedSockets)
+{
+    UdpServer real_server("127.0.0.1", 46056);
+    UdpClient real_client("127.0.0.1", 46056);
+    EXPECT_EQ("real", roundTrip(real_client, real_server, "real"));
+
+    SimulatedNetwork network;
+    SimulatedUdpServer server(network, "127.0.0.1", 46056);
+    SimulatedUdpClient client(network, "127.0.0.1", 46056);
+    EXPECT_EQ("simulated", roundTrip(client, server, "simulated"));
+}
+
+TEST(SimulatedNetwork, NegativeWaitBlocksUntilTheNextMessage)
+{
+    SimulatedNetwork network;
+    NetworkImpairment impairment;
+    impairment.latency_ns = 5000000000ULL;
+    network.setImpairment(impairment);
+    SimulatedUdpServer server(network, "127.0.0.1", 7000);
+    SimulatedUdpClient client(network, "127.0.0.1", 7000);
+
+    ASSERT_EQ(5, client.send("hello", 5));
+    char buffer[16];
+    EXPECT_EQ(5, server.timedRecv(buffer, sizeof(buffer), -1));
+    EXPECT_EQ(5000000000ULL, network.now());
+
+    // nothing in flight: waiting forever would hang, it fails instead
+    errno = 0;
+    EXPECT_EQ(-1, server.timedRecv(buffer, sizeof(buffer), -1));
+    EXPECT_EQ(EAGAIN, errno);
+    EXPECT_EQ(5000000000ULL, network.now());
+
+    // a zero wait returns right away
+    ASSERT_EQ(5, client.send("hello", 5));
+    EXPECT_EQ(-1, server.timedRecv(buffer, sizeof(buffer), 0));
+    EXPECT_EQ(5000000000ULL, network.now());
+}
+
+TEST(SimulatedNetwork, MaxPayloadFollowsTheMtuAndFamily)
+{
+    SimulatedNetwork network;
+    SimulatedUdpClient v4(network, "127.0.0.1", 7000);
+    SimulatedUdpClient v6(network, "::1", 7000);
+    EXPECT_EQ(1472U, v4.maxPayload());
+    EXPECT_EQ(1452U, v6.maxPayload());
+
+    network.setMtu(1280);
+    EXPECT_EQ(1252U, v4.maxPayload());
+    EXPECT_EQ(1232U, v6.maxPayload());
+}
+
+TEST(SimulatedNetwork, RecvFromTellsClientsApart)
+{
+    SimulatedNetwork network;
+    SimulatedUdpServer server(network, "0.0.0.0", 7000);
+    SimulatedUdpClient a(network, "127.0.0.1", 7000);
+    SimulatedUdpClient b(network, "127.0.0.1", 7000);
+    ASSERT_EQ(1, a.send("a", 1));
+    ASSERT_EQ(1, b.send("b", 1));
+    network.runUntilIdle();
+
+    char buffer[16];
+    struct sockaddr_storage from_a;
+    struct sockaddr_storage from_b;
+    socklen_t len_a(sizeof(from_a));
+    socklen_t len_b(sizeof(from_b));
+    ASSERT_EQ(1, server.recvFrom(buffer, sizeof(buffer), &from_a, &len_a));
+    EXPECT_EQ('a', buffer[0]);
+    ASSERT_EQ(1, server.recvFrom(buffer, sizeof(buffer), &from_b, &len_b));
+    EXPECT_EQ('b', buffer[0]);
+    ASSERT_EQ(sizeof(struct sockaddr_in), len_a);
+    EXPECT_NE(reinterpret_cast<struct sockaddr_in *>(&from_a)->sin_port
+            , reinterpret_cast<struct sockaddr_in *>(&from_b)->sin_port);
+    EXPECT_EQ(2U, network.getStats().delivered);
+}
+
+TEST(SimulatedNetwork, RetargetedClientReachesTheOtherServer)
+{
+    SimulatedNetwork network;
+    SimulatedUdpServer first(network, "127.0.0.1", 7000);
+    SimulatedUdpServer second(network, "127.0.0.1", 7001);
+    SimulatedUdpClient client(network, "127.0.0.1", 7000);
+    ASSERT_EQ(0, client.setDestination("127.0.0.1", 7001));
+    ASSERT_EQ(1, client.send("x", 1));
+    network.runUntilIdle();
+
+    char buffer[16];
+    EXPECT_EQ(-1, first.recv(buffer, sizeof(buffer)));
+    EXPECT_EQ(1, second.recv(buffer, sizeof(buffer)));
+}
+
+TEST(SimulatedNetwork, UnboundDestinationIsUnroutable)
+{
+    SimulatedNetwork network;
+    SimulatedUdpClient client(network, "127.0.0.1", 7000);
+    ASSERT_EQ(1, client.send("x", 1));
+    network.runUntilIdle();
+    EXPECT_EQ(1U, network.getStats().unroutable);
+}
+
+// vim: ts=4 sw=4 et
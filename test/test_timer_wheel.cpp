@@ -0,0 +1,116 @@
+// Timer Wheel Tests -- items held until their deadline
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <timer_wheel.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace udp_client_server;
+
+namespace
+{
+
+struct Collect
+{
+    std::vector<int> *  items;
+
+    void                operator () (int item) const { items->push_back(item); }
+};
+
+} // no name namespace
+
+
+TEST(TimerWheel, ReleasesItemsAtTheirDeadline)
+{
+    TimerWheel<int> wheel(100, 16);
+    std::vector<int> items;
+    Collect collect = { &items };
+    wheel.schedule(350, 2);
+    wheel.schedule(120, 1);
+    EXPECT_EQ(2u, wheel.size());
+
+    EXPECT_EQ(0u, wheel.advance(110, collect));
+    EXPECT_EQ(1u, wheel.advance(200, collect));
+    EXPECT_EQ(0u, wheel.advance(349, collect));
+    EXPECT_EQ(1u, wheel.advance(350, collect));
+    ASSERT_EQ(2u, items.size());
+    EXPECT_EQ(1, items[0]);
+    EXPECT_EQ(2, items[1]);
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheel, KeepsTheInsertionOrderWithinATick)
+{
+    TimerWheel<int> wheel(100, 16);
+    std::vector<int> items;
+    Collect collect = { &items };
+    for(int i(0); i < 5; ++i)
+    {
+        wheel.schedule(500, i);
+    }
+    EXPECT_EQ(5u, wheel.advance(500, collect));
+    ASSERT_EQ(5u, items.size());
+    for(int i(0); i < 5; ++i)
+    {
+        EXPECT_EQ(i, items[i]);
+    }
+}
+
+TEST(TimerWheel, HoldsDeadlinesBeyondOneRevolution)
+{
+    // 4 slots of 100 ns, one revolution is 400 ns
+    TimerWheel<int> wheel(100, 3);
+    std::vector<int> items;
+    Collect collect = { &items };
+    wheel.schedule(1050, 1);
+
+    EXPECT_EQ(0u, wheel.advance(250, collect));
+    EXPECT_EQ(0u, wheel.advance(650, collect));
+    EXPECT_EQ(0u, wheel.advance(1049, collect));
+    EXPECT_EQ(1u, wheel.advance(1050, collect));
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheel, ReleasesEverythingAfterALongJump)
+{
+    TimerWheel<int> wheel(100, 4);
+    std::vector<int> items;
+    Collect collect = { &items };
+    wheel.schedule(100, 1);
+    wheel.schedule(300, 2);
+    wheel.schedule(100000, 3);
+
+    EXPECT_EQ(2u, wheel.advance(5000, collect));
+    EXPECT_EQ(1u, wheel.size());
+    EXPECT_EQ(1u, wheel.advance(100000, collect));
+}
+
+TEST(TimerWheel, ReleasesPastDeadlinesOnTheNextAdvance)
+{
+    TimerWheel<int> wheel(100, 16);
+    std::vector<int> items;
+    Collect collect = { &items };
+    wheel.schedule(1000, 1);
+    EXPECT_EQ(1u, wheel.advance(1000, collect));
+
+    wheel.schedule(200, 2);
+    EXPECT_EQ(1u, wheel.advance(1000, collect));
+    ASSERT_EQ(2u, items.size());
+    EXPECT_EQ(2, items[1]);
+}
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,133 @@
+// Traffic Statistics Tests -- per-flow arrival jitter and sequence loss
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <traffic_stats.h>
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <string.h>
+
+using namespace udp_client_server;
+
+namespace
+{
+
+struct sockaddr_storage source(uint16_t port)
+{
+    struct sockaddr_storage addr;
+    memset(&addr, 0, sizeof(addr));
+    struct sockaddr_in *in(reinterpret_cast<struct sockaddr_in *>(&addr));
+    in->sin_family = AF_INET;
+    in->sin_port = htons(port);
+    in->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return addr;
+}
+
+/** \brief Build the view of a datagram with a 16 bit sequence number first.
+ */
+UdpPacketView datagram(char *payload, uint16_t port, uint16_t sequence, uint64_t timestamp_ns)
+{
+    payload[0] = static_cast<char>(sequence >> 8);
+    payload[1] = static_cast<char>(sequence);
+    UdpPacketView view;
+    memset(&view, 0, sizeof(view));
+    view.data = payload;
+    view.size = 4;
+    view.wire_size = 4;
+    view.source = source(port);
+    view.source_len = sizeof(struct sockaddr_in);
+    view.timestamp_ns = timestamp_ns;
+    return view;
+}
+
+const FlowStats& flow(TrafficStats& stats, uint16_t port)
+{
+    struct sockaddr_storage const addr(source(port));
+    return stats.getFlows().find(PeerKey(reinterpret_cast<const struct sockaddr *>(&addr)))->state;
+}
+
+} // no name namespace
+
+
+TEST(TrafficStats, SteadyArrivalsHaveNoJitter)
+{
+    TrafficStats stats;
+    char payload[4] = {};
+    for(uint16_t i(0); i < 100; ++i)
+    {
+        stats.observe(datagram(payload, 5000, i, 1000000ULL * i));
+    }
+    EXPECT_DOUBLE_EQ(1000000.0, flow(stats, 5000).mean_interarrival_ns);
+    EXPECT_DOUBLE_EQ(0.0, flow(stats, 5000).jitter_ns);
+}
+
+TEST(TrafficStats, JitterIsTheDeviationOfTheInterarrivalTime)
+{
+    TrafficStats stats;
+    char payload[4] = {};
+    uint64_t now(0);
+    for(uint16_t i(0); i < 1000; ++i)
+    {
+        // alternately 1 ms and 3 ms apart: 2 ms on average, 1 ms off
+        now += i % 2 == 0 ? 1000000ULL : 3000000ULL;
+        stats.observe(datagram(payload, 5000, i, now));
+    }
+    EXPECT_NEAR(2000000.0, flow(stats, 5000).mean_interarrival_ns, 100000.0);
+    EXPECT_NEAR(1000000.0, flow(stats, 5000).jitter_ns, 100000.0);
+}
+
+TEST(TrafficStats, CountsLostAndReorderedDatagrams)
+{
+    TrafficStats stats;
+    stats.setSequenceField(0, 2);
+    char payload[4] = {};
+    uint16_t const order[] = { 0, 1, 3, 4, 2, 7, 8 };
+    for(size_t i(0); i < sizeof(order) / sizeof(order[0]); ++i)
+    {
+        stats.observe(datagram(payload, 5000, order[i], 1000000ULL * i));
+    }
+    // 2 arrived late, 5 and 6 never did
+    EXPECT_EQ(2u, flow(stats, 5000).lost);
+    EXPECT_EQ(1u, flow(stats, 5000).reordered);
+}
+
+TEST(TrafficStats, SequenceNumbersWrapAround)
+{
+    TrafficStats stats;
+    stats.setSequenceField(0, 2);
+    char payload[4] = {};
+    stats.observe(datagram(payload, 5000, 0xFFFE, 0));
+    stats.observe(datagram(payload, 5000, 0xFFFF, 1000000));
+    stats.observe(datagram(payload, 5000, 0x0001, 2000000));
+    EXPECT_EQ(1u, flow(stats, 5000).lost);
+    EXPECT_EQ(0u, flow(stats, 5000).reordered);
+}
+
+TEST(TrafficStats, KeepsFlowsApartAndCountsUntracked)
+{
+    TrafficStats stats(2);
+    char payload[4] = {};
+    stats.observe(datagram(payload, 5000, 0, 0));
+    stats.observe(datagram(payload, 5001, 0, 0));
+    stats.observe(datagram(payload, 5002, 0, 0));
+    EXPECT_EQ(2u, stats.getFlows().size());
+    EXPECT_EQ(1u, stats.getUntrackedCount());
+
+    EXPECT_EQ(2u, stats.evictIdle(10000000000ULL, 1000000000ULL));
+    EXPECT_EQ(0u, stats.getFlows().size());
+}
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,258 @@
+// UDP Client Server Tests -- destinations of the UDP client
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <udp_client_server.h>
+#include <gtest/gtest.h>
+#include "test_helpers.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace udp_client_server;
+
+namespace
+{
+
+std::string receive(UdpServer& server)
+{
+    char buffer[256];
+    int const r(server.timedRecv(buffer, sizeof(buffer), 1000));
+    return r < 0 ? std::string() : std::string(buffer, r);
+}
+
+void collectError(void *user, const UdpErrorEvent& event)
+{
+    static_cast<std::vector<UdpErrorEvent> *>(user)->push_back(event);
+}
+
+} // no name namespace
+
+
+TEST(UdpClient, SendvGathersTheBuffersInOneDatagram)
+{
+    UdpServer server("127.0.0.1", 46052);
+    UdpClient client("127.0.0.1", 46052);
+
+    struct iovec iov[3];
+    iov[0].iov_base = const_cast<char *>("head:");
+    iov[0].iov_len = 5;
+    iov[1].iov_base = const_cast<char *>("body");
+    iov[1].iov_len = 4;
+    iov[2].iov_base = const_cast<char *>(":tail");
+    iov[2].iov_len = 5;
+    ASSERT_EQ(14, client.sendv(iov, 3));
+    EXPECT_EQ("head:body:tail", receive(server));
+}
+
+TEST(UdpClient, SendBatchvSendsOneDatagramPerVector)
+{
+    UdpServer server("127.0.0.1", 46052);
+    UdpClient client("127.0.0.1", 46052);
+
+    struct iovec header;
+    header.iov_base = const_cast<char *>("#");
+    header.iov_len = 1;
+    char const *const payloads[] = { "one", "two", "three" };
+    struct iovec iov[3][2];
+    UdpSendVector vectors[3];
+    for(int i(0); i < 3; ++i)
+    {
+        iov[i][0] = header;
+        iov[i][1].iov_base = const_cast<char *>(payloads[i]);
+        iov[i][1].iov_len = strlen(payloads[i]);
+        vectors[i].iov = iov[i];
+        vectors[i].iovcnt = 2;
+    }
+    ASSERT_EQ(3, client.sendBatchv(vectors, 3));
+    EXPECT_EQ("#one", receive(server));
+    EXPECT_EQ("#two", receive(server));
+    EXPECT_EQ("#three", receive(server));
+}
+
+TEST(UdpServer, RecvvScattersTheDatagram)
+{
+    UdpServer server("127.0.0.1", 46053);
+    UdpClient client("127.0.0.1", 46053);
+    ASSERT_EQ(10, client.send("HEADpayload", 10));
+    ASSERT_EQ(11, client.send("HEADpayload", 11));
+
+    char header[4];
+    char payload[6];
+    struct iovec iov[2];
+    iov[0].iov_base = header;
+    iov[0].iov_len = sizeof(header);
+    iov[1].iov_base = payload;
+    iov[1].iov_len = sizeof(payload);
+    waitReadable(server.getSocket());
+
+    // fits exactly
+    int flags(-1);
+    ASSERT_EQ(10, server.recvv(iov, 2, &flags));
+    EXPECT_EQ(0, flags & MSG_TRUNC);
+    EXPECT_EQ("HEAD", std::string(header, 4));
+    EXPECT_EQ("payloa", std::string(payload, 6));
+
+    // one byte too many
+    ASSERT_EQ(10, server.recvv(iov, 2, &flags));
+    EXPECT_NE(0, flags & MSG_TRUNC);
+
+    EXPECT_EQ(-1, server.recvv(iov, 2, &flags));
+    EXPECT_EQ(EAGAIN, errno);
+    EXPECT_EQ(0, flags);
+}
+
+TEST(UdpClient, MaxPayloadFollowsThePathMtu)
+{
+    UdpServer server("127.0.0.1", 46055);
+    UdpClient client("127.0.0.1", 46055);
+
+    // an Ethernet MTU is assumed until discovery is enabled
+    EXPECT_EQ(1472u, client.maxPayload());
+    EXPECT_EQ(-1, client.getMtu());
+    EXPECT_EQ(ENOTCONN, errno);
+
+    ASSERT_EQ(0, client.enablePmtuDiscovery());
+    int const mtu(client.getMtu());
+    ASSERT_GT(mtu, 0);
+    // capped by the largest UDP payload on the loopback MTU
+    EXPECT_EQ(std::min(static_cast<size_t>(mtu - 28), static_cast<size_t>(65507)), client.maxPayload());
+
+    std::string const large(client.maxPayload(), 'x');
+    ASSERT_EQ(static_cast<int>(large.size()), client.send(large.data(), large.size()));
+}
+
+TEST(UdpServer, ReportsItsQueueDepth)
+{
+    UdpServer server("127.0.0.1", 46060);
+    UdpClient client("127.0.0.1", 46060);
+    EXPECT_EQ(0, server.nextDatagramSize());
+    EXPECT_EQ(0, server.pendingRecvBytes());
+
+    ASSERT_EQ(300, client.send(std::string(300, 'x').data(), 300));
+    ASSERT_EQ(100, client.send(std::string(100, 'y').data(), 100));
+    EXPECT_EQ(300, server.nextDatagramSize());
+    // the kernel accounts the overhead of each packet too
+    EXPECT_GT(server.pendingRecvBytes(), 400);
+
+    SocketMemInfo info;
+    ASSERT_EQ(0, server.getMemInfo(info));
+    EXPECT_EQ(static_cast<uint32_t>(server.pendingRecvBytes()), info.rmem_alloc);
+    EXPECT_GT(info.receiveFill(), 0.0);
+    EXPECT_LT(info.receiveFill(), 1.0);
+    EXPECT_EQ(0u, info.drops);
+
+    char buffer[512];
+    ASSERT_EQ(300, server.recv(buffer, sizeof(buffer)));
+    EXPECT_EQ(100, server.nextDatagramSize());
+    EXPECT_EQ(0, client.pendingSendBytes());
+}
+
+TEST(UdpClient, SetDestinationRedirectsSends)
+{
+    UdpServer first("127.0.0.1", 46064);
+    UdpServer second("127.0.0.2", 46064);
+    UdpClient client("127.0.0.1", 46064);
+
+    ASSERT_EQ(5, client.send("first", 5));
+    EXPECT_EQ("first", receive(first));
+
+    ASSERT_EQ(0, client.setDestination("127.0.0.2", 46064));
+    EXPECT_EQ("127.0.0.2", client.getAddr());
+    ASSERT_EQ(6, client.send("second", 6));
+    EXPECT_EQ("second", receive(second));
+}
+
+TEST(UdpClient, FailedReconnectKeepsTheDestination)
+{
+    UdpServer server("127.0.0.1", 46064);
+    UdpClient client("127.0.0.1", 46064);
+    ASSERT_EQ(0, client.enablePmtuDiscovery());
+
+    // connecting to a broadcast address without SO_BROADCAST fails
+    errno = 0;
+    EXPECT_EQ(-1, client.setDestination("255.255.255.255", 46064));
+    EXPECT_EQ(EACCES, errno);
+
+    EXPECT_EQ("127.0.0.1", client.getAddr());
+    ASSERT_EQ(4, client.send("kept", 4));
+    EXPECT_EQ("kept", receive(server));
+}
+
+TEST(UdpClient, SwapsDestinationsWhileSending)
+{
+    UdpServer first("127.0.0.1", 46064);
+    UdpServer second("127.0.0.2", 46064);
+    UdpClient client("127.0.0.1", 46064);
+
+    std::atomic<bool> done(false);
+    std::atomic<int> failures(0);
+    std::thread sender([&]()
+        {
+            while(!done.load())
+            {
+                if(client.send("x", 1) != 1)
+                {
+                    ++failures;
+                }
+                client.getAddr();
+            }
+        });
+    for(int i(0); i < 2000; ++i)
+    {
+        ASSERT_EQ(0, client.setDestination(i % 2 == 0 ? "127.0.0.2" : "127.0.0.1", 46064));
+    }
+    done = true;
+    sender.join();
+    EXPECT_EQ(0, failures.load());
+    EXPECT_EQ("127.0.0.1", client.getAddr());
+}
+
+TEST(UdpClient, ReportsPortUnreachable)
+{
+    // nothing listens on this port
+    UdpClient client("127.0.0.1", 46075);
+    std::vector<UdpErrorEvent> events;
+    ASSERT_EQ(0, client.enableErrorReporting(collectError, &events));
+
+    ASSERT_EQ(5, client.send("hello", 5));
+    waitForError(client.getSocket());
+    EXPECT_EQ(1, client.pollErrors());
+    ASSERT_EQ(1u, events.size());
+    EXPECT_EQ(UDP_ERROR_PORT_UNREACHABLE, events[0].kind);
+    EXPECT_EQ(ECONNREFUSED, events[0].error);
+    EXPECT_EQ(46075, ntohs(reinterpret_cast<struct sockaddr_in *>(&events[0].destination)->sin_port));
+
+    // the queue is drained
+    EXPECT_EQ(0, client.pollErrors());
+}
+
+TEST(UdpClient, DrainsErrorsWithoutACallback)
+{
+    UdpClient client("127.0.0.1", 46075);
+    ASSERT_EQ(0, client.enableErrorReporting(NULL, NULL));
+    ASSERT_EQ(5, client.send("hello", 5));
+    waitForError(client.getSocket());
+    EXPECT_EQ(1, client.pollErrors());
+    EXPECT_EQ(0, client.pollErrors());
+}
+
+// vim: ts=4 sw=4 et
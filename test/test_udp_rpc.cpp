@@ -0,0 +1,188 @@
+// UDP RPC Tests -- requests and responses with correlation IDs
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <udp_rpc.h>
+#include <monotonic_clock.h>
+#include <gtest/gtest.h>
+#include "test_helpers.h"
+#include <string.h>
+#include <string>
+
+using namespace udp_client_server;
+
+namespace
+{
+
+int echo(void *user, uint16_t method, const char *request, size_t size, char *response, size_t max_size)
+{
+    static_cast<void>(user);
+    if(method != 1 || size > max_size)
+    {
+        return -1;
+    }
+    memcpy(response, request, size);
+    return static_cast<int>(size);
+}
+
+struct Result
+{
+                        Result() : calls(0), status(RPC_OK) {}
+
+    int                 calls;
+    RpcStatus           status;
+    std::string         response;
+};
+
+void record(void *user, RpcStatus status, const char *response, size_t size)
+{
+    Result& result(*static_cast<Result *>(user));
+    ++result.calls;
+    result.status = status;
+    result.response.assign(response, size);
+}
+
+} // no name namespace
+
+
+TEST(RpcClient, ReceivesTheResponseOfTheServer)
+{
+    UdpServer server_socket("127.0.0.1", 46065);
+    UdpClient client_socket("127.0.0.1", 46065);
+    RpcServer server(server_socket, echo, NULL);
+    RpcClient client(client_socket, 16);
+
+    Result result;
+    ASSERT_GE(client.call(1, "ping", 4, monotonicNowNs() + 1000000000ULL, record, &result), 0);
+    EXPECT_EQ(1u, client.getInFlight());
+
+    waitReadable(server_socket.getSocket());
+    EXPECT_EQ(1, server.poll());
+    waitReadable(client_socket.getSocket());
+    EXPECT_EQ(1, client.poll(monotonicNowNs()));
+
+    EXPECT_EQ(1, result.calls);
+    EXPECT_EQ(RPC_OK, result.status);
+    EXPECT_EQ("ping", result.response);
+    EXPECT_EQ(0u, client.getInFlight());
+}
+
+TEST(RpcClient, ReportsHandlerFailures)
+{
+    UdpServer server_socket("127.0.0.1", 46065);
+    UdpClient client_socket("127.0.0.1", 46065);
+    RpcServer server(server_socket, echo, NULL);
+    RpcClient client(client_socket, 16);
+
+    Result result;
+    ASSERT_GE(client.call(2, "ping", 4, monotonicNowNs() + 1000000000ULL, record, &result), 0);
+    waitReadable(server_socket.getSocket());
+    EXPECT_EQ(1, server.poll());
+    waitReadable(client_socket.getSocket());
+    client.poll(monotonicNowNs());
+    EXPECT_EQ(1, result.calls);
+    EXPECT_EQ(RPC_REMOTE_ERROR, result.status);
+}
+
+TEST(RpcClient, TimesOutWithoutAServer)
+{
+    UdpServer server_socket("127.0.0.1", 46065);
+    UdpClient client_socket("127.0.0.1", 46065);
+    RpcClient client(client_socket, 16);
+
+    Result result;
+    uint64_t const now(monotonicNowNs());
+    ASSERT_GE(client.call(1, "ping", 4, now + 20000000ULL, record, &result), 0);
+    EXPECT_EQ(0, client.poll(now + 15000000ULL));
+    EXPECT_EQ(1u, client.getRetransmitCount());
+    EXPECT_EQ(1, client.poll(now + 100000000ULL));
+    EXPECT_EQ(1, result.calls);
+    EXPECT_EQ(RPC_TIMEOUT, result.status);
+    EXPECT_EQ(1u, client.getTimeoutCount());
+}
+
+TEST(RpcClient, PollReadsAtMostMaxResponses)
+{
+    UdpServer server_socket("127.0.0.1", 46065);
+    UdpClient client_socket("127.0.0.1", 46065);
+    RpcServer server(server_socket, echo, NULL);
+    RpcClient client(client_socket, 16);
+
+    Result results[4];
+    for(int i(0); i < 4; ++i)
+    {
+        ASSERT_GE(client.call(1, "ping", 4, monotonicNowNs() + 1000000000ULL, record, &results[i]), 0);
+    }
+    int handled(0);
+    while(handled < 4)
+    {
+        waitReadable(server_socket.getSocket());
+        int const r(server.poll());
+        ASSERT_GT(r, 0);
+        handled += r;
+    }
+    waitReadable(client_socket.getSocket());
+
+    EXPECT_EQ(1, client.poll(monotonicNowNs(), 1));
+    EXPECT_EQ(3u, client.getInFlight());
+    EXPECT_EQ(3, client.poll(monotonicNowNs()));
+    EXPECT_EQ(0u, client.getInFlight());
+}
+
+TEST(RpcClient, IgnoresStaleResponses)
+{
+    UdpServer server_socket("127.0.0.1", 46065);
+    UdpClient client_socket("127.0.0.1", 46065);
+    RpcServer server(server_socket, echo, NULL);
+    RpcClient client(client_socket, 16);
+
+    Result result;
+    int64_t const id(client.call(1, "ping", 4, monotonicNowNs() + 1000000000ULL, record, &result));
+    ASSERT_GE(id, 0);
+    EXPECT_TRUE(client.cancel(static_cast<uint32_t>(id)));
+    waitReadable(server_socket.getSocket());
+    EXPECT_EQ(1, server.poll());
+    waitReadable(client_socket.getSocket());
+
+    EXPECT_EQ(0, client.poll(monotonicNowNs()));
+    EXPECT_EQ(0, result.calls);
+    EXPECT_EQ(1u, client.getStaleResponseCount());
+}
+
+TEST(RpcServer, PollReadsAtMostMaxRequests)
+{
+    UdpServer server_socket("127.0.0.1", 46065);
+    UdpClient client_socket("127.0.0.1", 46065);
+    RpcServer server(server_socket, echo, NULL);
+    RpcClient client(client_socket, 16);
+
+    // datagrams which are not requests count against the bound too
+    for(int i(0); i < 3; ++i)
+    {
+        ASSERT_EQ(4, client_socket.send("junk", 4));
+    }
+    Result result;
+    ASSERT_GE(client.call(1, "ping", 4, monotonicNowNs() + 1000000000ULL, record, &result), 0);
+    waitReadable(server_socket.getSocket());
+
+    EXPECT_EQ(0, server.poll(2));
+    EXPECT_EQ(2u, server.getInvalidCount());
+    EXPECT_EQ(1, server.poll());
+    EXPECT_EQ(3u, server.getInvalidCount());
+    EXPECT_EQ(1u, server.getRequestCount());
+}
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,174 @@
+// Work-Stealing Executor Tests -- tasks balanced over a pool of workers
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <work_stealing_executor.h>
+#include <gtest/gtest.h>
+#include <errno.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace udp_client_server;
+
+namespace
+{
+
+struct CountingTask
+    : public ExecutorTask
+{
+    std::atomic<int> *  counter;
+    int                 worker;
+};
+
+void count(ExecutorTask *task)
+{
+    CountingTask *t(static_cast<CountingTask *>(task));
+    t->worker = WorkStealingExecutor::currentWorker();
+    ++*t->counter;
+}
+
+struct OrderedTask
+    : public ExecutorTask
+{
+    std::vector<int> *  log;
+    int                 value;
+};
+
+void append(ExecutorTask *task)
+{
+    OrderedTask *t(static_cast<OrderedTask *>(task));
+    t->log->push_back(t->value);
+}
+
+/** \brief Spawns children from a worker, which go to its own deque.
+ */
+struct SplittingTask
+    : public ExecutorTask
+{
+    WorkStealingExecutor * executor;
+    std::vector<CountingTask> * children;
+};
+
+void split(ExecutorTask *task)
+{
+    SplittingTask *t(static_cast<SplittingTask *>(task));
+    for(size_t i(0); i < t->children->size(); ++i)
+    {
+        while(!t->executor->submit(&(*t->children)[i]))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void waitFor(const WorkStealingExecutor& executor, uint64_t count)
+{
+    for(int i(0); i < 5000 && executor.getExecutedCount() < count; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+} // no name namespace
+
+
+TEST(WorkStealingExecutor, RunsEverySubmittedTask)
+{
+    WorkStealingExecutor executor(3, 1024);
+    ASSERT_EQ(0, executor.start());
+
+    std::atomic<int> counter(0);
+    std::vector<CountingTask> tasks(500);
+    for(size_t i(0); i < tasks.size(); ++i)
+    {
+        tasks[i].run = count;
+        tasks[i].counter = &counter;
+        tasks[i].worker = -1;
+        ASSERT_TRUE(executor.submit(&tasks[i]));
+    }
+    waitFor(executor, tasks.size());
+    executor.stop();
+
+    EXPECT_EQ(500, counter.load());
+    EXPECT_EQ(500u, executor.getExecutedCount());
+    for(size_t i(0); i < tasks.size(); ++i)
+    {
+        EXPECT_GE(tasks[i].worker, 0);
+        EXPECT_LT(tasks[i].worker, 3);
+    }
+    EXPECT_EQ(-1, WorkStealingExecutor::currentWorker());
+}
+
+TEST(WorkStealingExecutor, RunsTasksSubmittedByTasks)
+{
+    WorkStealingExecutor executor(2, 1024);
+    ASSERT_EQ(0, executor.start());
+
+    std::atomic<int> counter(0);
+    std::vector<CountingTask> children(200);
+    for(size_t i(0); i < children.size(); ++i)
+    {
+        children[i].run = count;
+        children[i].counter = &counter;
+    }
+    SplittingTask parent;
+    parent.run = split;
+    parent.executor = &executor;
+    parent.children = &children;
+    ASSERT_TRUE(executor.submit(&parent));
+
+    waitFor(executor, 1 + children.size());
+    executor.stop();
+    EXPECT_EQ(200, counter.load());
+}
+
+TEST(WorkStealingExecutor, PinnedTasksRunInOrder)
+{
+    WorkStealingExecutor executor(4, 1024);
+    ASSERT_EQ(0, executor.start());
+
+    std::vector<int> log;
+    std::vector<OrderedTask> tasks(300);
+    for(size_t i(0); i < tasks.size(); ++i)
+    {
+        tasks[i].run = append;
+        tasks[i].log = &log;
+        tasks[i].value = static_cast<int>(i);
+        ASSERT_TRUE(executor.submitPinned(42, &tasks[i]));
+    }
+    waitFor(executor, tasks.size());
+    executor.stop();
+
+    ASSERT_EQ(tasks.size(), log.size());
+    for(size_t i(0); i < log.size(); ++i)
+    {
+        EXPECT_EQ(static_cast<int>(i), log[i]);
+    }
+}
+
+TEST(WorkStealingExecutor, StartTwiceFails)
+{
+    WorkStealingExecutor executor(1, 16);
+    ASSERT_EQ(0, executor.start());
+    errno = 0;
+    EXPECT_EQ(-1, executor.start());
+    EXPECT_EQ(EBUSY, errno);
+    executor.stop();
+}
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,260 @@
+// XDP Socket Tests -- AF_XDP receive path on the loopback interface
+// Copyright (C) 2026  ARMA Lab, Vanderbilt University
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include <xdp_socket.h>
+#include <gtest/gtest.h>
+#include "test_helpers.h"
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <memory>
+#include <string>
+
+using namespace udp_client_server;
+
+namespace
+{
+
+/** \brief Attach an XDP socket to lo, or explain why it cannot be.
+ *
+ * This needs CAP_NET_ADMIN and CAP_BPF (or root) and a kernel with
+ * AF_XDP; the tests are skipped otherwise. The kernel releases the
+ * queue of a closed XDP socket a little later, so the bind is retried
+ * for a while (EBUSY) when the previous test just closed its socket.
+ */
+std::unique_ptr<XdpSocket> attach(std::string& reason)
+{
+    for(int attempt(0); attempt < 50; ++attempt)
+    {
+        try
+        {
+            return std::unique_ptr<XdpSocket>(new XdpSocket("lo", "127.0.0.1", 46069));
+        }
+        catch(UdpClientServerRuntimeError const& e)
+        {
+            reason = e.what();
+        }
+        struct timespec pause = { 0, 10000000 };
+        nanosleep(&pause, NULL);
+    }
+    return std::unique_ptr<XdpSocket>();
+}
+
+bool run(const char *command)
+{
+    return system((std::string(command) + " >/dev/null 2>&1").c_str()) == 0;
+}
+
+const uint8_t PEER_MAC[6] = { 0x02, 0x00, 0x00, 0x00, 0x69, 0x02 };
+
+/** \brief A veth pair whose second end lives in a network namespace.
+ *
+ * The kernel drops the frames sent on lo with the addresses of the host
+ * as martians, so the transmission tests go through a veth pair: ucs69a
+ * (10.69.0.1) stays in the namespace of the test and ucs69b (10.69.0.2)
+ * goes to the namespace ucs69. This needs the ip tool and CAP_NET_ADMIN;
+ * ready is false otherwise.
+ */
+struct VethPair
+{
+    VethPair()
+    {
+        remove();
+        ready = run("ip netns add ucs69")
+             && run("ip link add ucs69a address 02:00:00:00:69:01 type veth peer name ucs69b address 02:00:00:00:69:02")
+             && run("ip link set ucs69b netns ucs69")
+             && run("ip addr add 10.69.0.1/24 dev ucs69a")
+             && run("ip link set ucs69a up")
+             && run("ip -n ucs69 addr add 10.69.0.2/24 dev ucs69b")
+             && run("ip -n ucs69 link set ucs69b up");
+    }
+
+    ~VethPair()
+    {
+        remove();
+    }
+
+    static void remove()
+    {
+        // deleting one end deletes the pair
+        run("ip link del ucs69a");
+        run("ip netns del ucs69");
+    }
+
+    bool ready;
+};
+
+/** \brief Create a UdpServer on 10.69.0.2 inside the namespace ucs69.
+ *
+ * A socket stays in the namespace it was created in, so the thread only
+ * enters the namespace while the server is constructed.
+ */
+std::unique_ptr<UdpServer> createPeerServer(int port)
+{
+    std::unique_ptr<UdpServer> server;
+    int const self(open("/proc/self/ns/net", O_RDONLY));
+    int const peer(open("/var/run/netns/ucs69", O_RDONLY));
+    if(self >= 0 && peer >= 0 && setns(peer, CLONE_NEWNET) == 0)
+    {
+        try
+        {
+            server.reset(new UdpServer("10.69.0.2", port));
+        }
+        catch(UdpClientServerRuntimeError const&)
+        {
+        }
+        setns(self, CLONE_NEWNET);
+    }
+    if(peer >= 0)
+    {
+        close(peer);
+    }
+    if(self >= 0)
+    {
+        close(self);
+    }
+    return server;
+}
+
+} // no name namespace
+
+
+TEST(XdpSocket, RejectsInvalidParameters)
+{
+    EXPECT_THROW(XdpSocket("lo", "127.0.0.1", 0), UdpClientServerRuntimeError);
+    EXPECT_THROW(XdpSocket("lo", "127.0.0.1", 46069, 0, true, 1000), UdpClientServerRuntimeError);
+    EXPECT_THROW(XdpSocket("lo", "::1", 46069), UdpClientServerRuntimeError);
+    EXPECT_THROW(XdpSocket("no-such-interface", "127.0.0.1", 46069), UdpClientServerRuntimeError);
+}
+
+TEST(XdpSocket, ReceivesTheDatagramsOfItsPort)
+{
+    std::string reason;
+    std::unique_ptr<XdpSocket> socket(attach(reason));
+    if(!socket)
+    {
+        GTEST_SKIP() << reason;
+    }
+    UdpClient client("127.0.0.1", 46069);
+    ASSERT_EQ(5, client.send("hello", 5));
+
+    char buffer[64];
+    UdpPacketView view;
+    ASSERT_EQ(5, socket->timedRecvView(buffer, sizeof(buffer), view, 1000));
+    EXPECT_EQ("hello", std::string(view.data, view.size));
+    EXPECT_EQ(5u, view.wire_size);
+    EXPECT_EQ(AF_INET, view.source.ss_family);
+    EXPECT_EQ(46069, ntohs(reinterpret_cast<struct sockaddr_in *>(&view.destination)->sin_port));
+    EXPECT_GT(view.timestamp_ns, 0u);
+}
+
+TEST(XdpSocket, LeavesOtherPortsToTheKernel)
+{
+    std::string reason;
+    std::unique_ptr<XdpSocket> socket(attach(reason));
+    if(!socket)
+    {
+        GTEST_SKIP() << reason;
+    }
+    UdpServer server("127.0.0.1", 46070);
+    UdpClient client("127.0.0.1", 46070);
+    ASSERT_EQ(5, client.send("other", 5));
+
+    char buffer[64];
+    ASSERT_EQ(5, server.timedRecv(buffer, sizeof(buffer), 1000));
+    EXPECT_EQ("other", std::string(buffer, 5));
+    EXPECT_EQ(-1, socket->timedRecv(buffer, sizeof(buffer), 10));
+}
+
+TEST(XdpSocket, SendsThroughAVethPair)
+{
+    VethPair veth;
+    if(!veth.ready)
+    {
+        GTEST_SKIP() << "cannot create a veth pair in a network namespace";
+    }
+    std::unique_ptr<XdpSocket> socket;
+    try
+    {
+        // few frames, so the transmission frames are reclaimed many times
+        socket.reset(new XdpSocket("ucs69a", "10.69.0.1", 46069, 0, true, 64));
+    }
+    catch(UdpClientServerRuntimeError const& e)
+    {
+        GTEST_SKIP() << e.what();
+    }
+    std::unique_ptr<UdpServer> server(createPeerServer(46069));
+    ASSERT_TRUE(server != NULL);
+    ASSERT_EQ(0, socket->setDestination("10.69.0.2", 46069, PEER_MAC));
+
+    // the peer drops datagrams with a bad IP or UDP checksum, so every
+    // datagram received proves both right
+    int const BATCH(16);
+    for(int first(0); first < 5000; first += BATCH)
+    {
+        for(int i(first); i < first + BATCH; ++i)
+        {
+            char payload[32];
+            int const size(snprintf(payload, sizeof(payload), "frame %d", i));
+            int r(-1);
+            for(int attempt(0); attempt < 1000 && r < 0; ++attempt)
+            {
+                if(i % 2 == 0)
+                {
+                    r = socket->send(payload, size);
+                }
+                else
+                {
+                    struct iovec iov[2];
+                    iov[0].iov_base = payload;
+                    iov[0].iov_len = 6;
+                    iov[1].iov_base = payload + 6;
+                    iov[1].iov_len = size - 6;
+                    r = socket->sendv(iov, 2);
+                }
+                if(r < 0)
+                {
+                    // all the frames are in flight until the completion ring is reclaimed
+                    ASSERT_EQ(EAGAIN, errno);
+                    struct timespec pause = { 0, 100000 };
+                    nanosleep(&pause, NULL);
+                }
+            }
+            ASSERT_EQ(size, r);
+        }
+        for(int i(first); i < first + BATCH; ++i)
+        {
+            char expected[32];
+            int const size(snprintf(expected, sizeof(expected), "frame %d", i));
+            char buffer[64];
+            struct sockaddr_storage from;
+            socklen_t from_len(sizeof(from));
+            waitReadable(server->getSocket());
+            ASSERT_EQ(size, server->recvFrom(buffer, sizeof(buffer), &from, &from_len)) << "frame " << i << " was lost";
+            EXPECT_EQ(std::string(expected, size), std::string(buffer, size));
+            struct sockaddr_in const *source(reinterpret_cast<struct sockaddr_in const *>(&from));
+            EXPECT_EQ(htonl(0x0A450001), source->sin_addr.s_addr);
+            EXPECT_EQ(46069, ntohs(source->sin_port));
+        }
+    }
+}
+
+// vim: ts=4 sw=4 et